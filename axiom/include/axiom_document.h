@@ -80,6 +80,18 @@ extern "C"
         struct axiom_document *document,
         const axutil_env_t * env);
 
+    /**
+     * Gets the env the tree of the document is to be changed with. For a document built by
+     * axiom_stax_builder_create_with_arena, this env allocates from the arena of the document.
+     * @param document document whose env is to be returned. cannot be NULL
+     * @param env Environment. MUST NOT be NULL.
+     * @return the env of the arena of the document, env if the document has no arena
+     */
+    AXIS2_EXTERN const axutil_env_t *AXIS2_CALL
+    axiom_document_get_env(
+        axiom_document_t *document,
+        const axutil_env_t * env);
+
     /** @} */
 
 #ifdef __cplusplus
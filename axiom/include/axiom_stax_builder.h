@@ -47,6 +47,27 @@ extern "C"
         const axutil_env_t * env,
         axiom_xml_reader_t * parser);
 
+    /**
+     * Creates an stax builder whose document keeps the tree in an arena.
+     * The nodes, elements, texts, namespaces and attributes built, and their
+     * strings, are carved out of large chunks owned by the document, and are
+     * all released at once when the last of the tree is freed, instead of
+     * one by one. Nodes detached from the tree keep the chunks alive until
+     * they are freed as well.
+     * Anything that changes the tree, or keeps results in its objects, must
+     * be given the env returned by axiom_document_get_env, so that memory is
+     * taken from and given back to the arena the right way.
+     * @param environment Environment. MUST NOT be NULL.
+     * @param parser parser to be used with builder. The builder will take ownership of the parser.
+     * @param chunk_size size of the chunks of the arena, 0 for the default
+     * @return a pointer to the newly created builder struct.
+     */
+    AXIS2_EXTERN axiom_stax_builder_t *AXIS2_CALL
+    axiom_stax_builder_create_with_arena(
+        const axutil_env_t * env,
+        axiom_xml_reader_t * parser,
+        size_t chunk_size);
+
     /**
      * Free the build struct instance and its associated document,axiom tree.
      * @param builder pointer to builder struct
@@ -61,7 +61,8 @@ extern "C"
         AXIOM_XML_READER_COMMENT,                   /* <!--comment--> */
         AXIOM_XML_READER_PROCESSING_INSTRUCTION,
         AXIOM_XML_READER_CDATA,
-        AXIOM_XML_READER_DOCUMENT_TYPE
+        AXIOM_XML_READER_DOCUMENT_TYPE,
+        AXIOM_XML_READER_NEED_MORE_INPUT            /* the next event has not been fed yet */
     } axiom_xml_reader_event_types;
 
     /**
@@ -356,6 +357,102 @@ extern "C"
             * get_current_buffer)(
                 axiom_xml_reader_t * parser,
                 const axutil_env_t * env);
+
+        /**
+         * The view getters return the same strings as the getters above,
+         * without copying them. A view need not be null terminated and is
+         * valid until the next call to next, though a reader may reuse the
+         * memory of a value for the next value asked for. It must not be
+         * freed.
+         * @param parser parser struct
+         * @param env environment, MUST NOT be NULL
+         * @param len set to the length of the view
+         * @returns the view, NULL if there is none
+         */
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_name_view)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_prefix_view)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_value_view)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_attribute_name_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_attribute_prefix_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_attribute_value_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_attribute_namespace_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_namespace_prefix_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        const axis2_char_t *(
+            AXIS2_CALL
+            * get_namespace_uri_view_by_number)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                int i,
+                unsigned int *len);
+
+        axis2_status_t(
+            AXIS2_CALL
+            * set_streaming)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                axis2_bool_t streaming);
+
+        axis2_status_t(
+            AXIS2_CALL
+            * feed)(
+                axiom_xml_reader_t * parser,
+                const axutil_env_t * env,
+                const axis2_char_t * data,
+                size_t len,
+                axis2_bool_t is_last);
     };
 
     /**
@@ -424,6 +521,23 @@ extern "C"
         const axis2_char_t * encoding,
         int type);
 
+    /**
+     * Creates a reader driven by the caller, for input that arrives in
+     * chunks, as from a non blocking socket. Chunks are given to the reader
+     * with axiom_xml_reader_feed as they come. axiom_xml_reader_next returns
+     * AXIOM_XML_READER_NEED_MORE_INPUT, instead of waiting for input, when
+     * the next event has not been fed, and the reader is left as it was so
+     * that the call can be made again once more is fed. No thread is tied
+     * up waiting for the rest of a slow message.
+     * @param env environment, MUST not be NULL
+     * @param encoding encoding of the xml
+     * @return pointer to axiom_xml_reader_t struct on success , NULL otherwise
+     */
+    AXIS2_EXTERN axiom_xml_reader_t *AXIS2_CALL
+    axiom_xml_reader_create_for_push(
+        const axutil_env_t * env,
+        const axis2_char_t * encoding);
+
     /**
      * init function initializes the parser. When using libxml2 parser, this function 
      * is needed to initialize libxml2. 
@@ -683,6 +797,141 @@ extern "C"
         axiom_xml_reader_t * parser,
         const axutil_env_t * env);
 
+    /**
+     * Gets the localname of the current element without copying it. The
+     * view need not be null terminated and is valid until the next call
+     * to axiom_xml_reader_next. It must not be freed.
+     * @param parser pointer to the OM XML Reader struct
+     * @param env environment struct, must not be null
+     * @param len set to the length of the view
+     * @return the view, NULL if there is none
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_name_view(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        unsigned int *len);
+
+    /**
+     * Gets the prefix of the current element, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_prefix_view(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        unsigned int *len);
+
+    /**
+     * Gets the text of the current node, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_value_view(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        unsigned int *len);
+
+    /**
+     * Gets the localname of the attribute at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_attribute_name_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Gets the prefix of the attribute at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_attribute_prefix_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Gets the value of the attribute at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_attribute_value_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Gets the namespace uri of the attribute at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_attribute_namespace_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Gets the prefix of the namespace declared at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_namespace_prefix_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Gets the uri of the namespace declared at index i, as a view
+     * @see axiom_xml_reader_get_name_view
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axiom_xml_reader_get_namespace_uri_view_by_number(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        int i,
+        unsigned int *len);
+
+    /**
+     * Lets the reader give back the input it has parsed, so that a huge
+     * document is read in bounded memory. Only the input of the open
+     * elements and their namespaces is kept. Buffers got from
+     * axiom_xml_reader_get_current_buffer then hold only part of the input.
+     * @param parser pointer to parser
+     * @param env environment, MUST not be NULL
+     * @param streaming AXIS2_TRUE to give back parsed input
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axiom_xml_reader_set_streaming(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        axis2_bool_t streaming);
+
+    /**
+     * Feeds the next bytes of the document to a reader made with
+     * axiom_xml_reader_create_for_push. The bytes are copied.
+     * @param parser pointer to parser
+     * @param env environment, MUST not be NULL
+     * @param data bytes that follow those already fed
+     * @param len no: of bytes, can be 0
+     * @param is_last AXIS2_TRUE when no more bytes follow
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axiom_xml_reader_feed(
+        axiom_xml_reader_t * parser,
+        const axutil_env_t * env,
+        const axis2_char_t * data,
+        size_t len,
+        axis2_bool_t is_last);
+
     /** @} */
 
 #ifdef __cplusplus
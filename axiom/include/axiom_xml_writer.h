@@ -26,6 +26,8 @@
 
 #include <axutil_env.h>
 #include <axiom_defines.h>
+#include <axutil_buffer_chain.h>
+#include <axutil_stream.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -575,6 +577,48 @@ extern "C"
         int compression,
         int type);
 
+    /**
+     * create fuction for xml writer that appends to a buffer chain. get_xml
+     * returns NULL for such a writer; the xml is read from the chain, which
+     * is not freed with the writer.
+     * @param env environment struct, must not be null
+     * @param encoding encoding
+     * @param is_prefix_default
+     * @param compression
+     * @param chain chain to append to
+     * @return xml writer wrapper structure.
+     */
+    AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+    axiom_xml_writer_create_for_chain(
+        const axutil_env_t * env,
+        axis2_char_t * encoding,
+        int is_prefix_default,
+        int compression,
+        axutil_buffer_chain_t * chain);
+
+    /**
+     * create fuction for xml writer that writes to a stream as it goes.
+     * get_xml returns NULL for such a writer. What is kept back is written
+     * when the writer is flushed or freed. The stream is not freed with
+     * the writer.
+     * @param env environment struct, must not be null
+     * @param encoding encoding
+     * @param is_prefix_default
+     * @param compression
+     * @param stream stream to write to
+     * @param flush_size no: of bytes kept back before they are written to
+     * the stream, a default size if 0
+     * @return xml writer wrapper structure.
+     */
+    AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+    axiom_xml_writer_create_for_stream(
+        const axutil_env_t * env,
+        axis2_char_t * encoding,
+        int is_prefix_default,
+        int compression,
+        axutil_stream_t * stream,
+        size_t flush_size);
+
     /**
      * free method for axiom xml writer
      * @param writer pointer to the OM XML Writer struct
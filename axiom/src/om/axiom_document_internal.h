@@ -73,6 +73,53 @@ extern "C"
         const axutil_env_t * env,
         axiom_node_t * om_node);
 
+    /**
+     * Arena of a document. Nodes built into the arena refer to it, and the arena is released
+     * when neither the document nor any part of the tree holds a reference to it any more.
+     */
+    typedef struct axiom_document_arena axiom_document_arena_t;
+
+    /**
+     * Makes the document keep the objects of its tree in a new arena
+     * @param document document to give an arena to, which has no tree yet
+     * @param env Environment. MUST NOT be NULL.
+     * @param chunk_size size of the chunks of the arena, 0 for the default
+     * @return status of the op. AXIS2_SUCCESS on success else AXIS2_FAILURE.
+     */
+    axis2_status_t AXIS2_CALL
+    axiom_document_create_arena(
+        struct axiom_document *document,
+        const axutil_env_t * env,
+        size_t chunk_size);
+
+    /**
+     * @return the arena of the document, NULL if the document has none
+     */
+    axiom_document_arena_t *AXIS2_CALL
+    axiom_document_get_arena(
+        struct axiom_document *document);
+
+    /**
+     * @return the env allocating from the arena
+     */
+    const axutil_env_t *AXIS2_CALL
+    axiom_document_arena_get_env(
+        axiom_document_arena_t * arena);
+
+    /**
+     * Takes a reference to the arena
+     */
+    void AXIS2_CALL
+    axiom_document_arena_retain(
+        axiom_document_arena_t * arena);
+
+    /**
+     * Gives back a reference to the arena, releasing the arena with the last one
+     */
+    void AXIS2_CALL
+    axiom_document_arena_release(
+        axiom_document_arena_t * arena);
+
 #if 0
     /* these methods are commented, because it is not used anymore (1.6.0)*/
 
@@ -149,4 +149,70 @@ extern "C"
 		axiom_element_t * om_element,
 		const axutil_env_t * env);
 
+    /**
+     * Frees the results the element keeps from operations such as axiom_element_get_qname,
+     * axiom_element_get_text and axiom_element_get_all_attributes, but not the element itself
+     * @param om_element pointer to om_element
+     * @param env environment MUST not be NULL
+     */
+    void AXIS2_CALL
+    axiom_element_free_results(
+        axiom_element_t * om_element,
+        const axutil_env_t * env);
+
+    /**
+     * Makes room in the element for the attributes the builder reads for it. They are kept as
+     * they were read, and are made into axiom_attribute_t only when they are asked for.
+     * Serializing the element writes them without making them.
+     * @param om_element pointer to om_element
+     * @param env environment MUST not be NULL
+     * @param count no: of attributes
+     * @param size no: of bytes the names and values of the attributes take, without their
+     * terminating nulls
+     * @param arena_env env of the arena the element is built in, NULL if it is not built in
+     * one. The attributes are made with it when it is given, else with the env of the caller
+     * asking for them.
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    axis2_status_t AXIS2_CALL
+    axiom_element_create_raw_attributes(
+        axiom_element_t * om_element,
+        const axutil_env_t * env,
+        int count,
+        size_t size,
+        const axutil_env_t * arena_env);
+
+    /**
+     * Adds an attribute to those room was made for with axiom_element_create_raw_attributes.
+     * Its value is empty until it is set with axiom_element_set_raw_attribute_value.
+     * @param om_element pointer to om_element
+     * @param env environment MUST not be NULL
+     * @param localname local name of the attribute, not null terminated. It is copied.
+     * @param localname_len no: of bytes in localname
+     * @param ns namespace of the attribute, in scope at the element. NULL if it has none.
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    axis2_status_t AXIS2_CALL
+    axiom_element_add_raw_attribute(
+        axiom_element_t * om_element,
+        const axutil_env_t * env,
+        const axis2_char_t * localname,
+        size_t localname_len,
+        axiom_namespace_t * ns);
+
+    /**
+     * Sets the value of the attribute last added with axiom_element_add_raw_attribute
+     * @param om_element pointer to om_element
+     * @param env environment MUST not be NULL
+     * @param value value of the attribute, not null terminated. It is copied.
+     * @param value_len no: of bytes in value
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    axis2_status_t AXIS2_CALL
+    axiom_element_set_raw_attribute_value(
+        axiom_element_t * om_element,
+        const axutil_env_t * env,
+        const axis2_char_t * value,
+        size_t value_len);
+
 #endif /* AXIOM_ELEMENT_INTERNAL_H_ */
@@ -39,6 +39,7 @@ extern "C"
      * @{
      */
     struct axiom_document;
+    struct axiom_document_arena;
     struct axiom_stax_builder;
 
     /**
@@ -137,6 +138,16 @@ extern "C"
         const axutil_env_t * env,
         struct axiom_stax_builder *builder);
 
+    /**
+     * Marks the node as built in the arena of a document, with its data element. The node and
+     * its data element are then released with the arena instead of being freed.
+     */
+    void AXIS2_CALL
+    axiom_node_set_arena(
+        axiom_node_t * om_node,
+        const axutil_env_t * env,
+        struct axiom_document_arena *arena);
+
     void AXIS2_CALL
     axiom_node_assume_builder_ownership(
         axiom_node_t *om_node,
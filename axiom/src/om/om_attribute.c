@@ -62,7 +62,7 @@ axiom_attribute_create(
     attribute->ns = NULL;
     attribute->qname = NULL;
 
-    attribute->localname = axutil_string_create(env, localname);
+    attribute->localname = axutil_string_intern(env, localname);
     if(!(attribute->localname))
     {
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
@@ -242,7 +242,7 @@ axiom_attribute_set_localname(
         attribute->localname = NULL;
     }
 
-    attribute->localname = axutil_string_create(env, localname);
+    attribute->localname = axutil_string_intern(env, localname);
 
     if(!(attribute->localname))
     {
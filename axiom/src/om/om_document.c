@@ -18,6 +18,7 @@
 #include <axiom_document_internal.h>
 #include <axiom_stax_builder_internal.h>
 #include <axutil_string.h>
+#include <axutil_error_default.h>
 
 struct axiom_document
 {
@@ -27,6 +28,18 @@ struct axiom_document
     /** builder of the document */
     struct axiom_stax_builder *builder;
 
+    /** arena the tree is built in, if any */
+    axiom_document_arena_t *arena;
+
+};
+
+struct axiom_document_arena
+{
+    /* allocates from the arena, which holds this struct as well */
+    axutil_env_t *env;
+
+    /* references held by the document and by the parts of the tree */
+    int ref;
 };
 
 axiom_document_t *AXIS2_CALL
@@ -46,9 +59,84 @@ axiom_document_create(
 
     document->builder = builder;
     document->root_element = root;
+    document->arena = NULL;
     return document;
 }
 
+axis2_status_t AXIS2_CALL
+axiom_document_create_arena(
+    axiom_document_t * document,
+    const axutil_env_t * env,
+    size_t chunk_size)
+{
+    axutil_allocator_t *allocator = NULL;
+    axutil_error_t *error = NULL;
+    axutil_env_t *arena_env = NULL;
+    axiom_document_arena_t *arena = NULL;
+
+    /* what the tree keeps from the allocator of env is freed through the arena */
+    allocator = axutil_allocator_arena_create_with_parent(chunk_size, env->allocator);
+    if(allocator)
+    {
+        error = axutil_error_create(allocator);
+    }
+    if(error)
+    {
+        arena_env = axutil_env_create_with_error_log(allocator, error, env->log);
+    }
+    if(arena_env)
+    {
+        arena = (axiom_document_arena_t *)AXIS2_MALLOC(allocator, sizeof(axiom_document_arena_t));
+    }
+    if(!arena)
+    {
+        if(allocator)
+        {
+            axutil_allocator_free(allocator);
+        }
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Insufficient memory to create document arena");
+        return AXIS2_FAILURE;
+    }
+
+    arena->env = arena_env;
+    arena->ref = 1;
+    document->arena = arena;
+    return AXIS2_SUCCESS;
+}
+
+axiom_document_arena_t *AXIS2_CALL
+axiom_document_get_arena(
+    axiom_document_t * document)
+{
+    return document->arena;
+}
+
+const axutil_env_t *AXIS2_CALL
+axiom_document_arena_get_env(
+    axiom_document_arena_t * arena)
+{
+    return arena->env;
+}
+
+void AXIS2_CALL
+axiom_document_arena_retain(
+    axiom_document_arena_t * arena)
+{
+    arena->ref++;
+}
+
+void AXIS2_CALL
+axiom_document_arena_release(
+    axiom_document_arena_t * arena)
+{
+    if(--arena->ref == 0)
+    {
+        /* the env, its error and this struct are in the arena too */
+        axutil_allocator_free(arena->env->allocator);
+    }
+}
+
 void AXIS2_CALL
 axiom_document_free(
     axiom_document_t * document,
@@ -58,6 +146,10 @@ axiom_document_free(
     {
         axiom_node_free_tree(document->root_element, env);
     }
+    if(document->arena)
+    {
+        axiom_document_arena_release(document->arena);
+    }
     AXIS2_FREE(env->allocator, document);
 }
 
@@ -66,6 +158,10 @@ axiom_document_free_self(
     axiom_document_t * document,
     const axutil_env_t * env)
 {
+    if(document->arena)
+    {
+        axiom_document_arena_release(document->arena);
+    }
     AXIS2_FREE(env->allocator, document);
 }
 
@@ -157,6 +253,14 @@ axiom_document_build_next(
     return return_node;
 }
 
+AXIS2_EXTERN const axutil_env_t *AXIS2_CALL
+axiom_document_get_env(
+    axiom_document_t * document,
+    const axutil_env_t * env)
+{
+    return document->arena ? document->arena->env : env;
+}
+
 #if 0
 AXIS2_EXTERN axiom_stax_builder_t *AXIS2_CALL
 axiom_document_get_builder(
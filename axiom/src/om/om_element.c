@@ -24,6 +24,62 @@
 #include <string.h>
 #include <stdio.h>
 
+/*
+ * Most elements carry no more than a few attributes and namespace declarations, so they are
+ * kept in a small array inside the element and searched linearly, which costs less than
+ * making and probing a hash. When there are more than fit in the array, or a caller asks for
+ * them as a hash, they are moved to a hash, which holds them from then on.
+ */
+#define AXIOM_ELEMENT_MAP_INLINE_SIZE 4
+
+typedef struct axiom_element_map_entry
+{
+    const axis2_char_t *key;
+    void *value;
+} axiom_element_map_entry_t;
+
+typedef struct axiom_element_map
+{
+    /* NULL while the entries are inline */
+    axutil_hash_t *hash;
+    int count;
+    axiom_element_map_entry_t entries[AXIOM_ELEMENT_MAP_INLINE_SIZE];
+} axiom_element_map_t;
+
+#define AXIOM_ELEMENT_MAP_IS_EMPTY(map) (!(map)->hash && (map)->count == 0)
+
+/* position while stepping through the values of a map */
+typedef struct axiom_element_map_index
+{
+    int i;
+    axutil_hash_index_t *hi;
+} axiom_element_map_index_t;
+
+/*
+ * Attributes the builder read for an element, kept as they were read. Making an
+ * axiom_attribute_t, its strings and its qname for every attribute of every element costs
+ * more than parsing them, and most of them are never looked at, so they are made only when
+ * they are asked for. The names and values are in the same block, after the entries.
+ */
+typedef struct axiom_element_raw_attribute
+{
+    axis2_char_t *localname;
+    axis2_char_t *value;
+    axiom_namespace_t *ns;
+} axiom_element_raw_attribute_t;
+
+typedef struct axiom_element_raw_attributes
+{
+    /* env of the arena the element is in, NULL if it is not in one */
+    const axutil_env_t *arena_env;
+    int count;
+    int size;
+    /* room left for names and values */
+    axis2_char_t *next;
+    axis2_char_t *end;
+    axiom_element_raw_attribute_t entries[1];
+} axiom_element_raw_attributes_t;
+
 struct axiom_element
 {
 
@@ -33,11 +89,14 @@ struct axiom_element
     /** Element's local name */
     axutil_string_t *localname;
 
-    /** List of attributes */
-    axutil_hash_t *attributes;
+    /** Attributes, keyed by the string form of their qname */
+    axiom_element_map_t attributes;
+
+    /** Other namespaces, keyed by prefix */
+    axiom_element_map_t namespaces;
 
-    /** List of other namespaces */
-    axutil_hash_t *namespaces;
+    /** Attributes read by the builder and not made yet. attributes is empty while there are any */
+    axiom_element_raw_attributes_t *raw_attributes;
 
     /* denotes whether current element is an empty element. i.e. <element/>
      * Used only when writing the output */
@@ -55,6 +114,234 @@ struct axiom_element
 
 };
 
+static void *
+axiom_element_map_get(
+    const axiom_element_map_t * map,
+    const axis2_char_t * key)
+{
+    int i;
+
+    if (map->hash)
+        return axutil_hash_get(map->hash, key, AXIS2_HASH_KEY_STRING);
+
+    for (i = 0; i < map->count; i++)
+    {
+        if (strcmp(map->entries[i].key, key) == 0)
+            return map->entries[i].value;
+    }
+    return NULL;
+}
+
+/* Moves the entries of map to a hash, if they are not in one already */
+static axis2_status_t
+axiom_element_map_to_hash(
+    axiom_element_map_t * map,
+    const axutil_env_t * env)
+{
+    int i;
+
+    if (map->hash)
+        return AXIS2_SUCCESS;
+
+    map->hash = axutil_hash_make(env);
+    if (!map->hash)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to create hash map for element");
+        return AXIS2_FAILURE;
+    }
+    for (i = 0; i < map->count; i++)
+    {
+        axutil_hash_set(map->hash, map->entries[i].key, AXIS2_HASH_KEY_STRING,
+            map->entries[i].value);
+    }
+    map->count = 0;
+    return AXIS2_SUCCESS;
+}
+
+/* Sets the value of key in map, replacing the value there was. A NULL value removes the key. */
+static axis2_status_t
+axiom_element_map_set(
+    axiom_element_map_t * map,
+    const axutil_env_t * env,
+    const axis2_char_t * key,
+    void *value)
+{
+    int i;
+
+    if (!map->hash)
+    {
+        for (i = 0; i < map->count; i++)
+        {
+            if (strcmp(map->entries[i].key, key) == 0)
+            {
+                if (value)
+                {
+                    map->entries[i].key = key;
+                    map->entries[i].value = value;
+                }
+                else
+                {
+                    map->count--;
+                    memmove(map->entries + i, map->entries + i + 1,
+                        (map->count - i) * sizeof(axiom_element_map_entry_t));
+                }
+                return AXIS2_SUCCESS;
+            }
+        }
+
+        if (!value)
+            return AXIS2_SUCCESS;
+
+        if (map->count < AXIOM_ELEMENT_MAP_INLINE_SIZE)
+        {
+            map->entries[map->count].key = key;
+            map->entries[map->count].value = value;
+            map->count++;
+            return AXIS2_SUCCESS;
+        }
+
+        if (axiom_element_map_to_hash(map, env) != AXIS2_SUCCESS)
+            return AXIS2_FAILURE;
+    }
+
+    axutil_hash_set(map->hash, key, AXIS2_HASH_KEY_STRING, value);
+    return AXIS2_SUCCESS;
+}
+
+/*
+ * Returns the first value of map, NULL if it is empty. The values that follow are got with
+ * axiom_element_map_next, and index must be given to axiom_element_map_index_free if the
+ * values are not stepped through to the end.
+ */
+static void *
+axiom_element_map_first(
+    const axiom_element_map_t * map,
+    const axutil_env_t * env,
+    axiom_element_map_index_t * index)
+{
+    void *value = NULL;
+
+    index->i = 0;
+    index->hi = NULL;
+    if (map->hash)
+    {
+        index->hi = axutil_hash_first(map->hash, env);
+        if (index->hi)
+            axutil_hash_this(index->hi, NULL, NULL, &value);
+        return value;
+    }
+    return map->count > 0 ? map->entries[0].value : NULL;
+}
+
+static void *
+axiom_element_map_next(
+    const axiom_element_map_t * map,
+    const axutil_env_t * env,
+    axiom_element_map_index_t * index)
+{
+    void *value = NULL;
+
+    if (map->hash)
+    {
+        index->hi = axutil_hash_next(env, index->hi);
+        if (index->hi)
+            axutil_hash_this(index->hi, NULL, NULL, &value);
+        return value;
+    }
+    index->i++;
+    return index->i < map->count ? map->entries[index->i].value : NULL;
+}
+
+static void
+axiom_element_map_index_free(
+    axiom_element_map_index_t * index,
+    const axutil_env_t * env)
+{
+    if (index->hi)
+    {
+        AXIS2_FREE(env->allocator, index->hi);
+        index->hi = NULL;
+    }
+}
+
+/* Makes the attributes the builder kept as they were read into axiom_attribute_t */
+static axis2_status_t
+axiom_element_make_raw_attributes(
+    axiom_element_t * om_element,
+    const axutil_env_t * env)
+{
+    axiom_element_raw_attributes_t *raw = om_element->raw_attributes;
+    axis2_status_t status = AXIS2_SUCCESS;
+    int i;
+
+    if (!raw)
+        return AXIS2_SUCCESS;
+
+    om_element->raw_attributes = NULL;
+    if (raw->arena_env)
+        env = raw->arena_env;
+
+    for (i = 0; i < raw->count && status == AXIS2_SUCCESS; i++)
+    {
+        axiom_attribute_t *attribute;
+        axutil_qname_t *qname = NULL;
+        axis2_char_t *name = NULL;
+
+        attribute = axiom_attribute_create(env, raw->entries[i].localname, raw->entries[i].value,
+            raw->entries[i].ns);
+        if (attribute)
+            qname = axiom_attribute_get_qname(attribute, env);
+        if (qname)
+            name = axutil_qname_to_string(qname, env);
+        if (name)
+            status = axiom_element_map_set(&om_element->attributes, env, name, attribute);
+        else
+            status = AXIS2_FAILURE;
+
+        if (status == AXIS2_SUCCESS)
+            axiom_attribute_increment_ref(attribute, env);
+        else if (attribute)
+            axiom_attribute_free(attribute, env);
+    }
+
+    if (status != AXIS2_SUCCESS)
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to make attributes read for element");
+
+    AXIS2_FREE(env->allocator, raw);
+    return status;
+}
+
+/* Writes an attribute kept as it was read, the way axiom_attribute_serialize writes one */
+static axis2_status_t
+axiom_element_serialize_raw_attribute(
+    axiom_element_raw_attribute_t * attribute,
+    const axutil_env_t * env,
+    axiom_output_t * om_output)
+{
+    axis2_char_t *uri;
+    axis2_char_t *prefix;
+
+    if (!attribute->ns)
+    {
+        return axiom_output_write(om_output, env, AXIOM_ATTRIBUTE, 2, attribute->localname,
+            attribute->value);
+    }
+
+    uri = axiom_namespace_get_uri(attribute->ns, env);
+    prefix = axiom_namespace_get_prefix(attribute->ns, env);
+    if (uri && prefix && (axutil_strcmp(prefix, "") != 0))
+    {
+        return axiom_output_write(om_output, env, AXIOM_ATTRIBUTE, 4, attribute->localname,
+            attribute->value, uri, prefix);
+    }
+    else if (uri)
+    {
+        return axiom_output_write(om_output, env, AXIOM_ATTRIBUTE, 3, attribute->localname,
+            attribute->value, uri);
+    }
+    return AXIS2_SUCCESS;
+}
+
 /**
  * Creates an AXIOM element with given local name
  *
@@ -102,7 +389,7 @@ axiom_element_create(
     }
     memset(element, 0, sizeof(axiom_element_t));
 
-    element->localname = axutil_string_create(env, localname);
+    element->localname = axutil_string_intern(env, localname);
     if (!element->localname)
     {
         AXIS2_FREE(env->allocator, element);/* Still we haven't set the data element. so, we have */
@@ -224,6 +511,9 @@ axiom_element_free(
     axiom_element_t * om_element,
     const axutil_env_t * env)
 {
+    axiom_element_map_index_t index;
+    void *val;
+
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(om_element->localname != NULL);
@@ -232,32 +522,31 @@ axiom_element_free(
     if (om_element->ns)
         axiom_namespace_free(om_element->ns, env);
 
-    if (om_element->attributes)
+    if (om_element->raw_attributes)
+        AXIS2_FREE(env->allocator, om_element->raw_attributes);
+
+    for (val = axiom_element_map_first(&om_element->attributes, env, &index); val;
+        val = axiom_element_map_next(&om_element->attributes, env, &index))
     {
-        axutil_hash_index_t *hi;
-        void *val;
-        for(hi = axutil_hash_first(om_element->attributes, env); hi; hi = axutil_hash_next(env, hi))
-        {
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
-            axiom_attribute_free((axiom_attribute_t *)val, env);
-        }
-        axutil_hash_free(om_element->attributes, env);
+        axiom_attribute_free((axiom_attribute_t *)val, env);
     }
 
-    if (om_element->namespaces)
+    for (val = axiom_element_map_first(&om_element->namespaces, env, &index); val;
+        val = axiom_element_map_next(&om_element->namespaces, env, &index))
     {
-        axutil_hash_index_t *hi;
-        void *val;
-        for(hi = axutil_hash_first(om_element->namespaces, env); hi; hi = axutil_hash_next(env, hi))
-        {
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
-            axiom_namespace_free((axiom_namespace_t *)val, env);
-        }
-        axutil_hash_free(om_element->namespaces, env);
+        axiom_namespace_free((axiom_namespace_t *)val, env);
     }
 
+    /* the hashes the attributes and namespaces may have been moved to go with the results */
+    axiom_element_free_results(om_element, env);
+    AXIS2_FREE(env->allocator, om_element);
+}
+
+void AXIS2_CALL
+axiom_element_free_results(
+    axiom_element_t * om_element,
+    const axutil_env_t * env)
+{
     if (om_element->qname)
         axutil_qname_free(om_element->qname, env);
 
@@ -275,7 +564,99 @@ axiom_element_free(
         AXIS2_FREE(env->allocator, om_element->text_value);
     }
 
-    AXIS2_FREE(env->allocator, om_element);
+    if (om_element->attributes.hash)
+        axutil_hash_free(om_element->attributes.hash, env);
+
+    if (om_element->namespaces.hash)
+        axutil_hash_free(om_element->namespaces.hash, env);
+}
+
+axis2_status_t AXIS2_CALL
+axiom_element_create_raw_attributes(
+    axiom_element_t * om_element,
+    const axutil_env_t * env,
+    int count,
+    size_t size,
+    const axutil_env_t * arena_env)
+{
+    axiom_element_raw_attributes_t *raw;
+    size_t entries_size;
+
+    AXIS2_ASSERT(om_element != NULL);
+    AXIS2_ASSERT(om_element->raw_attributes == NULL);
+    AXIS2_ASSERT(count > 0);
+
+    /* the names and values follow the entries, with their terminating nulls */
+    entries_size = sizeof(axiom_element_raw_attributes_t)
+        + (count - 1) * sizeof(axiom_element_raw_attribute_t);
+    raw = (axiom_element_raw_attributes_t *)AXIS2_MALLOC(env->allocator,
+        entries_size + size + 2 * count);
+    if (!raw)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Insufficient memory to keep attributes read");
+        return AXIS2_FAILURE;
+    }
+
+    raw->arena_env = arena_env;
+    raw->count = 0;
+    raw->size = count;
+    raw->next = (axis2_char_t *)raw + entries_size;
+    raw->end = raw->next + size + 2 * count;
+    om_element->raw_attributes = raw;
+    return AXIS2_SUCCESS;
+}
+
+axis2_status_t AXIS2_CALL
+axiom_element_add_raw_attribute(
+    axiom_element_t * om_element,
+    const axutil_env_t * env,
+    const axis2_char_t * localname,
+    size_t localname_len,
+    axiom_namespace_t * ns)
+{
+    axiom_element_raw_attributes_t *raw = om_element->raw_attributes;
+    axiom_element_raw_attribute_t *attribute;
+
+    /* room is left for the value's terminating null */
+    if (!raw || raw->count == raw->size
+        || (size_t)(raw->end - raw->next) < localname_len + 2)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "No room kept for attribute read");
+        return AXIS2_FAILURE;
+    }
+
+    attribute = raw->entries + raw->count++;
+    attribute->localname = raw->next;
+    memcpy(raw->next, localname, localname_len);
+    raw->next += localname_len;
+    *raw->next++ = '\0';
+    attribute->value = raw->next;
+    *raw->next = '\0';
+    attribute->ns = ns;
+    return AXIS2_SUCCESS;
+}
+
+axis2_status_t AXIS2_CALL
+axiom_element_set_raw_attribute_value(
+    axiom_element_t * om_element,
+    const axutil_env_t * env,
+    const axis2_char_t * value,
+    size_t value_len)
+{
+    axiom_element_raw_attributes_t *raw = om_element->raw_attributes;
+
+    /* the value goes where the empty one of the last attribute is */
+    if (!raw || raw->count == 0 || (size_t)(raw->end - raw->next) < value_len + 1)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "No room kept for attribute value read");
+        return AXIS2_FAILURE;
+    }
+
+    memcpy(raw->next, value, value_len);
+    raw->next += value_len;
+    *raw->next++ = '\0';
+    return AXIS2_SUCCESS;
 }
 
 /**
@@ -300,42 +681,36 @@ axiom_element_find_declared_namespace(
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
 
-    if (om_element->namespaces)
+    if (uri && (!prefix || axutil_strcmp(prefix, "") == 0))
     {
-        if (uri && (!prefix || axutil_strcmp(prefix, "") == 0))
+        /** prefix is null , so step through the namespaces to find the namespace */
+        axiom_element_map_index_t index;
+        void *ns;
+        for (ns = axiom_element_map_first(&om_element->namespaces, env, &index); ns;
+            ns = axiom_element_map_next(&om_element->namespaces, env, &index))
         {
-            /** prefix is null , so iterate the namespaces hash to find the namespace */
-            axutil_hash_index_t *hashindex;
-            for(hashindex = axutil_hash_first(om_element->namespaces, env); hashindex;
-                hashindex = axutil_hash_next(env, hashindex))
+            axiom_namespace_t *temp_ns = (axiom_namespace_t *)ns;
+            axis2_char_t *temp_nsuri = axiom_namespace_get_uri(temp_ns, env);
+            if (axutil_strcmp(temp_nsuri, uri) == 0)
             {
-                void *ns = NULL;
-                axutil_hash_this(hashindex, NULL, NULL, &ns);
-                if (ns)
-                {
-                    axiom_namespace_t *temp_ns = (axiom_namespace_t *)ns;
-                    axis2_char_t *temp_nsuri = axiom_namespace_get_uri(temp_ns, env);
-                    if (axutil_strcmp(temp_nsuri, uri) == 0)
-                    {
-                        /** namespace uri matches, so free hash index and return ns*/
-                        AXIS2_FREE(env->allocator, hashindex);
-                        return temp_ns;
-                    }
-                }
+                /** namespace uri matches, so free the index and return ns*/
+                axiom_element_map_index_free(&index, env);
+                return temp_ns;
             }
         }
-        else if (prefix)
+    }
+    else if (prefix)
+    {
+        /** prefix is not null get namespace directly if exist */
+        axiom_namespace_t *ns = (axiom_namespace_t *)axiom_element_map_get(&om_element->namespaces,
+            prefix);
+        if (ns)
         {
-            /** prefix is not null get namespace directly if exist */
-            axiom_namespace_t *ns = (axiom_namespace_t *)axutil_hash_get(om_element->namespaces, prefix, AXIS2_HASH_KEY_STRING);
-            if (ns)
-            {
-                /* if uri provided, return found ns only if uri matches */
-                if ((uri) && (axutil_strcmp(axiom_namespace_get_uri(ns, env), uri) != 0))
-                    ns = NULL;
+            /* if uri provided, return found ns only if uri matches */
+            if ((uri) && (axutil_strcmp(axiom_namespace_get_uri(ns, env), uri) != 0))
+                ns = NULL;
 
-                return ns;
-            }
+            return ns;
         }
     }
     return NULL;
@@ -450,30 +825,11 @@ axiom_element_declare_namespace(
     if (declared_ns)
         return AXIS2_SUCCESS;
 
-    if (!om_element->namespaces)
-    {
-        om_element->namespaces = axutil_hash_make(env);
-        if (!om_element->namespaces)
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to create namespaces hash map");
-            return AXIS2_FAILURE;
-        }
-    }
-
-    if (prefix)
-        axutil_hash_set(om_element->namespaces, prefix, AXIS2_HASH_KEY_STRING, ns);
-    else
+    if (axiom_element_map_set(&om_element->namespaces, env, prefix ? prefix : "", ns)
+        != AXIS2_SUCCESS)
     {
-        /* create a key with empty string */
-        axis2_char_t *key;
-        key = AXIS2_MALLOC(env->allocator, sizeof(char) * 1);
-        if (!key)
-        {
-            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Insufficient memory to create key to store namespace");
-        }
-        key[0] = '\0';
-        axutil_hash_set(om_element->namespaces, key, AXIS2_HASH_KEY_STRING, ns);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to store namespace");
+        return AXIS2_FAILURE;
     }
     axiom_namespace_increment_ref(ns, env);
     return AXIS2_SUCCESS;
@@ -495,17 +851,14 @@ axiom_element_get_default_namespace(
     axiom_node_t * element_node)
 {
     axiom_node_t *parent_node;
+    axiom_namespace_t *default_ns;
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(element_node != NULL);
 
-    if (om_element->namespaces)
-    {
-        axiom_namespace_t *default_ns;
-        default_ns = axutil_hash_get(om_element->namespaces, "", AXIS2_HASH_KEY_STRING);
-        if (default_ns)
-            return default_ns;
-    }
+    default_ns = axiom_element_map_get(&om_element->namespaces, "");
+    if (default_ns)
+        return default_ns;
 
     parent_node = axiom_node_get_parent(element_node, env);
     if ((parent_node) && (axiom_node_get_node_type(parent_node, env) == AXIOM_ELEMENT))
@@ -585,15 +938,18 @@ axiom_element_set_namespace(
  * @param om_element pointer to om_element
  * @param env environment MUST not be NULL
  *
- * @returns axutil_hash pointer to namespaces hash
- * this hash table is read only
+ * @returns axutil_hash pointer to namespaces hash, NULL if there are none
+ * this hash table is read only. The namespaces are kept in it from then on.
  */
 AXIS2_EXTERN axutil_hash_t *AXIS2_CALL
 axiom_element_get_namespaces(
     axiom_element_t * om_element,
     const axutil_env_t * env)
 {
-    return om_element->namespaces;
+    if (AXIOM_ELEMENT_MAP_IS_EMPTY(&om_element->namespaces))
+        return NULL;
+    axiom_element_map_to_hash(&om_element->namespaces, env);
+    return om_element->namespaces.hash;
 }
 
 /**
@@ -620,6 +976,10 @@ axiom_element_add_attribute(
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(om_element != NULL);
 
+    /* those read for the element go first */
+    if (axiom_element_make_raw_attributes(om_element, env) != AXIS2_SUCCESS)
+        return AXIS2_FAILURE;
+
     om_namespace = axiom_attribute_get_namespace(attribute, env);
     if (om_namespace)
     {
@@ -631,21 +991,16 @@ axiom_element_add_attribute(
         }
     }
 
-    if (!om_element->attributes)
-    {
-        om_element->attributes = axutil_hash_make(env);
-        if (!om_element->attributes)
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to create hash map to store attributes");
-            return AXIS2_FAILURE;
-        }
-    }
-
     qname = axiom_attribute_get_qname(attribute, env);
     if (qname)
     {
         axis2_char_t *name = axutil_qname_to_string(qname, env);
-        axutil_hash_set(om_element->attributes, name, AXIS2_HASH_KEY_STRING, attribute);
+        if (!name || axiom_element_map_set(&om_element->attributes, env, name, attribute)
+            != AXIS2_SUCCESS)
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to store attribute");
+            return AXIS2_FAILURE;
+        }
         axiom_attribute_increment_ref(attribute, env);
     }
     else
@@ -680,8 +1035,10 @@ axiom_element_get_attribute(
     AXIS2_ASSERT(qname != NULL);
     AXIS2_ASSERT(om_element != NULL);
 
+    axiom_element_make_raw_attributes(om_element, env);
+
     /* if there are no attributes, then return NULL */
-    if (!om_element->attributes)
+    if (AXIOM_ELEMENT_MAP_IS_EMPTY(&om_element->attributes))
         return NULL;
 
     name = axutil_qname_to_string(qname, env);
@@ -691,7 +1048,7 @@ axiom_element_get_attribute(
         return NULL;
     }
 
-    attr = axutil_hash_get(om_element->attributes, name, AXIS2_HASH_KEY_STRING);
+    attr = axiom_element_map_get(&om_element->attributes, name);
     return (axiom_attribute_t *)attr;
 }
 
@@ -701,15 +1058,19 @@ axiom_element_get_attribute(
  * @param om_element pointer to om_element
  * @param env environment MUST not be NULL
  *
- * @returns axutil_hash pointer to attributes hash
- * This hash table is read only
+ * @returns axutil_hash pointer to attributes hash, NULL if there are none
+ * This hash table is read only. The attributes are kept in it from then on.
  */
 AXIS2_EXTERN axutil_hash_t *AXIS2_CALL
 axiom_element_get_all_attributes(
     axiom_element_t * om_element,
     const axutil_env_t * env)
 {
-    return om_element->attributes;
+    axiom_element_make_raw_attributes(om_element, env);
+    if (AXIOM_ELEMENT_MAP_IS_EMPTY(&om_element->attributes))
+        return NULL;
+    axiom_element_map_to_hash(&om_element->attributes, env);
+    return om_element->attributes.hash;
 }
 
 /**
@@ -748,14 +1109,16 @@ axiom_element_extract_attributes(
     const axutil_env_t * env,
     axiom_node_t * ele_node)
 {
-    axutil_hash_index_t *hi;
+    axiom_element_map_index_t index;
+    void *val;
     axutil_hash_t *ht_cloned;
 
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(ele_node != NULL);
 
-    if (!om_element->attributes)
+    axiom_element_make_raw_attributes(om_element, env);
+    if (AXIOM_ELEMENT_MAP_IS_EMPTY(&om_element->attributes))
         return NULL;
 
     ht_cloned = axutil_hash_make(env);
@@ -765,15 +1128,12 @@ axiom_element_extract_attributes(
         return NULL;
     }
 
-    for(hi = axutil_hash_first(om_element->attributes, env); hi; hi = axutil_hash_next(env, hi))
+    for (val = axiom_element_map_first(&om_element->attributes, env, &index); val;
+        val = axiom_element_map_next(&om_element->attributes, env, &index))
     {
-        void *val;
         axiom_attribute_t *cloned_attr;
         axis2_char_t *key = NULL;
 
-        axutil_hash_this(hi, NULL, NULL, &val);
-        AXIS2_ASSERT(val != NULL);
-
         cloned_attr = axiom_attribute_clone((axiom_attribute_t*)val, env);
         if (cloned_attr)
         {
@@ -787,6 +1147,7 @@ axiom_element_extract_attributes(
         else
         {
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to clone attribute");
+            axiom_element_map_index_free(&index, env);
             return NULL;
         }
     }
@@ -806,25 +1167,22 @@ axiom_element_get_attribute_value_by_name(
     const axutil_env_t * env,
     axis2_char_t * attr_name)
 {
-    axutil_hash_index_t *hi;
+    axiom_element_map_index_t index;
+    void *attr;
 
     AXIS2_ASSERT(attr_name != NULL);
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
 
-    if (!om_element->attributes)
-        return NULL;
+    axiom_element_make_raw_attributes(om_element, env);
 
-    for(hi = axutil_hash_first(om_element->attributes, env); hi; hi = axutil_hash_next(env, hi))
+    for (attr = axiom_element_map_first(&om_element->attributes, env, &index); attr;
+        attr = axiom_element_map_next(&om_element->attributes, env, &index))
     {
-        void *attr;
         axis2_char_t *this_attr_name;
         axiom_namespace_t *attr_ns;
         axis2_char_t *prefix;
 
-        axutil_hash_this(hi, NULL, NULL, &attr);
-        AXIS2_ASSERT(attr != NULL);
-
         this_attr_name = axiom_attribute_get_localname((axiom_attribute_t*)attr, env);
         attr_ns = axiom_attribute_get_namespace((axiom_attribute_t*)attr, env);
         if (attr_ns && (prefix = axiom_namespace_get_prefix(attr_ns, env)) &&
@@ -853,7 +1211,7 @@ axiom_element_get_attribute_value_by_name(
         }
 
         /* we found the attribute */
-        AXIS2_FREE(env->allocator, hi);
+        axiom_element_map_index_free(&index, env);
         return axiom_attribute_get_value((axiom_attribute_t*)attr, env);
     }
     return NULL;
@@ -996,7 +1354,7 @@ axiom_element_set_localname(
     AXIS2_ASSERT(localname != NULL);
     AXIS2_ASSERT(env != NULL);
 
-    new_name = axutil_string_create(env, localname);
+    new_name = axutil_string_intern(env, localname);
     if (!new_name)
     {
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to set local name of element");
@@ -1248,22 +1606,15 @@ axiom_element_gather_parent_namespaces(
             && (axiom_node_get_node_type(parent_node, env) == AXIOM_ELEMENT))
     {
         axiom_element_t *parent_element;
-        axutil_hash_t *parent_namespaces;
-        axutil_hash_index_t *hi;
+        axiom_element_map_index_t index;
+        void *val;
 
         parent_element = (axiom_element_t *)axiom_node_get_data_element(parent_node, env);
-        parent_namespaces = axiom_element_get_namespaces(parent_element, env);
-
-        /* If no namespaces are declared. So, continue without processing */
-        if (!parent_namespaces)
-            continue;
 
-        for (hi = axutil_hash_first(parent_namespaces, env); hi; hi = axutil_hash_next(env, hi))
+        for (val = axiom_element_map_first(&parent_element->namespaces, env, &index); val;
+            val = axiom_element_map_next(&parent_element->namespaces, env, &index))
         {
             axis2_char_t *key;
-            void *val;
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
 
             key = axiom_namespace_get_prefix((axiom_namespace_t *)val, env);
             if (!key)
@@ -1347,7 +1698,8 @@ axiom_element_redeclare_parent_namespaces(
     axutil_hash_t *inscope_namespaces)
 {
     axiom_node_t *child_node;
-    axutil_hash_t * attributes;
+    axiom_element_map_index_t index;
+    void *val;
     AXIS2_ASSERT(om_element != NULL);
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(om_node != NULL);
@@ -1356,22 +1708,23 @@ axiom_element_redeclare_parent_namespaces(
     axiom_element_use_parent_namespace(om_element, env, om_node, om_element->ns, inscope_namespaces);
 
     /* for each attribute, ensure the attribute's namespace is declared */
-    attributes = om_element->attributes;
-    if (attributes)
+    if (om_element->raw_attributes)
     {
-        axutil_hash_index_t *hi;
-        for(hi = axutil_hash_first(attributes, env); hi; hi = axutil_hash_next(env, hi))
+        int i;
+        for (i = 0; i < om_element->raw_attributes->count; i++)
         {
-            void *val;
-            axiom_namespace_t* ns;
-
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
-
-            ns = axiom_attribute_get_namespace((axiom_attribute_t*)val, env);
-            axiom_element_use_parent_namespace(om_element, env, om_node,ns, inscope_namespaces);
+            axiom_element_use_parent_namespace(om_element, env, om_node,
+                om_element->raw_attributes->entries[i].ns, inscope_namespaces);
         }
     }
+    for (val = axiom_element_map_first(&om_element->attributes, env, &index); val;
+        val = axiom_element_map_next(&om_element->attributes, env, &index))
+    {
+        axiom_namespace_t* ns;
+
+        ns = axiom_attribute_get_namespace((axiom_attribute_t*)val, env);
+        axiom_element_use_parent_namespace(om_element, env, om_node,ns, inscope_namespaces);
+    }
 
     /* ensure the namespaces in all the children are declared */
     child_node = axiom_node_get_first_child(om_node, env);
@@ -1401,6 +1754,8 @@ axiom_element_serialize_start_part(
     axiom_node_t * ele_node)
 {
     axis2_status_t status = AXIS2_SUCCESS;
+    axiom_element_map_index_t index;
+    void *val;
 
     AXIS2_ASSERT(env != NULL);
     AXIS2_ASSERT(om_element != NULL);
@@ -1464,39 +1819,39 @@ axiom_element_serialize_start_part(
         return AXIS2_FAILURE;
     }
 
-    if (om_element->attributes)
+    if (om_element->raw_attributes)
     {
-        axutil_hash_index_t *hi;
-        void *val;
-        for(hi = axutil_hash_first(om_element->attributes, env); hi; hi = axutil_hash_next(env, hi))
+        int i;
+        for (i = 0; i < om_element->raw_attributes->count; i++)
         {
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
-
-            if (axiom_attribute_serialize((axiom_attribute_t *)val, env, om_output) != AXIS2_SUCCESS)
+            if (axiom_element_serialize_raw_attribute(om_element->raw_attributes->entries + i,
+                env, om_output) != AXIS2_SUCCESS)
             {
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "element attribute serialize failed");
-                AXIS2_FREE(env->allocator, hi);
                 return AXIS2_FAILURE;
             }
         }
     }
 
-    if (om_element->namespaces)
+    for (val = axiom_element_map_first(&om_element->attributes, env, &index); val;
+        val = axiom_element_map_next(&om_element->attributes, env, &index))
     {
-        axutil_hash_index_t *hi;
-        void *val;
-        for(hi = axutil_hash_first(om_element->namespaces, env); hi; hi = axutil_hash_next(env, hi))
+        if (axiom_attribute_serialize((axiom_attribute_t *)val, env, om_output) != AXIS2_SUCCESS)
         {
-            axutil_hash_this(hi, NULL, NULL, &val);
-            AXIS2_ASSERT(val != NULL);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "element attribute serialize failed");
+            axiom_element_map_index_free(&index, env);
+            return AXIS2_FAILURE;
+        }
+    }
 
-            if (axiom_namespace_serialize((axiom_namespace_t *)val, env, om_output) != AXIS2_SUCCESS)
-            {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "element namespace serialize failed");
-                AXIS2_FREE(env->allocator, hi);
-                return AXIS2_FAILURE;
-            }
+    for (val = axiom_element_map_first(&om_element->namespaces, env, &index); val;
+        val = axiom_element_map_next(&om_element->namespaces, env, &index))
+    {
+        if (axiom_namespace_serialize((axiom_namespace_t *)val, env, om_output) != AXIS2_SUCCESS)
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "element namespace serialize failed");
+            axiom_element_map_index_free(&index, env);
+            return AXIS2_FAILURE;
         }
     }
 
@@ -1577,31 +1932,12 @@ axiom_element_declare_namespace_assume_param_ownership(
         return AXIS2_FAILURE;
     }
 
-    if (!(om_element->namespaces))
-    {
-        om_element->namespaces = axutil_hash_make(env);
-        if (!(om_element->namespaces))
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to create namespaces hash map");
-            return AXIS2_FAILURE;
-        }
-    }
-	
     prefix = axiom_namespace_get_prefix(ns, env);
-    if (prefix)
-        axutil_hash_set(om_element->namespaces, prefix, AXIS2_HASH_KEY_STRING, ns);
-    else
+    if (axiom_element_map_set(&om_element->namespaces, env, prefix ? prefix : "", ns)
+        != AXIS2_SUCCESS)
     {
-        /* create a key with empty string */
-        axis2_char_t *key;
-        key = AXIS2_MALLOC(env->allocator, sizeof(char) * 1);
-        if (!key)
-        {
-            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Insufficient memory to create key to store namespace");
-        }
-        key[0] = '\0';
-        axutil_hash_set(om_element->namespaces, key, AXIS2_HASH_KEY_STRING, ns);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to store namespace");
+        return AXIS2_FAILURE;
     }
     axiom_namespace_increment_ref(ns, env);
     return AXIS2_SUCCESS;
@@ -1655,12 +1991,9 @@ axiom_element_find_namespace_uri(
     AXIS2_PARAM_CHECK(env->error, element_node, NULL);
     AXIS2_PARAM_CHECK(env->error, prefix, NULL);
 
-    if (om_element->namespaces)
-    {
-        ns = axutil_hash_get(om_element->namespaces, prefix, AXIS2_HASH_KEY_STRING);
-        if (ns)
-            return ns;
-    }
+    ns = axiom_element_map_get(&om_element->namespaces, prefix);
+    if (ns)
+        return ns;
 
     parent_node = axiom_node_get_parent(element_node, env);
     if ((parent_node) && (axiom_node_get_node_type(parent_node, env) == AXIOM_ELEMENT))
@@ -1746,17 +2079,11 @@ axiom_element_declare_default_namespace(
     if (!default_ns)
         return NULL;
 
-    if (!om_element->namespaces)
+    if (axiom_element_map_set(&om_element->namespaces, env, "", default_ns) != AXIS2_SUCCESS)
     {
-        om_element->namespaces = axutil_hash_make(env);
-        if (!(om_element->namespaces))
-        {
-            axiom_namespace_free(default_ns, env);
-            return NULL;
-        }
+        axiom_namespace_free(default_ns, env);
+        return NULL;
     }
-
-    axutil_hash_set(om_element->namespaces, "", AXIS2_HASH_KEY_STRING, default_ns);
     axiom_namespace_increment_ref(default_ns, env);
     return default_ns;
 }
@@ -1836,15 +2163,15 @@ axiom_element_remove_attribute(
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
     AXIS2_PARAM_CHECK(env->error, om_attribute, AXIS2_FAILURE);
 
+    axiom_element_make_raw_attributes(om_element, env);
     qname = axiom_attribute_get_qname(om_attribute, env);
-    if (qname && (om_element->attributes))
+    if (qname && !AXIOM_ELEMENT_MAP_IS_EMPTY(&om_element->attributes))
     {
         axis2_char_t *name = NULL;
         name = axutil_qname_to_string(qname, env);
         if (name)
         {
-            axutil_hash_set(om_element->attributes, name, AXIS2_HASH_KEY_STRING, NULL);
-            return AXIS2_SUCCESS;
+            return axiom_element_map_set(&om_element->attributes, env, name, NULL);
         }
     }
     return AXIS2_FAILURE;
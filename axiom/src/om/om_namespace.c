@@ -58,7 +58,7 @@ axiom_namespace_create(
     om_namespace->uri = NULL;
     om_namespace->key = NULL;
 
-    om_namespace->uri = axutil_string_create(env, uri);
+    om_namespace->uri = axutil_string_intern(env, uri);
     if(!om_namespace->uri)
     {
         AXIS2_FREE(env->allocator, om_namespace);
@@ -68,7 +68,7 @@ axiom_namespace_create(
 
     if(prefix)
     {
-        om_namespace->prefix = axutil_string_create(env, prefix);
+        om_namespace->prefix = axutil_string_intern(env, prefix);
         if(!om_namespace->prefix)
         {
             AXIS2_FREE(env->allocator, om_namespace);
@@ -111,6 +111,30 @@ axiom_namespace_free(
     AXIS2_FREE(env->allocator, om_namespace);
 }
 
+/* Compares the URIs or the prefixes of two namespaces. Atoms are equal
+ * only if they are the same, so most comparisons need not look at the
+ * characters */
+static int
+axiom_namespace_strings_differ(
+    axutil_string_t * str1,
+    axutil_string_t * str2,
+    const axutil_env_t * env)
+{
+    if(str1 == str2)
+    {
+        return 0;
+    }
+    if(!str1 || !str2)
+    {
+        return 1;
+    }
+    if(axutil_string_is_interned(str1, env) && axutil_string_is_interned(str2, env))
+    {
+        return 1;
+    }
+    return axutil_strcmp(axutil_string_get_buffer(str1, env), axutil_string_get_buffer(str2, env));
+}
+
 AXIS2_EXTERN axis2_bool_t AXIS2_CALL
 axiom_namespace_equals(
     axiom_namespace_t * om_namespace,
@@ -129,25 +153,9 @@ axiom_namespace_equals(
         return AXIS2_FALSE;
     }
 
-    if(om_namespace->uri && om_namespace1->uri)
-    {
-        uris_differ = axutil_strcmp(axutil_string_get_buffer(om_namespace->uri, env),
-            axutil_string_get_buffer(om_namespace1->uri, env));
-    }
-    else
-    {
-        uris_differ = (om_namespace->uri || om_namespace1->uri);
-    }
-
-    if(om_namespace->prefix && om_namespace1->prefix)
-    {
-        prefixes_differ = axutil_strcmp(axutil_string_get_buffer(om_namespace->prefix, env),
-            axutil_string_get_buffer(om_namespace1->prefix, env));
-    }
-    else
-    {
-        prefixes_differ = (om_namespace->prefix || om_namespace1->prefix);
-    }
+    uris_differ = axiom_namespace_strings_differ(om_namespace->uri, om_namespace1->uri, env);
+    prefixes_differ = axiom_namespace_strings_differ(om_namespace->prefix, om_namespace1->prefix,
+        env);
 
     return (!uris_differ && !prefixes_differ);
 }
@@ -271,7 +279,7 @@ axiom_namespace_set_uri(
         om_namespace->uri = NULL;
     }
 
-    om_namespace->uri = axutil_string_create(env, uri);
+    om_namespace->uri = axutil_string_intern(env, uri);
     if(!(om_namespace->uri))
     {
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
@@ -300,7 +308,7 @@ axiom_namespace_create_str(
 
     if(!uri)
     {
-        uri = axutil_string_create(env, "");
+        uri = axutil_string_intern(env, "");
     }
 
     om_namespace = (axiom_namespace_t *)AXIS2_MALLOC(env->allocator, sizeof(axiom_namespace_t));
@@ -18,6 +18,7 @@
 #include "axiom_node_internal.h"
 #include "axiom_element_internal.h"
 #include "axiom_stax_builder_internal.h"
+#include "axiom_document_internal.h"
 #include <axiom_text.h>
 #include <axiom_data_source.h>
 #include <axiom_comment.h>
@@ -58,8 +59,35 @@ struct axiom_node
     /** instances of an om struct, whose type is defined by node type */
     void *data_element;
 
+    /** arena of the document the node and its data element were built in, NULL if they were
+     * allocated on their own */
+    axiom_document_arena_t *arena;
+
 };
 
+/* The topmost node of each part of the tree that lives in an arena holds a reference to the
+ * arena, so that a node detached from an arena-backed tree keeps the arena alive */
+#define AXIOM_NODE_IS_ARENA_TOP(node) \
+    ((node)->arena && (!(node)->parent || (node)->parent->arena != (node)->arena))
+
+static void
+axiom_node_link_parent(
+    axiom_node_t * om_node,
+    axiom_node_t * parent)
+{
+    axis2_bool_t was_top = AXIOM_NODE_IS_ARENA_TOP(om_node);
+
+    om_node->parent = parent;
+    if(was_top && !AXIOM_NODE_IS_ARENA_TOP(om_node))
+    {
+        axiom_document_arena_release(om_node->arena);
+    }
+    else if(!was_top && AXIOM_NODE_IS_ARENA_TOP(om_node))
+    {
+        axiom_document_arena_retain(om_node->arena);
+    }
+}
+
 AXIS2_EXTERN axiom_node_t *AXIS2_CALL
 axiom_node_create(
     const axutil_env_t * env)
@@ -83,6 +111,7 @@ axiom_node_create(
     node->data_element = NULL;
     node->builder = NULL;
     node->own_builder = AXIS2_FALSE;
+    node->arena = NULL;
     return node;
 }
 
@@ -136,6 +165,8 @@ axiom_node_free_detached_subtree(
     axiom_node_t * om_node,
     const axutil_env_t * env)
 {
+    axiom_document_arena_t *arena = om_node->arena;
+
     /* Free any child nodes first */
     if(om_node->first_child)
     {
@@ -148,7 +179,17 @@ axiom_node_free_detached_subtree(
         }
     }
 
-    if(om_node->node_type == AXIOM_ELEMENT)
+    if(arena)
+    {
+        /* the data element is released with the arena, except for the results the element
+         * keeps, which may come from any allocator */
+        if(om_node->node_type == AXIOM_ELEMENT && om_node->data_element)
+        {
+            axiom_element_free_results((axiom_element_t *)(om_node->data_element),
+                axiom_document_arena_get_env(arena));
+        }
+    }
+    else if(om_node->node_type == AXIOM_ELEMENT)
     {
         if(om_node->data_element)
         {
@@ -195,7 +236,17 @@ axiom_node_free_detached_subtree(
         axiom_stax_builder_free_internal(om_node->builder, env);
     }
 
-    AXIS2_FREE(env->allocator, om_node);
+    if(arena)
+    {
+        if(AXIOM_NODE_IS_ARENA_TOP(om_node))
+        {
+            axiom_document_arena_release(arena);
+        }
+    }
+    else
+    {
+        AXIS2_FREE(env->allocator, om_node);
+    }
 }
 
 /**
@@ -245,7 +296,7 @@ axiom_node_add_child(
         child->prev_sibling = last_sib;
     }
 
-    child->parent = om_node;
+    axiom_node_link_parent(child, om_node);
     om_node->last_child = child;
     return AXIS2_SUCCESS;
 }
@@ -318,7 +369,7 @@ axiom_node_detach_without_namespaces(
     if(!om_node->own_builder)
         om_node->builder = NULL;
 
-    om_node->parent = NULL;
+    axiom_node_link_parent(om_node, NULL);
     om_node->prev_sibling = NULL;
     om_node->next_sibling = NULL;
     return om_node;
@@ -355,10 +406,12 @@ axiom_node_detach(
     om_node = axiom_node_detach_without_namespaces(om_node, env);
 
     /* If this is an element node, ensure that any namespaces available to it or its
-     children remain available after the detach. */
+     children remain available after the detach. The namespaces are declared in the arena
+     of the node, if it has one. */
     if(om_node && namespaces)
     {
-        axiom_element_redeclare_parent_namespaces(om_element, env, om_node, namespaces);
+        axiom_element_redeclare_parent_namespaces(om_element, om_node->arena ?
+            axiom_document_arena_get_env(om_node->arena) : env, om_node, namespaces);
     }
 
     if(namespaces)
@@ -392,7 +445,7 @@ axiom_node_set_parent(
         om_node = axiom_node_detach(om_node, env);
     }
 
-    om_node->parent = parent;
+    axiom_node_link_parent(om_node, parent);
 
     return AXIS2_SUCCESS;
 }
@@ -422,7 +475,7 @@ axiom_node_insert_sibling_after(
         return AXIS2_FAILURE;
     }
 
-    node_to_insert->parent = om_node->parent;
+    axiom_node_link_parent(node_to_insert, om_node->parent);
 
     node_to_insert->prev_sibling = om_node;
 
@@ -457,7 +510,7 @@ axiom_node_insert_sibling_before(
         return AXIS2_FAILURE;
     }
 
-    node_to_insert->parent = om_node->parent;
+    axiom_node_link_parent(node_to_insert, om_node->parent);
 
     node_to_insert->prev_sibling = om_node->prev_sibling;
 
@@ -1323,6 +1376,19 @@ axiom_node_set_builder(
     om_node->builder = builder;
 }
 
+void AXIS2_CALL
+axiom_node_set_arena(
+    axiom_node_t * om_node,
+    const axutil_env_t * env,
+    axiom_document_arena_t * arena)
+{
+    om_node->arena = arena;
+    if(AXIOM_NODE_IS_ARENA_TOP(om_node))
+    {
+        axiom_document_arena_retain(arena);
+    }
+}
+
 void AXIS2_CALL
 axiom_node_assume_builder_ownership(
     axiom_node_t *om_node,
@@ -1448,7 +1514,7 @@ axiom_node_add_sibling(
 	AXIS2_PARAM_CHECK(env->error, nodeElemSibling, NULL);
 
 	axiom_node_t *next_sib = NULL;
-	nodeElemSibling->parent = nodeElem->parent;
+	axiom_node_link_parent(nodeElemSibling, nodeElem->parent);
 	nodeElemSibling->prev_sibling = nodeElem;
 	next_sib = nodeElem->next_sibling;
 	if (next_sib)
@@ -324,10 +324,8 @@ axiom_output_get_next_content_id(
     axiom_output_t * om_output,
     const axutil_env_t * env)
 {
-    axis2_char_t *uuid = NULL;
-    axis2_char_t *temp_str = NULL;
-    axis2_char_t *temp_str1 = NULL;
-    axis2_char_t id[256];
+    axis2_char_t uuid[AXUTIL_UUID_STRING_SIZE];
+    axis2_char_t id[64 + AXUTIL_UUID_STRING_SIZE];
     om_output->next_id++;
 
     /** free existing id */
@@ -337,32 +335,13 @@ axiom_output_get_next_content_id(
         om_output->next_content_id = NULL;
     }
 
-    uuid = axutil_uuid_gen(env);
-    if(!uuid)
+    if(!axutil_uuid_gen_into(uuid))
     {
         return NULL;
     }
 
-    sprintf(id, "%d", om_output->next_id);
-
-    temp_str = axutil_stracat(env, id, ".");
-    temp_str1 = axutil_stracat(env, temp_str, uuid);
-    om_output->next_content_id = axutil_stracat(env, temp_str1, "@apache.org");
-    if(temp_str)
-    {
-        AXIS2_FREE(env->allocator, temp_str);
-        temp_str = NULL;
-    }
-    if(temp_str1)
-    {
-        AXIS2_FREE(env->allocator, temp_str1);
-        temp_str1 = NULL;
-    }
-    if(uuid)
-    {
-        AXIS2_FREE(env->allocator, uuid);
-        uuid = NULL;
-    }
+    sprintf(id, "%d.%s@apache.org", om_output->next_id, uuid);
+    om_output->next_content_id = axutil_strdup(env, id);
     return om_output->next_content_id;
 }
 
@@ -371,27 +350,13 @@ axiom_output_get_root_content_id(
     axiom_output_t * om_output,
     const axutil_env_t * env)
 {
-    axis2_char_t *temp_str = NULL;
-    axis2_char_t *uuid = NULL;
+    axis2_char_t id[16 + AXUTIL_UUID_STRING_SIZE];
+    axis2_char_t uuid[AXUTIL_UUID_STRING_SIZE];
 
-    if(!om_output->root_content_id)
+    if(!om_output->root_content_id && axutil_uuid_gen_into(uuid))
     {
-        uuid = axutil_uuid_gen(env);
-
-        temp_str = axutil_stracat(env, "0.", uuid);
-
-        om_output->root_content_id = axutil_stracat(env, temp_str, "@apache.org");
-
-        if(temp_str)
-        {
-            AXIS2_FREE(env->allocator, temp_str);
-            temp_str = NULL;
-        }
-        if(uuid)
-        {
-            AXIS2_FREE(env->allocator, uuid);
-            uuid = NULL;
-        }
+        sprintf(id, "0.%s@apache.org", uuid);
+        om_output->root_content_id = axutil_strdup(env, id);
     }
 
     return om_output->root_content_id;
@@ -402,17 +367,10 @@ axiom_output_get_mime_boundry(
     axiom_output_t * om_output,
     const axutil_env_t * env)
 {
-    axis2_char_t *uuid = NULL;
-    if(!om_output->mime_boundary)
+    axis2_char_t uuid[AXUTIL_UUID_STRING_SIZE];
+    if(!om_output->mime_boundary && axutil_uuid_gen_into(uuid))
     {
-        uuid = axutil_uuid_gen(env);
-
         om_output->mime_boundary = axutil_stracat(env, "MIMEBoundary", uuid);
-        if(uuid)
-        {
-            AXIS2_FREE(env->allocator, uuid);
-            uuid = NULL;
-        }
     }
     return om_output->mime_boundary;
 }
@@ -112,6 +112,41 @@ axiom_stax_builder_create(
     return om_builder;
 }
 
+AXIS2_EXTERN axiom_stax_builder_t *AXIS2_CALL
+axiom_stax_builder_create_with_arena(
+    const axutil_env_t * env,
+    axiom_xml_reader_t * parser,
+    size_t chunk_size)
+{
+    axiom_stax_builder_t *om_builder = NULL;
+
+    om_builder = axiom_stax_builder_create(env, parser);
+    if(!om_builder)
+    {
+        return NULL;
+    }
+
+    if(axiom_document_create_arena(om_builder->document, env, chunk_size) != AXIS2_SUCCESS)
+    {
+        /* the parser is not freed, as the caller still owns it */
+        axutil_hash_free(om_builder->declared_namespaces, env);
+        axiom_document_free(om_builder->document, env);
+        AXIS2_FREE(env->allocator, om_builder);
+        return NULL;
+    }
+    return om_builder;
+}
+
+/* Gets the env the objects of the tree are created with, which allocates from the arena of the
+ * document if it has one. Memory of the reader is still handled with env. */
+static const axutil_env_t *
+axiom_stax_builder_get_tree_env(
+    axiom_stax_builder_t * om_builder,
+    const axutil_env_t * env)
+{
+    return axiom_document_get_env(om_builder->document, env);
+}
+
 /**
  * Free the build struct instance and its associated document,axiom tree.
  * @param builder pointer to builder struct
@@ -181,6 +216,11 @@ axiom_stax_builder_get_document(
     return om_builder->document;
 }
 
+/*
+ * The attributes are kept in the element as they are read, and made into axiom_attribute_t
+ * only if they are asked for. Their namespaces are looked up now, while the namespaces in
+ * scope at the element are those of the document it was read from.
+ */
 static axis2_status_t
 axiom_stax_builder_process_attributes(
     axiom_stax_builder_t * om_builder,
@@ -189,71 +229,96 @@ axiom_stax_builder_process_attributes(
 {
     int i = 0;
     int attribute_count;
+    size_t size = 0;
     axiom_element_t *om_ele = NULL;
+    const axutil_env_t *tree_env = axiom_stax_builder_get_tree_env(om_builder, env);
 
-    om_ele = (axiom_element_t *)axiom_node_get_data_element(element_node, env);
     attribute_count = axiom_xml_reader_get_attribute_count(om_builder->parser, env);
+    if(attribute_count <= 0)
+        return AXIS2_SUCCESS;
+
+    for(i = 1; i <= attribute_count; ++i)
+    {
+        unsigned int len = 0;
+
+        if(axiom_xml_reader_get_attribute_name_view_by_number(om_builder->parser, env, i, &len))
+            size += len;
+        if(axiom_xml_reader_get_attribute_value_view_by_number(om_builder->parser, env, i, &len))
+            size += len;
+    }
+
+    om_ele = (axiom_element_t *)axiom_node_get_data_element(element_node, env);
+    if(axiom_element_create_raw_attributes(om_ele, tree_env, attribute_count, size,
+        axiom_document_get_arena(om_builder->document) ? tree_env : NULL) != AXIS2_SUCCESS)
+    {
+        return AXIS2_FAILURE;
+    }
+
     for(i = 1; i <= attribute_count; ++i)
     {
         axiom_namespace_t *ns = NULL;
-        axis2_char_t *uri = NULL;
-        axis2_char_t *prefix = NULL;
-        axis2_char_t *attr_name = NULL;
-        axis2_char_t *attr_value = NULL;
-
-        uri = axiom_xml_reader_get_attribute_namespace_by_number(om_builder-> parser, env, i);
-        prefix = axiom_xml_reader_get_attribute_prefix_by_number(om_builder->parser, env, i);
-        if(uri && (axutil_strcmp(uri, "") != 0))
+        const axis2_char_t *uri = NULL;
+        const axis2_char_t *prefix = NULL;
+        const axis2_char_t *attr_name = NULL;
+        const axis2_char_t *attr_value = NULL;
+        unsigned int len = 0;
+
+        /* the reader's views are taken as strings one at a time, as a view may not outlive
+         * the next one */
+        uri = axiom_xml_reader_get_attribute_namespace_view_by_number(om_builder->parser, env, i,
+            &len);
+        if(uri && len > 0)
         {
-            ns = axiom_element_find_namespace(om_ele, env, element_node, uri, prefix);
-            if(!ns)
+            axutil_string_t *uri_str = NULL;
+            axutil_string_t *prefix_str = NULL;
+
+            uri_str = axutil_string_intern_len(tree_env, uri, len);
+            prefix = axiom_xml_reader_get_attribute_prefix_view_by_number(om_builder->parser, env,
+                i, &len);
+            prefix_str = prefix ? axutil_string_intern_len(tree_env, prefix, len) : NULL;
+            if(uri_str && (!prefix || prefix_str))
             {
-                /* if namespace is not defined yet, create it */
-                ns = axiom_namespace_create(env, uri, prefix);
+                ns = axiom_element_find_namespace(om_ele, env, element_node,
+                    axutil_string_get_buffer(uri_str, env),
+                    prefix_str ? axutil_string_get_buffer(prefix_str, env) : NULL);
+                if(!ns)
+                {
+                    /* if namespace is not defined yet, such as that of the xml prefix, it is
+                     * declared in the element */
+                    ns = axiom_namespace_create(tree_env, axutil_string_get_buffer(uri_str, env),
+                        prefix_str ? axutil_string_get_buffer(prefix_str, env) : NULL);
+                    if(ns)
+                    {
+                        axis2_status_t status;
+                        status = axiom_element_declare_namespace(om_ele, tree_env, element_node,
+                            ns);
+                        /* the element holds it from now on */
+                        axiom_namespace_free(ns, tree_env);
+                        if(status != AXIS2_SUCCESS)
+                            ns = NULL;
+                    }
+                }
             }
+            axutil_string_free(uri_str, tree_env);
+            axutil_string_free(prefix_str, tree_env);
         }
-        if(uri)
-        {
-            axiom_xml_reader_xml_free(om_builder->parser, env, uri);
-        }
-        if(prefix)
+
+        attr_name = axiom_xml_reader_get_attribute_name_view_by_number(om_builder->parser, env, i,
+            &len);
+        if(!attr_name)
+            continue;
+        if(axiom_element_add_raw_attribute(om_ele, tree_env, attr_name, len, ns) != AXIS2_SUCCESS)
         {
-            axiom_xml_reader_xml_free(om_builder->parser, env, prefix);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot add attribute to element");
+            return AXIS2_FAILURE;
         }
-
-        attr_name = axiom_xml_reader_get_attribute_name_by_number(om_builder->parser, env, i);
-        attr_value = axiom_xml_reader_get_attribute_value_by_number(om_builder->parser, env, i);
-
-        if(attr_name)
+        attr_value = axiom_xml_reader_get_attribute_value_view_by_number(om_builder->parser,
+            env, i, &len);
+        if(attr_value && axiom_element_set_raw_attribute_value(om_ele, tree_env, attr_value, len)
+            != AXIS2_SUCCESS)
         {
-            axutil_string_t *attr_name_str = NULL;
-            axutil_string_t *attr_value_str = NULL;
-            axiom_attribute_t *attribute = NULL;
-
-#ifdef AXIS2_LIBXML2_ENABLED
-            attr_name_str = axutil_string_create(env, attr_name);
-            attr_value_str = axutil_string_create(env, attr_value);
-            axiom_xml_reader_xml_free(om_builder->parser, env, attr_name);
-            axiom_xml_reader_xml_free(om_builder->parser, env, attr_value);
-#else
-            attr_name_str = axutil_string_create_assume_ownership(env, &attr_name);
-            attr_value_str = axutil_string_create_assume_ownership(env, &attr_value);
-#endif
-
-            attribute = axiom_attribute_create_str(env, attr_name_str, attr_value_str, ns);
-            axutil_string_free(attr_name_str, env);
-            axutil_string_free(attr_value_str, env);
-
-            if(!attribute)
-            {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot create attribute");
-                return AXIS2_FAILURE;
-            }
-            if(axiom_element_add_attribute(om_ele, env, attribute, element_node) != AXIS2_SUCCESS)
-            {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot add attribute to element");
-                return AXIS2_FAILURE;
-            }
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot add attribute to element");
+            return AXIS2_FAILURE;
         }
     }
     return AXIS2_SUCCESS;
@@ -264,10 +329,12 @@ axiom_stax_builder_create_om_text(
     axiom_stax_builder_t * om_builder,
     const axutil_env_t * env)
 {
-    axis2_char_t *temp_value = NULL;
+    const axis2_char_t *temp_value = NULL;
+    unsigned int temp_value_len = 0;
     axutil_string_t *temp_value_str = NULL;
     axiom_node_t *node = NULL;
     axiom_node_t *parent = om_builder->lastnode;
+    const axutil_env_t *tree_env = axiom_stax_builder_get_tree_env(om_builder, env);
 
     if(!parent)
     {
@@ -276,7 +343,7 @@ axiom_stax_builder_create_om_text(
         return NULL;
     }
 
-    temp_value = axiom_xml_reader_get_value(om_builder->parser, env);
+    temp_value = axiom_xml_reader_get_value_view(om_builder->parser, env, &temp_value_len);
     if(!temp_value)
     {
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_XML_READER_VALUE_NULL, AXIS2_FAILURE);
@@ -284,12 +351,7 @@ axiom_stax_builder_create_om_text(
         return NULL;
     }
 
-#ifdef AXIS2_LIBXML2_ENABLED
-    temp_value_str = axutil_string_create(env, temp_value);
-    axiom_xml_reader_xml_free(om_builder->parser, env, temp_value);
-#else
-    temp_value_str = axutil_string_create_assume_ownership(env, &temp_value);
-#endif
+    temp_value_str = axutil_string_create_len(tree_env, temp_value, temp_value_len);
 
     if(!temp_value_str)
     {
@@ -303,8 +365,8 @@ axiom_stax_builder_create_om_text(
         parent = axiom_node_get_parent(om_builder->lastnode, env);
     }
 
-    axiom_text_create_str(env, parent, temp_value_str, &node);
-    axutil_string_free(temp_value_str, env);
+    axiom_text_create_str(tree_env, parent, temp_value_str, &node);
+    axutil_string_free(temp_value_str, tree_env);
 
     if(!node)
     {
@@ -312,6 +374,7 @@ axiom_stax_builder_create_om_text(
         return NULL;
     }
     axiom_node_set_builder(node, env, om_builder);
+    axiom_node_set_arena(node, env, axiom_document_get_arena(om_builder->document));
     axiom_node_set_complete(node, env, AXIS2_TRUE);
     om_builder->lastnode = node;
     return node;
@@ -330,11 +393,13 @@ axiom_stax_builder_process_namespaces(
     axiom_element_t *om_ele = NULL;
 
     /* temp values */
-    axis2_char_t *tmp_prefix = NULL;
-    axis2_char_t *tmp_ns_prefix = NULL;
-    axis2_char_t *tmp_ns_uri = NULL;
+    const axis2_char_t *tmp_prefix = NULL;
+    const axis2_char_t *tmp_ns_prefix = NULL;
+    const axis2_char_t *tmp_ns_uri = NULL;
+    unsigned int tmp_len = 0;
     axutil_string_t *tmp_ns_prefix_str = NULL;
     axutil_string_t *tmp_ns_uri_str = NULL;
+    const axutil_env_t *tree_env = axiom_stax_builder_get_tree_env(om_builder, env);
 
     int i = 0;
     om_ele = (axiom_element_t *)axiom_node_get_data_element(node, env);
@@ -342,38 +407,29 @@ axiom_stax_builder_process_namespaces(
     namespace_count = axiom_xml_reader_get_namespace_count(om_builder->parser, env);
     for(i = 1; i <= namespace_count; ++i)
     {
-        tmp_ns_prefix = axiom_xml_reader_get_namespace_prefix_by_number(om_builder->parser, env, i);
-        tmp_ns_uri = axiom_xml_reader_get_namespace_uri_by_number(om_builder->parser, env, i);
-
-#ifdef AXIS2_LIBXML2_ENABLED
-        tmp_ns_prefix_str = axutil_string_create(env, tmp_ns_prefix);
-        tmp_ns_uri_str = axutil_string_create(env, tmp_ns_uri);
-#else
-        tmp_ns_prefix_str = axutil_string_create_assume_ownership(env, &tmp_ns_prefix);
-        tmp_ns_uri_str = axutil_string_create_assume_ownership(env, &tmp_ns_uri);
-#endif
-
-        if(!tmp_ns_prefix || axutil_strcmp(tmp_ns_prefix, "xmlns") == 0)
+        tmp_ns_uri = axiom_xml_reader_get_namespace_uri_view_by_number(om_builder->parser, env, i,
+            &tmp_len);
+        tmp_ns_uri_str = axutil_string_intern_len(tree_env, tmp_ns_uri ? tmp_ns_uri : "",
+            tmp_ns_uri ? tmp_len : 0);
+        tmp_ns_prefix = axiom_xml_reader_get_namespace_prefix_view_by_number(om_builder->parser,
+            env, i, &tmp_len);
+
+        if(!tmp_ns_prefix || (tmp_len == 5 && !memcmp(tmp_ns_prefix, "xmlns", 5)))
         {
             /* default namespace case. !temp_ns_prefix is for guththila */
 
-            if(tmp_ns_prefix_str)
-            {
-                axutil_string_free(tmp_ns_prefix_str, env);
-            }
-
-            tmp_ns_prefix_str = axutil_string_create(env, "");
-            om_ns = axiom_namespace_create_str(env, tmp_ns_uri_str, tmp_ns_prefix_str);
+            tmp_ns_prefix_str = axutil_string_intern(tree_env, "");
+            om_ns = axiom_namespace_create_str(tree_env, tmp_ns_uri_str, tmp_ns_prefix_str);
             if(!om_ns)
             {
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot create namespace");
                 return AXIS2_FAILURE;
             }
 
-            status = axiom_element_declare_namespace(om_ele, env, node, om_ns);
+            status = axiom_element_declare_namespace(om_ele, tree_env, node, om_ns);
             if(!status)
             {
-                axiom_namespace_free(om_ns, env);
+                axiom_namespace_free(om_ns, tree_env);
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error when declaring namespace");
                 return AXIS2_FAILURE;
             }
@@ -381,35 +437,32 @@ axiom_stax_builder_process_namespaces(
         else
         {
             axis2_char_t *prefix = NULL;
-            om_ns = axiom_namespace_create_str(env, tmp_ns_uri_str, tmp_ns_prefix_str);
+            tmp_ns_prefix_str = axutil_string_intern_len(tree_env, tmp_ns_prefix, tmp_len);
+            om_ns = axiom_namespace_create_str(tree_env, tmp_ns_uri_str, tmp_ns_prefix_str);
             if(!om_ns)
             {
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot create namespace");
                 return AXIS2_FAILURE;
             }
 
-            status = axiom_element_declare_namespace(om_ele, env, node, om_ns);
+            status = axiom_element_declare_namespace(om_ele, tree_env, node, om_ns);
             prefix = axiom_namespace_get_prefix(om_ns, env);
             axutil_hash_set(om_builder->declared_namespaces, prefix, AXIS2_HASH_KEY_STRING, om_ns);
         }
 
-        axutil_string_free(tmp_ns_uri_str, env);
-        axutil_string_free(tmp_ns_prefix_str, env);
-#ifdef AXIS2_LIBXML2_ENABLED
-        axiom_xml_reader_xml_free(om_builder->parser, env, tmp_ns_uri);
-        axiom_xml_reader_xml_free(om_builder->parser, env, tmp_ns_prefix);
-#endif
+        axutil_string_free(tmp_ns_uri_str, tree_env);
+        axutil_string_free(tmp_ns_prefix_str, tree_env);
     }
 
     /* set own namespace */
-    tmp_prefix = axiom_xml_reader_get_prefix(om_builder->parser, env);
+    tmp_prefix = axiom_xml_reader_get_prefix_view(om_builder->parser, env, &tmp_len);
     if(tmp_prefix)
     {
-        om_ns = axutil_hash_get(om_builder->declared_namespaces, tmp_prefix, AXIS2_HASH_KEY_STRING);
+        om_ns = axutil_hash_get(om_builder->declared_namespaces, tmp_prefix, tmp_len);
 
         if(om_ns)
         {
-            axiom_element_set_namespace(om_ele, env, om_ns, node);
+            axiom_element_set_namespace(om_ele, tree_env, om_ns, node);
         }
         else
         {
@@ -418,8 +471,6 @@ axiom_stax_builder_process_namespaces(
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error when setting namespace");
             return AXIS2_FAILURE;
         }
-
-        axiom_xml_reader_xml_free(om_builder->parser, env, tmp_prefix);
     }
 
     return status;
@@ -433,11 +484,18 @@ axiom_stax_builder_create_om_element(
 {
     axiom_node_t *element_node = NULL;
     axiom_element_t *om_ele = NULL;
-    axis2_char_t *temp_localname = NULL;
+    const axis2_char_t *temp_localname = NULL;
+    unsigned int temp_localname_len = 0;
+    axutil_string_t *localname_str = NULL;
     axiom_node_t *parent = NULL;
+    const axutil_env_t *tree_env = axiom_stax_builder_get_tree_env(om_builder, env);
 
-    temp_localname = axiom_xml_reader_get_name(om_builder->parser, env);
-    if(!temp_localname)
+    temp_localname = axiom_xml_reader_get_name_view(om_builder->parser, env, &temp_localname_len);
+    if(temp_localname)
+    {
+        localname_str = axutil_string_intern_len(tree_env, temp_localname, temp_localname_len);
+    }
+    if(!localname_str)
     {
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_XML_READER_ELEMENT_NULL, AXIS2_FAILURE);
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot find name of the element");
@@ -459,14 +517,15 @@ axiom_stax_builder_create_om_element(
         }
     }
 
-    om_ele = axiom_element_create(env, parent, temp_localname, NULL, &element_node);
-    axiom_xml_reader_xml_free(om_builder->parser, env, temp_localname);
+    om_ele = axiom_element_create_str(tree_env, parent, localname_str, NULL, &element_node);
+    axutil_string_free(localname_str, tree_env);
     if((!om_ele) || (!element_node))
     {
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Cannot create axiom element");
         return NULL;
     }
     axiom_node_set_builder(element_node, env, om_builder);
+    axiom_node_set_arena(element_node, env, axiom_document_get_arena(om_builder->document));
     axiom_element_set_is_empty(om_ele, env, is_empty);
 
     if(!om_builder->lastnode)
@@ -512,7 +571,8 @@ axiom_stax_builder_create_om_comment(
         parent = om_builder->lastnode;
     }
 
-    axiom_comment_create(env, parent, comment_value, &comment_node);
+    axiom_comment_create(axiom_stax_builder_get_tree_env(om_builder, env), parent, comment_value,
+        &comment_node);
     axiom_xml_reader_xml_free(om_builder->parser,env,comment_value);
     if(!comment_node)
     {
@@ -521,6 +581,7 @@ axiom_stax_builder_create_om_comment(
     }
 
     axiom_node_set_builder(comment_node, env, om_builder);
+    axiom_node_set_arena(comment_node, env, axiom_document_get_arena(om_builder->document));
     om_builder->element_level++;
     om_builder->lastnode = comment_node;
 
@@ -554,19 +615,21 @@ axiom_stax_builder_create_om_processing_instruction(
     else if(axiom_node_is_complete(om_builder->lastnode, env)
         || (axiom_node_get_node_type(om_builder->lastnode, env) == AXIOM_TEXT))
     {
-        axiom_processing_instruction_create(env, axiom_node_get_parent(om_builder-> lastnode, env),
-            target, value, &pi_node);
+        axiom_processing_instruction_create(axiom_stax_builder_get_tree_env(om_builder, env),
+            axiom_node_get_parent(om_builder-> lastnode, env), target, value, &pi_node);
 
         axiom_node_set_next_sibling(om_builder->lastnode, env, pi_node);
         axiom_node_set_previous_sibling(pi_node, env, om_builder->lastnode);
     }
     else
     {
-        axiom_processing_instruction_create(env, om_builder->lastnode, target, value, &pi_node);
+        axiom_processing_instruction_create(axiom_stax_builder_get_tree_env(om_builder, env),
+            om_builder->lastnode, target, value, &pi_node);
         axiom_node_set_first_child(om_builder->lastnode, env, pi_node);
         axiom_node_set_parent(pi_node, env, om_builder->lastnode);
     }
     axiom_node_set_builder(pi_node, env, om_builder);
+    axiom_node_set_arena(pi_node, env, axiom_document_get_arena(om_builder->document));
     om_builder->element_level++;
 
     if(target)
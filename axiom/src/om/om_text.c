@@ -165,6 +165,54 @@ axiom_text_free(
     return;
 }
 
+static axis2_status_t AXIS2_CALL
+axiom_text_write_base64(
+    void *xml_writer,
+    const axutil_env_t * env,
+    const axis2_char_t * text,
+    int len)
+{
+    return axiom_xml_writer_write_characters((axiom_xml_writer_t *)xml_writer, env,
+        (axis2_char_t *)text);
+}
+
+/* Writes binary content inline, encoding it piece by piece straight into
+ * the writer rather than into one large string */
+static axis2_status_t
+axiom_text_serialize_base64(
+    axiom_text_t * om_text,
+    const axutil_env_t * env,
+    axiom_xml_writer_t * xml_writer)
+{
+    axis2_char_t *data = NULL;
+    size_t data_size = 0;
+    axutil_base64_encoder_t *encoder = NULL;
+    axis2_status_t status = AXIS2_SUCCESS;
+
+    if(!om_text->data_handler)
+    {
+        return AXIS2_SUCCESS;
+    }
+    axiom_data_handler_read_from(om_text->data_handler, env, &data, &data_size);
+    if(!data)
+    {
+        return AXIS2_SUCCESS;
+    }
+
+    encoder = axutil_base64_encoder_create(env, axiom_text_write_base64, xml_writer);
+    if(!encoder)
+    {
+        return AXIS2_FAILURE;
+    }
+    status = axutil_base64_encoder_update(encoder, env, (unsigned char *)data, (int)data_size);
+    if(status == AXIS2_SUCCESS)
+    {
+        status = axutil_base64_encoder_finish(encoder, env);
+    }
+    axutil_base64_encoder_free(encoder, env);
+    return status;
+}
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axiom_text_serialize(
     axiom_text_t * om_text,
@@ -173,7 +221,6 @@ axiom_text_serialize(
 {
     int status = AXIS2_SUCCESS;
     axis2_char_t *attribute_value = NULL;
-    const axis2_char_t *text = NULL;
     axiom_xml_writer_t *om_output_xml_writer = NULL;
 
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
@@ -230,8 +277,7 @@ axiom_text_serialize(
         }
         else
         {
-            text = axiom_text_get_text(om_text, env);
-            axiom_xml_writer_write_characters(om_output_xml_writer, env, (axis2_char_t *)text);
+            status = axiom_text_serialize_base64(om_text, env, om_output_xml_writer);
         }
     }
     return status;
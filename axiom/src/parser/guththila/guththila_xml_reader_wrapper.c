@@ -140,6 +140,80 @@ guththila_xml_reader_wrapper_get_current_buffer(
     axiom_xml_reader_t * parser,
     const axutil_env_t * env);
 
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_name_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_prefix_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_value_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_name_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_value_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_namespace_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_namespace_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_namespace_uri_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+axis2_status_t AXIS2_CALL
+guththila_xml_reader_wrapper_set_streaming(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    axis2_bool_t streaming);
+
+axis2_status_t AXIS2_CALL
+guththila_xml_reader_wrapper_feed(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    const axis2_char_t * data,
+    size_t len,
+    axis2_bool_t is_last);
+
 /*********** guththila_xml_reader_wrapper_impl_t wrapper struct   *******************/
 
 typedef struct guththila_xml_reader_wrapper_impl
@@ -172,6 +246,7 @@ guththila_xml_reader_wrapper_init_map(
     parser->event_map[GUTHTHILA_CHARACTER] = AXIOM_XML_READER_CHARACTER;
     parser->event_map[GUTHTHILA_ENTITY_REFERANCE] = AXIOM_XML_READER_ENTITY_REFERENCE;
     parser->event_map[GUTHTHILA_COMMENT] = AXIOM_XML_READER_COMMENT;
+    parser->event_map[GUTHTHILA_NEED_MORE_INPUT] = AXIOM_XML_READER_NEED_MORE_INPUT;
 }
 
 static const axiom_xml_reader_ops_t axiom_xml_reader_ops_var = {
@@ -196,7 +271,18 @@ static const axiom_xml_reader_ops_t axiom_xml_reader_ops_var = {
     guththila_xml_reader_wrapper_get_namespace_uri,
     guththila_xml_reader_wrapper_get_namespace_uri_by_prefix,
     guththila_xml_reader_wrapper_get_context,
-    guththila_xml_reader_wrapper_get_current_buffer};
+    guththila_xml_reader_wrapper_get_current_buffer,
+    guththila_xml_reader_wrapper_get_name_view,
+    guththila_xml_reader_wrapper_get_prefix_view,
+    guththila_xml_reader_wrapper_get_value_view,
+    guththila_xml_reader_wrapper_get_attribute_name_view_by_number,
+    guththila_xml_reader_wrapper_get_attribute_prefix_view_by_number,
+    guththila_xml_reader_wrapper_get_attribute_value_view_by_number,
+    guththila_xml_reader_wrapper_get_attribute_namespace_view_by_number,
+    guththila_xml_reader_wrapper_get_namespace_prefix_view_by_number,
+    guththila_xml_reader_wrapper_get_namespace_uri_view_by_number,
+    guththila_xml_reader_wrapper_set_streaming,
+    guththila_xml_reader_wrapper_feed };
 
 /********************************************************************************/
 
@@ -224,21 +310,12 @@ axiom_xml_reader_create_basic(
         return NULL;
     }
 
-    guththila = (guththila_t *)AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+    /* parsers are reused by the thread, see guththila_pool_get */
+    guththila = guththila_pool_get(reader, env);
     if(!guththila)
     {
         AXIS2_FREE(env->allocator, guththila_impl);
         guththila_reader_free(reader, env);
-        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
-        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Insufficient memory to create guththila");
-        return NULL;
-    }
-
-    if(guththila_init(guththila, reader, env) != GUTHTHILA_SUCCESS)
-    {
-        AXIS2_FREE(env->allocator, guththila_impl);
-        AXIS2_FREE(env->allocator, guththila);
-        guththila_reader_free(reader, env);
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_CREATING_XML_STREAM_READER, AXIS2_FAILURE);
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Guththila initialization failed");
         return NULL;
@@ -286,6 +363,15 @@ axiom_xml_reader_create_for_memory(
     return axiom_xml_reader_create_basic(env, reader, NULL);
 }
 
+AXIS2_EXTERN axiom_xml_reader_t *AXIS2_CALL
+axiom_xml_reader_create_for_push(
+    const axutil_env_t * env,
+    const axis2_char_t * encoding)
+{
+    guththila_reader_t *reader = guththila_reader_create_for_push(env);
+    return axiom_xml_reader_create_basic(env, reader, NULL);
+}
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axiom_xml_reader_init()
 {
@@ -322,7 +408,7 @@ guththila_xml_reader_wrapper_free(
 
     if(parser_impl->guththila_parser)
     {
-        guththila_un_init(parser_impl->guththila_parser, env);
+        guththila_pool_put(parser_impl->guththila_parser, env);
     }
 
     AXIS2_FREE(env->allocator, parser_impl);
@@ -509,3 +595,152 @@ guththila_xml_reader_wrapper_get_current_buffer(
     return guththila_get_current_buffer(AXIS2_INTF_TO_IMPL(parser)->guththila_parser, env);
 }
 
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_name_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_name_view(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_prefix_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_prefix_view(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_value_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_value_view(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_name_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_attribute_name_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_attribute_prefix_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_value_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_attribute_value_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_attribute_namespace_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_attribute_namespace_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_namespace_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_namespace_prefix_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+const axis2_char_t *AXIS2_CALL
+guththila_xml_reader_wrapper_get_namespace_uri_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    size_t size = 0;
+    const guththila_char_t *view = guththila_get_namespace_uri_view_by_number(
+        AXIS2_INTF_TO_IMPL(parser)->guththila_parser, i, &size, env);
+    *len = (unsigned int)size;
+    return view;
+}
+
+axis2_status_t AXIS2_CALL
+guththila_xml_reader_wrapper_set_streaming(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    axis2_bool_t streaming)
+{
+    guththila_set_streaming(AXIS2_INTF_TO_IMPL(parser)->guththila_parser, streaming, env);
+    return AXIS2_SUCCESS;
+}
+
+axis2_status_t AXIS2_CALL
+guththila_xml_reader_wrapper_feed(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    const axis2_char_t * data,
+    size_t len,
+    axis2_bool_t is_last)
+{
+    if(guththila_reader_feed(AXIS2_INTF_TO_IMPL(parser)->reader, data, len, is_last, env)
+        != GUTHTHILA_SUCCESS)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to feed input to the xml reader");
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
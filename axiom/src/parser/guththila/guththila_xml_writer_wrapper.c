@@ -309,14 +309,11 @@ axiom_xml_writer_create_for_memory(
         return NULL;
     }
 
-    /* creating guththila parser */
-    /* guththila xml stream writer for memory */
-
-    writer_impl->wr = guththila_create_xml_stream_writer_for_memory(env);
+    /* guththila xml stream writer for memory, reused by the thread */
+    writer_impl->wr = guththila_xml_writer_pool_get(env);
 
     if(!(writer_impl->wr))
     {
-        AXIS2_FREE(env->allocator, writer_impl->wr);
         AXIS2_FREE(env->allocator, writer_impl);
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
         return NULL;
@@ -329,6 +326,77 @@ axiom_xml_writer_create_for_memory(
 
 }
 
+AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+axiom_xml_writer_create_for_chain(
+    const axutil_env_t * env,
+    axis2_char_t * encoding,
+    int is_prefix_default,
+    int compression,
+    axutil_buffer_chain_t * chain)
+{
+    guththila_xml_writer_wrapper_impl_t *writer_impl = NULL;
+
+    AXIS2_ENV_CHECK(env, NULL);
+    AXIS2_PARAM_CHECK(env->error, chain, NULL);
+
+    writer_impl = (guththila_xml_writer_wrapper_impl_t *)AXIS2_MALLOC(env->allocator,
+        sizeof(guththila_xml_writer_wrapper_impl_t));
+
+    if(!writer_impl)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    writer_impl->wr = guththila_create_xml_stream_writer_for_chain(env, chain);
+
+    if(!(writer_impl->wr))
+    {
+        AXIS2_FREE(env->allocator, writer_impl);
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    writer_impl->writer.ops = &axiom_xml_writer_ops_var;
+    return &(writer_impl->writer);
+}
+
+AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+axiom_xml_writer_create_for_stream(
+    const axutil_env_t * env,
+    axis2_char_t * encoding,
+    int is_prefix_default,
+    int compression,
+    axutil_stream_t * stream,
+    size_t flush_size)
+{
+    guththila_xml_writer_wrapper_impl_t *writer_impl = NULL;
+
+    AXIS2_ENV_CHECK(env, NULL);
+    AXIS2_PARAM_CHECK(env->error, stream, NULL);
+
+    writer_impl = (guththila_xml_writer_wrapper_impl_t *)AXIS2_MALLOC(env->allocator,
+        sizeof(guththila_xml_writer_wrapper_impl_t));
+
+    if(!writer_impl)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    writer_impl->wr = guththila_create_xml_stream_writer_for_stream(env, stream, flush_size);
+
+    if(!(writer_impl->wr))
+    {
+        AXIS2_FREE(env->allocator, writer_impl);
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    writer_impl->writer.ops = &axiom_xml_writer_ops_var;
+    return &(writer_impl->writer);
+}
+
 void AXIS2_CALL
 guththila_xml_writer_wrapper_free(
     axiom_xml_writer_t * writer,
@@ -337,7 +405,7 @@ guththila_xml_writer_wrapper_free(
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
     if(AXIS2_INTF_TO_IMPL(writer)->wr)
     {
-        guththila_xml_writer_free(AXIS2_INTF_TO_IMPL(writer)->wr, env);
+        guththila_xml_writer_pool_put(AXIS2_INTF_TO_IMPL(writer)->wr, env);
     }
 
     if(writer)
@@ -772,6 +840,10 @@ guththila_xml_writer_wrapper_flush(
     axiom_xml_writer_t * writer,
     const axutil_env_t * env)
 {
+    if(guththila_flush(AXIS2_INTF_TO_IMPL(writer)->wr, env) != GUTHTHILA_SUCCESS)
+    {
+        return AXIS2_FAILURE;
+    }
     return AXIS2_SUCCESS;
 }
 
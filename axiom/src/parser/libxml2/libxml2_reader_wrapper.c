@@ -132,6 +132,80 @@ axis2_libxml2_reader_wrapper_get_namespace_uri_by_prefix(
     const axutil_env_t * env,
     axis2_char_t * prefix);
 
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_name_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_prefix_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_value_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_name_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_value_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_namespace_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_namespace_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_namespace_uri_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len);
+
+axis2_status_t AXIS2_CALL
+axis2_libxml2_reader_wrapper_set_streaming(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    axis2_bool_t streaming);
+
+axis2_status_t AXIS2_CALL
+axis2_libxml2_reader_wrapper_feed(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    const axis2_char_t * data,
+    size_t len,
+    axis2_bool_t is_last);
+
 axis2_status_t
 axis2_libxml2_reader_wrapper_fill_maps(
     axiom_xml_reader_t * parser,
@@ -175,6 +249,13 @@ typedef struct axis2_libxml2_reader_wrapper_impl_t
 
     AXIS2_CLOSE_INPUT_CALLBACK close_input_callback;
 
+    /* input fed to a push reader, parsed once it has all been fed */
+    axis2_bool_t is_push;
+    axis2_char_t *push_buffer;
+    size_t push_len;
+    size_t push_size;
+    axis2_char_t *encoding;
+
 } axis2_libxml2_reader_wrapper_impl_t;
 
 #define AXIS2_INTF_TO_IMPL(p) ((axis2_libxml2_reader_wrapper_impl_t*)p)
@@ -200,7 +281,20 @@ static const axiom_xml_reader_ops_t axiom_xml_reader_ops_var = {
     axis2_libxml2_reader_wrapper_xml_free,
     axis2_libxml2_reader_wrapper_get_char_set_encoding,
     axis2_libxml2_reader_wrapper_get_namespace_uri,
-    axis2_libxml2_reader_wrapper_get_namespace_uri_by_prefix };
+    axis2_libxml2_reader_wrapper_get_namespace_uri_by_prefix,
+    NULL,
+    NULL,
+    axis2_libxml2_reader_wrapper_get_name_view,
+    axis2_libxml2_reader_wrapper_get_prefix_view,
+    axis2_libxml2_reader_wrapper_get_value_view,
+    axis2_libxml2_reader_wrapper_get_attribute_name_view_by_number,
+    axis2_libxml2_reader_wrapper_get_attribute_prefix_view_by_number,
+    axis2_libxml2_reader_wrapper_get_attribute_value_view_by_number,
+    axis2_libxml2_reader_wrapper_get_attribute_namespace_view_by_number,
+    axis2_libxml2_reader_wrapper_get_namespace_prefix_view_by_number,
+    axis2_libxml2_reader_wrapper_get_namespace_uri_view_by_number,
+    axis2_libxml2_reader_wrapper_set_streaming,
+    axis2_libxml2_reader_wrapper_feed };
 
 static axis2_status_t
 axis2_libxml2_reader_wrapper_init_map(
@@ -422,6 +516,41 @@ axiom_xml_reader_create_for_memory(
     return &(wrapper_impl->parser);
 }
 
+/*
+ * The xmlTextReader of libxml2 pulls its input, and takes running out of it
+ * for the end of the document. So a push reader keeps what is fed, and
+ * starts the xmlTextReader on it when the last bytes come; the events are
+ * not read incrementally as with guththila.
+ */
+AXIS2_EXTERN axiom_xml_reader_t *AXIS2_CALL
+axiom_xml_reader_create_for_push(
+    const axutil_env_t * env,
+    const axis2_char_t * encoding)
+{
+    axis2_libxml2_reader_wrapper_impl_t *wrapper_impl = NULL;
+
+    wrapper_impl = libxml2_reader_wrapper_create(env);
+    if(!wrapper_impl)
+    {
+        return NULL;
+    }
+    wrapper_impl->is_push = AXIS2_TRUE;
+    if(encoding)
+    {
+        wrapper_impl->encoding = axutil_strdup(env, encoding);
+        if(!wrapper_impl->encoding)
+        {
+            AXIS2_FREE(env->allocator, wrapper_impl);
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+            return NULL;
+        }
+    }
+    axis2_libxml2_reader_wrapper_init_map(wrapper_impl);
+
+    wrapper_impl->parser.ops = &axiom_xml_reader_ops_var;
+    return &(wrapper_impl->parser);
+}
+
 int AXIS2_CALL
 axis2_libxml2_reader_wrapper_next(
     axiom_xml_reader_t * parser,
@@ -433,6 +562,10 @@ axis2_libxml2_reader_wrapper_next(
     axis2_libxml2_reader_wrapper_impl_t *parser_impl;
     AXIS2_ENV_CHECK(env, -1);
     parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(parser_impl->is_push && !parser_impl->reader)
+    {
+        return AXIOM_XML_READER_NEED_MORE_INPUT;
+    }
     ret_val = xmlTextReaderRead(parser_impl->reader);
     if(ret_val == 0)
     {
@@ -494,6 +627,14 @@ axis2_libxml2_reader_wrapper_free(
         xmlTextReaderClose(parser_impl->reader);
         xmlFreeTextReader(parser_impl->reader);
     }
+    if(parser_impl->push_buffer)
+    {
+        AXIS2_FREE(env->allocator, parser_impl->push_buffer);
+    }
+    if(parser_impl->encoding)
+    {
+        AXIS2_FREE(env->allocator, parser_impl->encoding);
+    }
     if(parser_impl->namespace_map)
     {
         AXIS2_FREE(env->allocator, parser_impl->namespace_map);
@@ -966,3 +1107,228 @@ axis2_libxml2_reader_wrapper_close_input_callback(
     return ((axis2_libxml2_reader_wrapper_impl_t *)ctx)-> close_input_callback(
         ((axis2_libxml2_reader_wrapper_impl_t *)ctx)-> ctx);
 }
+
+/*
+ * The views are the strings libxml2 keeps for the current node. libxml2 may
+ * build an attribute value in a buffer of the reader, which the next value
+ * asked for reuses.
+ */
+static const axis2_char_t *
+axis2_libxml2_reader_wrapper_view(
+    const xmlChar * str,
+    unsigned int *len)
+{
+    *len = str ? (unsigned int)strlen((const char *)str) : 0;
+    return (const axis2_char_t *)str;
+}
+
+/* Moves the reader to the attribute or namespace declaration at index in map */
+static axis2_bool_t
+axis2_libxml2_reader_wrapper_move_to(
+    axis2_libxml2_reader_wrapper_impl_t * parser_impl,
+    int count,
+    int *map,
+    int i)
+{
+    return count > 0 && count >= i
+        && xmlTextReaderMoveToAttributeNo(parser_impl->reader, map[i]) == 1;
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_name_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    xmlTextReaderMoveToElement(parser_impl->reader);
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstLocalName(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_prefix_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    xmlTextReaderMoveToElement(parser_impl->reader);
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstPrefix(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_value_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstValue(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_name_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_attribute_count,
+        parser_impl->attribute_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstLocalName(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_attribute_count,
+        parser_impl->attribute_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstPrefix(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_value_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_attribute_count,
+        parser_impl->attribute_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstValue(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_attribute_namespace_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_attribute_count,
+        parser_impl->attribute_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstNamespaceUri(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_namespace_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_namespace_count,
+        parser_impl->namespace_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstLocalName(parser_impl->reader), len);
+}
+
+const axis2_char_t *AXIS2_CALL
+axis2_libxml2_reader_wrapper_get_namespace_uri_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    if(!axis2_libxml2_reader_wrapper_move_to(parser_impl, parser_impl->current_namespace_count,
+        parser_impl->namespace_map, i))
+    {
+        *len = 0;
+        return NULL;
+    }
+    return axis2_libxml2_reader_wrapper_view(xmlTextReaderConstValue(parser_impl->reader), len);
+}
+
+/* xmlTextReader keeps only the current subtree, so it streams already */
+axis2_status_t AXIS2_CALL
+axis2_libxml2_reader_wrapper_set_streaming(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    axis2_bool_t streaming)
+{
+    return AXIS2_SUCCESS;
+}
+
+axis2_status_t AXIS2_CALL
+axis2_libxml2_reader_wrapper_feed(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    const axis2_char_t * data,
+    size_t len,
+    axis2_bool_t is_last)
+{
+    axis2_libxml2_reader_wrapper_impl_t *parser_impl = AXIS2_INTF_TO_IMPL(parser);
+    axis2_char_t *buffer = NULL;
+    size_t size = 0;
+
+    if(!parser_impl->is_push || parser_impl->reader)
+    {
+        return AXIS2_FAILURE;
+    }
+    if(parser_impl->push_len + len > parser_impl->push_size)
+    {
+        size = parser_impl->push_size ? parser_impl->push_size * 2 : 4096;
+        while(size < parser_impl->push_len + len)
+            size *= 2;
+        buffer = (axis2_char_t *)AXIS2_MALLOC(env->allocator, size);
+        if(!buffer)
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+            return AXIS2_FAILURE;
+        }
+        if(parser_impl->push_buffer)
+        {
+            memcpy(buffer, parser_impl->push_buffer, parser_impl->push_len);
+            AXIS2_FREE(env->allocator, parser_impl->push_buffer);
+        }
+        parser_impl->push_buffer = buffer;
+        parser_impl->push_size = size;
+    }
+    if(len)
+    {
+        memcpy(parser_impl->push_buffer + parser_impl->push_len, data, len);
+        parser_impl->push_len += len;
+    }
+    if(is_last)
+    {
+        parser_impl->reader = xmlReaderForMemory(parser_impl->push_buffer,
+            (int)parser_impl->push_len, NULL, parser_impl->encoding, XML_PARSE_RECOVER);
+        if(!parser_impl->reader)
+        {
+            AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_CREATING_XML_STREAM_READER, AXIS2_FAILURE);
+            return AXIS2_FAILURE;
+        }
+        xmlTextReaderSetErrorHandler(parser_impl->reader,
+            (xmlTextReaderErrorFunc)axis2_libxml2_reader_wrapper_error_handler, (void *)env);
+    }
+    return AXIS2_SUCCESS;
+}
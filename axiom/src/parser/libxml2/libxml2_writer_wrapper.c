@@ -73,6 +73,13 @@ typedef struct axis2_libxml2_writer_wrapper_impl
 
     uri_prefix_element_t *default_lang_namespace;
 
+    /* chain or stream the output goes to, and the env to write to it with */
+    axutil_buffer_chain_t *chain;
+
+    axutil_stream_t *stream;
+
+    const axutil_env_t *chain_env;
+
 } axis2_libxml2_writer_wrapper_impl_t;
 
 #define AXIS2_INTF_TO_IMPL(p) ((axis2_libxml2_writer_wrapper_impl_t*)p)
@@ -394,6 +401,9 @@ axiom_xml_writer_create(
 
     writer_impl->writer_type = AXIS2_XML_PARSER_TYPE_FILE;
     writer_impl->compression = compression;
+    writer_impl->chain = NULL;
+    writer_impl->stream = NULL;
+    writer_impl->chain_env = NULL;
 
     if(encoding)
     {
@@ -444,6 +454,9 @@ axiom_xml_writer_create_for_memory(
     writer_impl->uri_prefix_map = NULL;
     writer_impl->default_lang_namespace = NULL;
     writer_impl->compression = compression;
+    writer_impl->chain = NULL;
+    writer_impl->stream = NULL;
+    writer_impl->chain_env = NULL;
 
     if(AXIS2_XML_PARSER_TYPE_BUFFER == type)
     {
@@ -511,6 +524,149 @@ axiom_xml_writer_create_for_memory(
     return &(writer_impl->writer);
 }
 
+static int
+axis2_libxml2_writer_wrapper_write_chain(
+    void *context,
+    const char *buffer,
+    int len)
+{
+    axis2_libxml2_writer_wrapper_impl_t *writer_impl = NULL;
+    writer_impl = (axis2_libxml2_writer_wrapper_impl_t *)context;
+    if(axutil_buffer_chain_append(writer_impl->chain, writer_impl->chain_env, buffer, len)
+        != AXIS2_SUCCESS)
+    {
+        return -1;
+    }
+    return len;
+}
+
+AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+axiom_xml_writer_create_for_chain(
+    const axutil_env_t * env,
+    axis2_char_t * encoding,
+    int is_prefix_default,
+    int compression,
+    axutil_buffer_chain_t * chain)
+{
+    axiom_xml_writer_t *writer = NULL;
+    axis2_libxml2_writer_wrapper_impl_t *writer_impl = NULL;
+    xmlOutputBufferPtr output = NULL;
+
+    AXIS2_ENV_CHECK(env, NULL);
+    AXIS2_PARAM_CHECK(env->error, chain, NULL);
+
+    writer = axiom_xml_writer_create_for_memory(env, encoding, is_prefix_default, compression,
+        AXIS2_XML_PARSER_TYPE_BUFFER);
+    if(!writer)
+    {
+        return NULL;
+    }
+
+    /* replace the memory buffer with an output buffer writing to the chain */
+    writer_impl = AXIS2_INTF_TO_IMPL(writer);
+    xmlFreeTextWriter(writer_impl->xml_writer);
+    writer_impl->xml_writer = NULL;
+    xmlBufferFree(writer_impl->buffer);
+    writer_impl->buffer = NULL;
+    writer_impl->writer_type = AXIS2_XML_PARSER_TYPE_FILE;
+    writer_impl->chain = chain;
+    writer_impl->chain_env = env;
+
+    output = xmlOutputBufferCreateIO(axis2_libxml2_writer_wrapper_write_chain, NULL, writer_impl,
+        NULL);
+    if(output)
+    {
+        writer_impl->xml_writer = xmlNewTextWriter(output);
+    }
+    if(!(writer_impl->xml_writer))
+    {
+        if(output)
+        {
+            xmlOutputBufferClose(output);
+        }
+        axis2_libxml2_writer_wrapper_free(writer, env);
+        AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_CREATING_XML_STREAM_WRITER, AXIS2_FAILURE);
+        return NULL;
+    }
+    return writer;
+}
+
+static int
+axis2_libxml2_writer_wrapper_write_stream(
+    void *context,
+    const char *buffer,
+    int len)
+{
+    axis2_libxml2_writer_wrapper_impl_t *writer_impl = NULL;
+    int written = 0;
+    int total = 0;
+    writer_impl = (axis2_libxml2_writer_wrapper_impl_t *)context;
+    while(total < len)
+    {
+        written = axutil_stream_write(writer_impl->stream, writer_impl->chain_env, buffer + total,
+            len - total);
+        if(written <= 0)
+        {
+            return -1;
+        }
+        total += written;
+    }
+    return len;
+}
+
+AXIS2_EXTERN axiom_xml_writer_t *AXIS2_CALL
+axiom_xml_writer_create_for_stream(
+    const axutil_env_t * env,
+    axis2_char_t * encoding,
+    int is_prefix_default,
+    int compression,
+    axutil_stream_t * stream,
+    size_t flush_size)
+{
+    axiom_xml_writer_t *writer = NULL;
+    axis2_libxml2_writer_wrapper_impl_t *writer_impl = NULL;
+    xmlOutputBufferPtr output = NULL;
+
+    AXIS2_ENV_CHECK(env, NULL);
+    AXIS2_PARAM_CHECK(env->error, stream, NULL);
+
+    writer = axiom_xml_writer_create_for_memory(env, encoding, is_prefix_default, compression,
+        AXIS2_XML_PARSER_TYPE_BUFFER);
+    if(!writer)
+    {
+        return NULL;
+    }
+
+    /* replace the memory buffer with an output buffer writing to the stream. The output
+     * buffer is flushed by libxml2 as it fills, so flush_size is not used */
+    writer_impl = AXIS2_INTF_TO_IMPL(writer);
+    xmlFreeTextWriter(writer_impl->xml_writer);
+    writer_impl->xml_writer = NULL;
+    xmlBufferFree(writer_impl->buffer);
+    writer_impl->buffer = NULL;
+    writer_impl->writer_type = AXIS2_XML_PARSER_TYPE_FILE;
+    writer_impl->stream = stream;
+    writer_impl->chain_env = env;
+
+    output = xmlOutputBufferCreateIO(axis2_libxml2_writer_wrapper_write_stream, NULL, writer_impl,
+        NULL);
+    if(output)
+    {
+        writer_impl->xml_writer = xmlNewTextWriter(output);
+    }
+    if(!(writer_impl->xml_writer))
+    {
+        if(output)
+        {
+            xmlOutputBufferClose(output);
+        }
+        axis2_libxml2_writer_wrapper_free(writer, env);
+        AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_CREATING_XML_STREAM_WRITER, AXIS2_FAILURE);
+        return NULL;
+    }
+    return writer;
+}
+
 void AXIS2_CALL
 axis2_libxml2_writer_wrapper_free(
     axiom_xml_writer_t * writer,
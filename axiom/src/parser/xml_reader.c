@@ -201,3 +201,109 @@ axiom_xml_reader_get_current_buffer(
     return (parser)->ops->get_current_buffer(parser, env);
 }
 
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_name_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    return (parser)->ops->get_name_view(parser, env, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_prefix_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    return (parser)->ops->get_prefix_view(parser, env, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_value_view(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    unsigned int *len)
+{
+    return (parser)->ops->get_value_view(parser, env, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_attribute_name_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_attribute_name_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_attribute_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_attribute_prefix_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_attribute_value_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_attribute_value_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_attribute_namespace_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_attribute_namespace_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_namespace_prefix_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_namespace_prefix_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axiom_xml_reader_get_namespace_uri_view_by_number(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    int i,
+    unsigned int *len)
+{
+    return (parser)->ops->get_namespace_uri_view_by_number(parser, env, i, len);
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axiom_xml_reader_set_streaming(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    axis2_bool_t streaming)
+{
+    return (parser)->ops->set_streaming(parser, env, streaming);
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axiom_xml_reader_feed(
+    axiom_xml_reader_t * parser,
+    const axutil_env_t * env,
+    const axis2_char_t * data,
+    size_t len,
+    axis2_bool_t is_last)
+{
+    return (parser)->ops->feed(parser, env, data, len, is_last);
+}
@@ -25,10 +25,12 @@
 #include <axiom_text.h>
 #include <axiom_data_source.h>
 #include <axutil_stream.h>
+#include <axutil_buffer_chain.h>
 #include <axutil_log_default.h>
 #include <axutil_error_default.h>
 #include <axiom_xml_reader.h>
 #include <stdio.h>
+#include <string>
 #include <axiom_xml_writer.h>
 #include <axutil_env.h>
 
@@ -372,6 +374,108 @@ TEST_F(TestOM, test_om_buffer) {
     return;
 }
 
+TEST_F(TestOM, test_om_serialize_to_chain)
+{
+    axiom_node_t *node;
+    axiom_xml_writer_t *writer;
+    axiom_output_t *om_output;
+    axutil_buffer_chain_t *chain;
+    axis2_char_t *expected;
+    axis2_char_t *flat;
+    std::string xml;
+    int i;
+
+    /* big enough for the output to take several chunks */
+    xml = "<a:root xmlns:a=\"urn:a\" xmlns:b=\"urn:b\">";
+    for (i = 0; i < 2000; i++)
+    {
+        xml += "<b:item n=\"" + std::to_string(i) + "\"><a:name>x &amp; y</a:name>";
+        xml += "<c:v xmlns:c=\"urn:c\">" + std::to_string(i * 7) + "</c:v><e/></b:item>";
+    }
+    xml += "</a:root>";
+    node = axiom_node_create_from_buffer(m_env, (axis2_char_t *)xml.c_str());
+    ASSERT_NE(node, nullptr);
+
+    writer = axiom_xml_writer_create_for_memory(m_env, NULL, AXIS2_TRUE, 0,
+        AXIS2_XML_PARSER_TYPE_BUFFER);
+    om_output = axiom_output_create(m_env, writer);
+    ASSERT_EQ(axiom_node_serialize(node, m_env, om_output), AXIS2_SUCCESS);
+    expected = (axis2_char_t *)axutil_strdup(m_env,
+        (axis2_char_t *)axiom_xml_writer_get_xml(writer, m_env));
+    axiom_output_free(om_output, m_env);
+
+    chain = axutil_buffer_chain_create(m_env);
+    writer = axiom_xml_writer_create_for_chain(m_env, NULL, AXIS2_TRUE, 0, chain);
+    ASSERT_NE(writer, nullptr);
+    om_output = axiom_output_create(m_env, writer);
+    ASSERT_EQ(axiom_node_serialize(node, m_env, om_output), AXIS2_SUCCESS);
+    axiom_xml_writer_flush(writer, m_env);
+    EXPECT_EQ(axiom_xml_writer_get_xml(writer, m_env), nullptr);
+    axiom_output_free(om_output, m_env);
+
+    ASSERT_GT(axutil_buffer_chain_get_len(chain, m_env), (size_t)AXUTIL_BUFFER_CHAIN_CHUNK_SIZE);
+    flat = axutil_buffer_chain_flatten(chain, m_env);
+    EXPECT_STREQ(flat, expected);
+
+    AXIS2_FREE(m_env->allocator, flat);
+    AXIS2_FREE(m_env->allocator, expected);
+    axutil_buffer_chain_free(chain, m_env);
+    axiom_node_free_tree(node, m_env);
+}
+
+TEST_F(TestOM, test_om_arena)
+{
+    const char *xml = "<a:root xmlns:a=\"urn:a\"><a:item n=\"1\">one</a:item>"
+        "<a:item n=\"2\">two<!--c--></a:item></a:root>";
+    axiom_xml_reader_t *reader;
+    axiom_stax_builder_t *builder;
+    axiom_document_t *document;
+    const axutil_env_t *tree_env;
+    axiom_node_t *root, *first, *second, *extra, *holder;
+    axis2_char_t *str;
+
+    reader = axiom_xml_reader_create_for_memory(m_env, (void *)xml, strlen(xml), "UTF-8",
+        AXIS2_XML_PARSER_TYPE_BUFFER);
+    ASSERT_NE(reader, nullptr);
+    builder = axiom_stax_builder_create_with_arena(m_env, reader, 1024);
+    ASSERT_NE(builder, nullptr);
+    document = axiom_stax_builder_get_document(builder, m_env);
+    root = axiom_document_get_root_element(document, m_env);
+    ASSERT_NE(root, nullptr);
+    axiom_document_build_all(document, m_env);
+    tree_env = axiom_document_get_env(document, m_env);
+    EXPECT_NE(tree_env, m_env);
+
+    str = axiom_node_to_string(root, m_env);
+    EXPECT_STREQ(str, xml);
+    AXIS2_FREE(m_env->allocator, str);
+
+    /* attributes read into the arena are made there, whichever env asks for them */
+    first = axiom_node_get_first_child(root, m_env);
+    EXPECT_STREQ(axiom_element_get_attribute_value_by_name((axiom_element_t *)
+        axiom_node_get_data_element(first, m_env), m_env, (axis2_char_t *)"n"), "1");
+    EXPECT_EQ(axutil_hash_count(axiom_element_get_all_attributes((axiom_element_t *)
+        axiom_node_get_data_element(first, m_env), m_env)), 1u);
+
+    /* results kept by an element of the arena, and a node of the heap in the tree */
+    second = axiom_node_get_last_child(root, m_env);
+    EXPECT_STREQ(axiom_element_get_text((axiom_element_t *)axiom_node_get_data_element(second,
+        m_env), tree_env, second), "two");
+    axiom_element_create(m_env, root, "extra", NULL, &extra);
+    ASSERT_NE(extra, nullptr);
+
+    /* a detached node outlives the document, in another tree */
+    first = axiom_node_detach(axiom_node_get_first_child(root, m_env), m_env);
+    axiom_stax_builder_free(builder, m_env);
+
+    axiom_element_create(m_env, NULL, "holder", NULL, &holder);
+    axiom_node_add_child(holder, m_env, first);
+    str = axiom_node_to_string(holder, m_env);
+    EXPECT_STREQ(str, "<holder><a:item xmlns:a=\"urn:a\" n=\"1\">one</a:item></holder>");
+    AXIS2_FREE(m_env->allocator, str);
+    axiom_node_free_tree(holder, m_env);
+}
+
 /* AXIS2C-1627 */
 TEST_F(TestOM, test_attr_special_chars)
 {
@@ -438,3 +542,131 @@ TEST_F(TestOM, test_attribute)
 
 
 }
+
+TEST_F(TestOM, test_element_attribute_storage)
+{
+    axiom_node_t *node;
+    axiom_element_t *element;
+    axiom_namespace_t *ns;
+    axiom_namespace_t *default_ns;
+    axiom_attribute_t *attr;
+    axutil_qname_t *qname;
+    axutil_hash_t *hash;
+    axis2_char_t *xml;
+    char name[16];
+    int i;
+
+    element = axiom_element_create(m_env, NULL, "el", NULL, &node);
+    ASSERT_NE(element, nullptr);
+    ASSERT_EQ(axiom_element_get_all_attributes(element, m_env), nullptr);
+    ASSERT_EQ(axiom_element_get_namespaces(element, m_env), nullptr);
+
+    /* a few attributes and namespaces are kept in the element, in the order they are added */
+    ns = axiom_namespace_create(m_env, "urn:a", "a");
+    ASSERT_EQ(axiom_element_declare_namespace(element, m_env, node, ns), AXIS2_SUCCESS);
+    attr = axiom_attribute_create(m_env, "x", "1", ns);
+    axiom_element_add_attribute(element, m_env, attr, node);
+    attr = axiom_attribute_create(m_env, "y", "2", NULL);
+    axiom_element_add_attribute(element, m_env, attr, node);
+    default_ns = axiom_element_declare_default_namespace(element, m_env, (axis2_char_t *)"urn:d");
+    ASSERT_NE(default_ns, nullptr);
+
+    xml = axiom_node_to_string(node, m_env);
+    ASSERT_STREQ(xml, "<el xmlns:a=\"urn:a\" a:x=\"1\" y=\"2\" xmlns=\"urn:d\"></el>");
+    AXIS2_FREE(m_allocator, xml);
+
+    ASSERT_EQ(axiom_element_find_declared_namespace(element, m_env, "urn:a", NULL), ns);
+    ASSERT_EQ(axiom_element_find_declared_namespace(element, m_env, NULL, "a"), ns);
+    ASSERT_EQ(axiom_element_find_declared_namespace(element, m_env, "urn:b", "a"), nullptr);
+    ASSERT_STREQ(axiom_namespace_get_uri(axiom_element_find_declared_namespace(element, m_env,
+        NULL, ""), m_env), "urn:d");
+    ASSERT_STREQ(axiom_element_get_attribute_value_by_name(element, m_env,
+        (axis2_char_t *)"a:x"), "1");
+
+    qname = axutil_qname_create(m_env, "y", NULL, NULL);
+    attr = axiom_element_get_attribute(element, m_env, qname);
+    ASSERT_NE(attr, nullptr);
+    ASSERT_STREQ(axiom_attribute_get_value(attr, m_env), "2");
+    ASSERT_EQ(axiom_element_remove_attribute(element, m_env, attr), AXIS2_SUCCESS);
+    axiom_attribute_free(attr, m_env);
+    ASSERT_EQ(axiom_element_get_attribute(element, m_env, qname), nullptr);
+
+    /* past the few, they move to a hash, which is what callers asking for one get */
+    for (i = 0; i < 8; i++)
+    {
+        sprintf(name, "z%d", i);
+        attr = axiom_attribute_create(m_env, name, name, NULL);
+        axiom_element_add_attribute(element, m_env, attr, node);
+    }
+    hash = axiom_element_get_all_attributes(element, m_env);
+    ASSERT_NE(hash, nullptr);
+    ASSERT_EQ(axutil_hash_count(hash), 9u);
+    ASSERT_EQ(axiom_element_get_all_attributes(element, m_env), hash);
+    ASSERT_STREQ(axiom_element_get_attribute_value_by_name(element, m_env,
+        (axis2_char_t *)"z7"), "z7");
+    ASSERT_EQ(axiom_element_get_attribute(element, m_env, qname), nullptr);
+
+    /* the hash a caller was given keeps up with the element */
+    attr = axiom_attribute_create(m_env, "y", "4", NULL);
+    axiom_element_add_attribute(element, m_env, attr, node);
+    ASSERT_EQ(axutil_hash_count(hash), 10u);
+    ASSERT_EQ(axutil_hash_count(axiom_element_get_namespaces(element, m_env)), 2u);
+
+    axutil_qname_free(qname, m_env);
+    axiom_node_free_tree(node, m_env);
+    axiom_namespace_free(default_ns, m_env);
+    axiom_namespace_free(ns, m_env);
+}
+
+TEST_F(TestOM, test_om_read_attributes)
+{
+    axiom_node_t *root;
+    axiom_node_t *item;
+    axiom_element_t *element;
+    axiom_attribute_t *attr;
+    axutil_qname_t *qname;
+    axis2_char_t *first;
+    axis2_char_t *second;
+    axis2_char_t *xml = (axis2_char_t *)axutil_strdup(m_env,
+        "<r xmlns:p=\"urn:p\"><p:item p:id=\"1\" xml:lang=\"en\" note=\"a &amp; b\">x</p:item>"
+        "<item n=\"2\"/></r>");
+
+    /* attributes read are written as they were, without being made */
+    root = axiom_node_create_from_buffer(m_env, xml);
+    ASSERT_NE(root, nullptr);
+    first = axiom_node_to_string(root, m_env);
+    ASSERT_NE(first, nullptr);
+
+    item = axiom_node_get_first_element(root, m_env);
+    element = (axiom_element_t *)axiom_node_get_data_element(item, m_env);
+    ASSERT_STREQ(axiom_element_get_attribute_value_by_name(element, m_env,
+        (axis2_char_t *)"note"), "a & b");
+    ASSERT_STREQ(axiom_element_get_attribute_value_by_name(element, m_env,
+        (axis2_char_t *)"p:id"), "1");
+    qname = axutil_qname_create(m_env, "lang", "http://www.w3.org/XML/1998/namespace", "xml");
+    attr = axiom_element_get_attribute(element, m_env, qname);
+    ASSERT_NE(attr, nullptr);
+    ASSERT_STREQ(axiom_attribute_get_value(attr, m_env), "en");
+    axutil_qname_free(qname, m_env);
+
+    /* and once made, the same way */
+    second = axiom_node_to_string(root, m_env);
+    ASSERT_STREQ(first, second);
+    AXIS2_FREE(m_allocator, second);
+
+    /* a detached element keeps the namespaces its attributes use */
+    item = axiom_node_get_next_sibling(item, m_env);
+    element = (axiom_element_t *)axiom_node_get_data_element(item, m_env);
+    ASSERT_EQ(axutil_hash_count(axiom_element_get_all_attributes(element, m_env)), 1u);
+    item = axiom_node_get_first_element(root, m_env);
+    axiom_node_detach(item, m_env);
+    second = axiom_node_to_string(item, m_env);
+    ASSERT_NE(strstr(second, "xmlns:p=\"urn:p\""), nullptr);
+    ASSERT_NE(strstr(second, "p:id=\"1\""), nullptr);
+    AXIS2_FREE(m_allocator, second);
+
+    axiom_node_free_tree(item, m_env);
+    axiom_node_free_tree(root, m_env);
+    AXIS2_FREE(m_allocator, first);
+    AXIS2_FREE(m_allocator, xml);
+}
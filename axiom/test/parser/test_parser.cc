@@ -81,3 +81,50 @@ TEST_F(TestParser, test_axisc_1453) {
     axiom_node_free_tree(node_input3, m_env);
     AXIS2_FREE(m_env->allocator, output3);
 }
+
+TEST_F(TestParser, test_push_reader) {
+
+    std::string xml = "<?xml version='1.0'?><a:x xmlns:a='urn:a' k='v'><y>text</y><z/></a:x>";
+    std::string trace;
+    axiom_xml_reader_t *reader;
+    axis2_char_t *name;
+    size_t pos = 0, n;
+    int event, fed = 0;
+
+    reader = axiom_xml_reader_create_for_push(m_env, NULL);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(axiom_xml_reader_next(reader, m_env), AXIOM_XML_READER_NEED_MORE_INPUT);
+
+    /* three bytes at a time, as they would come from a slow client */
+    while ((event = axiom_xml_reader_next(reader, m_env)) != -1)
+    {
+        if (event == AXIOM_XML_READER_NEED_MORE_INPUT)
+        {
+            ASSERT_LT(pos, xml.size());
+            n = xml.size() - pos < 3 ? xml.size() - pos : 3;
+            ASSERT_EQ(axiom_xml_reader_feed(reader, m_env, xml.data() + pos, n,
+                pos + n == xml.size()), AXIS2_SUCCESS);
+            pos += n;
+            fed++;
+            continue;
+        }
+        if (event == AXIOM_XML_READER_START_ELEMENT || event == AXIOM_XML_READER_EMPTY_ELEMENT
+            || event == AXIOM_XML_READER_END_ELEMENT)
+        {
+            name = axiom_xml_reader_get_name(reader, m_env);
+            trace += std::string(event == AXIOM_XML_READER_END_ELEMENT ? "/" : "") + name + " ";
+            axiom_xml_reader_xml_free(reader, m_env, name);
+            if (event == AXIOM_XML_READER_END_ELEMENT && trace.find("/x") != std::string::npos)
+                break;
+        }
+        else if (event == AXIOM_XML_READER_CHARACTER)
+        {
+            name = axiom_xml_reader_get_value(reader, m_env);
+            trace += std::string("{") + name + "} ";
+            axiom_xml_reader_xml_free(reader, m_env, name);
+        }
+    }
+    EXPECT_EQ(trace, "x y {text} /y z /x ");
+    EXPECT_GT(fed, 1);
+    axiom_xml_reader_free(reader, m_env);
+}
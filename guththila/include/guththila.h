@@ -68,7 +68,8 @@ enum guththila_event_types
 	GUTHTHILA_COMMENT,
     GUTHTHILA_SPACE, 
 	GUTHTHILA_START_ELEMENT,
-    GUTHTHILA_EMPTY_ELEMENT
+    GUTHTHILA_EMPTY_ELEMENT,
+    GUTHTHILA_NEED_MORE_INPUT	/* A push reader has not been fed the next event whole */
 };
 
 typedef struct guththila_s
@@ -91,19 +92,27 @@ typedef struct guththila_s
 
     guththila_stack_t namesp; /* namespaces are put in a stack */    
 
+    guththila_stack_t values; /* values copied for views, freed at the next event */
+
     int status;
 
     int guththila_event; /* Current event */
 
     size_t next;    /* Keep track of the position in the xml string */
 
-    int last_start; /* Keep track of the starting position of the last token */
+    size_t last_start; /* Keep track of the starting position of the last token, -1 if none */
 
     guththila_token_t *temp_prefix; /* Temporery location for prefixes */
 
     guththila_token_t *temp_name;   /* Temporery location for names */
     
     guththila_token_t *temp_tok;   /* We don't know this until we close it */
+
+    size_t utf8_checked; /* The input before this position is known to be UTF-8 */
+
+    int utf8_check; /* Fail on input that is not UTF-8, see guththila_set_utf8_check */
+
+    int streaming; /* Release the buffers already parsed, see guththila_set_streaming */
 } guththila_t;
 
 /* 
@@ -133,10 +142,40 @@ GUTHTHILA_EXPORT int GUTHTHILA_CALL
 guththila_init(guththila_t * m, void *reader, 
 			   const axutil_env_t * env);
 
+/*
+ * Prepare the parser for another document read with the given reader, as
+ * guththila_un_init followed by guththila_init would, but keeping the memory
+ * allocated for tokens, stacks and buffers. The reader can be NULL to only
+ * give back what was held for the last document; the parser must then be
+ * reset with a reader before it is used again.
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_reset(guththila_t * m, void *reader, 
+			   const axutil_env_t * env);
+
 /* Uninitialize the parser */
 GUTHTHILA_EXPORT int GUTHTHILA_CALL
 guththila_un_init(guththila_t * m, const axutil_env_t * env);
 
+/* Parsers, and writers, a thread keeps for reuse */
+#define GUTHTHILA_POOL_SIZE 4
+
+/*
+ * Get a parser for the reader, reusing one the calling thread gave back with
+ * guththila_pool_put if there is one. Parsers are only reused with envs whose
+ * allocator is heap based. 
+ * @return the parser, NULL on failure
+ */
+GUTHTHILA_EXPORT guththila_t *GUTHTHILA_CALL
+guththila_pool_get(void *reader, const axutil_env_t * env);
+
+/*
+ * Give back a parser got with guththila_pool_get, or made with 
+ * guththila_init. The thread keeps it if it can, else it is un initialized.
+ */
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_pool_put(guththila_t * m, const axutil_env_t * env);
+
 /* Still not used */
 typedef void(GUTHTHILA_CALL * guththila_error_func)(void *arg, 
 													const guththila_char_t *msg, 
@@ -147,6 +186,9 @@ typedef void(GUTHTHILA_CALL * guththila_error_func)(void *arg,
  * Parse the xml and return an event. If something went wrong it will return -1. 
  * The events are of the type guththila_event_types. According to the event 
  * user can get the required information using the appriate functions.
+ * With a push reader GUTHTHILA_NEED_MORE_INPUT is returned, and the parser
+ * left as it was, when the next event has not been fed whole. The call is
+ * made again after feeding more, see guththila_reader_create_for_push.
  * @param g pointer to a guththila_t structure
  * @param env the environment
  */
@@ -326,6 +368,56 @@ GUTHTHILA_EXPORT guththila_char_t *GUTHTHILA_CALL
 guththila_get_attribute_namespace_by_number(guththila_t *g, int index, 
 											const axutil_env_t *env);
 
+/*
+ * The view getters below return the same strings as the getters above
+ * without copying them. A view points into the parser buffer, is not null
+ * terminated and is valid until the next call to guththila_next(). Its
+ * length is put in len. References in values are replaced, in a copy the
+ * parser frees at the next event when there are any.
+ * @param g pointer to a guththila_t structure
+ * @param len set to the length of the view, 0 if there is none
+ * @param env the environment
+ */
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_name_view(guththila_t * g, size_t *len, const axutil_env_t * env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_prefix_view(guththila_t * g, size_t *len, const axutil_env_t * env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_value_view(guththila_t * g, size_t *len, const axutil_env_t * env);
+
+/*
+ * Views of the attribute and namespace at the given position. First one will be 1.
+ * @param g pointer to a guththila_t structure
+ * @param index position of the attribute or namespace
+ * @param len set to the length of the view, 0 if there is none
+ * @param env the environment
+ */
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_attribute_name_view_by_number(guththila_t * g, int index, size_t *len,
+											const axutil_env_t *env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_attribute_prefix_view_by_number(guththila_t * g, int index, size_t *len,
+											  const axutil_env_t *env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_attribute_value_view_by_number(guththila_t * g, int index, size_t *len,
+											 const axutil_env_t *env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_attribute_namespace_view_by_number(guththila_t * g, int index, size_t *len,
+												 const axutil_env_t *env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_namespace_prefix_view_by_number(guththila_t * g, int index, size_t *len,
+											  const axutil_env_t *env);
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL  
+guththila_get_namespace_uri_view_by_number(guththila_t * g, int index, size_t *len,
+										   const axutil_env_t *env);
+
 /*
  * Get the encoding. at the moment we don't support UNICODE
  * @param g pointer to a guththila_t structure
@@ -348,6 +440,40 @@ guththila_get_current_buffer(
     guththila_t * m,
     const axutil_env_t * env);
 
+/*
+ * Switch streaming on or off. By default every buffer read from a file or
+ * IO reader is kept until the parser is freed. In streaming mode buffers are
+ * of the default size, grown only to hold a long token, and a buffer is
+ * released once the parser has gone past it and none of the names of the
+ * open elements, the namespaces in scope or the current event is in it. The
+ * memory used then depends on the nesting and the largest token rather than
+ * on the size of the document. guththila_get_current_buffer returns only
+ * the buffers still held.
+ * @param m pointer to a guththila_t structure
+ * @param streaming 1 to switch streaming on, 0 to switch it off
+ * @param env the environment
+ */
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_set_streaming(
+    guththila_t * m,
+    int streaming,
+    const axutil_env_t * env);
+
+/*
+ * Switch the UTF-8 check on or off. By default the input is only scanned
+ * for markup. When the check is on, the input read from then on is also
+ * checked to be UTF-8, in the same pass as the scan, and guththila_next
+ * fails at the event that holds bytes that are not.
+ * @param m pointer to a guththila_t structure
+ * @param utf8_check 1 to switch the check on, 0 to switch it off
+ * @param env the environment
+ */
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_set_utf8_check(
+    guththila_t * m,
+    int utf8_check,
+    const axutil_env_t * env);
+
 EXTERN_C_END() 
 #endif  
 
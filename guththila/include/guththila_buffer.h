@@ -41,6 +41,7 @@ typedef struct guththila_buffer_s
     unsigned int no_buffers;	/* No of buffers */
     short type;					/* Buffer type */
     guththila_char_t *xml;		/* All the buffers serialized together */
+    guththila_char_t *spare;	/* A released buffer of the default size, kept for reuse */
 } guththila_buffer_t;
 
 #define GUTHTHILA_BUFFER_DEF_SIZE 16384
@@ -112,6 +113,37 @@ guththila_buffer_init_for_buffer(guththila_buffer_t * mu_buff,
 								 int size, 
 								 const axutil_env_t * env);
 
+/**
+ * Empties the buffer so that it can be used again, as if it was un
+ * initialized and initialized with guththila_buffer_init. The arrays are
+ * kept, and so is a buffer of the default size.
+ * @param buffer buffer to reset
+ * @param size size of the first buffer, 0 for none
+ * @param env environment, MUST NOT be NULL.
+ * return status of op AXIS2_SUCCESS on success,
+ * AXIS2_FAILURE on error
+ */
+int GUTHTHILA_CALL 
+guththila_buffer_reset(guththila_buffer_t * buffer,
+					   int size,
+					   const axutil_env_t * env);
+
+/**
+ * Same as guththila_buffer_reset, but the buffer then holds the given
+ * data, as if initialized with guththila_buffer_init_for_buffer.
+ * @param mu_buff buffer to reset
+ * @param buffer data the buffer holds
+ * @param size size of the data
+ * @param env environment, MUST NOT be NULL.
+ * return status of op AXIS2_SUCCESS on success,
+ * AXIS2_FAILURE on error
+ */
+int GUTHTHILA_CALL 
+guththila_buffer_reset_for_buffer(guththila_buffer_t * mu_buff, 
+								  guththila_char_t *buffer, 
+								  int size, 
+								  const axutil_env_t * env);
+
 void *GUTHTHILA_CALL 
 guththila_get_position(guththila_buffer_t * buffer,
 					   int pos, 
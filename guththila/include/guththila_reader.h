@@ -33,7 +33,9 @@ enum guththila_reader_type
 {
     GUTHTHILA_FILE_READER = 1, 
 	GUTHTHILA_IO_READER, 
-	GUTHTHILA_MEMORY_READER
+	GUTHTHILA_MEMORY_READER,
+	GUTHTHILA_MMAP_READER,
+	GUTHTHILA_PUSH_READER
 };
 
 typedef struct guththila_reader_s
@@ -44,8 +46,26 @@ typedef struct guththila_reader_s
     int buff_size;			/* Buff size */
 	GUTHTHILA_READ_INPUT_CALLBACK input_read_callback;	/* Call back */
     void *context;			/* Context */
+    size_t push_len;		/* Bytes fed to a push reader, kept in buff */
+    size_t push_read;		/* Bytes of them given to the parser */
+    size_t push_ready;		/* Bytes up to the end of the last whole event fed */
+    size_t push_scanned;	/* Bytes looked at for the end of an event */
+    int push_state;			/* What the scan is in when it stopped */
+    int push_end;			/* Whether the last bytes have been fed */
 } guththila_reader_t;
 
+/* Whether the whole input of the reader is in buff */
+#ifndef GUTHTHILA_READER_IN_MEMORY
+#define GUTHTHILA_READER_IN_MEMORY(_reader) \
+    ((_reader)->type == GUTHTHILA_MEMORY_READER || (_reader)->type == GUTHTHILA_MMAP_READER)
+#endif
+
+/* Whether the parser can read a whole event, or to the end, from a push reader */
+#ifndef GUTHTHILA_READER_PUSH_READY
+#define GUTHTHILA_READER_PUSH_READY(_reader) \
+    ((_reader)->push_read < (_reader)->push_ready || (_reader)->push_end)
+#endif
+
 #ifndef GUTHTHILA_READER_SET_LAST_START
 #define GUTHTHILA_READER_SET_LAST_START(_reader, _start) ((_reader)->start = _start)
 #endif  
@@ -55,7 +75,8 @@ typedef struct guththila_reader_s
 #endif  
 
 /* 
- * Reading a file.
+ * Reading a file. A regular file is mapped into memory and parsed in place,
+ * anything else, a pipe for one, is read through stdio.
  * @param filename	name of the file
  * @param env environment
  */
@@ -88,6 +109,35 @@ guththila_reader_create_for_memory(
     int size,
     const axutil_env_t * env);
 
+/*
+ * Reading input the caller feeds as it arrives, with guththila_reader_feed.
+ * guththila_next() returns GUTHTHILA_NEED_MORE_INPUT, instead of waiting,
+ * when the next event has not been fed whole, and the same call is made
+ * again after more is fed. Bytes are handed to the parser one whole event
+ * at a time, so the parser never stops in the middle of one.
+ * @param env environment
+ */
+GUTHTHILA_EXPORT guththila_reader_t * GUTHTHILA_CALL
+guththila_reader_create_for_push(
+    const axutil_env_t * env);
+
+/*
+ * Feed bytes to a push reader. The bytes are copied.
+ * @param r reader made with guththila_reader_create_for_push
+ * @param data bytes of the document that follow those already fed
+ * @param len number of bytes, can be 0
+ * @param last non zero when no more bytes follow
+ * @param env environment
+ * @return GUTHTHILA_SUCCESS, GUTHTHILA_FAILURE if out of memory or the end was fed before
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_reader_feed(
+    guththila_reader_t * r,
+    const guththila_char_t * data,
+    size_t len,
+    int last,
+    const axutil_env_t * env);
+
 /* 
  * Read the specified number of character to the given buffer.
  * @param r reader
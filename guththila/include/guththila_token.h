@@ -27,7 +27,7 @@ typedef struct guththila_token_s
 {
     short type;
     guththila_char_t *start;
-    int _start;
+    size_t _start;
     size_t size;
     int last;
     int ref;
@@ -90,6 +90,15 @@ guththila_tok_list_free(
     guththila_tok_list_t * tok_list,
     const axutil_env_t * env);
 
+/*
+ * Release all the tokens to the token list, keeping the memory allocated
+ * for them.
+ */
+void GUTHTHILA_CALL
+guththila_tok_list_reset(
+    guththila_tok_list_t * tok_list,
+    const axutil_env_t * env);
+
 /*
  * Get a token from the list.
  */
@@ -23,6 +23,8 @@
 #include <guththila_buffer.h>
 #include <guththila.h>
 #include <axutil_utils.h>
+#include <axutil_stream.h>
+#include <axutil_buffer_chain.h>
 
 EXTERN_C_START()
 #define GUTHTHILA_XML_WRITER_TOKEN
@@ -39,7 +41,9 @@ is particularly important in very deep XML documents.
 typedef enum guththila_writer_type_s
 {
     GUTHTHILA_WRITER_FILE = 1,
-    GUTHTHILA_WRITER_MEMORY
+    GUTHTHILA_WRITER_MEMORY,
+    GUTHTHILA_WRITER_CHAIN,
+    GUTHTHILA_WRITER_STREAM
 } guththila_writer_type_t;
 
 typedef struct guththila_writer_s
@@ -61,6 +65,21 @@ typedef enum guththila_writer_status_s
     BEGINING
 } guththila_writer_status_t;
 
+/* A namespace guththila_get_prefix_for_namespace found, and its prefix */
+typedef struct guththila_xml_writer_prefix_s
+{
+    guththila_char_t *uri;
+    guththila_char_t *prefix;
+    /* index of the namespace stack entry the prefix was declared in */
+    int stack_no;
+} guththila_xml_writer_prefix_t;
+
+/* Prefixes kept by a writer for guththila_get_prefix_for_namespace */
+#define GUTHTHILA_XML_WRITER_PREFIX_CACHE_SIZE 4
+
+/* Bytes a stream writer keeps before it writes them to the stream, by default */
+#define GUTHTHILA_XML_WRITER_FLUSH_SIZE 16384
+
 /*Main structure which provides the writer capability*/
 typedef struct guththila_xml_writer_s
 {
@@ -70,13 +89,27 @@ typedef struct guththila_xml_writer_s
 #ifdef GUTHTHILA_XML_WRITER_TOKEN
     guththila_tok_list_t tok_list;
 #endif
-    /* Type of this writer. Can be file writer or memory writer */
+    /* Type of this writer. Can be file, memory, chain or stream writer */
     guththila_writer_type_t type;
 
     FILE *out_stream;
     guththila_buffer_t buffer;
     guththila_writer_status_t status;
     int next;
+
+    /* Chain a chain writer appends to. Owned by the caller */
+    axutil_buffer_chain_t *chain;
+    /* Where a chain or stream writer put the last token it wrote */
+    guththila_char_t *last_xtoken;
+
+    /* Stream a stream writer writes to. Owned by the caller */
+    axutil_stream_t *stream;
+    /* Copies of the tokens a stream writer wrote, as it does not keep its output */
+    struct guththila_xml_writer_names_s *names;
+
+    guththila_xml_writer_prefix_t prefixes[GUTHTHILA_XML_WRITER_PREFIX_CACHE_SIZE];
+    /* Entry of prefixes to be replaced next */
+    int next_prefix;
 } guththila_xml_writer_t;
 
 /*TODO: we need to came up with common implementation of followng two structures in writer and reader*/
@@ -138,6 +171,43 @@ GUTHTHILA_EXPORT guththila_xml_writer_t *GUTHTHILA_CALL
 guththila_create_xml_stream_writer_for_memory(
     const axutil_env_t * env);
 
+/* 
+ * Create a writer which appends to a buffer chain. The chain is not freed
+ * with the writer.
+ * @param env pointer to the environment
+ * @param chain chain to append to
+ */
+GUTHTHILA_EXPORT guththila_xml_writer_t *GUTHTHILA_CALL
+guththila_create_xml_stream_writer_for_chain(
+    const axutil_env_t * env,
+    axutil_buffer_chain_t * chain);
+
+/* 
+ * Create a writer which writes to a stream. Output is kept in a buffer and
+ * written to the stream whenever the buffer would overflow, and when the
+ * writer is flushed or freed. The stream is not freed with the writer.
+ * @param env pointer to the environment
+ * @param stream stream to write to
+ * @param flush_size size of the buffer, GUTHTHILA_XML_WRITER_FLUSH_SIZE if 0
+ */
+GUTHTHILA_EXPORT guththila_xml_writer_t *GUTHTHILA_CALL
+guththila_create_xml_stream_writer_for_stream(
+    const axutil_env_t * env,
+    axutil_stream_t * stream,
+    size_t flush_size);
+
+/* 
+ * Write what a stream writer keeps in its buffer to the stream, and flush
+ * a file writer. Nothing to do for other writers.
+ * @param wr pointer to the writer
+ * @param env pointer to the environment
+ * @return GUTHTHILA_SUCCESS, GUTHTHILA_FAILURE if the output could not be written
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_flush(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env);
+
 /* 
  * Jus write what ever the content in the buffer. If the writer was in 
  * a start of a element it will close it.
@@ -504,12 +574,44 @@ guththila_get_memory_buffer_size(
 GUTHTHILA_EXPORT void GUTHTHILA_CALL guththila_xml_writer_free(
     guththila_xml_writer_t * wr,
     const axutil_env_t * env);
+
+/*
+ * Get the writer ready to write another document, keeping the memory
+ * allocated for tokens, stacks and buffers. A memory writer starts again
+ * with an empty buffer; other writers go on writing where they are.
+ * @param wr pointer to the writer
+ * @param env pointer to the environment
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL guththila_xml_writer_reset(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env);
+
+/*
+ * Get a memory writer, reusing one the calling thread gave back with
+ * guththila_xml_writer_pool_put if there is one.
+ * @param env pointer to the environment
+ */
+GUTHTHILA_EXPORT guththila_xml_writer_t *GUTHTHILA_CALL
+guththila_xml_writer_pool_get(
+    const axutil_env_t * env);
+
+/*
+ * Give back a writer. A memory writer is kept by the thread if it can,
+ * other writers are freed.
+ * @param wr pointer to the writer
+ * @param env pointer to the environment
+ */
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_xml_writer_pool_put(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env);
 /*
- * Get the prefix for the namespace.
+ * Get the prefix for the namespace. The prefix belongs to the writer, and
+ * stays valid while the namespace is in scope.
  * @param wr pointer to the writer
  * @namespace namespace uri
  * @param env pointer to the environment
- * @return prefix for the namspace uri
+ * @return prefix for the namspace uri, NULL if it is not declared
  */
 GUTHTHILA_EXPORT char *GUTHTHILA_CALL guththila_get_prefix_for_namespace(
     guththila_xml_writer_t * wr,
@@ -37,6 +37,7 @@ guththila_buffer_init(
     buffer->pre_tot_data = 0;
     buffer->no_buffers = GUTHTHILA_BUFFER_NUMBER_OF_BUFFERS;
     buffer->xml = NULL;
+    buffer->spare = NULL;
     if(size > 0)
     {
         buffer->buff[0] = (guththila_char_t *)AXIS2_MALLOC(env->allocator, sizeof(guththila_char_t)
@@ -64,6 +65,8 @@ guththila_buffer_un_init(
             AXIS2_FREE(env->allocator, buffer->data_size);
         if(buffer->xml)
             AXIS2_FREE(env->allocator, buffer->xml);
+        if(buffer->spare)
+            AXIS2_FREE(env->allocator, buffer->spare);
 
         AXIS2_FREE(env->allocator, buffer->buff);
 
@@ -81,6 +84,8 @@ guththila_buffer_un_init(
             AXIS2_FREE(env->allocator, buffer->data_size);
         if(buffer->buffs_size)
             AXIS2_FREE(env->allocator, buffer->buffs_size);
+        if(buffer->spare)
+            AXIS2_FREE(env->allocator, buffer->spare);
     }
     return GUTHTHILA_SUCCESS;
 }
@@ -92,20 +97,98 @@ guththila_buffer_init_for_buffer(
     int size,
     const axutil_env_t * env)
 {
+    /* the arrays are of the usual size so that the buffer can be reset to
+     * hold multiple buffers */
     buffer->type = GUTHTHILA_SINGLE_BUFFER;
-    buffer->buff
-        = (char **)AXIS2_MALLOC(env->allocator, sizeof(char *) * GUTHTHILA_BUFFER_DEF_SIZE);
+    buffer->buff = (char **)AXIS2_MALLOC(env->allocator, sizeof(char *)
+        * GUTHTHILA_BUFFER_NUMBER_OF_BUFFERS);
     buffer->buff[0] = buff;
     buffer->cur_buff = 0;
     buffer->buffs_size = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t)
-        * GUTHTHILA_BUFFER_DEF_SIZE);
+        * GUTHTHILA_BUFFER_NUMBER_OF_BUFFERS);
     buffer->buffs_size[0] = size;
     buffer->pre_tot_data = 0;
     buffer->data_size = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t)
-        * GUTHTHILA_BUFFER_DEF_SIZE);
+        * GUTHTHILA_BUFFER_NUMBER_OF_BUFFERS);
     buffer->data_size[0] = size;
-    buffer->no_buffers = 1;
+    buffer->no_buffers = GUTHTHILA_BUFFER_NUMBER_OF_BUFFERS;
     buffer->xml = NULL;
+    buffer->spare = NULL;
+    return GUTHTHILA_SUCCESS;
+}
+
+/*
+ * Gives back the buffers holding data, keeping one of the default size as
+ * the spare buffer
+ */
+static void
+guththila_buffer_release(
+    guththila_buffer_t * buffer,
+    const axutil_env_t * env)
+{
+    int i = 0;
+
+    if(buffer->type == GUTHTHILA_MULTIPLE_BUFFER)
+    {
+        for(i = 0; i <= buffer->cur_buff; i++)
+        {
+            if(!buffer->spare && buffer->buffs_size[i] == GUTHTHILA_BUFFER_DEF_SIZE)
+                buffer->spare = buffer->buff[i];
+            else
+                AXIS2_FREE(env->allocator, buffer->buff[i]);
+        }
+    }
+    if(buffer->xml)
+    {
+        AXIS2_FREE(env->allocator, buffer->xml);
+        buffer->xml = NULL;
+    }
+    buffer->cur_buff = -1;
+    buffer->pre_tot_data = 0;
+}
+
+int GUTHTHILA_CALL
+guththila_buffer_reset(
+    guththila_buffer_t * buffer,
+    int size,
+    const axutil_env_t * env)
+{
+    guththila_buffer_release(buffer, env);
+    buffer->type = GUTHTHILA_MULTIPLE_BUFFER;
+    if(size > 0)
+    {
+        if(size == GUTHTHILA_BUFFER_DEF_SIZE && buffer->spare)
+        {
+            buffer->buff[0] = buffer->spare;
+            buffer->spare = NULL;
+        }
+        else
+        {
+            buffer->buff[0] = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
+                sizeof(guththila_char_t) * size);
+            if(!buffer->buff[0])
+                return GUTHTHILA_FAILURE;
+        }
+        buffer->data_size[0] = 0;
+        buffer->buffs_size[0] = size;
+        buffer->cur_buff = 0;
+    }
+    return GUTHTHILA_SUCCESS;
+}
+
+int GUTHTHILA_CALL
+guththila_buffer_reset_for_buffer(
+    guththila_buffer_t * buffer,
+    guththila_char_t *buff,
+    int size,
+    const axutil_env_t * env)
+{
+    guththila_buffer_release(buffer, env);
+    buffer->type = GUTHTHILA_SINGLE_BUFFER;
+    buffer->buff[0] = buff;
+    buffer->buffs_size[0] = size;
+    buffer->data_size[0] = size;
+    buffer->cur_buff = 0;
     return GUTHTHILA_SUCCESS;
 }
 
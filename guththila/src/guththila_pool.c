@@ -0,0 +1,229 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include <guththila.h>
+#include <guththila_xml_writer.h>
+#include <axutil_thread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ * Parsers and memory writers given back are kept by the thread, and handed
+ * out again after a reset, so that a small message does not pay for setting
+ * up the tokens, stacks and buffers.
+ *
+ * What a pooled object holds was allocated with the allocator of the env it
+ * was used with, and it goes on being used with the env of the next caller.
+ * So objects are pooled only for heap based allocators, and are handed out
+ * only to envs whose allocator frees the same way. An arena allocator
+ * releases its memory with the request, so its objects are never pooled.
+ * When the thread exits, the objects left are freed with a slab allocator,
+ * which frees blocks of any heap based allocator.
+ */
+
+typedef struct guththila_pool_s
+{
+    /* how the allocator of the pooled objects frees */
+    void (AXIS2_CALL *free_fn)(struct axutil_allocator *allocator, void *ptr);
+    guththila_t *parsers[GUTHTHILA_POOL_SIZE];
+    int no_parsers;
+    guththila_xml_writer_t *writers[GUTHTHILA_POOL_SIZE];
+    int no_writers;
+} guththila_pool_t;
+
+static axutil_allocator_t *guththila_pool_heap_allocator = NULL;
+static axutil_allocator_t *guththila_pool_slab_allocator = NULL;
+static axutil_env_t *guththila_pool_env = NULL;
+static axutil_threadkey_t *guththila_pool_key = NULL;
+
+#ifdef _WIN32
+static INIT_ONCE guththila_pool_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t guththila_pool_once = PTHREAD_ONCE_INIT;
+#endif
+
+static void AXIS2_CALL
+guththila_pool_free(
+    void *data)
+{
+    guththila_pool_t *pool = (guththila_pool_t *)data;
+    int i = 0;
+
+    for(i = 0; i < pool->no_parsers; i++)
+    {
+        guththila_un_init(pool->parsers[i], guththila_pool_env);
+    }
+    for(i = 0; i < pool->no_writers; i++)
+    {
+        guththila_xml_writer_free(pool->writers[i], guththila_pool_env);
+    }
+    AXIS2_FREE(guththila_pool_slab_allocator, pool);
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK
+guththila_pool_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+guththila_pool_init(
+    void)
+#endif
+{
+    guththila_pool_heap_allocator = axutil_allocator_init(NULL);
+    guththila_pool_slab_allocator = axutil_allocator_slab_create();
+    if(guththila_pool_heap_allocator && guththila_pool_slab_allocator)
+    {
+        guththila_pool_env = axutil_env_create(guththila_pool_slab_allocator);
+    }
+    if(guththila_pool_env)
+    {
+        guththila_pool_key = axutil_threadkey_create(guththila_pool_slab_allocator,
+            guththila_pool_free);
+    }
+#ifdef _WIN32
+    return TRUE;
+#endif
+}
+
+/*
+ * Returns the pool of the calling thread for objects used with env, NULL if
+ * they are not to be pooled. The pool is created when create is set.
+ */
+static guththila_pool_t *
+guththila_pool_get_thread(
+    const axutil_env_t * env,
+    int create)
+{
+    guththila_pool_t *pool = NULL;
+
+#ifdef _WIN32
+    InitOnceExecuteOnce(&guththila_pool_once, guththila_pool_init, NULL, NULL);
+#else
+    pthread_once(&guththila_pool_once, guththila_pool_init);
+#endif
+    if(!guththila_pool_key)
+        return NULL;
+    if(env->allocator->free_fn != guththila_pool_heap_allocator->free_fn
+        && env->allocator->free_fn != guththila_pool_slab_allocator->free_fn)
+        return NULL;
+
+    pool = (guththila_pool_t *)axutil_thread_getspecific(guththila_pool_key);
+    if(!pool && create)
+    {
+        pool = (guththila_pool_t *)AXIS2_MALLOC(guththila_pool_slab_allocator,
+            sizeof(guththila_pool_t));
+        if(!pool)
+            return NULL;
+        memset(pool, 0, sizeof(guththila_pool_t));
+        if(axutil_thread_setspecific(guththila_pool_key, pool) != AXIS2_SUCCESS)
+        {
+            AXIS2_FREE(guththila_pool_slab_allocator, pool);
+            return NULL;
+        }
+    }
+    if(pool && pool->free_fn && pool->free_fn != env->allocator->free_fn)
+        return NULL;
+    return pool;
+}
+
+GUTHTHILA_EXPORT guththila_t *GUTHTHILA_CALL
+guththila_pool_get(
+    void *reader,
+    const axutil_env_t * env)
+{
+    guththila_pool_t *pool = NULL;
+    guththila_t *m = NULL;
+
+    if(!reader)
+        return NULL;
+    pool = guththila_pool_get_thread(env, 0);
+    if(pool && pool->no_parsers > 0)
+    {
+        m = pool->parsers[--pool->no_parsers];
+        if(guththila_reset(m, reader, env) == GUTHTHILA_SUCCESS)
+            return m;
+        guththila_un_init(m, env);
+    }
+
+    m = (guththila_t *)AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+    if(!m)
+        return NULL;
+    if(guththila_init(m, reader, env) != GUTHTHILA_SUCCESS)
+    {
+        AXIS2_FREE(env->allocator, m);
+        return NULL;
+    }
+    return m;
+}
+
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_pool_put(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    guththila_pool_t *pool = guththila_pool_get_thread(env, 1);
+
+    /* the memory held for the document is given back before the parser is kept */
+    if(pool && pool->no_parsers < GUTHTHILA_POOL_SIZE
+        && guththila_reset(m, NULL, env) == GUTHTHILA_SUCCESS)
+    {
+        pool->free_fn = env->allocator->free_fn;
+        pool->parsers[pool->no_parsers++] = m;
+        return;
+    }
+    guththila_un_init(m, env);
+}
+
+GUTHTHILA_EXPORT guththila_xml_writer_t *GUTHTHILA_CALL
+guththila_xml_writer_pool_get(
+    const axutil_env_t * env)
+{
+    guththila_pool_t *pool = guththila_pool_get_thread(env, 0);
+
+    if(pool && pool->no_writers > 0)
+    {
+        return pool->writers[--pool->no_writers];
+    }
+    return guththila_create_xml_stream_writer_for_memory(env);
+}
+
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_xml_writer_pool_put(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env)
+{
+    guththila_pool_t *pool = NULL;
+
+    if(wr->type == GUTHTHILA_WRITER_MEMORY)
+    {
+        pool = guththila_pool_get_thread(env, 1);
+    }
+    if(pool && pool->no_writers < GUTHTHILA_POOL_SIZE
+        && guththila_xml_writer_reset(wr, env) == GUTHTHILA_SUCCESS)
+    {
+        pool->free_fn = env->allocator->free_fn;
+        pool->writers[pool->no_writers++] = wr;
+        return;
+    }
+    guththila_xml_writer_free(wr, env);
+}
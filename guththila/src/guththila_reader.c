@@ -14,9 +14,69 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+
+/* mmap and madvise are not in ANSI C */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <guththila_reader.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * Maps a regular file, so that the parser reads it in place as it reads a
+ * memory buffer. Returns 0 when the file can not be mapped, pipes and devices
+ * for one, and is to be read through stdio instead.
+ */
+static int
+guththila_reader_map_file(
+    guththila_reader_t * reader,
+    const char *file_name)
+{
+    struct stat st;
+    void *map = NULL;
+    int fd = -1;
+
+    /* look before opening, as opening a fifo waits for a writer */
+    if(stat(file_name, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        return 0;
+    }
+    fd = open(file_name, O_RDONLY);
+    if(fd < 0)
+    {
+        return 0;
+    }
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > INT_MAX)
+    {
+        close(fd);
+        return 0;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        return 0;
+    }
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    reader->type = GUTHTHILA_MMAP_READER;
+    reader->buff = (guththila_char_t *)map;
+    reader->buff_size = (int)st.st_size;
+    reader->fp = NULL;
+    reader->input_read_callback = NULL;
+    reader->context = NULL;
+    return 1;
+}
+#endif
 
 GUTHTHILA_EXPORT guththila_reader_t * GUTHTHILA_CALL
 guththila_reader_create_for_file(
@@ -42,6 +102,13 @@ guththila_reader_create_for_file(
         return NULL;
     }
 
+#ifndef _WIN32
+    if(guththila_reader_map_file(reader, file_name))
+    {
+        return reader;
+    }
+#endif
+
     f = fopen(file_name, "r");
     if(!f)
     {
@@ -110,6 +177,256 @@ guththila_reader_create_for_io(
     return reader;
 }
 
+/* What the scan of the input fed to a push reader is in */
+enum guththila_push_state
+{
+    GUTHTHILA_PUSH_TEXT = 0,	/* Text, or between markup */
+    GUTHTHILA_PUSH_TAG,			/* A start or end tag */
+    GUTHTHILA_PUSH_QUOT,		/* A value in double quotes */
+    GUTHTHILA_PUSH_APOS,		/* A value in single quotes */
+    GUTHTHILA_PUSH_COMMENT,
+    GUTHTHILA_PUSH_CDATA,
+    GUTHTHILA_PUSH_PI,			/* The xml declaration */
+    GUTHTHILA_PUSH_DECL			/* A DOCTYPE, which the parser reads past the end of */
+};
+
+/* The least a push reader allocates for the input it holds */
+#define GUTHTHILA_PUSH_MIN_SIZE 4096
+
+GUTHTHILA_EXPORT guththila_reader_t * GUTHTHILA_CALL
+guththila_reader_create_for_push(
+    const axutil_env_t * env)
+{
+    guththila_reader_t * reader;
+    reader = (guththila_reader_t *)AXIS2_MALLOC(env->allocator, sizeof(guththila_reader_t));
+    if(!reader)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+            "[guththila]insufficient memory to create guththila parser");
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    reader->type = GUTHTHILA_PUSH_READER;
+    reader->buff = NULL;
+    reader->buff_size = 0;
+    reader->fp = NULL;
+    reader->input_read_callback = NULL;
+    reader->context = NULL;
+    reader->push_len = 0;
+    reader->push_read = 0;
+    reader->push_ready = 0;
+    reader->push_scanned = 0;
+    reader->push_state = GUTHTHILA_PUSH_TEXT;
+    reader->push_end = 0;
+    return reader;
+}
+
+/*
+ * Scans what was fed since the last scan, moving push_ready to the end of
+ * the last whole event. An event ends with the '>' of a tag, a comment, a
+ * CDATA section or the xml declaration; text ends where the markup after it
+ * starts, so it is ready with that markup. The scan stops short of the end
+ * when it needs a few more bytes to tell what a '<' or a closing sequence
+ * is, and goes on from there with the next bytes fed, so that every byte is
+ * looked at once.
+ */
+static void
+guththila_reader_push_scan(
+    guththila_reader_t * r)
+{
+    const guththila_char_t *b = r->buff;
+    const guththila_char_t *p = NULL;
+    size_t i = r->push_scanned, len = r->push_len;
+    int wait = 0;
+
+    while(i < len && !wait)
+    {
+        switch(r->push_state)
+        {
+            case GUTHTHILA_PUSH_TEXT:
+                p = (const guththila_char_t *)memchr(b + i, '<', len - i);
+                if(!p)
+                {
+                    i = len;
+                    break;
+                }
+                i = p - b;
+                if(len - i < 2)
+                {
+                    wait = 1;
+                }
+                else if(b[i + 1] == '?')
+                {
+                    r->push_state = GUTHTHILA_PUSH_PI;
+                    i += 2;
+                }
+                else if(b[i + 1] != '!')
+                {
+                    r->push_state = GUTHTHILA_PUSH_TAG;
+                    i++;
+                }
+                else if(len - i < 4)
+                {
+                    wait = 1;
+                }
+                else if(!memcmp(b + i, "<!--", 4))
+                {
+                    r->push_state = GUTHTHILA_PUSH_COMMENT;
+                    i += 4;
+                }
+                else if(b[i + 2] == '[' && len - i < 9)
+                {
+                    wait = 1;
+                }
+                else if(b[i + 2] == '[' && !memcmp(b + i, "<![CDATA[", 9))
+                {
+                    r->push_state = GUTHTHILA_PUSH_CDATA;
+                    i += 9;
+                }
+                else
+                {
+                    r->push_state = GUTHTHILA_PUSH_DECL;
+                    i += 2;
+                }
+                break;
+            case GUTHTHILA_PUSH_TAG:
+                while(i < len && b[i] != '>' && b[i] != '"' && b[i] != '\'')
+                    i++;
+                if(i == len)
+                    break;
+                if(b[i] == '>')
+                {
+                    r->push_state = GUTHTHILA_PUSH_TEXT;
+                    r->push_ready = i + 1;
+                }
+                else
+                {
+                    r->push_state = b[i] == '"' ? GUTHTHILA_PUSH_QUOT : GUTHTHILA_PUSH_APOS;
+                }
+                i++;
+                break;
+            case GUTHTHILA_PUSH_QUOT:
+            case GUTHTHILA_PUSH_APOS:
+                p = (const guththila_char_t *)memchr(b + i,
+                    r->push_state == GUTHTHILA_PUSH_QUOT ? '"' : '\'', len - i);
+                if(!p)
+                {
+                    i = len;
+                    break;
+                }
+                r->push_state = GUTHTHILA_PUSH_TAG;
+                i = p - b + 1;
+                break;
+            case GUTHTHILA_PUSH_DECL:
+                p = (const guththila_char_t *)memchr(b + i, '>', len - i);
+                if(!p)
+                {
+                    i = len;
+                    break;
+                }
+                /* the parser goes on to the next markup, so this is not the end of an event */
+                r->push_state = GUTHTHILA_PUSH_TEXT;
+                i = p - b + 1;
+                break;
+            default:
+                /* "-->", "]]>" or "?>" ends the comment, CDATA section or declaration */
+                p = (const guththila_char_t *)memchr(b + i,
+                    r->push_state == GUTHTHILA_PUSH_COMMENT ? '-' :
+                    r->push_state == GUTHTHILA_PUSH_CDATA ? ']' : '?', len - i);
+                if(!p)
+                {
+                    i = len;
+                    break;
+                }
+                i = p - b;
+                if(r->push_state == GUTHTHILA_PUSH_PI ? len - i < 2 : len - i < 3)
+                {
+                    wait = 1;
+                }
+                else if((r->push_state == GUTHTHILA_PUSH_COMMENT && !memcmp(b + i, "-->", 3))
+                    || (r->push_state == GUTHTHILA_PUSH_CDATA && !memcmp(b + i, "]]>", 3))
+                    || (r->push_state == GUTHTHILA_PUSH_PI && b[i + 1] == '>'))
+                {
+                    i += r->push_state == GUTHTHILA_PUSH_PI ? 2 : 3;
+                    r->push_state = GUTHTHILA_PUSH_TEXT;
+                    r->push_ready = i;
+                }
+                else
+                {
+                    i++;
+                }
+                break;
+        }
+    }
+    r->push_scanned = i;
+}
+
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_reader_feed(
+    guththila_reader_t * r,
+    const guththila_char_t * data,
+    size_t len,
+    int last,
+    const axutil_env_t * env)
+{
+    size_t unread, size;
+    guththila_char_t *buff = NULL;
+
+    if(r->type != GUTHTHILA_PUSH_READER || r->push_end)
+    {
+        return GUTHTHILA_FAILURE;
+    }
+    if(len > 0)
+    {
+        /* make room by dropping what the parser has read, growing when less than half is free */
+        unread = r->push_len - r->push_read;
+        if(r->push_len + len > (size_t)r->buff_size)
+        {
+            if(unread + len > (size_t)r->buff_size / 2)
+            {
+                size = r->buff_size ? (size_t)r->buff_size : GUTHTHILA_PUSH_MIN_SIZE;
+                while(size < 2 * (unread + len))
+                    size *= 2;
+                if(size > INT_MAX)
+                {
+                    AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+                    return GUTHTHILA_FAILURE;
+                }
+                buff = (guththila_char_t *)AXIS2_MALLOC(env->allocator, size);
+                if(!buff)
+                {
+                    AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+                    return GUTHTHILA_FAILURE;
+                }
+                if(unread)
+                    memcpy(buff, r->buff + r->push_read, unread);
+                if(r->buff)
+                    AXIS2_FREE(env->allocator, r->buff);
+                r->buff = buff;
+                r->buff_size = (int)size;
+            }
+            else if(unread)
+            {
+                memmove(r->buff, r->buff + r->push_read, unread);
+            }
+            r->push_len -= r->push_read;
+            r->push_ready -= r->push_read;
+            r->push_scanned -= r->push_read;
+            r->push_read = 0;
+        }
+        memcpy(r->buff + r->push_len, data, len);
+        r->push_len += len;
+        guththila_reader_push_scan(r);
+    }
+    if(last)
+    {
+        r->push_end = 1;
+        r->push_ready = r->push_len;
+    }
+    return GUTHTHILA_SUCCESS;
+}
+
 GUTHTHILA_EXPORT void GUTHTHILA_CALL
 guththila_reader_free(
     guththila_reader_t * r,
@@ -119,10 +436,20 @@ guththila_reader_free(
     {
         fclose(r->fp);
     }
+#ifndef _WIN32
+    if(r->type == GUTHTHILA_MMAP_READER && r->buff)
+    {
+        munmap(r->buff, (size_t)r->buff_size);
+    }
+#endif
     if(r->type == GUTHTHILA_IO_READER && r->context)
     {
         AXIS2_FREE(env->allocator, r->context);
     }
+    if(r->type == GUTHTHILA_PUSH_READER && r->buff)
+    {
+        AXIS2_FREE(env->allocator, r->buff);
+    }
     AXIS2_FREE(env->allocator, r);
 
 }
@@ -136,12 +463,21 @@ guththila_reader_read(
     const axutil_env_t * env)
 {
     int rt = r->type;
+    size_t n;
     switch(rt)
     {
         case GUTHTHILA_FILE_READER:
             return (int)fread(buffer + offset, 1, length, r->fp);
         case GUTHTHILA_IO_READER:
             return r->input_read_callback((buffer + offset), length, r->context);
+        case GUTHTHILA_PUSH_READER:
+            /* only whole events, see guththila_reader_push_scan */
+            n = r->push_ready - r->push_read;
+            if(n > (size_t)length)
+                n = (size_t)length;
+            memcpy(buffer + offset, r->buff + r->push_read, n);
+            r->push_read += n;
+            return (int)n;
         default:
             return 0;
     }
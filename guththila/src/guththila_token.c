@@ -133,6 +133,23 @@ guththila_tok_list_free_data(
     AXIS2_FREE(env->allocator, tok_list->list);
 }
 
+void GUTHTHILA_CALL
+guththila_tok_list_reset(
+    guththila_tok_list_t * tok_list,
+    const axutil_env_t * env)
+{
+    int i = 0, j = 0;
+
+    tok_list->fr_stack.top = 0;
+    for(i = 0; i <= tok_list->cur_list; i++)
+    {
+        for(j = 0; j < tok_list->capacity[i]; j++)
+        {
+            guththila_stack_push(&tok_list->fr_stack, &tok_list->list[i][j], env);
+        }
+    }
+}
+
 guththila_token_t *GUTHTHILA_CALL
 guththila_tok_list_get_token(
     guththila_tok_list_t * tok_list,
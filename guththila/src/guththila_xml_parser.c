@@ -24,7 +24,8 @@
 #define GUTHTHILA_VALIDATION_PARSER
 
 /*
- * Read the next char from the reader and return it.
+ * Read the next char from the reader and return it, as an unsigned char so that it is not
+ * taken for the end of input.
  */
 static int
 guththila_next_char(
@@ -41,7 +42,7 @@ guththila_next_char(
     int result_found = 0;\
     if(!buffer)\
     {\
-        if(m->reader->type == GUTHTHILA_MEMORY_READER)\
+        if(GUTHTHILA_READER_IN_MEMORY(m->reader))\
         {\
             buffer = m->buffer.buff[0];\
             data_size = m->buffer.data_size[0];\
@@ -77,7 +78,7 @@ guththila_next_char(
             buffer = NULL;\
             data_size = -1;\
             --(m->next);\
-            if(m->reader->type == GUTHTHILA_MEMORY_READER)\
+            if(GUTHTHILA_READER_IN_MEMORY(m->reader))\
             {\
                 return -1;\
             }\
@@ -121,17 +122,1356 @@ guththila_process_xml_dec(
     guththila_t * m,
     const axutil_env_t * env);
 
+/*
+ * Free the values made for the views of the current event.
+ */
+static void
+guththila_release_values(
+    guththila_t * m,
+    const axutil_env_t * env);
+
 /*
  * Return non zero value if the given argument is a space. (c < 0x21) is added to improve the
  * performance. common case is printable characters. and if given character is printable, we can
  * return false immediately.
  */
-#define GUTHTHILA_IS_SPACE(c) ((c < 0x21) && (c == 0x20 || c == 0xD || c == 0xA || c == 0x9))
+#define GUTHTHILA_IS_SPACE(c) ((c < 0x21) && (c == 0x20 || c == 0xD || c == 0xA || c == 0x9))
+
+/* 
+ * Read characters until all the white spaces are read.
+ */
+#define GUTHTHILA_SKIP_SPACES(m, c, buffer, data_size, previous_size, _env)while(GUTHTHILA_IS_SPACE(c)){GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, _env, c);}
+
+/*
+ * Fast paths for the loops that step through names, attribute values, text and white space.
+ * Before reading the next character, such a loop lets a scanner move m->next over the run of
+ * bytes in the current buffer that it would only step through, so GUTHTHILA_NEXT_CHAR reads the
+ * byte that ends the run. A scanner may stop earlier than the loop would, and the loop simply
+ * goes on. Names are short, and are scanned 16 bytes at a time at most.
+ *
+ * By default the input is not checked to be UTF-8, and text and attribute values are scanned
+ * 256 bytes at a time with AVX-512 when the CPU has it, and with memchr elsewhere, which keeps
+ * up with the memory. When the check is on, see guththila_set_utf8_check, they are scanned 16
+ * bytes at a time with SSE2, 64 with AVX2 when the CPU has it, and a word at a time elsewhere,
+ * and the input is checked as it is scanned. With AVX2, or AVX-512 when the CPU has it, text and
+ * attribute values are checked in the same pass that looks for the delimiter, and blocks of
+ * ASCII are only scanned. Elsewhere the scan tells whether a run holds any non ASCII byte, and
+ * only then is it checked, a block at a time so that the check reads the run while it is still
+ * in the cache. m->utf8_checked tells how far the input has been checked. The scans also tell
+ * whether a run holds a reference, so that references are only replaced where there are some.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define GUTHTHILA_SCAN_SSE2
+#define GUTHTHILA_SCAN_AVX2
+#define GUTHTHILA_SCAN_TARGET(isa) __attribute__((target(isa)))
+#define GUTHTHILA_SCAN_FIRST_BIT(mask) __builtin_ctz(mask)
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GUTHTHILA_SCAN_SSE2
+#include <emmintrin.h>
+#include <intrin.h>
+static int
+guththila_scan_first_bit(
+    unsigned int mask)
+{
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return (int)i;
+}
+#define GUTHTHILA_SCAN_FIRST_BIT(mask) guththila_scan_first_bit(mask)
+#endif
+
+/* Bytes scanned and checked at a time */
+#define GUTHTHILA_SCAN_BLOCK 4096
+
+/* What a scanner found before it stopped */
+#define GUTHTHILA_SCAN_HIGH 1  /* a byte that is not ASCII */
+#define GUTHTHILA_SCAN_REF 2   /* a '&' */
+
+/* Word at a time tests, see "Bit Twiddling Hacks". Each tells whether any byte of x matches. */
+#define GUTHTHILA_SCAN_ONES ((size_t)-1 / 0xFF)
+#define GUTHTHILA_SCAN_HIGHS (GUTHTHILA_SCAN_ONES * 0x80)
+#define GUTHTHILA_SCAN_HAS_LESS(x, n) (((x) - GUTHTHILA_SCAN_ONES * (n)) & ~(x) & GUTHTHILA_SCAN_HIGHS)
+#define GUTHTHILA_SCAN_HAS_BYTE(x, b) GUTHTHILA_SCAN_HAS_LESS((x) ^ (GUTHTHILA_SCAN_ONES * (b)), 1)
+
+/* Names end at white space, '>', '/', '=' or ':' */
+#define GUTHTHILA_SCAN_IS_NAME_END(b) \
+    ((b) < 0x21 || (b) == '>' || (b) == '/' || (b) == '=' || (b) == ':')
+
+#ifdef GUTHTHILA_SCAN_AVX2
+static int guththila_scan_has_avx2 = -1;
+static int guththila_scan_has_avx512 = 0;
+
+#define GUTHTHILA_SCAN_USE_AVX2() \
+    (guththila_scan_has_avx2 < 0 ? guththila_scan_detect_avx2() : guththila_scan_has_avx2)
+
+static int
+guththila_scan_detect_avx2(
+    void)
+{
+    __builtin_cpu_init();
+    guththila_scan_has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    guththila_scan_has_avx512 = __builtin_cpu_supports("avx512bw") ? 1 : 0;
+    return guththila_scan_has_avx2;
+}
+
+#define GUTHTHILA_SCAN_USE_AVX512() (GUTHTHILA_SCAN_USE_AVX2() && guththila_scan_has_avx512)
+#endif
+
+/*
+ * Returns the offset of the first delim in p, or len, and adds what it found before to *flags.
+ */
+static size_t
+guththila_scan_delim_scalar(
+    const unsigned char *p,
+    size_t len,
+    int delim,
+    int *flags)
+{
+    size_t i = 0;
+    size_t word;
+    size_t highs = 0, refs = 0;
+
+    for(; i + sizeof(word) <= len; i += sizeof(word))
+    {
+        memcpy(&word, p + i, sizeof(word));
+        if(GUTHTHILA_SCAN_HAS_BYTE(word, delim))
+        {
+            break;
+        }
+        highs |= word;
+        refs |= GUTHTHILA_SCAN_HAS_BYTE(word, '&');
+    }
+    if(highs & GUTHTHILA_SCAN_HIGHS)
+    {
+        *flags |= GUTHTHILA_SCAN_HIGH;
+    }
+    if(refs)
+    {
+        *flags |= GUTHTHILA_SCAN_REF;
+    }
+    for(; i < len && p[i] != delim; i++)
+    {
+        if(p[i] & 0x80)
+        {
+            *flags |= GUTHTHILA_SCAN_HIGH;
+        }
+        else if(p[i] == '&')
+        {
+            *flags |= GUTHTHILA_SCAN_REF;
+        }
+    }
+    return i;
+}
+
+/*
+ * Returns the offset of the first byte in p that ends a name, or len, and adds what it found
+ * before to *flags.
+ */
+static size_t
+guththila_scan_name_scalar(
+    const unsigned char *p,
+    size_t len,
+    int *flags)
+{
+    size_t i;
+
+    for(i = 0; i < len && !GUTHTHILA_SCAN_IS_NAME_END(p[i]); i++)
+    {
+        if(p[i] & 0x80)
+        {
+            *flags |= GUTHTHILA_SCAN_HIGH;
+        }
+    }
+    return i;
+}
+
+/*
+ * Returns the offset of the first byte in p that is not white space, or len.
+ */
+static size_t
+guththila_scan_spaces_scalar(
+    const unsigned char *p,
+    size_t len)
+{
+    size_t i = 0;
+    while(i < len && GUTHTHILA_IS_SPACE(p[i]))
+    {
+        i++;
+    }
+    return i;
+}
+
+#ifdef GUTHTHILA_SCAN_SSE2
+
+static size_t
+guththila_scan_delim_sse2(
+    const unsigned char *p,
+    size_t len,
+    int delim,
+    int *flags)
+{
+    size_t i = 0;
+    int mask, before;
+    __m128i v;
+    __m128i highs = _mm_setzero_si128();
+    __m128i refs = _mm_setzero_si128();
+    __m128i d = _mm_set1_epi8((char)delim);
+    __m128i amp = _mm_set1_epi8('&');
+
+    for(; i + 16 <= len; i += 16)
+    {
+        v = _mm_loadu_si128((const __m128i *)(p + i));
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, d));
+        if(mask)
+        {
+            before = (1 << GUTHTHILA_SCAN_FIRST_BIT(mask)) - 1;
+            if(_mm_movemask_epi8(highs) || (_mm_movemask_epi8(v) & before))
+            {
+                *flags |= GUTHTHILA_SCAN_HIGH;
+            }
+            if(_mm_movemask_epi8(refs) || (_mm_movemask_epi8(_mm_cmpeq_epi8(v, amp)) & before))
+            {
+                *flags |= GUTHTHILA_SCAN_REF;
+            }
+            return i + GUTHTHILA_SCAN_FIRST_BIT(mask);
+        }
+        highs = _mm_or_si128(highs, v);
+        refs = _mm_or_si128(refs, _mm_cmpeq_epi8(v, amp));
+    }
+    if(_mm_movemask_epi8(highs))
+    {
+        *flags |= GUTHTHILA_SCAN_HIGH;
+    }
+    if(_mm_movemask_epi8(refs))
+    {
+        *flags |= GUTHTHILA_SCAN_REF;
+    }
+    return i + guththila_scan_delim_scalar(p + i, len - i, delim, flags);
+}
+
+static size_t
+guththila_scan_name_sse2(
+    const unsigned char *p,
+    size_t len,
+    int *flags)
+{
+    int mask;
+    __m128i v, m;
+    __m128i space = _mm_set1_epi8(0x20);
+
+    if(len < 16)
+    {
+        return guththila_scan_name_scalar(p, len, flags);
+    }
+    v = _mm_loadu_si128((const __m128i *)p);
+    /* max(v, 0x20) is 0x20 only for white space and other control characters */
+    m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, space), space),
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('>'))), _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v,
+        _mm_set1_epi8('/')), _mm_cmpeq_epi8(v, _mm_set1_epi8('='))), _mm_cmpeq_epi8(v,
+        _mm_set1_epi8(':'))));
+    mask = _mm_movemask_epi8(m);
+    if(!mask)
+    {
+        /* a long name, the loop goes on from here */
+        if(_mm_movemask_epi8(v))
+        {
+            *flags |= GUTHTHILA_SCAN_HIGH;
+        }
+        return 16;
+    }
+    mask = GUTHTHILA_SCAN_FIRST_BIT(mask);
+    if(_mm_movemask_epi8(v) & ((1 << mask) - 1))
+    {
+        *flags |= GUTHTHILA_SCAN_HIGH;
+    }
+    return mask;
+}
+
+static size_t
+guththila_scan_spaces_sse2(
+    const unsigned char *p,
+    size_t len)
+{
+    size_t i = 0;
+    int mask;
+    __m128i v;
+    __m128i sp = _mm_set1_epi8(0x20);
+    __m128i tab = _mm_set1_epi8(0x9);
+    __m128i lf = _mm_set1_epi8(0xA);
+    __m128i cr = _mm_set1_epi8(0xD);
+
+    for(; i + 16 <= len; i += 16)
+    {
+        v = _mm_loadu_si128((const __m128i *)(p + i));
+        mask = ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp),
+            _mm_cmpeq_epi8(v, tab)), _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr))))
+            & 0xFFFF;
+        if(mask)
+        {
+            return i + GUTHTHILA_SCAN_FIRST_BIT(mask);
+        }
+    }
+    return i + guththila_scan_spaces_scalar(p + i, len - i);
+}
+
+#endif
+
+#ifdef GUTHTHILA_SCAN_AVX2
+
+/*
+ * Scans 32 bytes at a time, and returns where it stopped, or the offset of the bytes left over.
+ * The caller scans those with SSE2 once the AVX state is cleared on return.
+ */
+GUTHTHILA_SCAN_TARGET("avx2")
+static size_t
+guththila_scan_delim_avx2(
+    const unsigned char *p,
+    size_t len,
+    int delim,
+    int *flags)
+{
+    size_t i = 0;
+    unsigned int mask, before;
+    __m256i v, w, m;
+    __m256i highs = _mm256_setzero_si256();
+    __m256i refs = _mm256_setzero_si256();
+    __m256i d = _mm256_set1_epi8((char)delim);
+    __m256i amp = _mm256_set1_epi8('&');
+
+    /* two vectors a step while there is no stop, then one to find where it is */
+    for(; i + 64 <= len; i += 64)
+    {
+        v = _mm256_loadu_si256((const __m256i *)(p + i));
+        w = _mm256_loadu_si256((const __m256i *)(p + i + 32));
+        m = _mm256_or_si256(_mm256_cmpeq_epi8(v, d), _mm256_cmpeq_epi8(w, d));
+        if(!_mm256_testz_si256(m, m))
+        {
+            break;
+        }
+        highs = _mm256_or_si256(highs, _mm256_or_si256(v, w));
+        refs = _mm256_or_si256(refs, _mm256_or_si256(_mm256_cmpeq_epi8(v, amp),
+            _mm256_cmpeq_epi8(w, amp)));
+    }
+    for(; i + 32 <= len; i += 32)
+    {
+        v = _mm256_loadu_si256((const __m256i *)(p + i));
+        mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, d));
+        if(mask)
+        {
+            /* the shift is done in two steps, as the stop may be the last byte */
+            before = ((2u << GUTHTHILA_SCAN_FIRST_BIT(mask)) >> 1) - 1;
+            if(_mm256_movemask_epi8(highs) || ((unsigned int)_mm256_movemask_epi8(v) & before))
+            {
+                *flags |= GUTHTHILA_SCAN_HIGH;
+            }
+            if(_mm256_movemask_epi8(refs) || ((unsigned int)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, amp)) & before))
+            {
+                *flags |= GUTHTHILA_SCAN_REF;
+            }
+            return i + GUTHTHILA_SCAN_FIRST_BIT(mask);
+        }
+        highs = _mm256_or_si256(highs, v);
+        refs = _mm256_or_si256(refs, _mm256_cmpeq_epi8(v, amp));
+    }
+    if(_mm256_movemask_epi8(highs))
+    {
+        *flags |= GUTHTHILA_SCAN_HIGH;
+    }
+    if(_mm256_movemask_epi8(refs))
+    {
+        *flags |= GUTHTHILA_SCAN_REF;
+    }
+    return i;
+}
+
+#endif
+
+/*
+ * Returns the offset of the first delim in p, or len, and adds what it found before to *flags.
+ */
+static size_t
+guththila_scan_delim(
+    const unsigned char *p,
+    size_t len,
+    int delim,
+    int *flags)
+{
+#ifdef GUTHTHILA_SCAN_AVX2
+    size_t i;
+
+    if(len >= 64 && GUTHTHILA_SCAN_USE_AVX2())
+    {
+        i = guththila_scan_delim_avx2(p, len & ~(size_t)31, delim, flags);
+        if(i < (len & ~(size_t)31))
+        {
+            return i;
+        }
+        return i + guththila_scan_delim_sse2(p + i, len - i, delim, flags);
+    }
+#endif
+#ifdef GUTHTHILA_SCAN_SSE2
+    return guththila_scan_delim_sse2(p, len, delim, flags);
+#else
+    return guththila_scan_delim_scalar(p, len, delim, flags);
+#endif
+}
+
+/*
+ * Returns the offset in p of the first byte that ends a name, or of a byte in the name from
+ * where the rest is to be scanned, and adds what it found before to *flags.
+ */
+static size_t
+guththila_scan_name(
+    const unsigned char *p,
+    size_t len,
+    int *flags)
+{
+#ifdef GUTHTHILA_SCAN_SSE2
+    return guththila_scan_name_sse2(p, len, flags);
+#else
+    return guththila_scan_name_scalar(p, len, flags);
+#endif
+}
+
+/*
+ * Returns the offset of the first byte in p that is not white space, or len.
+ */
+static size_t
+guththila_scan_spaces(
+    const unsigned char *p,
+    size_t len)
+{
+#ifdef GUTHTHILA_SCAN_SSE2
+    return guththila_scan_spaces_sse2(p, len);
+#else
+    return guththila_scan_spaces_scalar(p, len);
+#endif
+}
+
+/*
+ * Checks that p to end is UTF-8, p being the start of a character. A sequence cut short by end
+ * is accepted if partial is set, as the rest of it has not been read yet.
+ * Returns where the check stopped, that is end or the start of the sequence cut short, or NULL
+ * if p to end is not UTF-8.
+ */
+static const unsigned char *
+guththila_utf8_check_scalar(
+    const unsigned char *p,
+    const unsigned char *end,
+    int partial)
+{
+    const unsigned char *lead;
+    unsigned char lo, hi;
+    size_t word;
+    int n;
+
+    while(p < end)
+    {
+        if(*p < 0x80)
+        {
+            p++;
+            while(p + sizeof(word) <= end)
+            {
+                memcpy(&word, p, sizeof(word));
+                if(word & GUTHTHILA_SCAN_HIGHS)
+                {
+                    break;
+                }
+                p += sizeof(word);
+            }
+            continue;
+        }
+        lead = p;
+        lo = 0x80;
+        hi = 0xBF;
+        if(*p < 0xC2)
+        {
+            return NULL;
+        }
+        else if(*p < 0xE0)
+        {
+            n = 1;
+        }
+        else if(*p < 0xF0)
+        {
+            n = 2;
+            if(*p == 0xE0)
+                lo = 0xA0; /* overlong */
+            else if(*p == 0xED)
+                hi = 0x9F; /* surrogates */
+        }
+        else if(*p < 0xF5)
+        {
+            n = 3;
+            if(*p == 0xF0)
+                lo = 0x90; /* overlong */
+            else if(*p == 0xF4)
+                hi = 0x8F; /* above U+10FFFF */
+        }
+        else
+        {
+            return NULL;
+        }
+        p++;
+        if(p < end && (*p < lo || *p > hi))
+        {
+            return NULL;
+        }
+        for(; n > 0 && p < end; n--, p++)
+        {
+            if((*p & 0xC0) != 0x80)
+            {
+                return NULL;
+            }
+        }
+        if(n > 0)
+        {
+            return partial ? lead : NULL;
+        }
+    }
+    return p;
+}
+
+#ifdef GUTHTHILA_SCAN_AVX2
+
+/*
+ * Checks 32 bytes at a time with the lookup method of Keiser and Lemire, "Validating UTF-8 In
+ * Less Than One Instruction Per Byte". Each byte is classified by its high nibble and the
+ * nibbles of the byte before it, and the three classes are anded to find errors. A second and
+ * third continuation byte must follow a lead byte two or three bytes back.
+ */
+#define GUTHTHILA_UTF8_TOO_SHORT (1 << 0)
+#define GUTHTHILA_UTF8_TOO_LONG (1 << 1)
+#define GUTHTHILA_UTF8_OVERLONG_3 (1 << 2)
+#define GUTHTHILA_UTF8_TOO_LARGE (1 << 3)
+#define GUTHTHILA_UTF8_SURROGATE (1 << 4)
+#define GUTHTHILA_UTF8_OVERLONG_2 (1 << 5)
+#define GUTHTHILA_UTF8_TOO_LARGE_1000 (1 << 6)
+#define GUTHTHILA_UTF8_OVERLONG_4 (1 << 6)
+#define GUTHTHILA_UTF8_TWO_CONTS (1 << 7)
+#define GUTHTHILA_UTF8_CARRY \
+    (GUTHTHILA_UTF8_TOO_SHORT | GUTHTHILA_UTF8_TOO_LONG | GUTHTHILA_UTF8_TWO_CONTS)
+
+/* classes by the high nibble of the byte before */
+static const unsigned char guththila_utf8_byte_1_high[16] = {
+    GUTHTHILA_UTF8_TOO_LONG, GUTHTHILA_UTF8_TOO_LONG, GUTHTHILA_UTF8_TOO_LONG,
+    GUTHTHILA_UTF8_TOO_LONG, GUTHTHILA_UTF8_TOO_LONG, GUTHTHILA_UTF8_TOO_LONG,
+    GUTHTHILA_UTF8_TOO_LONG, GUTHTHILA_UTF8_TOO_LONG,
+    GUTHTHILA_UTF8_TWO_CONTS, GUTHTHILA_UTF8_TWO_CONTS, GUTHTHILA_UTF8_TWO_CONTS,
+    GUTHTHILA_UTF8_TWO_CONTS,
+    GUTHTHILA_UTF8_TOO_SHORT | GUTHTHILA_UTF8_OVERLONG_2,
+    GUTHTHILA_UTF8_TOO_SHORT,
+    GUTHTHILA_UTF8_TOO_SHORT | GUTHTHILA_UTF8_OVERLONG_3 | GUTHTHILA_UTF8_SURROGATE,
+    GUTHTHILA_UTF8_TOO_SHORT | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000
+        | GUTHTHILA_UTF8_OVERLONG_4
+};
+
+/* classes by the low nibble of the byte before */
+static const unsigned char guththila_utf8_byte_1_low[16] = {
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_OVERLONG_3 | GUTHTHILA_UTF8_OVERLONG_2
+        | GUTHTHILA_UTF8_OVERLONG_4,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_OVERLONG_2,
+    GUTHTHILA_UTF8_CARRY,
+    GUTHTHILA_UTF8_CARRY,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000
+        | GUTHTHILA_UTF8_SURROGATE,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000,
+    GUTHTHILA_UTF8_CARRY | GUTHTHILA_UTF8_TOO_LARGE | GUTHTHILA_UTF8_TOO_LARGE_1000
+};
+
+/* classes by the high nibble of the byte itself */
+static const unsigned char guththila_utf8_byte_2_high[16] = {
+    GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT,
+    GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT,
+    GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT,
+    GUTHTHILA_UTF8_TOO_LONG | GUTHTHILA_UTF8_OVERLONG_2 | GUTHTHILA_UTF8_TWO_CONTS
+        | GUTHTHILA_UTF8_OVERLONG_3 | GUTHTHILA_UTF8_TOO_LARGE_1000 | GUTHTHILA_UTF8_OVERLONG_4,
+    GUTHTHILA_UTF8_TOO_LONG | GUTHTHILA_UTF8_OVERLONG_2 | GUTHTHILA_UTF8_TWO_CONTS
+        | GUTHTHILA_UTF8_OVERLONG_3 | GUTHTHILA_UTF8_TOO_LARGE,
+    GUTHTHILA_UTF8_TOO_LONG | GUTHTHILA_UTF8_OVERLONG_2 | GUTHTHILA_UTF8_TWO_CONTS
+        | GUTHTHILA_UTF8_SURROGATE | GUTHTHILA_UTF8_TOO_LARGE,
+    GUTHTHILA_UTF8_TOO_LONG | GUTHTHILA_UTF8_OVERLONG_2 | GUTHTHILA_UTF8_TWO_CONTS
+        | GUTHTHILA_UTF8_SURROGATE | GUTHTHILA_UTF8_TOO_LARGE,
+    GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT, GUTHTHILA_UTF8_TOO_SHORT,
+    GUTHTHILA_UTF8_TOO_SHORT
+};
+
+/*
+ * Returns where the scalar check is to go on from, or NULL if p to there is not UTF-8.
+ */
+GUTHTHILA_SCAN_TARGET("avx2")
+static const unsigned char *
+guththila_utf8_check_avx2(
+    const unsigned char *p,
+    const unsigned char *end)
+{
+    const unsigned char *start = p;
+    __m128i t;
+    __m256i v, prev, shifted, prev1, prev2, prev3, sc, must23;
+    __m256i errors = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i byte_1_high, byte_1_low, byte_2_high, max_last;
+
+    t = _mm_loadu_si128((const __m128i *)guththila_utf8_byte_1_high);
+    byte_1_high = _mm256_broadcastsi128_si256(t);
+    t = _mm_loadu_si128((const __m128i *)guththila_utf8_byte_1_low);
+    byte_1_low = _mm256_broadcastsi128_si256(t);
+    t = _mm_loadu_si128((const __m128i *)guththila_utf8_byte_2_high);
+    byte_2_high = _mm256_broadcastsi128_si256(t);
+    /* the last three bytes of a block may start a sequence the next block ends */
+    max_last = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1),
+        (char)(0xC0 - 1));
+    prev = _mm256_setzero_si256();
+
+    for(; p + 32 <= end; p += 32)
+    {
+        v = _mm256_loadu_si256((const __m256i *)p);
+        if(!_mm256_movemask_epi8(v))
+        {
+            /* ASCII, so a sequence the last block started was cut short */
+            errors = _mm256_or_si256(errors, incomplete);
+            incomplete = _mm256_setzero_si256();
+            prev = v;
+            continue;
+        }
+        /* the bytes one, two and three places back, across the two halves and blocks */
+        shifted = _mm256_permute2x128_si256(prev, v, 0x21);
+        prev1 = _mm256_alignr_epi8(v, shifted, 15);
+        prev2 = _mm256_alignr_epi8(v, shifted, 14);
+        prev3 = _mm256_alignr_epi8(v, shifted, 13);
+        sc = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+        /* only 111_____ two bytes back and 1111____ three bytes back give bytes >= 0x80 */
+        must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+        must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+        errors = _mm256_or_si256(errors, _mm256_xor_si256(must23, sc));
+        incomplete = _mm256_subs_epu8(v, max_last);
+        prev = v;
+    }
+    if(!_mm256_testz_si256(errors, errors))
+    {
+        return NULL;
+    }
+    /* go on from the start of the last sequence, which the rest may end */
+    if(p > start)
+    {
+        int k;
+        for(k = 0; k < 3 && p > start && (p[-1] & 0xC0) == 0x80; k++)
+        {
+            p--;
+        }
+        if(p > start && p[-1] >= 0xC0)
+        {
+            p--;
+        }
+    }
+    return p;
+}
+
+#endif
+
+/*
+ * Checks that p to end is UTF-8, see guththila_utf8_check_scalar().
+ */
+static const unsigned char *
+guththila_utf8_check(
+    const unsigned char *p,
+    const unsigned char *end,
+    int partial)
+{
+#ifdef GUTHTHILA_SCAN_AVX2
+    if(end - p >= 64 && GUTHTHILA_SCAN_USE_AVX2())
+    {
+        p = guththila_utf8_check_avx2(p, end);
+        if(!p)
+        {
+            return NULL;
+        }
+    }
+#endif
+    return guththila_utf8_check_scalar(p, end, partial);
+}
+
+#ifdef GUTHTHILA_SCAN_AVX2
+
+/*
+ * Returns where the check of a run that ends at len is to stop, that is len or the start of a
+ * sequence len cuts short. The rest of that sequence has not been read yet. checked is where
+ * the check of the run starts.
+ */
+static size_t
+guththila_utf8_cut(
+    const unsigned char *data,
+    size_t checked,
+    size_t len)
+{
+    size_t k;
+    unsigned char b;
+
+    for(k = 1; k <= 3 && k <= len - checked; k++)
+    {
+        b = data[len - k];
+        if(b < 0x80)
+        {
+            break;
+        }
+        if(b >= 0xC0)
+        {
+            if(b < 0xF8 && (b >= 0xF0 ? 4u : b >= 0xE0 ? 3u : 2u) > k)
+            {
+                return len - k;
+            }
+            break;
+        }
+    }
+    return len;
+}
+
+/* the last three bytes of a block may start a sequence the next block ends */
+static const unsigned char guththila_utf8_max_last[64] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1,
+    0xE0 - 1, 0xC0 - 1
+};
+
+/*
+ * Returns the errors of guththila_utf8_check_avx2() in the 32 bytes v, prev1, prev2 and prev3
+ * being the bytes one, two and three places back.
+ */
+GUTHTHILA_SCAN_TARGET("avx2")
+static __m256i
+guththila_utf8_errors_avx2(
+    __m256i v,
+    __m256i prev1,
+    __m256i prev2,
+    __m256i prev3)
+{
+    __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i sc, must23;
+
+    sc = _mm256_and_si256(_mm256_and_si256(
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_1_high)),
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_1_low)), _mm256_and_si256(prev1, nibble))),
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_2_high)),
+            _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+    must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+    return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)), sc);
+}
+
+/*
+ * Scans data from index to len for delim, and checks the bytes from checked to where the scan
+ * stops to be UTF-8, in the same pass. The bytes from checked to index are the start of the
+ * sequence an earlier check stopped at. Each block is checked with the lookups of
+ * guththila_utf8_check_avx2(), the bytes before it being loaded from where they are, and blocks
+ * of ASCII are only scanned. After the first pair of blocks the blocks are aligned, so a block
+ * may start inside the one before; checking bytes twice finds the same errors, and a sequence
+ * the block before leaves open is ended in the next one. A sequence len cuts short is left to
+ * be checked later.
+ * Returns the offset of the first delim, or len, and sets *checked_to to where the check
+ * stopped and adds a '&' before the delim to *flags. Returns (size_t)-1 if the bytes are not
+ * UTF-8.
+ */
+GUTHTHILA_SCAN_TARGET("avx2")
+static size_t
+guththila_scan_delim_utf8_avx2(
+    const unsigned char *data,
+    size_t checked,
+    size_t index,
+    size_t len,
+    int delim,
+    int *flags,
+    size_t *checked_to)
+{
+    const unsigned char *p = data + index;
+    const unsigned char *end, *q;
+    unsigned char copy[3 + 32];
+    size_t n, k;
+    unsigned int stop = 0, refs = 0, keep;
+    __m256i v, w, block;
+    __m256i errors = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    __m256i d = _mm256_set1_epi8((char)delim);
+    __m256i amp = _mm256_set1_epi8('&');
+    __m256i max_last = _mm256_loadu_si256((const __m256i *)(guththila_utf8_max_last + 32));
+
+    end = data + guththila_utf8_cut(data, checked, len);
+    if(end <= p)
+    {
+        /* the rest is the sequence that was cut short, or the start of another */
+        if(end == p && checked < index)
+        {
+            return (size_t)-1;
+        }
+        *checked_to = end - data;
+        return len;
+    }
+    if(checked < index)
+    {
+        /* an ASCII block may not end the sequence that was cut short */
+        incomplete = _mm256_set1_epi8(1);
+    }
+    while(p < end)
+    {
+        n = end - p;
+        if(n >= 64 && p >= data + 3)
+        {
+            v = _mm256_loadu_si256((const __m256i *)p);
+            w = _mm256_loadu_si256((const __m256i *)(p + 32));
+            if(!_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, d),
+                _mm256_cmpeq_epi8(w, d))))
+            {
+                refs |= _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, amp),
+                    _mm256_cmpeq_epi8(w, amp)));
+                if(!_mm256_movemask_epi8(_mm256_or_si256(v, w)))
+                {
+                    /* ASCII, so a sequence the last block started was cut short */
+                    errors = _mm256_or_si256(errors, incomplete);
+                    incomplete = _mm256_setzero_si256();
+                }
+                else
+                {
+                    errors = _mm256_or_si256(errors, guththila_utf8_errors_avx2(v,
+                        _mm256_loadu_si256((const __m256i *)(p - 1)),
+                        _mm256_loadu_si256((const __m256i *)(p - 2)),
+                        _mm256_loadu_si256((const __m256i *)(p - 3))));
+                    errors = _mm256_or_si256(errors, guththila_utf8_errors_avx2(w,
+                        _mm256_loadu_si256((const __m256i *)(p + 31)),
+                        _mm256_loadu_si256((const __m256i *)(p + 30)),
+                        _mm256_loadu_si256((const __m256i *)(p + 29))));
+                    incomplete = _mm256_subs_epu8(w, max_last);
+                }
+                /* on from a boundary of the vector size, so that the loads are aligned */
+                p = (const unsigned char *)(((size_t)p + 64) & ~(size_t)31);
+                continue;
+            }
+        }
+        /* a block with the delim, or at the start or the end of the buffer */
+        q = p;
+        if(n < 32 || p < data + 3)
+        {
+            /* the bytes before the buffer and after the end are taken as zeros */
+            k = p - data < 3 ? p - data : 3;
+            memset(copy, 0, sizeof(copy));
+            memcpy(copy + 3 - k, p - k, k + (n < 32 ? n : 32));
+            q = copy + 3;
+        }
+        v = _mm256_loadu_si256((const __m256i *)q);
+        block = guththila_utf8_errors_avx2(v, _mm256_loadu_si256((const __m256i *)(q - 1)),
+            _mm256_loadu_si256((const __m256i *)(q - 2)),
+            _mm256_loadu_si256((const __m256i *)(q - 3)));
+        stop = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, d));
+        if(n < 32)
+        {
+            stop &= (1u << n) - 1;
+        }
+        if(stop)
+        {
+            /* a sequence the delim cuts short is an error, and what follows is not looked at */
+            keep = stop ^ (stop - 1);
+            if(~_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_setzero_si256())) & keep)
+            {
+                return (size_t)-1;
+            }
+            refs |= _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, amp)) & (keep >> 1);
+            break;
+        }
+        errors = _mm256_or_si256(errors, block);
+        refs |= _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, amp));
+        incomplete = n < 32 ? _mm256_setzero_si256() : _mm256_subs_epu8(v, max_last);
+        p += n < 32 ? n : 32;
+    }
+    if(!stop)
+    {
+        errors = _mm256_or_si256(errors, incomplete);
+    }
+    if(!_mm256_testz_si256(errors, errors))
+    {
+        return (size_t)-1;
+    }
+    if(refs)
+    {
+        *flags |= GUTHTHILA_SCAN_REF;
+    }
+    if(stop)
+    {
+        *checked_to = p - data + GUTHTHILA_SCAN_FIRST_BIT(stop);
+        return *checked_to;
+    }
+    *checked_to = end - data;
+    return len;
+}
+
+/*
+ * Returns the errors of guththila_utf8_check_avx2() in the 64 bytes v, see
+ * guththila_utf8_errors_avx2().
+ */
+GUTHTHILA_SCAN_TARGET("avx512f,avx512bw")
+static __m512i
+guththila_utf8_errors_avx512(
+    __m512i v,
+    __m512i prev1,
+    __m512i prev2,
+    __m512i prev3)
+{
+    __m512i nibble = _mm512_set1_epi8(0x0F);
+    __m512i sc;
+
+    /* the and of the three lookups */
+    sc = _mm512_ternarylogic_epi32(
+        _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_1_high)),
+            _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble)),
+        _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_1_low)), _mm512_and_si512(prev1, nibble)),
+        _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128(
+            (const __m128i *)guththila_utf8_byte_2_high)),
+            _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble)), 0x80);
+    /* (must23 & 0x80) ^ sc */
+    return _mm512_ternarylogic_epi32(_mm512_or_si512(
+        _mm512_subs_epu8(prev2, _mm512_set1_epi8((char)(0xE0 - 0x80))),
+        _mm512_subs_epu8(prev3, _mm512_set1_epi8((char)(0xF0 - 0x80)))),
+        _mm512_set1_epi8((char)0x80), sc, 0x6A);
+}
+
+/*
+ * guththila_scan_delim_utf8_avx2() 64 bytes at a time. The blocks at the start and the end of
+ * the buffer are loaded with masks.
+ */
+GUTHTHILA_SCAN_TARGET("avx512f,avx512bw")
+static size_t
+guththila_scan_delim_utf8_avx512(
+    const unsigned char *data,
+    size_t checked,
+    size_t index,
+    size_t len,
+    int delim,
+    int *flags,
+    size_t *checked_to)
+{
+    const unsigned char *p = data + index;
+    const unsigned char *end, *q;
+    unsigned char copy[3 + 2 + 64];
+    size_t n;
+    __mmask64 limit, stop = 0, refs = 0;
+    __m512i v, w, block;
+    __m512i errors = _mm512_setzero_si512();
+    __m512i incomplete = _mm512_setzero_si512();
+    __m512i d = _mm512_set1_epi8((char)delim);
+    __m512i amp = _mm512_set1_epi8('&');
+    __m512i max_last = _mm512_loadu_si512((const void *)guththila_utf8_max_last);
+
+    end = data + guththila_utf8_cut(data, checked, len);
+    if(end <= p)
+    {
+        if(end == p && checked < index)
+        {
+            return (size_t)-1;
+        }
+        *checked_to = end - data;
+        return len;
+    }
+    if(checked < index)
+    {
+        incomplete = _mm512_set1_epi8(1);
+    }
+    while(p < end)
+    {
+        n = end - p;
+        if(n >= 128 && p >= data + 3)
+        {
+            v = _mm512_loadu_si512((const void *)p);
+            w = _mm512_loadu_si512((const void *)(p + 64));
+            if(!(_mm512_cmpeq_epi8_mask(v, d) | _mm512_cmpeq_epi8_mask(w, d)))
+            {
+                refs |= _mm512_cmpeq_epi8_mask(v, amp) | _mm512_cmpeq_epi8_mask(w, amp);
+                if(!_mm512_movepi8_mask(_mm512_or_si512(v, w)))
+                {
+                    errors = _mm512_or_si512(errors, incomplete);
+                    incomplete = _mm512_setzero_si512();
+                }
+                else
+                {
+                    errors = _mm512_ternarylogic_epi32(errors, guththila_utf8_errors_avx512(v,
+                        _mm512_loadu_si512((const void *)(p - 1)),
+                        _mm512_loadu_si512((const void *)(p - 2)),
+                        _mm512_loadu_si512((const void *)(p - 3))),
+                        guththila_utf8_errors_avx512(w,
+                        _mm512_loadu_si512((const void *)(p + 63)),
+                        _mm512_loadu_si512((const void *)(p + 62)),
+                        _mm512_loadu_si512((const void *)(p + 61))), 0xFE);
+                    incomplete = _mm512_subs_epu8(w, max_last);
+                }
+                p = (const unsigned char *)(((size_t)p + 128) & ~(size_t)63);
+                continue;
+            }
+        }
+        limit = n < 64 ? ((__mmask64)1 << n) - 1 : ~(__mmask64)0;
+        q = p;
+        if(p < data + 3)
+        {
+            memset(copy, 0, sizeof(copy));
+            memcpy(copy + 3, data, p - data + (n < 64 ? n : 64));
+            q = copy + 3 + (p - data);
+        }
+        v = _mm512_maskz_loadu_epi8(limit, q);
+        block = guththila_utf8_errors_avx512(v, _mm512_maskz_loadu_epi8(~(~limit << 1), q - 1),
+            _mm512_maskz_loadu_epi8(~(~limit << 2), q - 2),
+            _mm512_maskz_loadu_epi8(~(~limit << 3), q - 3));
+        stop = _mm512_mask_cmpeq_epi8_mask(limit, v, d);
+        if(stop)
+        {
+            limit = stop ^ (stop - 1);
+            errors = _mm512_or_si512(errors, _mm512_maskz_mov_epi8(limit, block));
+            refs |= _mm512_mask_cmpeq_epi8_mask(limit >> 1, v, amp);
+            break;
+        }
+        errors = _mm512_or_si512(errors, block);
+        refs |= _mm512_mask_cmpeq_epi8_mask(limit, v, amp);
+        incomplete = n < 64 ? _mm512_setzero_si512() : _mm512_subs_epu8(v, max_last);
+        p += n < 64 ? n : 64;
+    }
+    if(!stop)
+    {
+        errors = _mm512_or_si512(errors, incomplete);
+    }
+    if(_mm512_test_epi8_mask(errors, errors))
+    {
+        return (size_t)-1;
+    }
+    if(refs)
+    {
+        *flags |= GUTHTHILA_SCAN_REF;
+    }
+    if(stop)
+    {
+        *checked_to = p - data + __builtin_ctzll(stop);
+        return *checked_to;
+    }
+    *checked_to = end - data;
+    return len;
+}
+
+/*
+ * Returns the offset of the first delim in p, or len, and adds GUTHTHILA_SCAN_REF to *flags if
+ * there is a '&' before, for input that is not checked. The bytes are loaded 64 at a time from
+ * aligned addresses, four vectors a step while there is no stop, and those outside p to p + len
+ * are masked out.
+ */
+GUTHTHILA_SCAN_TARGET("avx512f,avx512bw")
+static size_t
+guththila_scan_delim_avx512(
+    const unsigned char *p,
+    size_t len,
+    int delim,
+    int *flags)
+{
+    const unsigned char *q = (const unsigned char *)((size_t)p & ~(size_t)63);
+    const unsigned char *end = p + len;
+    __mmask64 mask, stop, refs;
+    __m512i v, w, x, y;
+    __m512i d = _mm512_set1_epi8((char)delim);
+    __m512i amp = _mm512_set1_epi8('&');
+
+    mask = ~(__mmask64)0 << (p - q);
+    while(q < end)
+    {
+        if((size_t)(end - q) < 64)
+        {
+            mask &= ~(~(__mmask64)0 << (end - q));
+        }
+        v = _mm512_maskz_loadu_epi8(mask, q);
+        stop = _mm512_mask_cmpeq_epi8_mask(mask, v, d);
+        refs = _mm512_mask_cmpeq_epi8_mask(mask, v, amp);
+        if(stop)
+        {
+            /* only the references before the stop count */
+            refs &= (stop & (0 - stop)) - 1;
+        }
+        if(refs)
+        {
+            *flags |= GUTHTHILA_SCAN_REF;
+        }
+        if(stop)
+        {
+            return q - p + __builtin_ctzll(stop);
+        }
+        q += 64;
+        mask = ~(__mmask64)0;
+        while(end - q >= 256)
+        {
+            v = _mm512_load_si512((const void *)q);
+            w = _mm512_load_si512((const void *)(q + 64));
+            x = _mm512_load_si512((const void *)(q + 128));
+            y = _mm512_load_si512((const void *)(q + 192));
+            if(_mm512_cmpeq_epi8_mask(v, d) | _mm512_cmpeq_epi8_mask(w, d)
+                | _mm512_cmpeq_epi8_mask(x, d) | _mm512_cmpeq_epi8_mask(y, d))
+            {
+                break;
+            }
+            refs |= _mm512_cmpeq_epi8_mask(v, amp) | _mm512_cmpeq_epi8_mask(w, amp)
+                | _mm512_cmpeq_epi8_mask(x, amp) | _mm512_cmpeq_epi8_mask(y, amp);
+            q += 256;
+        }
+        if(refs)
+        {
+            *flags |= GUTHTHILA_SCAN_REF;
+        }
+    }
+    return len;
+}
+
+#endif
+
+/*
+ * Moves m->next over the bytes of the current buffer up to the first delim, or over the name at
+ * m->next when delim is 0. When the UTF-8 check is on, the bytes read one by one since the last
+ * check, which are few, and the run are checked to be UTF-8, and m->utf8_checked is moved on.
+ * Returns what the scan found in the run, see GUTHTHILA_SCAN_REF, or -1 if they are not UTF-8.
+ */
+static int
+guththila_skip_run(
+    guththila_t * m,
+    const guththila_char_t *buffer,
+    size_t data_size,
+    size_t previous_size,
+    int delim)
+{
+    const unsigned char *data = (const unsigned char *)buffer;
+    const unsigned char *checked;
+    size_t index = m->next - previous_size;
+    size_t start = 0, block, len;
+    int found, flags = 0;
+
+    if(!m->utf8_check)
+    {
+        const unsigned char *stop;
+
+        if(!delim)
+        {
+            if(index < data_size)
+            {
+                m->next += guththila_scan_name(data + index, data_size - index, &flags);
+            }
+            return flags;
+        }
+
+#ifdef GUTHTHILA_SCAN_AVX2
+        if(index < data_size && GUTHTHILA_SCAN_USE_AVX512())
+        {
+            m->next += guththila_scan_delim_avx512(data + index, data_size - index, delim,
+                &flags);
+            return flags;
+        }
+#endif
+        /* memchr is the fastest way to the delimiter, and a block is looked at again for a
+         * reference while it is in the cache, until one is found */
+        while(index < data_size)
+        {
+            block = data_size - index;
+            if(block > GUTHTHILA_SCAN_BLOCK)
+            {
+                block = GUTHTHILA_SCAN_BLOCK;
+            }
+            stop = (const unsigned char *)memchr(data + index, delim, block);
+            len = stop ? (size_t)(stop - (data + index)) : block;
+            if(!(flags & GUTHTHILA_SCAN_REF) && memchr(data + index, '&', len))
+            {
+                flags |= GUTHTHILA_SCAN_REF;
+            }
+            index += len;
+            if(stop)
+            {
+                break;
+            }
+        }
+        m->next = previous_size + index;
+        return flags;
+    }
+
+    /* the bytes of the earlier buffers were checked when the current one was started */
+    if(m->utf8_checked > previous_size)
+    {
+        start = m->utf8_checked - previous_size;
+    }
+    while(start < index && data[start] < 0x80)
+    {
+        start++;
+    }
+    checked = data + start;
+    if(start < index)
+    {
+        checked = guththila_utf8_check(checked, data + index, 1);
+        if(!checked)
+        {
+            return -1;
+        }
+    }
+#ifdef GUTHTHILA_SCAN_AVX2
+    if(delim && index < data_size && GUTHTHILA_SCAN_USE_AVX2())
+    {
+        /* checked is at most the three bytes of a sequence back from index */
+        len = GUTHTHILA_SCAN_USE_AVX512()
+            ? guththila_scan_delim_utf8_avx512(data, checked - data, index, data_size, delim,
+                &flags, &start)
+            : guththila_scan_delim_utf8_avx2(data, checked - data, index, data_size, delim,
+                &flags, &start);
+        if(len == (size_t)-1)
+        {
+            return -1;
+        }
+        m->next = previous_size + len;
+        m->utf8_checked = previous_size + start;
+        return flags;
+    }
+#endif
+    while(index < data_size)
+    {
+        block = data_size - index;
+        if(block > GUTHTHILA_SCAN_BLOCK)
+        {
+            block = GUTHTHILA_SCAN_BLOCK;
+        }
+        found = 0;
+        len = delim ? guththila_scan_delim(data + index, block, delim, &found)
+            : guththila_scan_name(data + index, block, &found);
+        flags |= found;
+        if((found & GUTHTHILA_SCAN_HIGH) || checked < data + index)
+        {
+            /* a sequence may be cut short where the scan stopped inside a name or a block */
+            checked = guththila_utf8_check(checked, data + index + len, 1);
+            if(!checked)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            checked = data + index + len;
+        }
+        index += len;
+        if(len < block)
+        {
+            break;
+        }
+    }
+    m->next = previous_size + index;
+    m->utf8_checked = previous_size + (checked - data);
+    return flags;
+}
+
+/*
+ * Checks that the bytes read since the last check are UTF-8. The parser is between events, so
+ * no sequence may be cut short.
+ * Returns GUTHTHILA_FAILURE if they are not UTF-8.
+ */
+static int
+guththila_utf8_check_read(
+    guththila_t * m)
+{
+    const unsigned char *data;
+    size_t previous_size, start = 0, end;
+    size_t word;
 
-/* 
- * Read characters until all the white spaces are read.
+    if(!m->utf8_check || m->buffer.cur_buff == -1 || m->utf8_checked >= m->next)
+    {
+        return GUTHTHILA_SUCCESS;
+    }
+    data = (const unsigned char *)m->buffer.buff[m->buffer.cur_buff];
+    previous_size = GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer);
+    end = m->next - previous_size;
+    if(end > GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer))
+    {
+        end = GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer);
+    }
+    if(m->utf8_checked > previous_size)
+    {
+        start = m->utf8_checked - previous_size;
+    }
+    /* most events are ASCII */
+    for(; start + sizeof(word) <= end; start += sizeof(word))
+    {
+        memcpy(&word, data + start, sizeof(word));
+        if(word & GUTHTHILA_SCAN_HIGHS)
+        {
+            break;
+        }
+    }
+    if(start < end && !guththila_utf8_check(data + start, data + end, 0))
+    {
+        return GUTHTHILA_FAILURE;
+    }
+    m->utf8_checked = m->next;
+    return GUTHTHILA_SUCCESS;
+}
+
+/*
+ * Moves m->next over the white space at the start of the rest of the current buffer.
  */
-#define GUTHTHILA_SKIP_SPACES(m, c, buffer, data_size, previous_size, _env)while(GUTHTHILA_IS_SPACE(c)){GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, _env, c);}
+static void
+guththila_skip_spaces(
+    guththila_t * m,
+    const guththila_char_t *buffer,
+    size_t data_size,
+    size_t previous_size)
+{
+    size_t index = m->next - previous_size;
+
+    if(index < data_size)
+    {
+        m->next += guththila_scan_spaces((const unsigned char *)buffer + index, data_size - index);
+    }
+}
+
+/* Bytes of a token read one by one before the rest is scanned, as short runs read faster so */
+#define GUTHTHILA_SCAN_MIN_RUN 8
+
+/*
+ * Skips the run up to delim, or the name when delim is 0, once the open token is long enough.
+ * The current buffer is looked up the way GUTHTHILA_NEXT_CHAR does, and nothing is skipped
+ * before the first read.
+ */
+#define GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size, delim, flags)\
+{\
+    if(m->next - m->last_start > GUTHTHILA_SCAN_MIN_RUN)\
+    {\
+        if(!buffer && m->buffer.cur_buff != -1)\
+        {\
+            buffer = m->buffer.buff[m->buffer.cur_buff];\
+            data_size = GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer);\
+            previous_size = GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer);\
+        }\
+        if(buffer)\
+        {\
+            int found = guththila_skip_run(m, buffer, data_size, previous_size, delim);\
+            if(found < 0)\
+                return -1;\
+            flags |= found;\
+        }\
+    }\
+}
 
 
 #define GUTHTHILA_XML_NAME "xml"
@@ -145,9 +1485,8 @@ guththila_process_xml_dec(
 #define GUTHTHILA_TOKEN_OPEN(m, tok, _env)					\
     m->temp_tok = guththila_tok_list_get_token(&m->tokens, _env); \
     m->temp_tok->type = _Unknown; \
-    m->temp_tok->_start = (int)m->next; \
-    m->last_start = (int)m->next - 1;
-/* We are sure that the difference lies within the int range */
+    m->temp_tok->_start = m->next; \
+    m->last_start = m->next - 1;
 
 /*
  * Read until we met a = character.
@@ -195,37 +1534,18 @@ guththila_process_xml_dec(
     m->value = NULL;
 
 /*
- * Initialize the guththila_t structure with the reader. 
- * All the values will be set to default values. 
+ * Sets up the state for a new document: the namespace of the xml prefix,
+ * which is always in scope, and where parsing starts.
  */
-GUTHTHILA_EXPORT int GUTHTHILA_CALL
-guththila_init(
+static int
+guththila_init_document(
     guththila_t * m,
-    void *reader,
     const axutil_env_t * env)
 {
     guththila_token_t* temp_name = NULL;
     guththila_token_t* temp_tok = NULL;
     guththila_elem_namesp_t* e_namesp = NULL;
 
-    if(!((guththila_reader_t *)reader))
-        return GUTHTHILA_FAILURE;
-    m->reader = (guththila_reader_t *)reader;
-    if(!guththila_tok_list_init(&m->tokens, env))
-    {
-        return GUTHTHILA_FAILURE;
-    }
-    if(m->reader->type == GUTHTHILA_MEMORY_READER)
-    {
-        guththila_buffer_init_for_buffer(&m->buffer, m->reader->buff, m->reader->buff_size, env);
-    }
-    else if(m->reader->type == GUTHTHILA_FILE_READER || m->reader->type == GUTHTHILA_IO_READER)
-    {
-        guththila_buffer_init(&m->buffer, 0, env);
-    }
-    guththila_stack_init(&m->elem, env);
-    guththila_stack_init(&m->attrib, env);
-    guththila_stack_init(&m->namesp, env);
     temp_name = guththila_tok_list_get_token(&m->tokens, env);
     temp_tok = guththila_tok_list_get_token(&m->tokens, env);
     if(temp_tok && temp_name)
@@ -245,7 +1565,7 @@ guththila_init(
         e_namesp->namesp = (guththila_namespace_t *)AXIS2_MALLOC(env->allocator,
             sizeof(guththila_namespace_t) * GUTHTHILA_NAMESPACE_DEF_SIZE);
     }
-    if(e_namesp->namesp)
+    if(e_namesp && e_namesp->namesp)
     {
         e_namesp->no = 1;
         e_namesp->size = GUTHTHILA_NAMESPACE_DEF_SIZE;
@@ -257,12 +1577,12 @@ guththila_init(
     {
         if(temp_name)
         {
-            AXIS2_FREE(env->allocator, temp_name);
+            guththila_tok_list_release_token(&m->tokens, temp_name, env);
             temp_name = NULL;
         }
         if(temp_tok)
         {
-            AXIS2_FREE(env->allocator, temp_tok);
+            guththila_tok_list_release_token(&m->tokens, temp_tok, env);
             temp_tok = NULL;
         }
         if(e_namesp)
@@ -282,61 +1602,34 @@ guththila_init(
     m->temp_name = NULL;
     m->temp_prefix = NULL;
     m->temp_tok = NULL;
+    m->utf8_checked = 0;
+    m->utf8_check = 0;
+    m->streaming = 0;
     return GUTHTHILA_SUCCESS;
 }
 
 /*
- * Uninitialize a guththila_t structure. This method deallocates all the 
- * resources that are held in the guththila_t structure.
+ * Frees the attributes, elements and namespaces held for the document. Their
+ * tokens are not released, the callers take back all the tokens at once.
  */
-GUTHTHILA_EXPORT int GUTHTHILA_CALL
-guththila_un_init(
+static void
+guththila_release_document(
     guththila_t * m,
     const axutil_env_t * env)
 {
-    int size = 0, i = 0, j = 0;
+    int size = 0, i = 0;
     guththila_attr_t * attr = NULL;
     guththila_element_t* elem = NULL;
     guththila_elem_namesp_t * e_namesp = NULL;
 
-    if(m->prefix)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->prefix, env);
-    }
-    if(m->name)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->name, env);
-    }
-    if(m->value)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->value, env);
-    }
-    if(m->temp_tok)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->temp_tok, env);
-    }
-    if(m->temp_name)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->temp_name, env);
-    }
-    if(m->temp_prefix)
-    {
-        guththila_tok_list_release_token(&m->tokens, m->temp_prefix, env);
-    }
     size = GUTHTHILA_STACK_SIZE(m->attrib);
     for(i = 0; i < size; i++)
     {
         attr = (guththila_attr_t *)guththila_stack_pop(&m->attrib, env);
         if(attr)
-        {
-            if(attr->name)
-                guththila_tok_list_release_token(&m->tokens, attr->name, env);
-            if(attr->pref)
-                guththila_tok_list_release_token(&m->tokens, attr->pref, env);
             AXIS2_FREE(env->allocator, attr);
-        }
     }
-    guththila_stack_un_init(&m->attrib, env);
+    guththila_release_values(m, env);
 
 #ifndef GUTHTHILA_VALIDATION_PARSER
     guththila_namespace_t * namesp = NULL;
@@ -347,13 +1640,7 @@ guththila_un_init(
         namesp =
         (guththila_namespace_t *) guththila_stack_pop(&m->namesp, env);
         if (namesp)
-        {
-            if (namesp->name)
-            guththila_tok_list_release_token(&m->tokens, namesp->name, env);
-            if (namesp->uri)
-            guththila_tok_list_release_token(&m->tokens, namesp->uri, env);
             AXIS2_FREE(env->allocator, namesp);
-        }
     }
 #else 
 
@@ -363,17 +1650,6 @@ guththila_un_init(
         e_namesp = (guththila_elem_namesp_t *)guththila_stack_pop(&m->namesp, env);
         if(e_namesp)
         {
-            for(j = 0; j < e_namesp->no; j++)
-            {
-                if(e_namesp->namesp[j].name)
-                {
-                    guththila_tok_list_release_token(&m->tokens, e_namesp->namesp[j].name, env);
-                }
-                if(e_namesp->namesp[j].uri)
-                {
-                    guththila_tok_list_release_token(&m->tokens, e_namesp->namesp[j].uri, env);
-                }
-            }
             AXIS2_FREE(env->allocator, e_namesp->namesp);
             AXIS2_FREE(env->allocator, e_namesp);
         }
@@ -385,14 +1661,89 @@ guththila_un_init(
     {
         elem = (guththila_element_t *)guththila_stack_pop(&m->elem, env);
         if(elem)
-        {
-            if(elem->name)
-                guththila_tok_list_release_token(&m->tokens, elem->name, env);
-            if(elem->prefix)
-                guththila_tok_list_release_token(&m->tokens, elem->prefix, env);
             AXIS2_FREE(env->allocator, elem);
-        }
     }
+    m->name = NULL;
+    m->prefix = NULL;
+    m->value = NULL;
+    m->temp_name = NULL;
+    m->temp_prefix = NULL;
+    m->temp_tok = NULL;
+}
+
+/*
+ * Initialize the guththila_t structure with the reader. 
+ * All the values will be set to default values. 
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_init(
+    guththila_t * m,
+    void *reader,
+    const axutil_env_t * env)
+{
+    if(!((guththila_reader_t *)reader))
+        return GUTHTHILA_FAILURE;
+    m->reader = (guththila_reader_t *)reader;
+    if(!guththila_tok_list_init(&m->tokens, env))
+    {
+        return GUTHTHILA_FAILURE;
+    }
+    if(GUTHTHILA_READER_IN_MEMORY(m->reader))
+    {
+        guththila_buffer_init_for_buffer(&m->buffer, m->reader->buff, m->reader->buff_size, env);
+    }
+    else
+    {
+        guththila_buffer_init(&m->buffer, 0, env);
+    }
+    guththila_stack_init(&m->elem, env);
+    guththila_stack_init(&m->attrib, env);
+    guththila_stack_init(&m->namesp, env);
+    guththila_stack_init(&m->values, env);
+    return guththila_init_document(m, env);
+}
+
+/*
+ * Prepare a guththila_t structure for another document. The memory taken by
+ * the tokens, the stacks and the buffers is kept.
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_reset(
+    guththila_t * m,
+    void *reader,
+    const axutil_env_t * env)
+{
+    guththila_release_document(m, env);
+    guththila_tok_list_reset(&m->tokens, env);
+    m->reader = (guththila_reader_t *)reader;
+    if(!m->reader)
+    {
+        guththila_buffer_reset(&m->buffer, 0, env);
+        return GUTHTHILA_SUCCESS;
+    }
+    if(GUTHTHILA_READER_IN_MEMORY(m->reader))
+    {
+        guththila_buffer_reset_for_buffer(&m->buffer, m->reader->buff, m->reader->buff_size, env);
+    }
+    else
+    {
+        guththila_buffer_reset(&m->buffer, 0, env);
+    }
+    return guththila_init_document(m, env);
+}
+
+/*
+ * Uninitialize a guththila_t structure. This method deallocates all the 
+ * resources that are held in the guththila_t structure.
+ */
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_un_init(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    guththila_release_document(m, env);
+    guththila_stack_un_init(&m->attrib, env);
+    guththila_stack_un_init(&m->values, env);
     guththila_stack_un_init(&m->elem, env);
     guththila_stack_un_init(&m->namesp, env);
     guththila_tok_list_free_data(&m->tokens, env);
@@ -474,8 +1825,9 @@ guththila_utf8_bytes(
 
 /*
  * Replace the references with the corresponding actual values.
+ * Returns the length of the string after the replacement.
  */
-static void
+static size_t
 guththila_string_evaluate_references(
     guththila_char_t *start, size_t size)
 {
@@ -582,6 +1934,7 @@ guththila_string_evaluate_references(
         p++; /* go over ';' */
     }
     start[q - start] = '\0';
+    return q - start;
 }
 
 /*
@@ -783,15 +2136,18 @@ guththila_validate_namespaces(
     return GUTHTHILA_SUCCESS;
 }
 
-GUTHTHILA_EXPORT int GUTHTHILA_CALL
-guththila_next(
+/*
+ * Reads the next event. guththila_next() checks that what it read is UTF-8.
+ */
+static int
+guththila_next_event(
     guththila_t * m,
     const axutil_env_t * env)
 {
     guththila_element_t * elem = NULL;
     guththila_elem_namesp_t * nmsp = NULL;
     guththila_token_t * tok = NULL;
-    int quote = 0, ref = 0;
+    int quote = 0, ref = 0, run = 0;
     int c = -1;
     guththila_attr_t * attr = NULL;
     int size = 0, i = 0, nmsp_counter, loop = 0, white_space = 0;
@@ -813,6 +2169,7 @@ guththila_next(
             AXIS2_FREE(env->allocator, attr);
         }
     }
+    guththila_release_values(m, env);
 
 #ifdef GUTHTHILA_VALIDATION_PARSER    
     if(m->guththila_event == GUTHTHILA_END_ELEMENT && m->name)
@@ -888,6 +2245,8 @@ guththila_next(
                     {
                         if(c != ':')
                         {
+                            GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size,
+                                0, run);
                             GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                         }
                         else
@@ -952,6 +2311,8 @@ guththila_next(
                             {
                                 if(c != ':')
                                 {
+                                    GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size,
+                                        0, run);
                                     GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                                 }
                                 else if(c == ':')
@@ -975,11 +2336,20 @@ guththila_next(
                         {
                             GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                             GUTHTHILA_TOKEN_OPEN(m, tok, env);
+                            ref = 0;
+                            run = 0;
                             while(c != quote)
                             {
+                                if(c == '&')
+                                {
+                                    ref = 1;
+                                }
+                                GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size,
+                                    quote, run);
                                 GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                             }
-                            guththila_token_close(m, tok, _attribute_value, 0, env);
+                            guththila_token_close(m, tok, _attribute_value,
+                                ref || (run & GUTHTHILA_SCAN_REF), env);
                             GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                             GUTHTHILA_SKIP_SPACES(m, c, buffer, data_size, previous_size, env);
                         }
@@ -1003,6 +2373,8 @@ guththila_next(
                     {
                         if(c != ':')
                         {
+                            GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size,
+                                0, run);
                             GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                         }
                         else
@@ -1161,6 +2533,8 @@ guththila_next(
                 white_space = 0;
             else
                 white_space = 1;
+            ref = (c == '&');
+            run = 0;
             GUTHTHILA_TOKEN_OPEN(m, tok, env);
 
             /* code given below is having two do-while loop wrapped by another do-while loop.
@@ -1175,10 +2549,15 @@ guththila_next(
                 {
                     do
                     {
+                        if(buffer)
+                        {
+                            guththila_skip_spaces(m, buffer, data_size, previous_size);
+                        }
                         GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
                         if(!GUTHTHILA_IS_SPACE(c) && c != '<')
                         {
                             white_space = 0;
+                            ref = (c == '&');
                             break;
                         }
                     }
@@ -1188,31 +2567,18 @@ guththila_next(
                 {
                     do
                     {
-                        if(buffer)
-                        {
-                            guththila_char_t *pos = NULL;
-                            size_t index = m->next - previous_size;
-                            pos = (guththila_char_t*)memchr(buffer + index, '<', data_size - index);
-                            if(pos)
-                            {
-                                m->next += pos - (buffer + index);
-                            }
-                            else
-                            {
-                                m->next = previous_size + data_size;
-                            }
-
-                            GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
-                        }
-                        else
+                        GUTHTHILA_SKIP_RUN(m, buffer, data_size, previous_size,
+                            '<', run);
+                        GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
+                        if(c == '&')
                         {
-                            GUTHTHILA_NEXT_CHAR(m, buffer, data_size, previous_size, env, c);
+                            ref = 1;
                         }
                     }while(c != '<');
                 }
             }
             while(c != '<');
-            guththila_token_close(m, tok, _text_data, ref, env);
+            guththila_token_close(m, tok, _text_data, ref || (run & GUTHTHILA_SCAN_REF), env);
             m->next--;
             if(white_space)
             {
@@ -1238,6 +2604,28 @@ guththila_next(
     return c;
 }
 
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_next(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    int event;
+
+    /* nothing is read, or released, until the next event can be read whole */
+    if(m->reader->type == GUTHTHILA_PUSH_READER && !GUTHTHILA_READER_PUSH_READY(m->reader)
+        && (m->buffer.cur_buff == -1 || m->next >= GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)
+        + GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer)))
+    {
+        return GUTHTHILA_NEED_MORE_INPUT;
+    }
+    event = guththila_next_event(m, env);
+    if(event != -1 && !guththila_utf8_check_read(m))
+    {
+        return -1;
+    }
+    return event;
+}
+
 /* Process the XML declaration */
 static int
 guththila_process_xml_dec(
@@ -1341,6 +2729,52 @@ guththila_process_xml_dec(
     return c;
 }
 
+static void
+guththila_release_values(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    while(GUTHTHILA_STACK_SIZE(m->values) > 0)
+    {
+        AXIS2_FREE(env->allocator, guththila_stack_pop(&m->values, env));
+    }
+}
+
+/*
+ * Points at the text of a token. A token holding references is copied with
+ * the references replaced, and the copy lives until the next event.
+ */
+static const guththila_char_t *
+guththila_token_view(
+    guththila_t * m,
+    guththila_token_t * tok,
+    int eval_ref,
+    size_t *len,
+    const axutil_env_t * env)
+{
+    guththila_char_t *str = NULL;
+
+    if(!tok)
+    {
+        *len = 0;
+        return NULL;
+    }
+    if(!eval_ref || !tok->ref)
+    {
+        *len = GUTHTHILA_TOKEN_LEN(tok);
+        return tok->start;
+    }
+    GUTHTHILA_TOKEN_TO_STRING(tok, str, env);
+    if(!str)
+    {
+        *len = 0;
+        return NULL;
+    }
+    *len = guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(tok));
+    guththila_stack_push(&m->values, str, env);
+    return str;
+}
+
 GUTHTHILA_EXPORT int GUTHTHILA_CALL
 guththila_get_attribute_count(
     guththila_t * m,
@@ -1374,7 +2808,10 @@ guththila_get_attribute_value(
     if(att->val)
     {
         GUTHTHILA_TOKEN_TO_STRING(att->val, str, env);
-        guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(att->val));
+        if(att->val->ref)
+        {
+            guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(att->val));
+        }
         return str;
     }
     return NULL;
@@ -1432,7 +2869,10 @@ guththila_get_attribute_value_by_number(
     if(attr->val)
     {
         GUTHTHILA_TOKEN_TO_STRING(attr->val, str, env);
-        guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(attr->val));
+        if(attr->val->ref)
+        {
+            guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(attr->val));
+        }
         return str;
     }
     return NULL;
@@ -1492,8 +2932,8 @@ guththila_get_value(
     if(m->value)
     {
         GUTHTHILA_TOKEN_TO_STRING(m->value, str, env);
-        /* don't eval references in comments or cdata sections */
-        if (m->value->type != _char_data)
+        /* don't eval references in comments or cdata sections, or where the parser saw none */
+        if (m->value->type != _char_data && m->value->ref)
         {
             guththila_string_evaluate_references(str, GUTHTHILA_TOKEN_LEN(m->value));
         }
@@ -1671,6 +3111,143 @@ guththila_get_attribute_namespace_by_number(
 #endif 
 }
 
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_name_view(
+    guththila_t * m,
+    size_t *len,
+    const axutil_env_t * env)
+{
+    return guththila_token_view(m, m->name, 0, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_prefix_view(
+    guththila_t * m,
+    size_t *len,
+    const axutil_env_t * env)
+{
+    return guththila_token_view(m, m->prefix, 0, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_value_view(
+    guththila_t * m,
+    size_t *len,
+    const axutil_env_t * env)
+{
+    /* as in guththila_get_value, references in cdata sections and comments stay */
+    return guththila_token_view(m, m->value, m->value && m->value->type != _char_data, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_attribute_name_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_attr_t * attr = (guththila_attr_t *)guththila_stack_get_by_index(&m->attrib, i - 1,
+        env);
+    return guththila_token_view(m, attr ? attr->name : NULL, 0, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_attribute_prefix_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_attr_t * attr = (guththila_attr_t *)guththila_stack_get_by_index(&m->attrib, i - 1,
+        env);
+    return guththila_token_view(m, attr ? attr->pref : NULL, 0, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_attribute_value_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_attr_t * attr = (guththila_attr_t *)guththila_stack_get_by_index(&m->attrib, i - 1,
+        env);
+    return guththila_token_view(m, attr ? attr->val : NULL, 1, len, env);
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_attribute_namespace_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_attr_t * attr = NULL;
+    int j = 0, k = 0;
+    guththila_elem_namesp_t * nmsp = NULL;
+
+    if(i <= GUTHTHILA_STACK_SIZE(m->attrib))
+    {
+        attr = (guththila_attr_t *)guththila_stack_get_by_index(&m->attrib, i - 1, env);
+        if(attr && attr->pref)
+        {
+            for(j = GUTHTHILA_STACK_SIZE(m->namesp) - 1; j >= 0; j--)
+            {
+                nmsp = (guththila_elem_namesp_t *)guththila_stack_get_by_index(&m->namesp, j, env);
+                for(k = 0; k < nmsp->no; k++)
+                {
+                    if(!guththila_tok_tok_cmp(nmsp->namesp[k].name, attr->pref, env))
+                    {
+                        return guththila_token_view(m, nmsp->namesp[k].uri, 0, len, env);
+                    }
+                }
+            }
+        }
+    }
+    *len = 0;
+    return NULL;
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_namespace_prefix_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_elem_namesp_t * nmsp = NULL;
+    if(((guththila_element_t *)guththila_stack_peek(&m->elem, env))->is_namesp)
+    {
+        nmsp = (guththila_elem_namesp_t *)guththila_stack_peek(&m->namesp, env);
+        if(nmsp && nmsp->no >= i)
+        {
+            return guththila_token_view(m, nmsp->namesp[i - 1].name, 0, len, env);
+        }
+    }
+    *len = 0;
+    return NULL;
+}
+
+GUTHTHILA_EXPORT const guththila_char_t *GUTHTHILA_CALL
+guththila_get_namespace_uri_view_by_number(
+    guththila_t * m,
+    int i,
+    size_t *len,
+    const axutil_env_t *env)
+{
+    guththila_elem_namesp_t * nmsp = NULL;
+    if(((guththila_element_t *)guththila_stack_peek(&m->elem, env))->is_namesp)
+    {
+        nmsp = (guththila_elem_namesp_t *)guththila_stack_peek(&m->namesp, env);
+        if(nmsp && nmsp->no >= i)
+        {
+            return guththila_token_view(m, nmsp->namesp[i - 1].uri, 0, len, env);
+        }
+    }
+    *len = 0;
+    return NULL;
+}
+
 GUTHTHILA_EXPORT guththila_char_t *GUTHTHILA_CALL
 guththila_get_encoding(
     guththila_t * m,
@@ -1679,6 +3256,238 @@ guththila_get_encoding(
     return "UTF-8";
 }
 
+/* Whether tok is in the part of the input from start to end */
+#define GUTHTHILA_TOKEN_IN(tok, start, end) ((tok) && (tok)->start >= (start) && (tok)->start < (end))
+
+/*
+ * Whether a token the parser holds is in the part of the input from start to
+ * end. These are the tokens of the current event, the names of the open
+ * elements and the namespaces in scope.
+ */
+static int
+guththila_tokens_in(
+    guththila_t * m,
+    const guththila_char_t *start,
+    const guththila_char_t *end,
+    const axutil_env_t * env)
+{
+    guththila_element_t * elem = NULL;
+    guththila_attr_t * attr = NULL;
+    guththila_elem_namesp_t * nmsp = NULL;
+    int i, j;
+
+    if(GUTHTHILA_TOKEN_IN(m->name, start, end) || GUTHTHILA_TOKEN_IN(m->prefix, start, end)
+        || GUTHTHILA_TOKEN_IN(m->value, start, end) || GUTHTHILA_TOKEN_IN(m->temp_name, start, end)
+        || GUTHTHILA_TOKEN_IN(m->temp_prefix, start, end))
+    {
+        return 1;
+    }
+    for(i = 0; i < GUTHTHILA_STACK_SIZE(m->attrib); i++)
+    {
+        attr = (guththila_attr_t *)guththila_stack_get_by_index(&m->attrib, i, env);
+        if(attr && (GUTHTHILA_TOKEN_IN(attr->name, start, end)
+            || GUTHTHILA_TOKEN_IN(attr->pref, start, end)
+            || GUTHTHILA_TOKEN_IN(attr->val, start, end)))
+        {
+            return 1;
+        }
+    }
+    for(i = 0; i < GUTHTHILA_STACK_SIZE(m->elem); i++)
+    {
+        elem = (guththila_element_t *)guththila_stack_get_by_index(&m->elem, i, env);
+        if(elem && (GUTHTHILA_TOKEN_IN(elem->name, start, end)
+            || GUTHTHILA_TOKEN_IN(elem->prefix, start, end)))
+        {
+            return 1;
+        }
+    }
+    for(i = 0; i < GUTHTHILA_STACK_SIZE(m->namesp); i++)
+    {
+        nmsp = (guththila_elem_namesp_t *)guththila_stack_get_by_index(&m->namesp, i, env);
+        for(j = 0; nmsp && j < nmsp->no; j++)
+        {
+            if(GUTHTHILA_TOKEN_IN(nmsp->namesp[j].name, start, end)
+                || GUTHTHILA_TOKEN_IN(nmsp->namesp[j].uri, start, end))
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Frees the buffers no token is in, keeping one of the default size for reuse.
+ * The buffer before the current one is kept as well, as the caller of
+ * guththila_next_char may still be reading from it.
+ */
+static void
+guththila_release_buffers(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    guththila_buffer_t *b = &m->buffer;
+    int i, kept = 0;
+
+    for(i = 0; i < b->cur_buff; i++)
+    {
+        if(i == b->cur_buff - 1
+            || guththila_tokens_in(m, b->buff[i], b->buff[i] + b->data_size[i], env))
+        {
+            b->buff[kept] = b->buff[i];
+            b->buffs_size[kept] = b->buffs_size[i];
+            b->data_size[kept] = b->data_size[i];
+            kept++;
+        }
+        else if(!b->spare && b->buffs_size[i] == GUTHTHILA_BUFFER_DEF_SIZE)
+        {
+            b->spare = b->buff[i];
+        }
+        else
+        {
+            AXIS2_FREE(env->allocator, b->buff[i]);
+        }
+    }
+    b->buff[kept] = b->buff[b->cur_buff];
+    b->buffs_size[kept] = b->buffs_size[b->cur_buff];
+    b->data_size[kept] = b->data_size[b->cur_buff];
+    b->cur_buff = kept;
+}
+
+/*
+ * Starts a new buffer after the current one, moving the bytes from position
+ * keep on to it. The new buffer is twice the size of the current one. In
+ * streaming mode it is of the default size, or large enough for what is
+ * moved, and the buffers no longer needed are released. Fails if the
+ * bytes before keep that are not yet checked are not UTF-8.
+ */
+static int
+guththila_next_buffer(
+    guththila_t * m,
+    size_t keep,
+    const axutil_env_t * env)
+{
+    guththila_buffer_t *b = &m->buffer;
+    size_t data_move = 0, size, i, checked, end;
+    guththila_char_t **temp1;
+    size_t * temp2, *temp3;
+    const unsigned char *data;
+
+    /* the bytes left behind are not read again, so those read one by one are checked now */
+    end = b->pre_tot_data + b->data_size[b->cur_buff];
+    if(keep < end)
+        end = keep;
+    checked = m->utf8_checked > b->pre_tot_data ? m->utf8_checked : b->pre_tot_data;
+    if(m->utf8_check && checked < end)
+    {
+        data = (const unsigned char *)b->buff[b->cur_buff];
+        if(!guththila_utf8_check(data + checked - b->pre_tot_data, data + end - b->pre_tot_data,
+            0))
+            return GUTHTHILA_FAILURE;
+        m->utf8_checked = end;
+    }
+
+    if(b->cur_buff == (int)b->no_buffers - 1)
+    {
+        /* we are out of allocated buffers. Need to allocate more buffers */
+        temp1 = (guththila_char_t **)AXIS2_MALLOC(env->allocator,
+            sizeof(guththila_char_t *) * b->no_buffers * 2);
+        temp2 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * b->no_buffers * 2);
+        temp3 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * b->no_buffers * 2);
+        if(!temp1 || !temp2 || !temp3)
+            return GUTHTHILA_FAILURE;
+        for(i = 0; i < b->no_buffers; i++)
+        {
+            temp1[i] = b->buff[i];
+            temp2[i] = b->buffs_size[i];
+            temp3[i] = b->data_size[i];
+        }
+        AXIS2_FREE(env->allocator, b->buff);
+        AXIS2_FREE(env->allocator, b->data_size);
+        AXIS2_FREE(env->allocator, b->buffs_size);
+        b->buff = temp1;
+        b->buffs_size = temp2;
+        b->data_size = temp3;
+        b->no_buffers *= 2;
+    }
+
+    if(keep < b->pre_tot_data)
+        keep = b->pre_tot_data;
+    if(keep < b->pre_tot_data + b->data_size[b->cur_buff])
+        data_move = b->pre_tot_data + b->data_size[b->cur_buff] - keep;
+    if(m->streaming)
+    {
+        size = GUTHTHILA_BUFFER_DEF_SIZE;
+        while(size < 2 * data_move + GUTHTHILA_BUFFER_DEF_MIN_SIZE)
+            size *= 2;
+    }
+    else
+    {
+        size = b->buffs_size[b->cur_buff] * 2;
+    }
+    if(size == GUTHTHILA_BUFFER_DEF_SIZE && b->spare)
+    {
+        b->buff[b->cur_buff + 1] = b->spare;
+        b->spare = NULL;
+    }
+    else
+    {
+        b->buff[b->cur_buff + 1] = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
+            sizeof(guththila_char_t) * size);
+        if(!b->buff[b->cur_buff + 1])
+            return GUTHTHILA_FAILURE;
+    }
+    b->cur_buff++;
+    b->buffs_size[b->cur_buff] = size;
+    b->data_size[b->cur_buff] = 0;
+    if(data_move)
+    {
+        memcpy(b->buff[b->cur_buff], b->buff[b->cur_buff - 1] + b->data_size[b->cur_buff - 1]
+            - data_move, data_move);
+        b->data_size[b->cur_buff - 1] -= data_move;
+        b->data_size[b->cur_buff] += data_move;
+    }
+    b->pre_tot_data += b->data_size[b->cur_buff - 1];
+    if(m->streaming)
+    {
+        guththila_release_buffers(m, env);
+    }
+    return GUTHTHILA_SUCCESS;
+}
+
+/*
+ * Starts the first buffer of a file or io reader, using the spare buffer if
+ * there is one, and fills it. Returns the no: of bytes read.
+ */
+static int
+guththila_first_buffer(
+    guththila_t * m,
+    const axutil_env_t * env)
+{
+    guththila_buffer_t *b = &m->buffer;
+    int temp;
+
+    if(b->spare)
+    {
+        b->buff[0] = b->spare;
+        b->spare = NULL;
+    }
+    else
+    {
+        b->buff[0] = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
+            sizeof(guththila_char_t) * GUTHTHILA_BUFFER_DEF_SIZE);
+        if(!b->buff[0])
+            return -1;
+    }
+    b->buffs_size[0] = GUTHTHILA_BUFFER_DEF_SIZE;
+    b->data_size[0] = 0;
+    b->cur_buff = 0;
+    temp = guththila_reader_read(m->reader, b->buff[0], 0, GUTHTHILA_BUFFER_DEF_SIZE, env);
+    if(temp > 0)
+        b->data_size[0] = temp;
+    return temp;
+}
+
 /* Return the next character */
 static int
 guththila_next_char(
@@ -1686,20 +3495,17 @@ guththila_next_char(
     const axutil_env_t * env)
 {
     int c;
-    size_t data_move, i;
     int temp;
-    guththila_char_t **temp1;
-    size_t * temp2, *temp3;
 
     /* we have a buffered reader. Easiest case just fetch the character from 
      * the buffer. Here we have a single buffer. 
      * */
-    if(m->reader->type == GUTHTHILA_MEMORY_READER)
+    if(GUTHTHILA_READER_IN_MEMORY(m->reader))
     {
         size_t index = m->next++;
         if(index < m->buffer.data_size[0])
         {
-            return m->buffer.buff[0][index];
+            return (unsigned char)m->buffer.buff[0][index];
         }
     }
     else
@@ -1709,63 +3515,21 @@ guththila_next_char(
             + GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer))
         {
             /* What we are looking for is already in the buffer */
-            c = m->buffer.buff[m->buffer.cur_buff][m->next++ - GUTHTHILA_BUFFER_PRE_DATA_SIZE(
-                m->buffer)];
+            c = (unsigned char)m->buffer.buff[m->buffer.cur_buff][m->next++
+                - GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)];
             return c;
         }
         else if(m->buffer.cur_buff != -1 && m->next >= GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)
             + GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer))
         {
-            /* if we have don't have enough space in current buffer, have to create new buffer */
+            /* if we have don't have enough space in current buffer, have to create new buffer.
+             * We need to have the content for one token in a single buffer, so the open
+             * token is moved to the new buffer */
             if(m->buffer.buffs_size[m->buffer.cur_buff] <
                 GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer) + GUTHTHILA_BUFFER_DEF_MIN_SIZE)
             {
-                if(m->buffer.cur_buff == (int)m->buffer.no_buffers - 1)
-                {
-                    /* we are out of allocated buffers. Need to allocate more buffers */
-                    temp = m->buffer.no_buffers * 2;
-                    temp1 = (guththila_char_t **)AXIS2_MALLOC(env->allocator,
-                        sizeof(guththila_char_t *) * temp);
-                    temp2 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * temp);
-                    temp3 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * temp);
-                    if(!temp1 || !temp2 || !temp3)
-                        return (-1);
-                    for(i = 0; i < m->buffer.no_buffers; i++)
-                    {
-                        temp1[i] = m->buffer.buff[i];
-                        temp2[i] = m->buffer.buffs_size[i];
-                        temp3[i] = m->buffer.data_size[i];
-                    }
-                    AXIS2_FREE(env->allocator, m->buffer.buff);
-                    AXIS2_FREE(env->allocator, m->buffer.data_size);
-                    AXIS2_FREE(env->allocator, m->buffer.buffs_size);
-                    m->buffer.buff = temp1;
-                    m->buffer.buffs_size = temp2;
-                    m->buffer.data_size = temp3;
-                    m->buffer.no_buffers *= 2;
-                }
-                m->buffer.buff[m->buffer.cur_buff + 1] = (guththila_char_t *)AXIS2_MALLOC(
-                    env->allocator,
-                    sizeof(guththila_char_t) * m->buffer.buffs_size[m->buffer.cur_buff] * 2);
-                if(!m->buffer.buff[m->buffer.cur_buff + 1])
+                if(guththila_next_buffer(m, m->last_start, env) != GUTHTHILA_SUCCESS)
                     return -1;
-                m->buffer.cur_buff++;
-                m->buffer.buffs_size[m->buffer.cur_buff] =
-                    m->buffer.buffs_size[m->buffer.cur_buff - 1] * 2;
-                m->buffer.data_size[m->buffer.cur_buff] = 0;
-                /* We need to have the content for one token in a single buffer.
-                 * So if the space is not sufficient we have to move first part
-                 * of the token to the next buffer */
-                if(m->last_start != -1)
-                {
-                    data_move = m->buffer.data_size[m->buffer.cur_buff - 1] -
-                        (m->last_start - m->buffer.pre_tot_data);
-                    memcpy(m->buffer.buff[m->buffer.cur_buff], m->buffer.buff[m->buffer.cur_buff - 1]
-                        + m->buffer.data_size[m->buffer.cur_buff - 1] - data_move, data_move);
-                    m->buffer.data_size[m->buffer.cur_buff - 1] -= data_move;
-                    m->buffer.data_size[m->buffer.cur_buff] += data_move;
-                }
-                m->buffer.pre_tot_data += m->buffer.data_size[m->buffer.cur_buff - 1];
             }
             temp = guththila_reader_read(m->reader, GUTHTHILA_BUFFER_CURRENT_BUFF(m->buffer), 0,
                 (int)GUTHTHILA_BUFFER_CURRENT_BUFF_SIZE(m->buffer), env);
@@ -1777,21 +3541,16 @@ guththila_next_char(
             {
                 return -1;
             }
-            c = m->buffer.buff[m->buffer.cur_buff][m->next++ - GUTHTHILA_BUFFER_PRE_DATA_SIZE(
-                m->buffer)];
+            c = (unsigned char)m->buffer.buff[m->buffer.cur_buff][m->next++
+                - GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)];
             return c;
         }
         /* Initial stage. We dont' have the array of buffers allocated*/
         else if(m->buffer.cur_buff == -1)
         {
-            m->buffer.buff[0] = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
-                sizeof(guththila_char_t) * GUTHTHILA_BUFFER_DEF_SIZE);
-            m->buffer.buffs_size[0] = GUTHTHILA_BUFFER_DEF_SIZE;
-            m->buffer.cur_buff = 0;
-            temp = guththila_reader_read(m->reader, m->buffer.buff[0], 0,
-                GUTHTHILA_BUFFER_DEF_SIZE, env);
-            m->buffer.data_size[0] = temp;
-            c = m->buffer.buff[0][m->next++];
+            if(guththila_first_buffer(m, env) <= 0)
+                return -1;
+            c = (unsigned char)m->buffer.buff[0][m->next++];
             return c;
         }
     }
@@ -1809,11 +3568,9 @@ guththila_next_no_char(
     size_t no,
     const axutil_env_t * env)
 {
-    int temp, data_move;
+    int temp;
     size_t i;
-    guththila_char_t **temp1;
-    size_t * temp2, *temp3;
-    if(m->reader->type == GUTHTHILA_MEMORY_READER && m->next + no - 1
+    if(GUTHTHILA_READER_IN_MEMORY(m->reader) && m->next + no - 1
         < GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer) && m->buffer.cur_buff != -1)
     {
         for(i = 0; i < no; i++)
@@ -1823,7 +3580,7 @@ guththila_next_no_char(
         return (int)no;
         /* We are sure that the difference lies within the int range */
     }
-    else if(m->reader->type == GUTHTHILA_IO_READER || m->reader->type == GUTHTHILA_FILE_READER)
+    else if(!GUTHTHILA_READER_IN_MEMORY(m->reader))
     {
         if(m->next + no <= GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)
             + GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer) && m->buffer.cur_buff != -1) 
@@ -1839,54 +3596,10 @@ guththila_next_no_char(
         else if(m->next + no > GUTHTHILA_BUFFER_PRE_DATA_SIZE(m->buffer)
             + GUTHTHILA_BUFFER_CURRENT_DATA_SIZE(m->buffer) && m->buffer.cur_buff != -1) 
         {
-            /* We are sure that the difference lies within the int range */
-            if(m->buffer.cur_buff == (int)m->buffer.no_buffers - 1)
-            {
-                temp = m->buffer.no_buffers * 2;
-                temp1 = (guththila_char_t **)AXIS2_MALLOC(env->allocator,
-                    sizeof(guththila_char_t *) * temp);
-                temp2 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * temp);
-                temp3 = (size_t *)AXIS2_MALLOC(env->allocator, sizeof(size_t) * temp);
-                if(!temp1 || !temp2 || !temp3)
-                    return (-1);
-                for(i = 0; i < m->buffer.no_buffers; i++)
-                {
-                    temp1[i] = m->buffer.buff[i];
-                    temp2[i] = m->buffer.buffs_size[i];
-                    temp3[i] = m->buffer.data_size[i];
-                }
-                AXIS2_FREE(env->allocator, m->buffer.buff);
-                AXIS2_FREE(env->allocator, m->buffer.data_size);
-                AXIS2_FREE(env->allocator, m->buffer.buffs_size);
-                m->buffer.buff = temp1;
-                m->buffer.buffs_size = temp2;
-                m->buffer.data_size = temp3;
-                m->buffer.no_buffers *= 2;
-            }
-            m->buffer.buff[m->buffer.cur_buff + 1] = (guththila_char_t *)AXIS2_MALLOC(
-                env->allocator, sizeof(guththila_char_t) * m->buffer.data_size[m->buffer.cur_buff]
-                    * 2);
-            if(!m->buffer.buff[m->buffer.cur_buff + 1])
+            /* the bytes from the open token, or from the next one, go on to the new buffer */
+            if(guththila_next_buffer(m, m->last_start < m->next ? m->last_start : m->next, env)
+                != GUTHTHILA_SUCCESS)
                 return -1;
-            m->buffer.cur_buff++;
-            m->buffer.buffs_size[m->buffer.cur_buff] = m->buffer.buffs_size[m->buffer.cur_buff - 1]
-                * 2;
-            m->buffer.data_size[m->buffer.cur_buff] = 0;
-            data_move = (int)m->next;
-            /* We are sure that the difference lies within the int range */
-            if((m->last_start != -1) && (m->last_start < data_move))
-                data_move = m->last_start;
-            data_move = (int)m->buffer.data_size[m->buffer.cur_buff - 1] - (data_move
-                - (int)m->buffer.pre_tot_data);
-            /* We are sure that the difference lies within the int range */
-            if(data_move)
-            {
-                memcpy(m->buffer.buff[m->buffer.cur_buff], m->buffer.buff[m->buffer.cur_buff - 1]
-                    + m->buffer.data_size[m->buffer.cur_buff - 1] - data_move, data_move);
-                m->buffer.data_size[m->buffer.cur_buff - 1] -= data_move;
-                m->buffer.data_size[m->buffer.cur_buff] += data_move;
-            }
-            m->buffer.pre_tot_data += m->buffer.data_size[m->buffer.cur_buff - 1];
             temp = guththila_reader_read(m->reader, GUTHTHILA_BUFFER_CURRENT_BUFF(m->buffer), 0,
                 (int)GUTHTHILA_BUFFER_CURRENT_BUFF_SIZE(m-> buffer), env);
             /* We are sure that the difference lies within the int range */
@@ -1908,13 +3621,8 @@ guththila_next_no_char(
         }
         else if(m->buffer.cur_buff == -1)
         {
-            m->buffer.buff[0] = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
-                sizeof(guththila_char_t) * GUTHTHILA_BUFFER_DEF_SIZE);
-            m->buffer.buffs_size[0] = GUTHTHILA_BUFFER_DEF_SIZE;
-            m->buffer.cur_buff = 0;
-            temp = guththila_reader_read(m->reader, m->buffer.buff[0], 0,
-                GUTHTHILA_BUFFER_DEF_SIZE, env);
-            m->buffer.data_size[0] = temp;
+            if(guththila_first_buffer(m, env) <= 0)
+                return -1;
             for(i = 0; i < no; i++)
             {
                 bytes[i] = m->buffer.buff[m->buffer.cur_buff][m->next++
@@ -1935,3 +3643,26 @@ guththila_get_current_buffer(
     return guththila_buffer_get(&m->buffer, env);
 }
 
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_set_streaming(
+    guththila_t * m,
+    int streaming,
+    const axutil_env_t * env)
+{
+    m->streaming = streaming;
+}
+
+GUTHTHILA_EXPORT void GUTHTHILA_CALL
+guththila_set_utf8_check(
+    guththila_t * m,
+    int utf8_check,
+    const axutil_env_t * env)
+{
+    /* the input read so far is not checked */
+    if(utf8_check && !m->utf8_check)
+    {
+        m->utf8_checked = m->next;
+    }
+    m->utf8_check = utf8_check;
+}
+
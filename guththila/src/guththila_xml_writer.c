@@ -34,7 +34,8 @@
 #define GUTHTHILA_WRITER_ELEM_FREE(wr, elem, _env)		\
     if ((elem)->prefix) guththila_tok_list_release_token(&wr->tok_list, (elem)->prefix, _env); \
     if ((elem)->name) guththila_tok_list_release_token(&wr->tok_list, (elem)->name, _env); \
-    AXIS2_FREE(env->allocator, elem);
+    AXIS2_FREE(env->allocator, elem); \
+    if ((wr)->type == GUTHTHILA_WRITER_STREAM) guththila_writer_names_release(wr, _env);
 #endif 
 #endif 
 
@@ -53,7 +54,8 @@
         AXIS2_FREE(env->allocator, _namesp); \
     } \
     _namesp = NULL; \
-}
+} \
+guththila_writer_prefixes_drop(wr, _no, NULL, _env);
 #endif 
 #else  
 #ifndef GUTHTHILA_WRITER_CLEAR_NAMESP 
@@ -70,7 +72,8 @@
         AXIS2_FREE(env->allocator, _namesp); \
     } \
     _namesp = NULL; \
-}
+} \
+guththila_writer_prefixes_drop(wr, _no, NULL, _env);
 #endif 
 #endif 
 
@@ -92,6 +95,14 @@
     _elem->prefix->NULL;
 #endif 
 
+/*
+ * Position in the output of a token written with guththila_write_xtoken. A
+ * chain or stream writer can only give the position of the last token written.
+ */
+#define GUTHTHILA_WRITER_POS(_wr, _pos) ((_wr)->type == GUTHTHILA_WRITER_CHAIN \
+    || (_wr)->type == GUTHTHILA_WRITER_STREAM ? \
+    (_wr)->last_xtoken : GUTHTHILA_BUF_POS((_wr)->buffer, _pos))
+
 /*
  #ifndef guththila_write(_wr, _buff, _buff_size)
  #define guththila_write(_wr, _buff, _buff_size)	\
@@ -140,6 +151,173 @@ int GUTHTHILA_CALL guththila_free_empty_element(
     guththila_xml_writer_t *wr,
     const axutil_env_t *env);
 
+/*
+ * A stream writer does not keep what it has written, so the tokens that the
+ * element and namespace stacks point to are copied to chunks of their own,
+ * which are never moved. The elements and namespaces are released in the
+ * reverse order of their tokens, so the copies are dropped from the end.
+ */
+typedef struct guththila_xml_writer_names_s
+{
+    struct guththila_xml_writer_names_s *prev;
+    size_t size;
+    size_t len;
+} guththila_xml_writer_names_t;
+
+#define GUTHTHILA_WRITER_NAMES_SIZE 1024
+#define GUTHTHILA_WRITER_NAMES_DATA(_names) ((guththila_char_t *)((_names) + 1))
+
+/*
+ * Copies a token of a stream writer. Returns the copy, NULL on failure.
+ */
+static guththila_char_t *
+guththila_writer_names_add(
+    guththila_xml_writer_t * wr,
+    guththila_char_t *buff,
+    size_t buff_len,
+    const axutil_env_t * env)
+{
+    guththila_xml_writer_names_t *names = wr->names;
+    guththila_char_t *copy = NULL;
+    size_t size = GUTHTHILA_WRITER_NAMES_SIZE;
+
+    if(!names || names->size - names->len < buff_len)
+    {
+        if(buff_len > size)
+        {
+            size = buff_len;
+        }
+        names = (guththila_xml_writer_names_t *)AXIS2_MALLOC(env->allocator,
+            sizeof(guththila_xml_writer_names_t) + size);
+        if(!names)
+        {
+            return NULL;
+        }
+        names->prev = wr->names;
+        names->size = size;
+        names->len = 0;
+        wr->names = names;
+    }
+    copy = GUTHTHILA_WRITER_NAMES_DATA(names) + names->len;
+    memcpy(copy, buff, buff_len);
+    names->len += buff_len;
+    return copy;
+}
+
+/*
+ * Returns the end of tok if it is in names and ends after end, else end.
+ */
+static guththila_char_t *
+guththila_writer_names_end(
+    guththila_xml_writer_names_t * names,
+    guththila_token_t * tok,
+    guththila_char_t *end)
+{
+    guththila_char_t *data = GUTHTHILA_WRITER_NAMES_DATA(names);
+
+    if(tok && tok->start >= data && tok->start < data + names->len
+        && (!end || tok->start + tok->size > end))
+    {
+        return tok->start + tok->size;
+    }
+    return end;
+}
+
+/*
+ * Drops the copies of the tokens no longer needed, once an element has been
+ * closed. The last of those still needed belong to the element now open, or
+ * to the namespaces declared last. The first chunk is kept for reuse.
+ */
+static void
+guththila_writer_names_release(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env)
+{
+    guththila_xml_writer_element_t * elem = NULL;
+    guththila_xml_writer_namesp_t * namesp = NULL;
+    guththila_xml_writer_names_t *names = NULL;
+    guththila_char_t *end = NULL;
+    int i = 0;
+
+    if(GUTHTHILA_STACK_SIZE(wr->element) > 0)
+    {
+        elem = (guththila_xml_writer_element_t *)guththila_stack_peek(&wr->element, env);
+    }
+    if(GUTHTHILA_STACK_SIZE(wr->namesp) > 0)
+    {
+        namesp = (guththila_xml_writer_namesp_t *)guththila_stack_peek(&wr->namesp, env);
+    }
+    while((names = wr->names) != NULL)
+    {
+        end = NULL;
+        if(elem)
+        {
+            end = guththila_writer_names_end(names, elem->name, end);
+            end = guththila_writer_names_end(names, elem->prefix, end);
+        }
+        for(i = 0; namesp && i < namesp->no; i++)
+        {
+            end = guththila_writer_names_end(names, namesp->name[i], end);
+            end = guththila_writer_names_end(names, namesp->uri[i], end);
+        }
+        if(end)
+        {
+            names->len = end - GUTHTHILA_WRITER_NAMES_DATA(names);
+            return;
+        }
+        if(!names->prev)
+        {
+            names->len = 0;
+            return;
+        }
+        wr->names = names->prev;
+        AXIS2_FREE(env->allocator, names);
+    }
+}
+
+/*
+ * Forgets the prefixes found in namespace stack entries from no up, and those
+ * of uri if it is given, as a namespace declared for it may come first now.
+ */
+static void
+guththila_writer_prefixes_drop(
+    guththila_xml_writer_t * wr,
+    int no,
+    guththila_char_t *uri,
+    const axutil_env_t * env)
+{
+    guththila_xml_writer_prefix_t *cached = NULL;
+    int i = 0;
+
+    for(i = 0; i < GUTHTHILA_XML_WRITER_PREFIX_CACHE_SIZE; i++)
+    {
+        cached = &wr->prefixes[i];
+        if(cached->uri && (cached->stack_no >= no || (uri && !strcmp(cached->uri, uri))))
+        {
+            AXIS2_FREE(env->allocator, cached->uri);
+            cached->uri = NULL;
+            cached->prefix = NULL;
+        }
+    }
+}
+
+/*
+ * Sets up the members every kind of writer has.
+ */
+static void
+guththila_writer_init_common(
+    guththila_xml_writer_t * wr)
+{
+    wr->status = BEGINING;
+    wr->next = 0;
+    wr->chain = NULL;
+    wr->last_xtoken = NULL;
+    wr->stream = NULL;
+    wr->names = NULL;
+    memset(wr->prefixes, 0, sizeof(wr->prefixes));
+    wr->next_prefix = 0;
+}
+
 GUTHTHILA_EXPORT guththila_xml_writer_t * GUTHTHILA_CALL
 guththila_create_xml_stream_writer(
     guththila_char_t *file_name,
@@ -168,8 +346,7 @@ guththila_create_xml_stream_writer(
         return NULL;
     }
     wr->type = GUTHTHILA_WRITER_FILE;
-    wr->status = BEGINING;
-    wr->next = 0;
+    guththila_writer_init_common(wr);
     return wr;
 }
 
@@ -210,8 +387,95 @@ guththila_create_xml_stream_writer_for_memory(
     }
 #endif 
     wr->type = GUTHTHILA_WRITER_MEMORY;
-    wr->status = BEGINING;
-    wr->next = 0;
+    guththila_writer_init_common(wr);
+    return wr;
+}
+
+GUTHTHILA_EXPORT guththila_xml_writer_t * GUTHTHILA_CALL
+guththila_create_xml_stream_writer_for_chain(
+    const axutil_env_t * env,
+    axutil_buffer_chain_t * chain)
+{
+    guththila_xml_writer_t * wr = NULL;
+    if(!chain)
+        return NULL;
+    wr = AXIS2_MALLOC(env->allocator, sizeof(guththila_xml_writer_t));
+    if(!wr)
+        return NULL;
+    if(!guththila_stack_init(&wr->element, env))
+    {
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+    if(!guththila_stack_init(&wr->namesp, env))
+    {
+        guththila_stack_un_init(&wr->element, env);
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+
+#ifdef GUTHTHILA_XML_WRITER_TOKEN
+    if (!guththila_tok_list_init(&wr->tok_list, env))
+    {
+        guththila_stack_un_init(&wr->element, env);
+        guththila_stack_un_init(&wr->namesp, env);
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+#endif 
+    wr->type = GUTHTHILA_WRITER_CHAIN;
+    guththila_writer_init_common(wr);
+    wr->chain = chain;
+    return wr;
+}
+
+GUTHTHILA_EXPORT guththila_xml_writer_t * GUTHTHILA_CALL
+guththila_create_xml_stream_writer_for_stream(
+    const axutil_env_t * env,
+    axutil_stream_t * stream,
+    size_t flush_size)
+{
+    guththila_xml_writer_t * wr = NULL;
+    if(!stream)
+        return NULL;
+    if(!flush_size)
+        flush_size = GUTHTHILA_XML_WRITER_FLUSH_SIZE;
+    wr = AXIS2_MALLOC(env->allocator, sizeof(guththila_xml_writer_t));
+    if(!wr)
+        return NULL;
+    /* Only the first buffer is used, it is emptied into the stream when full */
+    if(!guththila_buffer_init(&wr->buffer, (int)flush_size, env))
+    {
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+    if(!guththila_stack_init(&wr->element, env))
+    {
+        guththila_buffer_un_init(&wr->buffer, env);
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+    if(!guththila_stack_init(&wr->namesp, env))
+    {
+        guththila_buffer_un_init(&wr->buffer, env);
+        guththila_stack_un_init(&wr->element, env);
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+
+#ifdef GUTHTHILA_XML_WRITER_TOKEN
+    if (!guththila_tok_list_init(&wr->tok_list, env))
+    {
+        guththila_buffer_un_init(&wr->buffer, env);
+        guththila_stack_un_init(&wr->element, env);
+        guththila_stack_un_init(&wr->namesp, env);
+        AXIS2_FREE(env->allocator, wr);
+        return NULL;
+    }
+#endif 
+    wr->type = GUTHTHILA_WRITER_STREAM;
+    guththila_writer_init_common(wr);
+    wr->stream = stream;
     return wr;
 }
 
@@ -220,6 +484,8 @@ guththila_xml_writer_free(
     guththila_xml_writer_t * wr,
     const axutil_env_t * env)
 {
+    guththila_xml_writer_names_t *names = NULL;
+
     if(wr->type == GUTHTHILA_WRITER_MEMORY)
     {
         guththila_buffer_un_init(&wr->buffer, env);
@@ -228,6 +494,17 @@ guththila_xml_writer_free(
     {
         fclose(wr->out_stream);
     }
+    else if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        guththila_flush(wr, env);
+        guththila_buffer_un_init(&wr->buffer, env);
+        while((names = wr->names) != NULL)
+        {
+            wr->names = names->prev;
+            AXIS2_FREE(env->allocator, names);
+        }
+    }
+    guththila_writer_prefixes_drop(wr, 0, NULL, env);
 
 #ifdef GUTHTHILA_XML_WRITER_TOKEN
     guththila_tok_list_free_data(&wr->tok_list, env);
@@ -237,6 +514,74 @@ guththila_xml_writer_free(
     AXIS2_FREE(env->allocator, wr);
 }
 
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_xml_writer_reset(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env)
+{
+    int i = 0, j = 0;
+    guththila_xml_writer_element_t * elem = NULL;
+    guththila_xml_writer_namesp_t * namesp = NULL;
+
+    while(GUTHTHILA_STACK_SIZE(wr->element) > 0)
+    {
+        elem = (guththila_xml_writer_element_t *)guththila_stack_pop(&wr->element, env);
+        if(elem)
+        {
+            GUTHTHILA_WRITER_ELEM_FREE(wr, elem, env);
+        }
+    }
+    GUTHTHILA_WRITER_CLEAR_NAMESP(wr, &wr->namesp, 0, i, namesp, j, env);
+    if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        guththila_writer_names_release(wr, env);
+    }
+
+#ifdef GUTHTHILA_XML_WRITER_TOKEN
+    guththila_tok_list_reset(&wr->tok_list, env);
+#endif  
+    if(wr->type == GUTHTHILA_WRITER_MEMORY
+        && !guththila_buffer_reset(&wr->buffer, GUTHTHILA_BUFFER_DEF_SIZE, env))
+    {
+        return GUTHTHILA_FAILURE;
+    }
+    wr->status = BEGINING;
+    wr->next = 0;
+    wr->last_xtoken = NULL;
+    return GUTHTHILA_SUCCESS;
+}
+
+/*
+ * Writes data out to the stream of a stream writer, through its buffer unless
+ * the data would not fit in the buffer anyway.
+ */
+static int
+guththila_write_stream(
+    guththila_xml_writer_t * wr,
+    guththila_char_t *buff,
+    size_t buff_len,
+    const axutil_env_t * env)
+{
+    int written = 0;
+
+    if(wr->buffer.buffs_size[0] - wr->buffer.data_size[0] < buff_len)
+    {
+        if(guththila_flush(wr, env) != GUTHTHILA_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        while(buff_len >= wr->buffer.buffs_size[0])
+        {
+            written = axutil_stream_write(wr->stream, env, buff, buff_len);
+            if(written <= 0)
+                return GUTHTHILA_FAILURE;
+            buff += written;
+            buff_len -= written;
+        }
+    }
+    memcpy(wr->buffer.buff[0] + wr->buffer.data_size[0], buff, buff_len);
+    wr->buffer.data_size[0] += buff_len;
+    return GUTHTHILA_SUCCESS;
+}
+
 int GUTHTHILA_CALL
 guththila_write(
     guththila_xml_writer_t * wr,
@@ -314,6 +659,22 @@ guththila_write(
             return (int)buff_len;
         }
     }
+    else if(wr->type == GUTHTHILA_WRITER_CHAIN)
+    {
+        if(axutil_buffer_chain_append(wr->chain, env, buff, buff_len) != AXIS2_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)buff_len;
+        /* We are sure that the difference lies within the int range */
+        return (int)buff_len;
+    }
+    else if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        if(guththila_write_stream(wr, buff, buff_len, env) != GUTHTHILA_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)buff_len;
+        /* We are sure that the difference lies within the int range */
+        return (int)buff_len;
+    }
     else if(wr->type == GUTHTHILA_WRITER_FILE)
     {
         return (int)fwrite(buff, 1, buff_len, wr->out_stream);
@@ -398,6 +759,22 @@ guththila_write_token(
             return (int)tok->size;
         }
     }
+    else if(wr->type == GUTHTHILA_WRITER_CHAIN)
+    {
+        if(axutil_buffer_chain_append(wr->chain, env, tok->start, tok->size) != AXIS2_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)tok->size;
+        /* We are sure that the difference lies within the int range */
+        return (int)tok->size;
+    }
+    else if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        if(guththila_write_stream(wr, tok->start, tok->size, env) != GUTHTHILA_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)tok->size;
+        /* We are sure that the difference lies within the int range */
+        return (int)tok->size;
+    }
     else if(wr->type == GUTHTHILA_WRITER_FILE)
     {
         return (int)fwrite(tok->start, 1, tok->size, wr->out_stream);
@@ -474,6 +851,27 @@ guththila_write_xtoken(
             return (int)buff_len;
         }
     }
+    else if(wr->type == GUTHTHILA_WRITER_CHAIN)
+    {
+        /* Tokens are kept whole, as the writer points back to them */
+        wr->last_xtoken = axutil_buffer_chain_append_contiguous(wr->chain, env, buff, buff_len);
+        if(!wr->last_xtoken)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)buff_len;
+        /* We are sure that the difference lies within the int range */
+        return (int)buff_len;
+    }
+    else if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        /* The output is not kept, the writer points back to a copy */
+        wr->last_xtoken = guththila_writer_names_add(wr, buff, buff_len, env);
+        if(!wr->last_xtoken || guththila_write_stream(wr, buff, buff_len, env)
+            != GUTHTHILA_SUCCESS)
+            return GUTHTHILA_FAILURE;
+        wr->next += (int)buff_len;
+        /* We are sure that the difference lies within the int range */
+        return (int)buff_len;
+    }
     else if(wr->type == GUTHTHILA_WRITER_FILE)
     {
         return (int)fwrite(buff, 1, buff_len, wr->out_stream);
@@ -481,6 +879,37 @@ guththila_write_xtoken(
     return GUTHTHILA_FAILURE;
 }
 
+GUTHTHILA_EXPORT int GUTHTHILA_CALL
+guththila_flush(
+    guththila_xml_writer_t * wr,
+    const axutil_env_t * env)
+{
+    guththila_char_t *buff = NULL;
+    size_t len = 0;
+    int written = 0;
+
+    if(wr->type == GUTHTHILA_WRITER_STREAM)
+    {
+        buff = wr->buffer.buff[0];
+        len = wr->buffer.data_size[0];
+        while(len > 0)
+        {
+            written = axutil_stream_write(wr->stream, env, buff, len);
+            if(written <= 0)
+                return GUTHTHILA_FAILURE;
+            buff += written;
+            len -= written;
+        }
+        wr->buffer.data_size[0] = 0;
+    }
+    else if(wr->type == GUTHTHILA_WRITER_FILE)
+    {
+        if(fflush(wr->out_stream))
+            return GUTHTHILA_FAILURE;
+    }
+    return GUTHTHILA_SUCCESS;
+}
+
 int GUTHTHILA_CALL
 guththila_free_empty_element(
     guththila_xml_writer_t *wr,
@@ -593,7 +1022,7 @@ guththila_write_start_element(
     element->prefix = NULL;
 #else  
     element->name = guththila_tok_list_get_token(&wr->tok_list, env);
-    element->name->start = GUTHTHILA_BUF_POS(wr->buffer, cur_pos);
+    element->name->start = GUTHTHILA_WRITER_POS(wr, cur_pos);
     element->name->size = len;
     element->prefix = NULL;
 
@@ -777,6 +1206,89 @@ guththila_write_comment(
     return GUTHTHILA_FAILURE;
 }
 
+/*
+ * Text is escaped by writing the runs between the characters that need it
+ * whole. The runs are found 16 bytes at a time with SSE2, and a word at a
+ * time elsewhere.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define GUTHTHILA_ESCAPE_SSE2
+#define GUTHTHILA_ESCAPE_FIRST_BIT(mask) __builtin_ctz(mask)
+#include <emmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GUTHTHILA_ESCAPE_SSE2
+#include <emmintrin.h>
+#include <intrin.h>
+static int
+guththila_escape_first_bit(
+    unsigned int mask)
+{
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return (int)i;
+}
+#define GUTHTHILA_ESCAPE_FIRST_BIT(mask) guththila_escape_first_bit(mask)
+#endif
+
+#define GUTHTHILA_ESCAPE_IS_SPECIAL(b) \
+    ((b) == '&' || (b) == '<' || (b) == '>' || (b) == '\'' || (b) == '"')
+
+/* Word at a time tests, see "Bit Twiddling Hacks". Each tells whether any byte of x matches. */
+#define GUTHTHILA_ESCAPE_ONES ((size_t)-1 / 0xFF)
+#define GUTHTHILA_ESCAPE_HAS_ZERO(x) \
+    (((x) - GUTHTHILA_ESCAPE_ONES) & ~(x) & (GUTHTHILA_ESCAPE_ONES * 0x80))
+#define GUTHTHILA_ESCAPE_HAS_BYTE(x, b) GUTHTHILA_ESCAPE_HAS_ZERO((x) ^ (GUTHTHILA_ESCAPE_ONES * (b)))
+
+/*
+ * Returns the offset of the first character in p that needs escaping, or len.
+ */
+static size_t
+guththila_escape_scan(
+    const unsigned char *p,
+    size_t len)
+{
+    size_t i = 0;
+#ifdef GUTHTHILA_ESCAPE_SSE2
+    int mask;
+    __m128i v;
+    __m128i amp = _mm_set1_epi8('&');
+    __m128i lt = _mm_set1_epi8('<');
+    __m128i gt = _mm_set1_epi8('>');
+    __m128i apos = _mm_set1_epi8('\'');
+    __m128i quot = _mm_set1_epi8('"');
+
+    for(; i + 16 <= len; i += 16)
+    {
+        v = _mm_loadu_si128((const __m128i *)(p + i));
+        mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, amp),
+            _mm_cmpeq_epi8(v, lt)), _mm_or_si128(_mm_cmpeq_epi8(v, gt), _mm_cmpeq_epi8(v,
+            apos))), _mm_cmpeq_epi8(v, quot)));
+        if(mask)
+        {
+            return i + GUTHTHILA_ESCAPE_FIRST_BIT(mask);
+        }
+    }
+#else
+    size_t word;
+
+    for(; i + sizeof(word) <= len; i += sizeof(word))
+    {
+        memcpy(&word, p + i, sizeof(word));
+        if(GUTHTHILA_ESCAPE_HAS_BYTE(word, '&') || GUTHTHILA_ESCAPE_HAS_BYTE(word, '<')
+            || GUTHTHILA_ESCAPE_HAS_BYTE(word, '>') || GUTHTHILA_ESCAPE_HAS_BYTE(word, '\'')
+            || GUTHTHILA_ESCAPE_HAS_BYTE(word, '"'))
+        {
+            break;
+        }
+    }
+#endif
+    while(i < len && !GUTHTHILA_ESCAPE_IS_SPECIAL(p[i]))
+    {
+        i++;
+    }
+    return i;
+}
+
 GUTHTHILA_EXPORT int GUTHTHILA_CALL
 guththila_write_escape_character(
     guththila_xml_writer_t * wr,
@@ -819,18 +1331,9 @@ guththila_write_escaped_buffer(
 
     while(len > 0)
     {
-        size_t i = 0;
         /* scan buffer until the next special character (&, <, >, ', ") these need to be escaped,
          * otherwise XML will not be valid*/
-        guththila_char_t *pos = (guththila_char_t*)strpbrk(buff, "&<>'\"");
-        if(pos)
-        {
-            i = pos - buff;
-        }
-        else
-        {
-            i = len;
-        }
+        size_t i = guththila_escape_scan((const unsigned char *)buff, len);
 
         /* write everything until the special character */
         if(i > 0)
@@ -895,7 +1398,7 @@ guththila_write_empty_element(
     element->prefix = NULL;
 #else  
     element->name = guththila_tok_list_get_token(&wr->tok_list, env);
-    element->name->start = GUTHTHILA_BUF_POS(wr->buffer, cur_pos);
+    element->name->start = GUTHTHILA_WRITER_POS(wr, cur_pos);
     element->name->size = len;
     element->prefix = NULL;
 
@@ -960,14 +1463,15 @@ guththila_write_namespace(
     /* Proceed if we didn't find the namespace */
     if(!nmsp_found && (wr->status == START || wr->status == START_EMPTY))
     {
+        guththila_writer_prefixes_drop(wr, stack_size, uri, env);
         guththila_write(wr, " xmlns:", 7u, env);
         pref_start = wr->next;
         guththila_write_xtoken(wr, prefix, pref_len, env);
-        pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+        pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
         guththila_write(wr, "=\"", 2u, env);
         uri_start = wr->next;
         guththila_write_xtoken(wr, uri, uri_len, env);
-        uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+        uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
         guththila_write(wr, "\"", 1u, env);
         elem = guththila_stack_peek(&wr->element, env);
         if(elem && elem->name_sp_stack_no == -1)
@@ -1274,22 +1778,22 @@ guththila_write_start_element_with_prefix_and_namespace(
             guththila_write(wr, "><", 2u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
         }
@@ -1299,22 +1803,22 @@ guththila_write_start_element_with_prefix_and_namespace(
             guththila_write(wr, "/><", 2u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
             wr->status = START;
@@ -1324,22 +1828,22 @@ guththila_write_start_element_with_prefix_and_namespace(
             guththila_write(wr, "<", 1u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
             wr->status = START;
@@ -1351,6 +1855,8 @@ guththila_write_start_element_with_prefix_and_namespace(
         if(!nmsp_found)
         {
             /* If this namespace not defined previously we need to add it */
+            guththila_writer_prefixes_drop(wr, GUTHTHILA_STACK_SIZE(wr->namesp), namespace_uri,
+                env);
             namesp = (guththila_xml_writer_namesp_t *)AXIS2_MALLOC(env->allocator,
                 sizeof(guththila_xml_writer_namesp_t));
 
@@ -1479,7 +1985,7 @@ guththila_write_start_element_with_namespace(
     }
     elem_start = wr->next;
     guththila_write_xtoken(wr, local_name, elem_len, env);
-    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
 
     /* Remember this element's name and prefix, so the closing tag can be written later. */
 #ifndef GUTHTHILA_XML_WRITER_TOKEN
@@ -1558,7 +2064,7 @@ guththila_write_start_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else if(wr->status == START_EMPTY)
                 {
@@ -1568,7 +2074,7 @@ guththila_write_start_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else if(wr->status == BEGINING)
                 {
@@ -1577,7 +2083,7 @@ guththila_write_start_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else
                 {
@@ -1662,22 +2168,22 @@ guththila_write_empty_element_with_prefix_and_namespace(
             guththila_write(wr, "><", 2u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
             wr->status = START_EMPTY;
@@ -1688,22 +2194,22 @@ guththila_write_empty_element_with_prefix_and_namespace(
             guththila_write(wr, "/><", 2u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
         }
@@ -1712,22 +2218,22 @@ guththila_write_empty_element_with_prefix_and_namespace(
             guththila_write(wr, "<", 1u, env);
             elem_pref_start = wr->next;
             guththila_write_xtoken(wr, prefix, pref_len, env);
-            elem_pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_pref_start);
+            elem_pref_start_p = GUTHTHILA_WRITER_POS(wr, elem_pref_start);
             guththila_write(wr, ":", 1u, env);
             elem_start = wr->next;
             guththila_write_xtoken(wr, local_name, elem_len, env);
-            elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+            elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
             if(!nmsp_found)
             {
                 guththila_write(wr, " ", 1u, env);
                 guththila_write(wr, "xmlns:", 6u, env);
                 pref_start = wr->next;
                 guththila_write_xtoken(wr, prefix, pref_len, env);
-                pref_start_p = GUTHTHILA_BUF_POS(wr->buffer, pref_start);
+                pref_start_p = GUTHTHILA_WRITER_POS(wr, pref_start);
                 guththila_write(wr, "=\"", 2u, env);
                 uri_start = wr->next;
                 guththila_write_xtoken(wr, namespace_uri, uri_len, env);
-                uri_start_p = GUTHTHILA_BUF_POS(wr->buffer, uri_start);
+                uri_start_p = GUTHTHILA_WRITER_POS(wr, uri_start);
                 guththila_write(wr, "\"", 1u, env);
             }
             wr->status = START_EMPTY;
@@ -1739,6 +2245,8 @@ guththila_write_empty_element_with_prefix_and_namespace(
         if(!nmsp_found)
         {
             /* If the namespace is not defined we need to remember it for later*/
+            guththila_writer_prefixes_drop(wr, GUTHTHILA_STACK_SIZE(wr->namesp), namespace_uri,
+                env);
 #ifndef GUTHTHILA_XML_WRITER_TOKEN
             namesp->name = (guththila_char_t **)AXIS2_MALLOC(env->allocator,
                 sizeof(guththila_char_t *) * GUTHTHILA_XML_WRITER_NAMESP_DEF_SIZE);
@@ -1865,7 +2373,7 @@ guththila_write_empty_element_with_namespace(
     }
     elem_start = wr->next;
     guththila_write_xtoken(wr, local_name, elem_len, env);
-    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
 
     /* Remember this element's name and prefix, so the closing tag can be written later. */
 #ifndef GUTHTHILA_XML_WRITER_TOKEN
@@ -1944,7 +2452,7 @@ guththila_write_empty_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else if(wr->status == START_EMPTY)
                 {
@@ -1954,7 +2462,7 @@ guththila_write_empty_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else if(wr->status == BEGINING)
                 {
@@ -1963,7 +2471,7 @@ guththila_write_empty_element_with_prefix(
                     guththila_write(wr, ":", 1u, env);
                     elem_start = wr->next;
                     guththila_write_xtoken(wr, local_name, strlen(local_name), env);
-                    elem_start_p = GUTHTHILA_BUF_POS(wr->buffer, elem_start);
+                    elem_start_p = GUTHTHILA_WRITER_POS(wr, elem_start);
                 }
                 else
                 {
@@ -2060,8 +2568,18 @@ guththila_get_prefix_for_namespace(
     int i, j;
     int stack_size = GUTHTHILA_STACK_SIZE(wr->namesp);
     int temp;
-    guththila_char_t *str = NULL;
+    size_t len = strlen(nmsp);
+    guththila_xml_writer_prefix_t *cached = NULL;
     guththila_xml_writer_namesp_t * writer_namesp = NULL;
+
+    /* Serializers ask for the same few namespaces over and over */
+    for(i = 0; i < GUTHTHILA_XML_WRITER_PREFIX_CACHE_SIZE; i++)
+    {
+        if(wr->prefixes[i].uri && !strcmp(wr->prefixes[i].uri, nmsp))
+        {
+            return wr->prefixes[i].prefix;
+        }
+    }
     for(i = stack_size - 1; i >= 0; i--)
     {
         writer_namesp = (guththila_xml_writer_namesp_t *)guththila_stack_get_by_index(&wr-> namesp,
@@ -2069,10 +2587,28 @@ guththila_get_prefix_for_namespace(
         temp = writer_namesp->no;
         for(j = 0; j < temp; j++)
         {
-            if(!guththila_tok_str_cmp(writer_namesp->uri[j], nmsp, strlen(nmsp), env))
+            if(!guththila_tok_str_cmp(writer_namesp->uri[j], nmsp, len, env))
             {
-                GUTHTHILA_TOKEN_TO_STRING(writer_namesp->uri[j], str, env);
-                return str;
+                cached = &wr->prefixes[wr->next_prefix];
+                wr->next_prefix = (wr->next_prefix + 1) % GUTHTHILA_XML_WRITER_PREFIX_CACHE_SIZE;
+                if(cached->uri)
+                {
+                    AXIS2_FREE(env->allocator, cached->uri);
+                }
+                /* the uri and the prefix are kept in one block */
+                cached->uri = (guththila_char_t *)AXIS2_MALLOC(env->allocator,
+                    len + writer_namesp->name[j]->size + 2);
+                if(!cached->uri)
+                {
+                    cached->prefix = NULL;
+                    return NULL;
+                }
+                memcpy(cached->uri, nmsp, len + 1);
+                cached->prefix = cached->uri + len + 1;
+                memcpy(cached->prefix, writer_namesp->name[j]->start, writer_namesp->name[j]->size);
+                cached->prefix[writer_namesp->name[j]->size] = 0;
+                cached->stack_no = i;
+                return cached->prefix;
             }
         }
     }
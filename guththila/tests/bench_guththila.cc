@@ -0,0 +1,198 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Throughput of guththila_next() on SOAP envelopes.
+ *
+ * Usage: bench_guththila [ROUNDS] [utf8]
+ *
+ * Each envelope is parsed from memory until its end, without asking for
+ * names or values, so the time is spent scanning the input. The envelopes
+ * carry a large text payload with a few references and non ASCII
+ * characters, a large base64 payload, many small elements with
+ * attributes, and many addressing headers with long attribute values.
+ * With utf8 the input is also checked to be UTF-8, see
+ * guththila_set_utf8_check. Results are in MB of input per second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <guththila.h>
+#include <axutil_error_default.h>
+#include <axutil_log_default.h>
+
+static const char *envelope_start =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<soapenv:Envelope xmlns:soapenv=\"http://schemas.xmlsoap.org/soap/envelope/\">\n"
+    "  <soapenv:Header/>\n"
+    "  <soapenv:Body>\n"
+    "    <ns1:echo xmlns:ns1=\"http://ws.apache.org/axis2/c/samples\">\n";
+
+static const char *envelope_end =
+    "    </ns1:echo>\n"
+    "  </soapenv:Body>\n"
+    "</soapenv:Envelope>\n";
+
+static std::string
+text_envelope(
+    size_t size)
+{
+    static const char *sentence =
+        "Guththila reads the message in blocks, and na\xc3\xafve scanners step through "
+        "every byte &amp; compare it against each delimiter in turn. \xe2\x82\xac 42. ";
+    std::string xml = envelope_start;
+
+    xml += "      <ns1:text>";
+    while (xml.size() < size)
+        xml += sentence;
+    xml += "</ns1:text>\n";
+    return xml + envelope_end;
+}
+
+static std::string
+base64_envelope(
+    size_t size)
+{
+    static const char *alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string xml = envelope_start;
+
+    xml += "      <ns1:data contentType=\"application/octet-stream\">";
+    srand(1);
+    while (xml.size() < size)
+        xml += alphabet[rand() % 64];
+    xml += "==</ns1:data>\n";
+    return xml + envelope_end;
+}
+
+static std::string
+records_envelope(
+    size_t size)
+{
+    char record[256];
+    std::string xml = envelope_start;
+    int i = 0;
+
+    while (xml.size() < size)
+    {
+        sprintf(record, "      <ns1:item id=\"%d\" type='record' status=\"active\">"
+            "<ns1:name>item number %d</ns1:name><ns1:price>%d.%02d</ns1:price></ns1:item>\n",
+            i, i, i % 1000, i % 100);
+        xml += record;
+        i++;
+    }
+    return xml + envelope_end;
+}
+
+static std::string
+headers_envelope(
+    size_t size)
+{
+    char header[512];
+    std::string xml = envelope_start;
+    int i = 0;
+
+    while (xml.size() < size)
+    {
+        sprintf(header, "      <wsa:RelatesTo xmlns:wsa=\"http://www.w3.org/2005/08/addressing\" "
+            "RelationshipType=\"http://www.w3.org/2005/08/addressing/reply\">"
+            "urn:uuid:6f1e2c4a-%04d-4f6b-9a4e-2b7c1d9e8f30</wsa:RelatesTo>\n", i % 10000);
+        xml += header;
+        i++;
+    }
+    return xml + envelope_end;
+}
+
+/* Parses xml to the end of the root element. Returns the number of events, -1 on failure */
+static int
+parse(
+    const axutil_env_t *env,
+    const std::string &xml,
+    int utf8_check)
+{
+    guththila_reader_t *reader;
+    guththila_t *parser;
+    int c, depth = 0, events = 0;
+
+    reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), env);
+    parser = (guththila_t *) AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+    guththila_init(parser, reader, env);
+    guththila_set_utf8_check(parser, utf8_check, env);
+    while ((c = guththila_next(parser, env)) != -1)
+    {
+        events++;
+        if (c == GUTHTHILA_START_ELEMENT)
+            depth++;
+        else if (c == GUTHTHILA_END_ELEMENT && --depth == 0)
+            break;
+    }
+    guththila_un_init(parser, env);
+    guththila_reader_free(reader, env);
+    return depth == 0 && c != -1 ? events : -1;
+}
+
+static void
+run_workload(
+    const axutil_env_t *env,
+    const char *name,
+    const std::string &xml,
+    int rounds,
+    int utf8_check)
+{
+    clock_t start;
+    double seconds;
+    int i, events = 0;
+
+    /* warm up, and make sure the envelope parses */
+    if (parse(env, xml, utf8_check) < 0)
+    {
+        printf("%-10s %9lu bytes  parse failed\n", name, (unsigned long) xml.size());
+        return;
+    }
+    start = clock();
+    for (i = 0; i < rounds; i++)
+        events = parse(env, xml, utf8_check);
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%-10s %9lu bytes %8d events %9.1f MB/s\n", name, (unsigned long) xml.size(),
+        events, seconds > 0 ? (double) xml.size() * rounds / seconds / 1e6 : 0.0);
+}
+
+int
+main(
+    int argc,
+    char **argv)
+{
+    axutil_allocator_t *allocator = axutil_allocator_init(NULL);
+    axutil_error_t *error = axutil_error_create(allocator);
+    axutil_log_t *log = axutil_log_create(allocator, NULL, NULL);
+    axutil_env_t *env = axutil_env_create_with_error_log(allocator, error, log);
+    int rounds = argc > 1 ? atoi(argv[1]) : 1;
+    int utf8_check = argc > 2 && !strcmp(argv[2], "utf8");
+
+    run_workload(env, "text", text_envelope(64 * 1024), rounds * 2000, utf8_check);
+    run_workload(env, "text", text_envelope(4 * 1024 * 1024), rounds * 30, utf8_check);
+    run_workload(env, "base64", base64_envelope(64 * 1024), rounds * 2000, utf8_check);
+    run_workload(env, "base64", base64_envelope(4 * 1024 * 1024), rounds * 30, utf8_check);
+    run_workload(env, "records", records_envelope(64 * 1024), rounds * 500, utf8_check);
+    run_workload(env, "headers", headers_envelope(64 * 1024), rounds * 500, utf8_check);
+
+    axutil_env_free(env);
+    return 0;
+}
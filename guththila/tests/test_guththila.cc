@@ -16,9 +16,11 @@
 */
 
 #include <gtest/gtest.h>
+#include <string>
 
 #include <guththila.h>
 #include <guththila_defines.h>
+#include <guththila_xml_writer.h>
 
 #define BUF_SIZE 256
 
@@ -205,6 +207,8 @@ TEST_F(TestGuththila, test_character) {
 
     m_reader = guththila_reader_create_for_file("resources/om/numbers.xml", m_env);
     ASSERT_NE(m_reader, nullptr);
+    /* a regular file is parsed in place */
+    EXPECT_EQ(m_reader->type, GUTHTHILA_MMAP_READER);
     guththila_init(m_parser, m_reader, m_env);
 
     guththila_reader_read(m_parser->reader, m_buffer, 0, BUF_SIZE,  m_env);
@@ -230,3 +234,713 @@ TEST_F(TestGuththila, test_character) {
     ASSERT_STREQ(p, "24");
     AXIS2_FREE(m_allocator, p);
 }
+
+/* Reads a document a few bytes at a time, so tokens cross buffer boundaries */
+struct chunked_input
+{
+    const char *data;
+    size_t len;
+    size_t pos;
+    size_t chunk;
+};
+
+static int GUTHTHILA_CALL
+chunked_read(
+    guththila_char_t *buffer,
+    int size,
+    void *ctx)
+{
+    chunked_input *in = (chunked_input *) ctx;
+    size_t n = in->len - in->pos;
+
+    if (n > in->chunk)
+        n = in->chunk;
+    if (n > (size_t) size)
+        n = size;
+    memcpy(buffer, in->data + in->pos, n);
+    in->pos += n;
+    return (int) n;
+}
+
+/* Feeds the next chunk of in to a push reader, with the end after the last one */
+static void
+feed_chunk(
+    guththila_reader_t *reader,
+    chunked_input *in,
+    const axutil_env_t *env)
+{
+    size_t n = in->len - in->pos;
+
+    if (n > in->chunk)
+        n = in->chunk;
+    ASSERT_EQ(guththila_reader_feed(reader, in->data + in->pos, n, in->pos + n == in->len, env),
+        GUTHTHILA_SUCCESS);
+    in->pos += n;
+}
+
+/*
+ * Describes the events of a document, ending with "error" if the parser fails.
+ * The parser reads from push when it needs more input.
+ */
+static std::string
+trace_events(
+    guththila_t *parser,
+    const axutil_env_t *env,
+    chunked_input *push = NULL)
+{
+    std::string trace;
+    int c, i, depth = 0;
+    char *p;
+
+    while ((c = guththila_next(parser, env)) != -1)
+    {
+        switch (c)
+        {
+            case GUTHTHILA_NEED_MORE_INPUT:
+                if (!push || push->pos == push->len)
+                    return trace + "stalled";
+                feed_chunk(parser->reader, push, env);
+                break;
+            case GUTHTHILA_START_ELEMENT:
+            case GUTHTHILA_EMPTY_ELEMENT:
+                p = guththila_get_name(parser, env);
+                trace += std::string("<") + p;
+                AXIS2_FREE(env->allocator, p);
+                for (i = 1; i <= guththila_get_attribute_count(parser, env); i++)
+                {
+                    p = guththila_get_attribute_name_by_number(parser, i, env);
+                    trace += std::string(" ") + p + "=";
+                    AXIS2_FREE(env->allocator, p);
+                    p = guththila_get_attribute_value_by_number(parser, i, env);
+                    trace += std::string("[") + p + "]";
+                    AXIS2_FREE(env->allocator, p);
+                }
+                if (c == GUTHTHILA_START_ELEMENT)
+                {
+                    trace += ">";
+                    depth++;
+                    break;
+                }
+                trace += "/>";
+                if (depth == 0)
+                    return trace;
+                break;
+            case GUTHTHILA_END_ELEMENT:
+                p = guththila_get_name(parser, env);
+                trace += std::string("</") + p + ">";
+                AXIS2_FREE(env->allocator, p);
+                if (--depth == 0)
+                    return trace;
+                break;
+            case GUTHTHILA_CHARACTER:
+                p = guththila_get_value(parser, env);
+                trace += std::string("{") + p + "}";
+                AXIS2_FREE(env->allocator, p);
+                break;
+            case GUTHTHILA_SPACE:
+                trace += "_";
+                break;
+        }
+    }
+    return trace + "error";
+}
+
+/*
+ * Parses xml from memory, and a few bytes at a time for each chunk size up to
+ * 40, read from a stream and pushed, checking that it is UTF-8 unless told not to
+ */
+static void
+expect_trace(
+    const axutil_env_t *env,
+    const std::string &xml,
+    const std::string &expected,
+    int utf8_check = 1)
+{
+    guththila_reader_t *reader;
+    guththila_t *parser;
+    chunked_input *in;
+    size_t chunk;
+
+    reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), env);
+    parser = (guththila_t *) AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+    guththila_init(parser, reader, env);
+    guththila_set_utf8_check(parser, utf8_check, env);
+    EXPECT_EQ(trace_events(parser, env), expected) << "memory";
+    guththila_un_init(parser, env);
+    guththila_reader_free(reader, env);
+
+    for (chunk = 1; chunk <= 40; chunk++)
+    {
+        /* the reader frees its context */
+        in = (chunked_input *) AXIS2_MALLOC(env->allocator, sizeof(chunked_input));
+        in->data = xml.data();
+        in->len = xml.size();
+        in->pos = 0;
+        in->chunk = chunk;
+        reader = guththila_reader_create_for_io(chunked_read, in, env);
+        parser = (guththila_t *) AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+        guththila_init(parser, reader, env);
+        guththila_set_utf8_check(parser, utf8_check, env);
+        EXPECT_EQ(trace_events(parser, env), expected) << "chunk " << chunk;
+        guththila_un_init(parser, env);
+        guththila_reader_free(reader, env);
+
+        in = (chunked_input *) AXIS2_MALLOC(env->allocator, sizeof(chunked_input));
+        in->data = xml.data();
+        in->len = xml.size();
+        in->pos = 0;
+        in->chunk = chunk;
+        reader = guththila_reader_create_for_push(env);
+        parser = (guththila_t *) AXIS2_MALLOC(env->allocator, sizeof(guththila_t));
+        guththila_init(parser, reader, env);
+        guththila_set_utf8_check(parser, utf8_check, env);
+        EXPECT_EQ(trace_events(parser, env, in), expected) << "pushed chunk " << chunk;
+        guththila_un_init(parser, env);
+        guththila_reader_free(reader, env);
+        AXIS2_FREE(env->allocator, in);
+    }
+}
+
+TEST_F(TestGuththila, test_scan_runs) {
+
+    std::string pad(70, 'x');
+    std::string spaces = "\n" + std::string(37, ' ') + "\t";
+    std::string text = pad + " caf\xc3\xa9 \xe2\x82\xac" + pad + "\xf0\x9d\x84\x9e";
+
+    m_reader = guththila_reader_create_for_memory((void *) "<a/>", 4, m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    /* long names, attribute values and text, non ASCII bytes at block boundaries */
+    expect_trace(m_env,
+        "<root" + pad + " long" + pad + "='" + text + "'" + spaces + "b=\"" + pad + "\">"
+        + spaces + "<el\xc3\xa9ment>" + text + "</el\xc3\xa9ment>" + spaces + "</root" + pad + ">",
+        "<root" + pad + " long" + pad + "=[" + text + "] b=[" + pad + "]>_<el\xc3\xa9ment>{"
+        + text + "}</el\xc3\xa9ment>_</root" + pad + ">");
+
+    /* references are replaced wherever the scan stops for them */
+    expect_trace(m_env,
+        "<a v=\"" + pad + "&amp;&quot;" + pad + "&#x20AC;\">" + spaces + "&lt;" + pad + "&gt;"
+        + pad + "&amp;</a>",
+        "<a v=[" + pad + "&\"" + pad + "\xe2\x82\xac]>{" + spaces + "<" + pad + ">" + pad
+        + "&}</a>");
+
+    /* quotes of the other kind and '>' are plain characters in attribute values */
+    expect_trace(m_env, "<a v='" + pad + "\"x>" + pad + "' w=\"'\"/>",
+        "<a v=[" + pad + "\"x>" + pad + "] w=[']/>");
+
+    /* the same runs are scanned alike when they are not checked */
+    expect_trace(m_env,
+        "<root" + pad + " long" + pad + "='" + text + "'>" + spaces + "<el\xc3\xa9ment>" + text
+        + "&amp;" + pad + "</el\xc3\xa9ment></root" + pad + ">",
+        "<root" + pad + " long" + pad + "=[" + text + "]>_<el\xc3\xa9ment>{" + text + "&" + pad
+        + "}</el\xc3\xa9ment></root" + pad + ">", 0);
+}
+
+TEST_F(TestGuththila, test_scan_invalid_utf8) {
+
+    std::string pad(70, 'x');
+    const char *invalid[] = {
+        "\xc3\x28", /* missing continuation */
+        "\xa9", /* stray continuation */
+        "\xc0\xaf", /* overlong */
+        "\xed\xa0\x80", /* surrogate */
+        "\xf4\x90\x80\x80", /* above U+10FFFF */
+        "\xe2\x82", /* cut short by markup */
+        "\xff"
+    };
+    size_t i;
+
+    m_reader = guththila_reader_create_for_memory((void *) "<a/>", 4, m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    {
+        SCOPED_TRACE(i);
+        expect_trace(m_env, "<a>" + pad + invalid[i] + pad + "</a>", "<a>error");
+        expect_trace(m_env, "<a v='" + pad + invalid[i] + "'/>", "error");
+    }
+
+    /* without the check the bytes are taken as they are */
+    expect_trace(m_env, "<a>" + pad + "\xff" + pad + "</a>",
+        "<a>{" + pad + "\xff" + pad + "}</a>", 0);
+    expect_trace(m_env, "<a v='" + pad + "\xc3\x28'/>", "<a v=[" + pad + "\xc3\x28]/>", 0);
+}
+
+TEST_F(TestGuththila, test_invalid_utf8_at_buffer_switch) {
+
+    std::string xml, events;
+    size_t offset;
+
+    m_reader = guththila_reader_create_for_memory((void *) "<a/>", 4, m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    /*
+     * Short values and names are read one by one, and the first buffer is
+     * left when it is filled up to about GUTHTHILA_BUFFER_DEF_SIZE -
+     * GUTHTHILA_BUFFER_DEF_MIN_SIZE
+     */
+    for (offset = 15860; offset < 15880; offset++)
+    {
+        SCOPED_TRACE(offset);
+        xml = "<r>";
+        events = "<r>";
+        while (xml.size() + 20 < offset)
+        {
+            xml += "<e a='v'/>";
+            events += "<e a=[v]/>";
+        }
+        xml.append(offset - xml.size() - 6, ' ');
+        expect_trace(m_env, xml + "<e a='\xff'/></r>", events + "_error");
+        expect_trace(m_env, xml + "<e b\xff='v'/></r>", events + "_error");
+    }
+}
+
+static std::string
+view_string(
+    const guththila_char_t *view,
+    size_t len)
+{
+    return view ? std::string(view, len) : std::string("(null)");
+}
+
+TEST_F(TestGuththila, test_views) {
+
+    std::string xml = "<p:a xmlns:p='urn:x' p:k='1&amp;2' n=\"plain\">t&lt;x</p:a>";
+    const guththila_char_t *view;
+    size_t len;
+
+    m_reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    guththila_init(m_parser, m_reader, m_env);
+    ASSERT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_START_ELEMENT);
+
+    view = guththila_get_name_view(m_parser, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "a");
+    view = guththila_get_prefix_view(m_parser, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "p");
+    view = guththila_get_namespace_prefix_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "p");
+    view = guththila_get_namespace_uri_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "urn:x");
+
+    ASSERT_EQ(guththila_get_attribute_count(m_parser, m_env), 2);
+    view = guththila_get_attribute_name_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "k");
+    view = guththila_get_attribute_prefix_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "p");
+    view = guththila_get_attribute_namespace_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "urn:x");
+    view = guththila_get_attribute_value_view_by_number(m_parser, 1, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "1&2");
+
+    /* a value without references is not copied */
+    view = guththila_get_attribute_value_view_by_number(m_parser, 2, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "plain");
+    EXPECT_EQ(view, xml.data() + xml.find("plain"));
+    view = guththila_get_attribute_prefix_view_by_number(m_parser, 2, &len, m_env);
+    EXPECT_EQ(view, nullptr);
+    EXPECT_EQ(len, 0u);
+
+    ASSERT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_CHARACTER);
+    view = guththila_get_value_view(m_parser, &len, m_env);
+    EXPECT_EQ(view_string(view, len), "t<x");
+    ASSERT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_END_ELEMENT);
+}
+
+/* Bytes of input the parser holds on to */
+static size_t
+held_buffers(
+    guththila_t *parser)
+{
+    size_t held = 0;
+    int i;
+
+    for (i = 0; i <= parser->buffer.cur_buff; i++)
+        held += parser->buffer.buffs_size[i];
+    return held;
+}
+
+TEST_F(TestGuththila, test_streaming) {
+
+    std::string xml = "<root xmlns:r='urn:r'>";
+    std::string long_text(100000, 'y');
+    chunked_input *in;
+    char record[128];
+    size_t max_held = 0;
+    int c, i, records = 0;
+    char *p;
+
+    for (i = 0; i < 50000; i++)
+    {
+        sprintf(record, "<r:item r:id='%d'>value %d</r:item>", i, i);
+        xml += record;
+        if (i == 25000)
+            xml += "<long>" + long_text + "</long>";
+    }
+    xml += "</root>";
+
+    in = (chunked_input *) AXIS2_MALLOC(m_allocator, sizeof(chunked_input));
+    in->data = xml.data();
+    in->len = xml.size();
+    in->pos = 0;
+    in->chunk = 4096;
+    m_reader = guththila_reader_create_for_io(chunked_read, in, m_env);
+    guththila_init(m_parser, m_reader, m_env);
+    guththila_set_streaming(m_parser, 1, m_env);
+
+    while ((c = guththila_next(m_parser, m_env)) != -1)
+    {
+        if (held_buffers(m_parser) > max_held)
+            max_held = held_buffers(m_parser);
+        if (c == GUTHTHILA_START_ELEMENT)
+        {
+            p = guththila_get_name(m_parser, m_env);
+            if (!strcmp(p, "item"))
+            {
+                AXIS2_FREE(m_allocator, p);
+                /* the namespace declared on the root is still there */
+                p = guththila_get_attribute_namespace_by_number(m_parser, 1, m_env);
+                ASSERT_NE(p, nullptr);
+                EXPECT_STREQ(p, "urn:r");
+                AXIS2_FREE(m_allocator, p);
+                p = guththila_get_attribute_value_by_number(m_parser, 1, m_env);
+                EXPECT_EQ(atoi(p), records);
+                records++;
+            }
+            AXIS2_FREE(m_allocator, p);
+        }
+        else if (c == GUTHTHILA_CHARACTER)
+        {
+            p = guththila_get_value(m_parser, m_env);
+            if (p[0] == 'y')
+            {
+                EXPECT_EQ(std::string(p), long_text);
+            }
+            AXIS2_FREE(m_allocator, p);
+        }
+        else if (c == GUTHTHILA_END_ELEMENT)
+        {
+            p = guththila_get_name(m_parser, m_env);
+            if (!strcmp(p, "root"))
+            {
+                AXIS2_FREE(m_allocator, p);
+                break;
+            }
+            AXIS2_FREE(m_allocator, p);
+        }
+    }
+    EXPECT_EQ(c, GUTHTHILA_END_ELEMENT);
+    EXPECT_EQ(records, 50000);
+    /* bounded by the longest token, not by the document */
+    EXPECT_LT(max_held, 4 * long_text.size() + 8 * GUTHTHILA_BUFFER_DEF_SIZE);
+    EXPECT_LT(max_held, xml.size() / 4);
+}
+
+/* A reader for xml, a few bytes at a time */
+static guththila_reader_t *
+chunked_reader(
+    const axutil_env_t *env,
+    const std::string &xml,
+    size_t chunk)
+{
+    chunked_input *in = (chunked_input *) AXIS2_MALLOC(env->allocator, sizeof(chunked_input));
+
+    in->data = xml.data();
+    in->len = xml.size();
+    in->pos = 0;
+    in->chunk = chunk;
+    return guththila_reader_create_for_io(chunked_read, in, env);
+}
+
+TEST_F(TestGuththila, test_reset) {
+
+    std::string first = "<a:x xmlns:a='urn:a' k='v'><b>text</b></a:x>";
+    std::string second = "<y z='1'>more</y>";
+    guththila_reader_t *reader;
+
+    m_reader = chunked_reader(m_env, first, 3);
+    guththila_init(m_parser, m_reader, m_env);
+    EXPECT_EQ(trace_events(m_parser, m_env), "<x k=[v]><b>{text}</b></x>");
+
+    /* from a stream to memory */
+    reader = guththila_reader_create_for_memory((void *) second.data(), (int) second.size(),
+        m_env);
+    ASSERT_EQ(guththila_reset(m_parser, reader, m_env), GUTHTHILA_SUCCESS);
+    guththila_reader_free(m_reader, m_env);
+    m_reader = reader;
+    EXPECT_EQ(trace_events(m_parser, m_env), "<y z=[1]>{more}</y>");
+
+    /* in the middle of a document, back to a stream */
+    reader = guththila_reader_create_for_memory((void *) first.data(), (int) first.size(), m_env);
+    ASSERT_EQ(guththila_reset(m_parser, reader, m_env), GUTHTHILA_SUCCESS);
+    guththila_reader_free(m_reader, m_env);
+    m_reader = reader;
+    ASSERT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_START_ELEMENT);
+    ASSERT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_START_ELEMENT);
+
+    reader = chunked_reader(m_env, second, 2);
+    ASSERT_EQ(guththila_reset(m_parser, reader, m_env), GUTHTHILA_SUCCESS);
+    guththila_reader_free(m_reader, m_env);
+    m_reader = reader;
+    EXPECT_EQ(trace_events(m_parser, m_env), "<y z=[1]>{more}</y>");
+}
+
+TEST_F(TestGuththila, test_pool) {
+
+    std::string xml = "<p:a xmlns:p='urn:p'><p:b c='d'/></p:a>";
+    guththila_reader_t *reader;
+    guththila_t *parser, *reused;
+    guththila_xml_writer_t *writer, *reused_writer;
+    char *p;
+
+    m_reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    reader = chunked_reader(m_env, xml, 5);
+    parser = guththila_pool_get(reader, m_env);
+    ASSERT_NE(parser, nullptr);
+    EXPECT_EQ(trace_events(parser, m_env), "<a><b c=[d]/></a>");
+    guththila_pool_put(parser, m_env);
+    guththila_reader_free(reader, m_env);
+
+    reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    reused = guththila_pool_get(reader, m_env);
+    EXPECT_EQ(reused, parser);
+    EXPECT_EQ(trace_events(reused, m_env), "<a><b c=[d]/></a>");
+    guththila_pool_put(reused, m_env);
+    guththila_reader_free(reader, m_env);
+
+    writer = guththila_xml_writer_pool_get(m_env);
+    ASSERT_NE(writer, nullptr);
+    guththila_write_start_element(writer, (char *) "a", m_env);
+    guththila_write_characters(writer, (char *) "1", m_env);
+    guththila_write_end_element(writer, m_env);
+    p = guththila_get_memory_buffer(writer, m_env);
+    EXPECT_STREQ(p, "<a>1</a>");
+    guththila_xml_writer_pool_put(writer, m_env);
+
+    /* the writer starts again with an empty buffer */
+    reused_writer = guththila_xml_writer_pool_get(m_env);
+    EXPECT_EQ(reused_writer, writer);
+    guththila_write_start_element(reused_writer, (char *) "b", m_env);
+    guththila_write_end_element(reused_writer, m_env);
+    p = guththila_get_memory_buffer(reused_writer, m_env);
+    EXPECT_STREQ(p, "<b></b>");
+    guththila_xml_writer_pool_put(reused_writer, m_env);
+}
+
+/* Escapes text the plain way, to check the writer against */
+static std::string
+escaped(
+    const std::string &text)
+{
+    std::string out;
+    size_t i;
+
+    for (i = 0; i < text.size(); i++)
+    {
+        switch (text[i])
+        {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '\'': out += "&apos;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += text[i];
+        }
+    }
+    return out;
+}
+
+TEST_F(TestGuththila, test_escape) {
+
+    std::string xml = "<a/>";
+    std::string text, expected;
+    guththila_xml_writer_t *writer;
+    const char *specials = "&<>'\"";
+    int i;
+
+    m_reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    /* specials at every offset of a 16 byte block, in runs and next to each other */
+    for (i = 0; i < 200; i++)
+    {
+        text += (i % 7 == 3 || i % 23 == 22) ? specials[i % 5] : (char) ('a' + i % 26);
+    }
+    text += "\xc3\xa9t\xc3\xa9 &&<<>> plain tail of more than sixteen bytes";
+
+    writer = guththila_create_xml_stream_writer_for_memory(m_env);
+    ASSERT_NE(writer, nullptr);
+    guththila_write_start_element(writer, (char *) "a", m_env);
+    guththila_write_attribute(writer, (char *) "v", (char *) text.c_str(), m_env);
+    guththila_write_characters(writer, (char *) text.c_str(), m_env);
+    guththila_write_end_element(writer, m_env);
+    expected = "<a v=\"" + escaped(text) + "\">" + escaped(text) + "</a>";
+    EXPECT_EQ(std::string(guththila_get_memory_buffer(writer, m_env),
+        guththila_get_memory_buffer_size(writer, m_env)), expected);
+    guththila_xml_writer_free(writer, m_env);
+}
+
+/* Writes a document with nested namespaces, many siblings and long names */
+static void
+write_document(
+    guththila_xml_writer_t *wr,
+    const axutil_env_t *env)
+{
+    char name[128], uri[64];
+    int i, j;
+
+    guththila_write_start_document(wr, env, NULL, NULL);
+    guththila_write_start_element_with_prefix_and_namespace(wr, (char *) "s",
+        (char *) "urn:s", (char *) "Envelope", env);
+    for (i = 0; i < 300; i++)
+    {
+        sprintf(uri, "urn:r%d", i);
+        guththila_write_start_element_with_prefix_and_namespace(wr, (char *) "r", uri,
+            (char *) "record", env);
+        guththila_write_attribute(wr, (char *) "id", uri, env);
+        for (j = 0; j < 5; j++)
+        {
+            sprintf(name, "a_rather_long_element_name_to_fill_the_chunks_%d_%d", i, j);
+            guththila_write_start_element_with_namespace(wr, (char *) "urn:s", name, env);
+            guththila_write_characters(wr, (char *) "x < y & \"z\"", env);
+            guththila_write_empty_element(wr, name, env);
+            guththila_write_end_element(wr, env);
+        }
+        guththila_write_start_element_with_prefix(wr, (char *) "r", (char *) "deep", env);
+        for (j = 0; j < 20; j++)
+        {
+            sprintf(name, "level%d", j);
+            guththila_write_start_element(wr, name, env);
+        }
+        guththila_write_characters(wr, (char *) "bottom", env);
+        for (j = 0; j < 20; j++)
+        {
+            guththila_write_end_element(wr, env);
+        }
+        guththila_write_end_element(wr, env);
+        guththila_write_end_element(wr, env);
+    }
+    guththila_write_end_document(wr, env);
+}
+
+TEST_F(TestGuththila, test_stream_writer) {
+
+    std::string xml = "<a/>";
+    std::string expected;
+    guththila_xml_writer_t *writer;
+    axutil_stream_t *stream;
+    int len;
+
+    m_reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    writer = guththila_create_xml_stream_writer_for_memory(m_env);
+    ASSERT_NE(writer, nullptr);
+    write_document(writer, m_env);
+    expected.assign(guththila_get_memory_buffer(writer, m_env),
+        guththila_get_memory_buffer_size(writer, m_env));
+    guththila_xml_writer_free(writer, m_env);
+    ASSERT_GT(expected.size(), 100000u);
+
+    stream = axutil_stream_create_basic(m_env);
+    ASSERT_NE(stream, nullptr);
+    writer = guththila_create_xml_stream_writer_for_stream(m_env, stream, 64);
+    ASSERT_NE(writer, nullptr);
+    EXPECT_EQ(guththila_get_memory_buffer(writer, m_env), nullptr);
+
+    guththila_write_start_element(writer, (char *) "x", m_env);
+    guththila_write_characters(writer, (char *) "short", m_env);
+    EXPECT_EQ(axutil_stream_get_len(stream, m_env), 0);
+    guththila_write_end_element(writer, m_env);
+    ASSERT_EQ(guththila_flush(writer, m_env), GUTHTHILA_SUCCESS);
+    EXPECT_EQ(std::string(axutil_stream_get_buffer(stream, m_env),
+        axutil_stream_get_len(stream, m_env)), "<x>short</x>");
+    expected = "<x>short</x>" + expected;
+
+    write_document(writer, m_env);
+    /* all but the last few bytes are in the stream before the writer is freed */
+    len = axutil_stream_get_len(stream, m_env);
+    EXPECT_GT(len, (int) expected.size() - 64);
+    guththila_xml_writer_free(writer, m_env);
+    EXPECT_EQ(std::string(axutil_stream_get_buffer(stream, m_env),
+        axutil_stream_get_len(stream, m_env)), expected);
+    axutil_stream_free(stream, m_env);
+}
+
+TEST_F(TestGuththila, test_prefix_for_namespace) {
+
+    std::string xml = "<a/>";
+    guththila_xml_writer_t *writer;
+    char *prefix;
+
+    m_reader = guththila_reader_create_for_memory((void *) xml.data(), (int) xml.size(), m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    writer = guththila_create_xml_stream_writer_for_memory(m_env);
+    ASSERT_NE(writer, nullptr);
+    guththila_write_start_element_with_prefix_and_namespace(writer, (char *) "a",
+        (char *) "urn:a", (char *) "x", m_env);
+    EXPECT_EQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:b", m_env), nullptr);
+    prefix = guththila_get_prefix_for_namespace(writer, (char *) "urn:a", m_env);
+    EXPECT_STREQ(prefix, "a");
+    EXPECT_EQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:a", m_env), prefix);
+
+    guththila_write_start_element_with_prefix_and_namespace(writer, (char *) "b",
+        (char *) "urn:b", (char *) "y", m_env);
+    EXPECT_STREQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:b", m_env), "b");
+    /* a declaration made later comes first */
+    guththila_write_namespace(writer, (char *) "c", (char *) "urn:a", m_env);
+    EXPECT_STREQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:a", m_env), "c");
+
+    /* out of scope with the element that declared them */
+    guththila_write_end_element(writer, m_env);
+    EXPECT_EQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:b", m_env), nullptr);
+    EXPECT_STREQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:a", m_env), "a");
+    guththila_write_end_element(writer, m_env);
+    EXPECT_EQ(guththila_get_prefix_for_namespace(writer, (char *) "urn:a", m_env), nullptr);
+    guththila_xml_writer_free(writer, m_env);
+}
+
+TEST_F(TestGuththila, test_push) {
+
+    std::string text(40000, 'x');
+    std::string xml = "<?xml version='1.0' encoding='UTF-8'?>\n<a:root xmlns:a='urn:a'>"
+        "<!-- a - comment --><b v='&lt;>'>" + text + "</b><![CDATA[<c>]]><c/></a:root>\n";
+    chunked_input in;
+    size_t chunk;
+
+    m_reader = guththila_reader_create_for_push(m_env);
+    guththila_init(m_parser, m_reader, m_env);
+
+    /* nothing is returned for an event that has not been fed whole */
+    EXPECT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_NEED_MORE_INPUT);
+    ASSERT_EQ(guththila_reader_feed(m_reader, "<x a='1' b='2", 13, 0, m_env), GUTHTHILA_SUCCESS);
+    EXPECT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_NEED_MORE_INPUT);
+    EXPECT_EQ(guththila_next(m_parser, m_env), GUTHTHILA_NEED_MORE_INPUT);
+    ASSERT_EQ(guththila_reader_feed(m_reader, "'>text", 6, 0, m_env), GUTHTHILA_SUCCESS);
+    in.data = "</x>";
+    in.len = 4;
+    in.pos = 0;
+    in.chunk = 1;
+    EXPECT_EQ(trace_events(m_parser, m_env, &in), "<x a=[1] b=[2]>{text}</x>");
+    /* nothing can be fed after the end */
+    EXPECT_EQ(guththila_reader_feed(m_reader, "<y/>", 4, 1, m_env), GUTHTHILA_FAILURE);
+    EXPECT_EQ(guththila_next(m_parser, m_env), -1);
+
+    /* markup inside comments, values and CDATA does not end an event, text longer than a buffer */
+    for (chunk = 1; chunk <= 4096; chunk *= 8)
+    {
+        SCOPED_TRACE(chunk);
+        in.data = xml.data();
+        in.len = xml.size();
+        in.pos = 0;
+        in.chunk = chunk;
+        ASSERT_EQ(guththila_reset(m_parser, guththila_reader_create_for_push(m_env), m_env),
+            GUTHTHILA_SUCCESS);
+        guththila_reader_free(m_reader, m_env);
+        m_reader = m_parser->reader;
+        EXPECT_EQ(trace_events(m_parser, m_env, &in),
+            "_<root><b v=[<>]>{" + text + "}</b>{<c>}<c/></root>");
+    }
+}
@@ -379,6 +379,15 @@ extern "C"
 #define AXIS2_MTOM_SENDING_CALLBACK "MTOMSendingCallback"
 #define AXIS2_ENABLE_MTOM_SERVICE_CALLBACK "EnableMTOMServiceCallback"
 
+    /* version of generated message ids, "4" (random) or "7" (time ordered) */
+#define AXIS2_UUID_VERSION "uuidVersion"
+
+    /* seconds host addresses are cached for, seconds a host that did not
+     * resolve is remembered for, and hosts to resolve at start up */
+#define AXIS2_DNS_CACHE_TTL "dnsCacheTTL"
+#define AXIS2_DNS_NEGATIVE_CACHE_TTL "dnsNegativeCacheTTL"
+#define AXIS2_DNS_PREWARM_HOSTS "dnsPrewarmHosts"
+
     /* op_ctx persistance */
 #define AXIS2_PERSIST_OP_CTX "persistOperationContext"
 
@@ -37,6 +37,7 @@
 #include <axis2_http_simple_response.h>
 #include <axis2_http_simple_request.h>
 #include <axutil_url.h>
+#include <axutil_network_handler.h>
 
 
 
@@ -122,6 +123,31 @@ extern "C"
         const axis2_http_client_t * client,
         const axutil_env_t * env);
 
+    /**
+     * Sets the options of the sockets the client opens, including the
+     * connect timeout. The timeout set with axis2_http_client_set_timeout
+     * only applies to reads and writes.
+     * @param client pointer to client
+     * @param env pointer to environment struct
+     * @param options socket options, copied into the client
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axis2_http_client_set_socket_options(
+        axis2_http_client_t * client,
+        const axutil_env_t * env,
+        const axutil_socket_options_t * options);
+
+    /**
+     * @param client pointer to client
+     * @param env pointer to environment struct
+     * @return the socket options of the client
+     */
+    AXIS2_EXTERN const axutil_socket_options_t *AXIS2_CALL
+    axis2_http_client_get_socket_options(
+        const axis2_http_client_t * client,
+        const axutil_env_t * env);
+
     /**
      * @param client pointer to client
      * @param env pointer to environment struct
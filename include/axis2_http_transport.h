@@ -830,11 +830,32 @@ extern "C"
      */
     #define AXIS2_HTTP_CONNECTION_TIMEOUT "CONNECTION_TIMEOUT"
 
+    /**
+     * Milli seconds to wait for a connection, SO_TIMEOUT by default
+     */
+    #define AXIS2_HTTP_CONNECT_TIMEOUT "CONNECT_TIMEOUT"
+
+    /**
+     * Socket options of outgoing connections, from the transportSender
+     * parameters or from the options of the client
+     */
+    #define AXIS2_HTTP_TCP_NODELAY "TCP_NODELAY"
+    #define AXIS2_HTTP_SO_KEEPALIVE "SO_KEEPALIVE"
+    #define AXIS2_HTTP_TCP_USER_TIMEOUT "TCP_USER_TIMEOUT"
+    #define AXIS2_HTTP_SO_SNDBUF "SO_SNDBUF"
+    #define AXIS2_HTTP_SO_RCVBUF "SO_RCVBUF"
+
     /**
      * DEFAULT_SO_TIMEOUT
      */
     #define AXIS2_HTTP_DEFAULT_SO_TIMEOUT 60000
 
+    /**
+     * Chunk size of the per request arena allocator used by the simple
+     * http server. 0 disables the arena.
+     */
+    #define AXIS2_HTTP_DEFAULT_REQUEST_ARENA_SIZE AXUTIL_ALLOCATOR_ARENA_DEFAULT_CHUNK_SIZE
+
     /**
      * DEFAULT_CONNECTION_TIMEOUT
      */
@@ -502,6 +502,25 @@ extern "C"
         const axutil_env_t * env,
         const long timeout_in_milli_seconds);
 
+    /**
+     * Sets an option of the sockets the transport opens, overriding the
+     * transportSender parameter of the same name in axis2.xml. The http
+     * transport takes CONNECT_TIMEOUT, TCP_USER_TIMEOUT (both in milli
+     * seconds), SO_SNDBUF and SO_RCVBUF (in bytes), and TCP_NODELAY and
+     * SO_KEEPALIVE (AXIS2_TRUE or AXIS2_FALSE).
+     * @param options pointer to options struct
+     * @param env pointer to environment struct
+     * @param name name of the socket option
+     * @param value value of the socket option
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axis2_options_set_socket_option(
+        axis2_options_t * options,
+        const axutil_env_t * env,
+        const axis2_char_t * name,
+        const int value);
+
     /**
      * Sets transport information. Transport information includes the name 
      * of the sender transport, name of the receiver transport and if a 
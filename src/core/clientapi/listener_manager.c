@@ -156,13 +156,9 @@ axis2_listener_manager_make_sure_started(
                                 "Thread creation failed"
                                 "Invoke non blocking failed");
                         }
-                        else
-                        {
-                            /*axutil_thread_pool_thread_detach(env->thread_pool,
-                                worker_thread);*/
-                            /* we should not detach this, because, in the dual channel case
-                            we should be able to terminate the thread before deleting the listener */
-                        }
+                        /* not detached: in the dual channel case the listener must have
+                         * finished before it is deleted, so axis2_listener_manager_stop
+                         * joins the thread */
                     }
                     else
                     {
@@ -217,6 +213,7 @@ axis2_listener_manager_stop(
     axis2_transport_listener_state_t *tl_state = NULL;
     axis2_status_t status = AXIS2_FAILURE;
     axutil_thread_t *listener_thread = NULL;
+    axis2_bool_t running = AXIS2_TRUE;
 
     tl_state = listener_manager->listener_map[transport];
     listener_thread = listener_manager->listener_thread[transport];
@@ -228,13 +225,27 @@ axis2_listener_manager_stop(
         {
             status = axis2_transport_receiver_stop(tl_state->listener, env);
             if(status == AXIS2_SUCCESS)
+            {
+                running = axis2_transport_receiver_is_running(tl_state->listener, env);
                 listener_manager->listener_map[transport] = NULL;
+            }
         }
     }
 
-    if(listener_thread)
+    /* The thread is left alone while other calls still wait on the listener. A listener
+     * that says it has stopped returns from its loop, so it is waited for, which also
+     * releases its handle. Others may never return, so their handle is released when
+     * they do. */
+    if(listener_thread && !listener_manager->listener_map[transport])
     {
-        axutil_thread_pool_exit_thread(env->thread_pool, listener_thread);
+        if(running)
+        {
+            axutil_thread_pool_thread_detach(env->thread_pool, listener_thread);
+        }
+        else
+        {
+            axutil_thread_pool_join_thread(env->thread_pool, listener_thread);
+        }
         listener_manager->listener_thread[transport] = NULL;
     }
 
@@ -616,6 +616,38 @@ axis2_options_set_timeout_in_milli_seconds(
     return AXIS2_SUCCESS;
 }
 
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axis2_options_set_socket_option(
+    axis2_options_t * options,
+    const axutil_env_t * env,
+    const axis2_char_t * name,
+    const int value)
+{
+    axis2_char_t value_str[12];
+    axutil_property_t *property = NULL;
+
+    AXIS2_PARAM_CHECK(env->error, name, AXIS2_FAILURE);
+
+    /* flags are given as in axis2.xml */
+    if(!axutil_strcmp(name, AXIS2_HTTP_TCP_NODELAY) || !axutil_strcmp(name,
+        AXIS2_HTTP_SO_KEEPALIVE))
+    {
+        strcpy(value_str, value ? AXIS2_VALUE_TRUE : AXIS2_VALUE_FALSE);
+    }
+    else
+    {
+        sprintf(value_str, "%d", value);
+    }
+
+    property = axutil_property_create_with_args(env, AXIS2_SCOPE_REQUEST, AXIS2_TRUE, NULL,
+        axutil_strdup(env, value_str));
+    if(!property)
+    {
+        return AXIS2_FAILURE;
+    }
+    return axis2_options_set_property(options, env, name, property);
+}
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axis2_options_set_transport_info(
     axis2_options_t * options,
@@ -23,6 +23,8 @@
 #include <axis2_transport_out_desc.h>
 #include <axutil_utils.h>
 #include <axis2_transport_receiver.h>
+#include <axutil_uuid_gen.h>
+#include <axutil_dns_cache.h>
 
 struct axis2_conf_builder
 {
@@ -307,6 +309,62 @@ axis2_conf_builder_populate_conf(
                 AXIS2_VALUE_TRUE)));
         }
     }
+
+    param = axutil_param_container_get_param(
+        axis2_conf_get_param_container(conf_builder->conf, env), env, AXIS2_UUID_VERSION);
+    if(param)
+    {
+        axis2_char_t *value = NULL;
+        value = axutil_param_get_value(param, env);
+        if(value)
+        {
+            axutil_uuid_gen_set_version(env, (axutil_uuid_version_t)atoi(value));
+        }
+    }
+
+    param = axutil_param_container_get_param(
+        axis2_conf_get_param_container(conf_builder->conf, env), env, AXIS2_DNS_CACHE_TTL);
+    if(param)
+    {
+        axis2_char_t *value = NULL;
+        axutil_param_t *negative_param = NULL;
+        int negative_ttl = AXUTIL_DNS_CACHE_DEFAULT_NEGATIVE_TTL;
+        value = axutil_param_get_value(param, env);
+        negative_param = axutil_param_container_get_param(axis2_conf_get_param_container(
+            conf_builder->conf, env), env, AXIS2_DNS_NEGATIVE_CACHE_TTL);
+        if(negative_param && axutil_param_get_value(negative_param, env))
+        {
+            negative_ttl = atoi((axis2_char_t *)axutil_param_get_value(negative_param, env));
+        }
+        if(value)
+        {
+            axutil_dns_cache_set_ttl(env, atoi(value), negative_ttl);
+        }
+    }
+
+    param = axutil_param_container_get_param(
+        axis2_conf_get_param_container(conf_builder->conf, env), env, AXIS2_DNS_PREWARM_HOSTS);
+    if(param)
+    {
+        axis2_char_t *value = NULL;
+        axis2_char_t *hosts = NULL;
+        axis2_char_t *host = NULL;
+        value = axutil_param_get_value(param, env);
+        hosts = axutil_strdup(env, value);
+        for(host = hosts; host && *host;)
+        {
+            axis2_char_t *end = host + strcspn(host, ", \t\r\n");
+            axis2_bool_t last = !*end;
+            *end = '\0';
+            if(*host && !axutil_dns_cache_prewarm(env, host))
+            {
+                AXIS2_LOG_WARNING(env->log, AXIS2_LOG_SI, "Unable to resolve %s at start up",
+                    host);
+            }
+            host = last ? end : end + 1;
+        }
+        AXIS2_FREE(env->allocator, hosts);
+    }
     AXIS2_LOG_TRACE(env->log, AXIS2_LOG_SI, "Exit:axis2_conf_builder_populate_conf");
     return AXIS2_SUCCESS;
 }
@@ -522,6 +522,8 @@ axis2_svc_builder_process_ops(
         }
 
         op_name = axiom_attribute_get_value(op_name_att, env);
+        /* messages name the operation in their body elements, so make the name an atom */
+        axutil_string_intern_register(op_name);
         qopname = axutil_qname_create(env, op_name, NULL, NULL);
         op_desc = axis2_op_create(env);
         axis2_op_set_qname(op_desc, env, qopname);
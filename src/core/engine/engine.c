@@ -484,7 +484,7 @@ axis2_engine_create_fault_msg_ctx(
     const axis2_char_t *wsa_action = NULL;
     const axis2_char_t *msg_id = NULL;
     axis2_relates_to_t *relates_to = NULL;
-    axis2_char_t *msg_uuid = NULL;
+    axis2_char_t msg_uuid[AXUTIL_UUID_STRING_SIZE];
     axis2_msg_info_headers_t *msg_info_headers = NULL;
     axis2_bool_t doing_rest = AXIS2_FALSE;
 
@@ -571,13 +571,7 @@ axis2_engine_create_fault_msg_ctx(
     axis2_msg_ctx_set_relates_to(fault_ctx, env, relates_to);
 
     /* Set msg id */
-    msg_uuid = axutil_uuid_gen(env);
-    axis2_msg_ctx_set_message_id(fault_ctx, env, msg_uuid);
-    if(msg_uuid)
-    {
-        AXIS2_FREE(env->allocator, msg_uuid);
-        msg_uuid = NULL;
-    }
+    axis2_msg_ctx_set_message_id(fault_ctx, env, axutil_uuid_gen_into(msg_uuid));
 
 	/** Copy the property map from the current message context to the newly created fault message
 		context. */
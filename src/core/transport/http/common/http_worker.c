@@ -28,6 +28,7 @@
 #include <axis2_op_ctx.h>
 #include <axis2_engine.h>
 #include <axutil_uuid_gen.h>
+#include <axutil_date_time_util.h>
 #include <axutil_url.h>
 #include <axutil_property.h>
 #include <axiom_soap.h>
@@ -112,8 +113,9 @@ axis2_http_worker_process_request(
     axis2_msg_ctx_t *msg_ctx = NULL;
     axutil_stream_t *request_body = NULL;
 
-    /* Creating out_stream as basic stream */
-    axutil_stream_t *out_stream = axutil_stream_create_basic(env);
+    /* Creating out_stream as chain stream, so that the response is serialized into
+     * pooled chunks and sent from them without being copied into one buffer */
+    axutil_stream_t *out_stream = axutil_stream_create_chain(env);
     axis2_http_simple_response_t *response = NULL;
 
     /* Transport in and out descriptions */
@@ -1997,30 +1999,6 @@ axis2_http_worker_set_svr_port(
     worker->svr_port = port;
     return AXIS2_SUCCESS;
 }
-#if 0
-static axis2_char_t *
-axis2_http_worker_get_server_time(
-    axis2_http_worker_t * http_worker,
-    const axutil_env_t * env)
-{
-    time_t tp;
-    char *time_str;
-    tp = time(&tp);
-    time_str = ctime(&tp);
-    if(!time_str)
-    {
-        return NULL;
-    }
-    if(AXIS2_NEW_LINE == time_str[strlen(time_str) - 1])
-    {
-        time_str[strlen(time_str) - 1] = AXIS2_ESC_NULL;
-    }
-    /* We use the ANSI C Date Format, which is Legal according to RFC2616, 
-     * Section 3.3.1. We are not a HTTP/1.1 only server, and thus, it suffices.
-     */
-    return time_str;
-}
-#endif
 
 static axis2_http_simple_response_t *
 axis2_http_worker_create_simple_response(
@@ -2033,40 +2011,12 @@ axis2_http_worker_create_simple_response(
     {
         axis2_http_header_t *server = NULL;
         axis2_http_header_t *server_date = NULL;
-        axis2_char_t *date_str = NULL;
-        char *date_str_tmp = NULL;
-        time_t tp;
-        size_t date_str_len = 0;
-
-        /* create "Date: xxxx GMT" HTTP header */
-        tp = time(&tp);
-        date_str_tmp = ctime(&tp);
-        if(!date_str_tmp)
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "cannot get server time");
-            return NULL;
-        }
+        axis2_char_t date_str[AXUTIL_HTTP_DATE_SIZE];
 
-        date_str_len = strlen(date_str_tmp);
-        if(AXIS2_NEW_LINE == date_str_tmp[date_str_len - 1])
-        {
-            date_str_len -= 1;
-            date_str_tmp[date_str_len] = AXIS2_ESC_NULL;
-        }
-        /* We use the ANSI C Date Format, which is Legal according to RFC2616,
-         * Section 3.3.1. We are not a HTTP/1.1 only server, and thus, it suffices.
-         */
-
-        date_str = AXIS2_MALLOC(env->allocator, sizeof(axis2_char_t) * (date_str_len + 5));
-        if(!date_str)
-        {
-            AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
-            return NULL;
-
-        }
-        sprintf(date_str, "%s GMT", date_str_tmp);
+        /* create "Date: xxxx GMT" HTTP header, in the RFC 1123 format
+         * preferred by RFC 2616, Section 3.3.1 */
+        axutil_get_http_date(date_str);
         server_date = axis2_http_header_create(env, AXIS2_HTTP_HEADER_DATE, date_str);
-        AXIS2_FREE(env->allocator, date_str);
         axis2_http_simple_response_set_header(response, env, server_date);
 
         /* create "Server: Axis2C/x.x.x (Simple Axis2 HTTP Server)" HTTP Header */
@@ -20,6 +20,7 @@
 #include <axutil_string.h>
 #include <axutil_network_handler.h>
 #include <axutil_http_chunked_stream.h>
+#include <axutil_buffer_chain.h>
 #include <platforms/axutil_platform_auto_sense.h>
 #include <string.h>
 #include <axis2_http_simple_response.h>
@@ -57,7 +58,7 @@ axis2_simple_http_svr_conn_create(
 
     if(-1 != svr_conn->socket)
     {
-        svr_conn->stream = axutil_stream_create_socket(env, svr_conn->socket);
+        svr_conn->stream = axutil_stream_create_buffered_socket(env, svr_conn->socket, 0);
         if(!svr_conn->stream)
         {
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "socket creation failed, socket %d", sockfd);
@@ -194,8 +195,8 @@ axis2_simple_http_svr_conn_read_request(
     return request;
 }
 
-AXIS2_EXTERN axis2_status_t AXIS2_CALL
-axis2_simple_http_svr_conn_write_response(
+static axis2_status_t
+axis2_simple_http_svr_conn_print_response(
     axis2_simple_http_svr_conn_t * svr_conn,
     const axutil_env_t * env,
     axis2_http_simple_response_t * response)
@@ -203,6 +204,7 @@ axis2_simple_http_svr_conn_write_response(
     axis2_http_response_writer_t *response_writer = NULL;
     axutil_array_list_t *headers = NULL;
     axutil_stream_t *response_stream = NULL;
+    axutil_buffer_chain_t *body_chain = NULL;
     axis2_char_t *response_body = NULL;
     int body_size = 0;
 
@@ -282,9 +284,17 @@ axis2_simple_http_svr_conn_write_response(
     if(response_stream)
     {
         body_size = axutil_stream_get_len(response_stream, env);
-        axutil_stream_set_buffer_end_null(response_stream, env);
-        response_body = axutil_stream_get_buffer(response_stream, env);
-        axutil_stream_flush_buffer(response_stream, env);
+        if(!chuked_encoding && !binary_content)
+        {
+            /* a body kept in a buffer chain is sent from the chain as it is */
+            body_chain = axutil_stream_get_chain(response_stream, env);
+        }
+        if(!body_chain)
+        {
+            axutil_stream_set_buffer_end_null(response_stream, env);
+            response_body = axutil_stream_get_buffer(response_stream, env);
+            axutil_stream_flush_buffer(response_stream, env);
+        }
     }
 
     if(body_size <= 0 && !binary_content)
@@ -299,7 +309,21 @@ axis2_simple_http_svr_conn_write_response(
     {
         /* This sending a normal SOAP response without chunk transfer encoding */
         axis2_status_t write_stat = AXIS2_FAILURE;
-        write_stat = axis2_http_response_writer_println_str(response_writer, env, response_body);
+        if(body_chain)
+        {
+            write_stat = axutil_buffer_chain_write_to_stream(body_chain, env, svr_conn->stream);
+            if(write_stat == AXIS2_SUCCESS)
+            {
+                write_stat = axis2_http_response_writer_print_str(response_writer, env,
+                    AXIS2_HTTP_CRLF);
+            }
+            axutil_stream_flush_buffer(response_stream, env);
+        }
+        else
+        {
+            write_stat = axis2_http_response_writer_println_str(response_writer, env,
+                response_body);
+        }
         if(write_stat != AXIS2_SUCCESS)
         {
             AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_WRITING_RESPONSE, AXIS2_FAILURE);
@@ -377,6 +401,27 @@ axis2_simple_http_svr_conn_write_response(
     return AXIS2_SUCCESS;
 }
 
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axis2_simple_http_svr_conn_write_response(
+    axis2_simple_http_svr_conn_t * svr_conn,
+    const axutil_env_t * env,
+    axis2_http_simple_response_t * response)
+{
+    axis2_status_t status = AXIS2_FAILURE;
+
+    AXIS2_PARAM_CHECK(env->error, response, AXIS2_FAILURE);
+
+    /* collect the status line, headers and small bodies, so that they are sent together */
+    axutil_stream_cork(svr_conn->stream, env);
+    status = axis2_simple_http_svr_conn_print_response(svr_conn, env, response);
+    if(axutil_stream_uncork(svr_conn->stream, env) != AXIS2_SUCCESS)
+    {
+        AXIS2_HANDLE_ERROR(env, AXIS2_ERROR_WRITING_RESPONSE, AXIS2_FAILURE);
+        status = AXIS2_FAILURE;
+    }
+    return status;
+}
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axis2_simple_http_svr_conn_set_rcv_timeout(
     axis2_simple_http_svr_conn_t * svr_conn,
@@ -420,85 +465,36 @@ axis2_simple_http_svr_conn_read_line(
     axis2_char_t tmp_buf[2048];
     int read = -1;
 
-    /* peek for 2047 characters to verify whether it contains CRLF character */
-    while((read = axutil_stream_peek(svr_conn->stream, env, tmp_buf, 2048 - 1)) > 0)
+    while((read = axutil_stream_read_line(svr_conn->stream, env, tmp_buf, sizeof(tmp_buf))) > 0)
     {
-        axis2_char_t *start = tmp_buf;
-        axis2_char_t *end = NULL;
-        tmp_buf[read] = AXIS2_ESC_NULL;
-        end = strstr(tmp_buf, AXIS2_HTTP_CRLF);
-        if(end)
+        if(str_line)
         {
-            axis2_char_t *buffer = NULL;
-            if(str_line)
-            {
-                /* header is more than 2048 character. this is not a common case, and not optimized
-                 * for performance (reading in a temp buffer and then strcat to get final buffer */
-                buffer = tmp_buf;
-            }
-            else
-            {
-                /* header is less than 2048 characters, this is the common case. So to improve
-                 * the performance, the buffer is malloc and then used to read the stream. */
-                buffer = (axis2_char_t *)AXIS2_MALLOC(env->allocator, end - start + 3);
-            }
-
-            /* read the data including CRLF (hence the size = end - start + 2) */
-            read = axutil_stream_read(svr_conn->stream, env, buffer, end - start + 2);
-            if(read > 0)
-            {
-                buffer[read] = AXIS2_ESC_NULL;
-
-                if(str_line)
-                {
-                    axis2_char_t* tmp_str_line = NULL;
-                    tmp_str_line = axutil_stracat(env, str_line, buffer);
-                    if(tmp_str_line)
-                    {
-                        AXIS2_FREE(env->allocator, str_line);
-                        str_line = tmp_str_line;
-                    }
-                }
-                else
-                {
-                    str_line = buffer;
-                }
-            }
-            else
-            {
-                /* read returns 0 or negative value, this could be an error */
-                if(str_line)
-                {
-                    AXIS2_FREE(env->allocator, str_line);
-                    str_line = NULL;
-                }
-                else
-                {
-                    AXIS2_FREE(env->allocator, buffer);
-                }
-            }
-            break;
+            /* header is more than 2048 character. this is not a common case, and not optimized
+             * for performance */
+            axis2_char_t* tmp_str_line = NULL;
+            tmp_str_line = axutil_stracat(env, str_line, tmp_buf);
+            AXIS2_FREE(env->allocator, str_line);
+            str_line = tmp_str_line;
         }
         else
         {
-            /* not reached end yet */
-            read = axutil_stream_read(svr_conn->stream, env, tmp_buf, 2048 - 1);
-            if(read > 0)
+            str_line = (axis2_char_t *)AXIS2_MALLOC(env->allocator, read + 1);
+            if(str_line)
             {
-                axis2_char_t* tmp_str_line = NULL;
-                tmp_buf[read] = AXIS2_ESC_NULL;
-                tmp_str_line = axutil_stracat(env, str_line, tmp_buf);
-                if(tmp_str_line)
-                {
-                    if(str_line)
-                    {
-                        AXIS2_FREE(env->allocator, str_line);
-                    }
-                    str_line = tmp_str_line;
-                }
+                memcpy(str_line, tmp_buf, read + 1);
             }
         }
+        if(!str_line || tmp_buf[read - 1] == '\n')
+        {
+            break;
+        }
     }
 
+    if(read <= 0 && str_line)
+    {
+        /* the stream ended in the middle of the line */
+        AXIS2_FREE(env->allocator, str_line);
+        str_line = NULL;
+    }
     return str_line;
 }
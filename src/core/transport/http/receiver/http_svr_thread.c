@@ -29,6 +29,7 @@
 #include <signal.h>
 
 AXIS2_EXPORT int axis2_http_socket_read_timeout = AXIS2_HTTP_DEFAULT_SO_TIMEOUT;
+AXIS2_EXPORT int axis2_http_request_arena_size = AXIS2_HTTP_DEFAULT_REQUEST_ARENA_SIZE;
 
 struct axis2_http_svr_thread
 {
@@ -51,6 +52,10 @@ axis2_svr_thread_worker_func(
     axutil_thread_t * thd,
     void *data);
 
+static axutil_env_t *
+axis2_svr_thread_init_request_env(
+    const axutil_env_t * env);
+
 axis2_http_svr_thread_t *AXIS2_CALL
 axis2_http_svr_thread_create(
     const axutil_env_t * env,
@@ -121,6 +126,10 @@ axis2_http_svr_thread_run(
 #endif
 
         socket = (int)axutil_network_handler_svr_socket_accept(env, svr_thread-> listen_socket);
+        if(socket < 0 && svr_thread->stopped)
+        {
+            break;
+        }
         if(!svr_thread->worker)
         {
             AXIS2_LOG_WARNING(env->log, AXIS2_LOG_SI,
@@ -170,6 +179,8 @@ axis2_http_svr_thread_destroy(
     AXIS2_LOG_DEBUG(env->log, AXIS2_LOG_SI, "Terminating HTTP server thread.");
     if(svr_thread->listen_socket)
     {
+        /* closing alone does not wake a thread blocked in accept */
+        shutdown(svr_thread->listen_socket, AXIS2_SHUT_RDWR);
         axutil_network_handler_close_socket(env, svr_thread->listen_socket);
         svr_thread->listen_socket = -1;
     }
@@ -203,6 +214,35 @@ axis2_http_svr_thread_set_worker(
     return AXIS2_SUCCESS;
 }
 
+/**
+ * Creates the environment a single request is served with. Unless disabled,
+ * everything allocated while serving the request comes out of an arena that
+ * is released in one go when the environment is freed.
+ */
+static axutil_env_t *
+axis2_svr_thread_init_request_env(
+    const axutil_env_t * env)
+{
+    axutil_allocator_t *allocator = NULL;
+    axutil_error_t *error = NULL;
+
+    if(axis2_http_request_arena_size <= 0)
+    {
+        return axutil_init_thread_env(env);
+    }
+
+    /* blocks of the server's allocator that the request frees are given back to it */
+    allocator = axutil_allocator_arena_create_with_parent((size_t)axis2_http_request_arena_size,
+        env->allocator);
+    if(!allocator)
+    {
+        return axutil_init_thread_env(env);
+    }
+    error = axutil_error_create(allocator);
+    return axutil_env_create_with_error_log_thread_pool(allocator, error, env->log,
+        env->thread_pool);
+}
+
 /**
  * Thread worker function.
  */
@@ -236,7 +276,7 @@ axis2_svr_thread_worker_func(
     arg_list = (axis2_http_svr_thd_args_t *)data;
 
     env = arg_list->env;
-    thread_env = axutil_init_thread_env(env);
+    thread_env = axis2_svr_thread_init_request_env(env);
 
     IF_AXIS2_LOG_DEBUG_ENABLED(env->log)
     {
@@ -299,7 +339,7 @@ axis2_svr_thread_worker_func(
         AXIS2_LOG_WARNING(thread_env->log, AXIS2_LOG_SI, "Error occurred in processing request ");
     }
 
-    AXIS2_FREE(thread_env->allocator, arg_list);
+    AXIS2_FREE(env->allocator, arg_list);
     axutil_free_thread_env(thread_env);
     thread_env = NULL;
 
@@ -43,6 +43,7 @@ struct axis2_http_client
     axis2_http_simple_response_t *response;
     axis2_bool_t request_sent;
     int timeout;
+    axutil_socket_options_t socket_options;
     axis2_bool_t proxy_enabled;
     axis2_char_t *proxy_host;
     int proxy_port;
@@ -85,6 +86,8 @@ axis2_http_client_create(
 
     /* default timeout is 60000 milliseconds */
     http_client->timeout = AXIS2_HTTP_DEFAULT_CONNECTION_TIMEOUT;
+    axutil_socket_options_init(&http_client->socket_options);
+    http_client->socket_options.connect_timeout = AXIS2_HTTP_DEFAULT_CONNECTION_TIMEOUT;
     http_client->proxy_enabled = AXIS2_FALSE;
     http_client->proxy_port = 0;
     http_client->proxy_host = NULL;
@@ -237,8 +240,8 @@ axis2_http_client_send(
 
         if(client->sockfd < 0)
         {
-            client->sockfd = (int)axutil_network_handler_open_socket(env, client->proxy_host,
-                client->proxy_port);
+            client->sockfd = (int)axutil_network_handler_open_socket_with_options(env,
+                client->proxy_host, client->proxy_port, &client->socket_options);
         }
     }
     else
@@ -247,7 +250,8 @@ axis2_http_client_send(
 
         if(client->sockfd < 0)
         {
-            client->sockfd = (int)axutil_network_handler_open_socket(env, host, port);
+            client->sockfd = (int)axutil_network_handler_open_socket_with_options(env, host, port,
+                &client->socket_options);
         }
     }
 
@@ -298,7 +302,7 @@ axis2_http_client_send(
     else
     {
         if(!client->data_stream)
-            client->data_stream = axutil_stream_create_socket(env, client->sockfd);
+            client->data_stream = axutil_stream_create_buffered_socket(env, client->sockfd, 0);
     }
 
     if(!client->data_stream)
@@ -423,7 +427,9 @@ axis2_http_client_send(
 
     }
 
-    /* Here first we send the http header part */
+    /* Here first we send the http header part. The stream is corked so that the header and a
+     * small body go out together */
+    axutil_stream_cork(client->data_stream, env);
 
     wire_format = axutil_stracat(env, str_request_line, str_header);
     AXIS2_FREE(env->allocator, str_header);
@@ -456,6 +462,7 @@ axis2_http_client_send(
             if(axis2_http_transport_utils_is_callback_required(env, client->mime_parts))
             {
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Sender callback not specified");
+                axutil_stream_uncork(client->data_stream, env);
                 return AXIS2_FAILURE;
             }
         }
@@ -508,6 +515,7 @@ axis2_http_client_send(
             status = AXIS2_SUCCESS;
             if(!chunked_stream)
             {
+                axutil_stream_uncork(client->data_stream, env);
                 axutil_network_handler_close_socket(env, client->sockfd);
                 client->sockfd = -1;
                 AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Creatoin of chunked stream failed");
@@ -536,6 +544,10 @@ axis2_http_client_send(
         }
     }
 
+    if(axutil_stream_uncork(client->data_stream, env) != AXIS2_SUCCESS)
+    {
+        status = AXIS2_FAILURE;
+    }
     client->request_sent = AXIS2_TRUE;
     return status;
 }
@@ -557,11 +569,9 @@ axis2_http_client_receive_header(
     int status_code = -1;
     axis2_http_status_line_t *status_line = NULL;
     axis2_char_t str_status_line[AXIS2_HTTP_STATUS_LINE_LENGTH];
-    axis2_char_t tmp_buf[3];
     axis2_char_t str_header[AXIS2_HTTP_HEADER_LENGTH];
     int read = 0;
     int http_status = 0;
-    axis2_bool_t end_of_line = AXIS2_FALSE;
     axis2_bool_t end_of_headers = AXIS2_FALSE;
 
     if(-1 == client->sockfd || !client->data_stream || AXIS2_FALSE == client->request_sent)
@@ -580,28 +590,8 @@ axis2_http_client_receive_header(
     /* read the status line */
     do
     {
-        memset(str_status_line, 0, AXIS2_HTTP_STATUS_LINE_LENGTH);
-        unsigned int str_status_line_length = 0;
-        while((read = axutil_stream_read(client->data_stream, env, tmp_buf, 1)) > 0)
-        {
-            /* "read" variable is number of characters read by stream */
-            tmp_buf[read] = '\0';
-            str_status_line_length += read;
-            if (str_status_line_length + 1 > AXIS2_HTTP_STATUS_LINE_LENGTH)
-            {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "reached maximum status line length %i",
-                        AXIS2_HTTP_STATUS_LINE_LENGTH);
-                end_of_line = AXIS2_TRUE;
-                break;
-            }
-            strcat(str_status_line, tmp_buf);
-            if(0 != strstr(str_status_line, AXIS2_HTTP_CRLF))
-            {
-                end_of_line = AXIS2_TRUE;
-                break;
-            }
-        }
-
+        read = axutil_stream_read_line(client->data_stream, env, str_status_line,
+            AXIS2_HTTP_STATUS_LINE_LENGTH);
         if(read < 0)
         {
             AXIS2_LOG_DEBUG(env->log, AXIS2_LOG_SI, "http client , response timed out");
@@ -614,7 +604,16 @@ axis2_http_client_receive_header(
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Response error, Server Shutdown");
             return 0;
         }
+        if(str_status_line[read - 1] != '\n')
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "reached maximum status line length %i",
+                AXIS2_HTTP_STATUS_LINE_LENGTH);
+        }
 
+        if(status_line)
+        {
+            axis2_http_status_line_free(status_line, env);
+        }
         status_line = axis2_http_status_line_create(env, str_status_line);
         if(!status_line)
         {
@@ -640,46 +639,46 @@ str_status_line %s", str_status_line);
         axis2_http_status_line_get_reason_phrase(status_line, env));
 
     /* now read the headers */
-    memset(str_header, 0, AXIS2_HTTP_HEADER_LENGTH);
-    unsigned int str_header_length = 0;
-    end_of_line = AXIS2_FALSE;
     while(AXIS2_FALSE == end_of_headers)
     {
-        while((read = axutil_stream_read(client->data_stream, env, tmp_buf, 1)) > 0)
+        read = axutil_stream_read_line(client->data_stream, env, str_header,
+            AXIS2_HTTP_HEADER_LENGTH);
+        if(read <= 0)
         {
-            tmp_buf[read] = '\0';
-            str_header_length += read;
-            if (str_header_length + 1 > AXIS2_HTTP_HEADER_LENGTH)
+            /* nothing more to read, so stop here rather than loop for ever */
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "reading http header failed");
+            break;
+        }
+        if(str_header[read - 1] != '\n')
+        {
+            /* drop the whole line, its pieces are not headers of their own */
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+                "reached maximum header line length %i, header ignored", AXIS2_HTTP_HEADER_LENGTH);
+            do
             {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "reached maximum header line length %i",
-                        AXIS2_HTTP_HEADER_LENGTH);
-                end_of_line = AXIS2_TRUE;
-                break;
+                read = axutil_stream_read_line(client->data_stream, env, str_header,
+                    AXIS2_HTTP_HEADER_LENGTH);
             }
-            strcat(str_header, tmp_buf);
-            if(0 != strstr(str_header, AXIS2_HTTP_CRLF))
+            while(read > 0 && str_header[read - 1] != '\n');
+            if(read <= 0)
             {
-                end_of_line = AXIS2_TRUE;
+                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "reading http header failed");
                 break;
             }
+            continue;
         }
-        if(AXIS2_TRUE == end_of_line)
+        if(0 ==axutil_strcmp(str_header, AXIS2_HTTP_CRLF))
         {
-            if(0 == axutil_strcmp(str_header, AXIS2_HTTP_CRLF))
-            {
-                end_of_headers = AXIS2_TRUE;
-            }
-            else
+            end_of_headers = AXIS2_TRUE;
+        }
+        else
+        {
+            axis2_http_header_t *tmp_header = axis2_http_header_create_by_str(env, str_header);
+            if(tmp_header)
             {
-                axis2_http_header_t *tmp_header = axis2_http_header_create_by_str(env, str_header);
-                memset(str_header, 0, AXIS2_HTTP_HEADER_LENGTH);
-                if(tmp_header)
-                {
-                    axis2_http_simple_response_set_header(client->response, env, tmp_header);
-                }
+                axis2_http_simple_response_set_header(client->response, env, tmp_header);
             }
         }
-        end_of_line = AXIS2_FALSE;
     }
     axis2_http_simple_response_set_body_stream(client->response, env, client->data_stream);
     if(status_line)
@@ -755,6 +754,27 @@ axis2_http_client_get_timeout(
     return client->timeout;
 }
 
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axis2_http_client_set_socket_options(
+    axis2_http_client_t * client,
+    const axutil_env_t * env,
+    const axutil_socket_options_t * options)
+{
+    AXIS2_PARAM_CHECK(env->error, client, AXIS2_FAILURE);
+    AXIS2_PARAM_CHECK(env->error, options, AXIS2_FAILURE);
+    client->socket_options = *options;
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN const axutil_socket_options_t *AXIS2_CALL
+axis2_http_client_get_socket_options(
+    const axis2_http_client_t * client,
+    const axutil_env_t * env)
+{
+    AXIS2_PARAM_CHECK(env->error, client, NULL);
+    return &client->socket_options;
+}
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axis2_http_client_set_proxy(
     axis2_http_client_t * client,
@@ -84,6 +84,12 @@ axis2_http_sender_configure_key_file(
     const axutil_env_t * env,
     axis2_msg_ctx_t * msg_ctx);
 
+static axis2_status_t
+axis2_http_sender_configure_socket_options(
+    axis2_http_sender_t * sender,
+    const axutil_env_t * env,
+    axis2_msg_ctx_t * msg_ctx);
+
 static axis2_status_t
 axis2_http_sender_configure_http_auth(
     axis2_http_sender_t * sender,
@@ -936,6 +942,7 @@ axis2_http_sender_send(
 
     axis2_http_sender_get_timeout_values(sender, env, msg_ctx);
     axis2_http_client_set_timeout(sender->client, env, sender->so_timeout);
+    axis2_http_sender_configure_socket_options(sender, env, msg_ctx);
 
     ssl_pp_property = axis2_msg_ctx_get_property(msg_ctx, env, AXIS2_SSL_PASSPHRASE);
 
@@ -1912,6 +1919,93 @@ axis2_http_sender_configure_key_file(
 }
 #endif
 
+#ifndef AXIS2_LIBCURL_ENABLED
+/* Looks a socket setting up in the options of the client, then in the
+ * transportSender parameters */
+static axis2_char_t *
+axis2_http_sender_get_socket_setting(
+    const axutil_env_t * env,
+    axis2_msg_ctx_t * msg_ctx,
+    axis2_transport_out_desc_t * trans_desc,
+    const axis2_char_t * name)
+{
+    axutil_property_t *property = NULL;
+    axutil_param_t *param = NULL;
+
+    property = axis2_msg_ctx_get_property(msg_ctx, env, name);
+    if(property)
+    {
+        return (axis2_char_t *)axutil_property_get_value(property, env);
+    }
+    if(trans_desc)
+    {
+        param = axutil_param_container_get_param(axis2_transport_out_desc_param_container(
+            trans_desc, env), env, name);
+        if(param)
+        {
+            return (axis2_char_t *)axutil_param_get_value(param, env);
+        }
+    }
+    return NULL;
+}
+
+static axis2_status_t
+axis2_http_sender_configure_socket_options(
+    axis2_http_sender_t * sender,
+    const axutil_env_t * env,
+    axis2_msg_ctx_t * msg_ctx)
+{
+    axutil_socket_options_t options;
+    axis2_transport_out_desc_t *trans_desc = NULL;
+    axis2_char_t *value = NULL;
+
+    AXIS2_PARAM_CHECK(env->error, msg_ctx, AXIS2_FAILURE);
+
+    trans_desc = axis2_msg_ctx_get_transport_out_desc(msg_ctx, env);
+    axutil_socket_options_init(&options);
+
+    /* a dead server is given up on after the read timeout, unless a
+     * connect timeout of its own is set */
+    options.connect_timeout = sender->so_timeout;
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc,
+        AXIS2_HTTP_CONNECT_TIMEOUT);
+    if(value)
+    {
+        options.connect_timeout = AXIS2_ATOI(value);
+    }
+
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc, AXIS2_HTTP_TCP_NODELAY);
+    if(value)
+    {
+        options.nodelay = axutil_strcmp(value, AXIS2_VALUE_FALSE) ? AXIS2_TRUE : AXIS2_FALSE;
+    }
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc,
+        AXIS2_HTTP_SO_KEEPALIVE);
+    if(value)
+    {
+        options.keepalive = axutil_strcmp(value, AXIS2_VALUE_TRUE) ? AXIS2_FALSE : AXIS2_TRUE;
+    }
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc,
+        AXIS2_HTTP_TCP_USER_TIMEOUT);
+    if(value)
+    {
+        options.user_timeout = AXIS2_ATOI(value);
+    }
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc, AXIS2_HTTP_SO_SNDBUF);
+    if(value)
+    {
+        options.send_buffer_size = AXIS2_ATOI(value);
+    }
+    value = axis2_http_sender_get_socket_setting(env, msg_ctx, trans_desc, AXIS2_HTTP_SO_RCVBUF);
+    if(value)
+    {
+        options.recv_buffer_size = AXIS2_ATOI(value);
+    }
+
+    return axis2_http_client_set_socket_options(sender->client, env, &options);
+}
+#endif
+
 #ifndef AXIS2_LIBCURL_ENABLED
 static axis2_status_t
 axis2_http_sender_configure_http_basic_auth(
@@ -192,6 +192,8 @@ axis2_http_transport_sender_invoke(
     axutil_hash_t *transport_attrs = NULL;
     axis2_bool_t write_xml_declaration = AXIS2_FALSE;
     axis2_bool_t fault = AXIS2_FALSE;
+    axutil_buffer_chain_t *out_chain = NULL;
+    axutil_stream_t *direct_stream = NULL;
 
     AXIS2_LOG_TRACE(env->log, AXIS2_LOG_SI, "Entry:axis2_http_transport_sender_invoke");
     AXIS2_PARAM_CHECK(env->error, msg_ctx, AXIS2_FAILURE);
@@ -345,8 +347,37 @@ axis2_http_transport_sender_invoke(
     }
 #endif
 
-    xml_writer = axiom_xml_writer_create_for_memory(env, NULL, AXIS2_TRUE, 0,
-        AXIS2_XML_PARSER_TYPE_BUFFER);
+    /* A response going back on the connection the request came in on is serialized straight
+     * into the out stream, appending to its buffer chain when it keeps its data in one, else
+     * writing to it as the writer goes. MTOM needs the whole xml in one buffer to build the
+     * mime parts from. */
+    if(!do_mtom && axis2_msg_ctx_get_server_side(msg_ctx, env))
+    {
+        const axis2_char_t *address = epr ? axis2_endpoint_ref_get_address(epr, env) : NULL;
+        axutil_stream_t *out_stream = axis2_msg_ctx_get_transport_out_stream(msg_ctx, env);
+
+        if(out_stream && (!epr || !axutil_strcmp(AXIS2_WSA_NONE_URL_SUBMISSION, address)
+            || !axutil_strcmp(AXIS2_WSA_NONE_URL, address)))
+        {
+            direct_stream = out_stream;
+            out_chain = axutil_stream_get_chain(out_stream, env);
+        }
+    }
+
+    if(out_chain)
+    {
+        xml_writer = axiom_xml_writer_create_for_chain(env, NULL, AXIS2_TRUE, 0, out_chain);
+    }
+    else if(direct_stream)
+    {
+        xml_writer = axiom_xml_writer_create_for_stream(env, NULL, AXIS2_TRUE, 0, direct_stream,
+            0);
+    }
+    else
+    {
+        xml_writer = axiom_xml_writer_create_for_memory(env, NULL, AXIS2_TRUE, 0,
+            AXIS2_XML_PARSER_TYPE_BUFFER);
+    }
     if(!xml_writer)
     {
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
@@ -580,9 +611,16 @@ AXIS2_XML_PARSER_TYPE_BUFFER");
                 }
 
                 axiom_node_serialize(data_out, env, om_output);
-                buffer = (axis2_char_t *)axiom_xml_writer_get_xml(xml_writer, env);
-                buffer_size = axiom_xml_writer_get_xml_size(xml_writer, env);
-                axutil_stream_write(out_stream, env, buffer, buffer_size);
+                if(direct_stream)
+                {
+                    axiom_xml_writer_flush(xml_writer, env);
+                }
+                else
+                {
+                    buffer = (axis2_char_t *)axiom_xml_writer_get_xml(xml_writer, env);
+                    buffer_size = axiom_xml_writer_get_xml_size(xml_writer, env);
+                    axutil_stream_write(out_stream, env, buffer, buffer_size);
+                }
                 /* Finish Rest Processing */
 
             }
@@ -623,6 +661,11 @@ AXIS2_XML_PARSER_TYPE_BUFFER");
                     content_type = (axis2_char_t *)axiom_output_get_content_type(om_output, env);
                     AXIS2_HTTP_OUT_TRANSPORT_INFO_SET_CONTENT_TYPE(out_info, env, content_type);
                 }
+                else if(direct_stream)
+                {
+                    /* The envelope was serialized into out_stream already */
+                    axiom_xml_writer_flush(xml_writer, env);
+                }
                 else
                 {
                     buffer = (axis2_char_t *)axiom_xml_writer_get_xml(xml_writer, env);
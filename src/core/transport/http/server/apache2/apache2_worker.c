@@ -50,9 +50,8 @@ static axis2_status_t
 apache2_worker_send_attachment_using_file(
     const axutil_env_t * env,
     request_rec *request,
-    FILE *fp,
-    axis2_byte_t *buffer,
-    int buffer_size);
+    const axis2_char_t *file_name,
+    apr_size_t size);
 
 static axis2_status_t
 apache2_worker_send_attachment_using_callback(
@@ -1478,31 +1477,8 @@ apache2_worker_send_mtom_message(
             }
             else if((mime_part->type) == AXIOM_MIME_PART_FILE)
             {
-                FILE *f = NULL;
-                axis2_byte_t *output_buffer = NULL;
-                int output_buffer_size = 0;
-
-                f = fopen(mime_part->file_name, "rb");
-                if(!f)
-                {
-                    AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error opening file %s for reading",
-                        mime_part->file_name);
-                    return AXIS2_FAILURE;
-                }
-                if(mime_part->part_size > AXIS2_MTOM_OUTPUT_BUFFER_SIZE)
-                {
-                    output_buffer_size = AXIS2_MTOM_OUTPUT_BUFFER_SIZE;
-                }
-                else
-                {
-                    output_buffer_size = (int)mime_part->part_size;
-                }
-
-                output_buffer = AXIS2_MALLOC(env->allocator, (output_buffer_size + 1)
-                    * sizeof(axis2_char_t));
-
-                status = apache2_worker_send_attachment_using_file(env, request, f, output_buffer,
-                    output_buffer_size);
+                status = apache2_worker_send_attachment_using_file(env, request,
+                    mime_part->file_name, mime_part->part_size);
                 if(status == AXIS2_FAILURE)
                 {
                     return status;
@@ -1565,73 +1541,36 @@ apache2_worker_send_mtom_message(
     }
 }
 
+/* Hands the file to httpd as a file bucket, so that the core output filter
+ * can send it with sendfile instead of reading it through a buffer */
 static axis2_status_t
 apache2_worker_send_attachment_using_file(
     const axutil_env_t * env,
     request_rec *request,
-    FILE *fp,
-    axis2_byte_t *buffer,
-    int buffer_size)
+    const axis2_char_t *file_name,
+    apr_size_t size)
 {
+    apr_file_t *file = NULL;
+    apr_size_t sent = 0;
+    apr_status_t rv;
 
-    int count = 0;
-    int len = 0;
-    /*int written = 0;*/
-    axis2_status_t status = AXIS2_SUCCESS;
-
-    do
+    rv = apr_file_open(&file, file_name, APR_READ | APR_BINARY | APR_SENDFILE_ENABLED,
+        APR_OS_DEFAULT, request->pool);
+    if(rv != APR_SUCCESS)
     {
-        count = (int)fread(buffer, 1, buffer_size + 1, fp);
-        if(ferror(fp))
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error in reading file containg the attachment");
-            if(buffer)
-            {
-                AXIS2_FREE(env->allocator, buffer);
-                buffer = NULL;
-            }
-            fclose(fp);
-            return AXIS2_FAILURE;
-        }
-
-        if(count > 0)
-        {
-            len = 0;
-            len = ap_rwrite(buffer, count, request);
-            ap_rflush(request);
-            if(len == -1)
-            {
-                status = AXIS2_FAILURE;
-                break;
-            }
-        }
-        else
-        {
-            if(buffer)
-            {
-                AXIS2_FREE(env->allocator, buffer);
-                buffer = NULL;
-            }
-            fclose(fp);
-            return AXIS2_FAILURE;
-        }
-        memset(buffer, 0, buffer_size);
-        if(status == AXIS2_FAILURE)
-        {
-            if(buffer)
-            {
-                AXIS2_FREE(env->allocator, buffer);
-                buffer = NULL;
-            }
-            fclose(fp);
-            return AXIS2_FAILURE;
-        }
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error opening file %s for reading", file_name);
+        return AXIS2_FAILURE;
     }
-    while(!feof(fp));
 
-    fclose(fp);
-    AXIS2_FREE(env->allocator, buffer);
-    buffer = NULL;
+    /* the output filters may set the bucket aside, so the file is left to
+     * be closed with the request pool */
+    rv = ap_send_fd(file, request, 0, size, &sent);
+    if(rv != APR_SUCCESS || sent != size)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error in sending file %s containing the attachment",
+            file_name);
+        return AXIS2_FAILURE;
+    }
     return AXIS2_SUCCESS;
 }
 
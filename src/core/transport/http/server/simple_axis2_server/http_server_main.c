@@ -32,7 +32,9 @@
 
 axutil_env_t *system_env = NULL;
 axis2_transport_receiver_t *server = NULL;
+int worker_threads = AXUTIL_THREAD_POOL_DEFAULT_MAX_WORKERS;
 AXIS2_IMPORT extern int axis2_http_socket_read_timeout;
+AXIS2_IMPORT extern int axis2_http_request_arena_size;
 AXIS2_IMPORT extern axis2_char_t *axis2_request_url_prefix;
 
 #define DEFAULT_REPO_PATH "../"
@@ -67,7 +69,10 @@ init_syetem_env(
     /* if (!log) */
 
     /* 		  log = axutil_log_create_default (allocator); */
-    axutil_thread_pool_t *thread_pool = axutil_thread_pool_init(allocator);
+    axutil_thread_pool_t *thread_pool = axutil_thread_pool_create(allocator, worker_threads,
+        AXUTIL_THREAD_POOL_DEFAULT_MAX_QUEUE);
+    /* Services submit tasks to this pool from inside its workers, so a full
+     * queue spawns extra threads (the default) rather than making them wait */
     /* We need to init the parser in main thread before spawning child
      * threads
      */
@@ -111,6 +116,8 @@ main(
     axutil_log_levels_t log_level = AXIS2_LOG_LEVEL_DEBUG;
     const axis2_char_t *log_file = "axis2.log";
     int port = 9090;
+    const axis2_char_t *allocator_name = "heap";
+    int log_buffer_size = 0;
     axis2_status_t status;
 
 	axis2_char_t *repo_path = AXIS2_GETENV("AXIS2C_HOME");
@@ -123,7 +130,7 @@ main(
      set with AXIS2_REQUEST_URL_PREFIX macro at compile time */
     axis2_request_url_prefix = AXIS2_REQUEST_URL_PREFIX;
 
-    while((c = AXIS2_GETOPT(argc, argv, ":p:r:ht:l:s:f:")) != -1)
+    while((c = AXIS2_GETOPT(argc, argv, ":p:r:ht:l:s:f:w:a:m:b:")) != -1)
     {
 
         switch(c)
@@ -150,6 +157,20 @@ main(
             case 'f':
                 log_file = optarg;
                 break;
+            case 'a':
+                axis2_http_request_arena_size = 1024 * AXIS2_ATOI(optarg);
+                break;
+            case 'm':
+                allocator_name = optarg;
+                break;
+            case 'b':
+                log_buffer_size = 1024 * AXIS2_ATOI(optarg);
+                break;
+            case 'w':
+                worker_threads = AXIS2_ATOI(optarg);
+                if(worker_threads < 0)
+                    worker_threads = 0;
+                break;
             case 'h':
                 usage(argv[0]);
                 return 0;
@@ -165,7 +186,15 @@ main(
         }
     }
 
-    allocator = axutil_allocator_init(NULL);
+    if(!axutil_strcmp(allocator_name, "slab"))
+    {
+        allocator = axutil_allocator_slab_create();
+    }
+    else
+    {
+        allocator_name = "heap";
+        allocator = axutil_allocator_init(NULL);
+    }
 
     if(!allocator)
     {
@@ -175,6 +204,11 @@ main(
     env = init_syetem_env(allocator, log_file);
     env->log->level = log_level;
     env->log->size = log_file_size;
+    if(log_buffer_size > 0 && axutil_log_set_async(env->log, allocator, log_buffer_size,
+        AXUTIL_LOG_OVERFLOW_DROP) != AXIS2_SUCCESS)
+    {
+        log_buffer_size = 0;
+    }
 
     axutil_error_init();
     system_env = env;
@@ -189,6 +223,10 @@ main(
     AXIS2_LOG_INFO(env->log, "Server port : %d", port);
     AXIS2_LOG_INFO(env->log, "Repo location : %s", repo_path);
     AXIS2_LOG_INFO(env->log, "Read Timeout : %d ms", axis2_http_socket_read_timeout);
+    AXIS2_LOG_INFO(env->log, "Worker threads : %d", worker_threads);
+    AXIS2_LOG_INFO(env->log, "Request arena chunk : %d bytes", axis2_http_request_arena_size);
+    AXIS2_LOG_INFO(env->log, "Allocator : %s", allocator_name);
+    AXIS2_LOG_INFO(env->log, "Log buffer : %d bytes", log_buffer_size);
 
     status = axutil_file_handler_access(repo_path, AXIS2_R_OK);
     if(status == AXIS2_SUCCESS)
@@ -240,7 +278,11 @@ usage(
     fprintf(stdout, " [-r REPO_PATH]");
     fprintf(stdout, " [-l LOG_LEVEL]");
     fprintf(stdout, " [-f LOG_FILE]\n");
-    fprintf(stdout, " [-s LOG_FILE_SIZE]\n");
+    fprintf(stdout, " [-s LOG_FILE_SIZE]");
+    fprintf(stdout, " [-w WORKERS]");
+    fprintf(stdout, " [-a ARENA_KB]");
+    fprintf(stdout, " [-m ALLOCATOR]");
+    fprintf(stdout, " [-b LOG_BUFFER_KB]\n");
     fprintf(stdout, " Options :\n");
     fprintf(stdout, "\t-p PORT \t port number to use, default port is 9090\n");
     fprintf(stdout, "\t-r REPO_PATH \t repository path, default is ../\n");
@@ -259,6 +301,17 @@ usage(
 #endif
     fprintf(stdout,
         "\t-s LOG_FILE_SIZE\t Maximum log file size in mega bytes, default maximum size is 1MB.\n");
+    fprintf(stdout, "\t-w WORKERS\t number of worker threads, default is %d."
+        "\n\t\t\t 0 creates a new thread for every request\n",
+        AXUTIL_THREAD_POOL_DEFAULT_MAX_WORKERS);
+    fprintf(stdout, "\t-a ARENA_KB\t chunk size in KB of the per request memory arena,"
+        "\n\t\t\t default is %d. 0 allocates from the heap\n",
+        AXIS2_HTTP_DEFAULT_REQUEST_ARENA_SIZE / 1024);
+    fprintf(stdout, "\t-m ALLOCATOR\t allocator to use, heap (default) or slab."
+        "\n\t\t\t slab serves small objects from per size slabs\n");
+    fprintf(stdout, "\t-b LOG_BUFFER_KB\t size in KB of the log buffer of each thread,"
+        "\n\t\t\t default is 0. Above 0, log lines are written out in the"
+        "\n\t\t\t background and low priority lines may be dropped under load\n");
     fprintf(stdout, " Help :\n\t-h \t display this help screen.\n\n");
 }
 
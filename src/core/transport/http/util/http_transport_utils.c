@@ -202,14 +202,6 @@ axis2_http_transport_utils_session_map_free_void_arg(
     void *sm_void,
     const axutil_env_t *env);
 
-static axis2_status_t
-axis2_http_transport_utils_send_attachment_using_file(
-    const axutil_env_t * env,
-    axutil_http_chunked_stream_t *chunked_stream,
-    FILE *fp,
-    axis2_byte_t *buffer,
-    int buffer_size);
-
 static axis2_status_t
 axis2_http_transport_utils_send_attachment_using_callback(
     const axutil_env_t * env,
@@ -3376,13 +3368,12 @@ axis2_http_transport_utils_send_mtom_message(
             }
         }
 
-        /* If it is a file we load a very little portion to memory and send it as chunked ,
-         * we keep on doing this until we find the end of the file */
+        /* If it is a file we send it as one chunk. On a plain socket the
+         * kernel copies the file to the wire, other streams such as SSL get
+         * it through a buffer */
         else if(mime_part->type == AXIOM_MIME_PART_FILE)
         {
             FILE *f = NULL;
-            axis2_byte_t *output_buffer = NULL;
-            int output_buffer_size = 0;
 
             f = fopen(mime_part->file_name, "rb");
             if(!f)
@@ -3392,23 +3383,13 @@ axis2_http_transport_utils_send_mtom_message(
                 return AXIS2_FAILURE;
             }
 
-            /* If the part_size is less than the defined buffer size then
-             * from the first write to the wire we can send the file */
-            if(mime_part->part_size > AXIS2_MTOM_OUTPUT_BUFFER_SIZE)
-            {
-                output_buffer_size = AXIS2_MTOM_OUTPUT_BUFFER_SIZE;
-            }
-            else
+            status = axutil_http_chunked_stream_write_file(chunked_stream, env, f,
+                mime_part->part_size);
+            if(status != AXIS2_SUCCESS)
             {
-                output_buffer_size = (int)mime_part->part_size;
+                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "error in writing file %s to stream",
+                    mime_part->file_name);
             }
-
-            output_buffer = AXIS2_MALLOC(env->allocator, output_buffer_size * sizeof(axis2_char_t));
-
-            /*This is the method responsible for writing to the wire */
-            status = axis2_http_transport_utils_send_attachment_using_file(env, chunked_stream,
-                f, output_buffer, output_buffer_size);
-            AXIS2_FREE(env->allocator, output_buffer);
             fclose(f);
         }
         else if((mime_part->type) == AXIOM_MIME_PART_HANDLER) 
@@ -3493,50 +3474,6 @@ axis2_http_transport_utils_send_mtom_message(
     return status;
 }
 
-static axis2_status_t
-axis2_http_transport_utils_send_attachment_using_file(
-    const axutil_env_t * env,
-    axutil_http_chunked_stream_t *chunked_stream,
-    FILE *fp,
-    axis2_byte_t *buffer,
-    int buffer_size)
-{
-    /*We do not load the whole file to memory. Just load a buffer_size portion
-     *and send it. Keep on doing this until the end of file */
-    do
-    {
-        int written = 0;
-        int count = (int)fread(buffer, 1, buffer_size, fp);
-        if(ferror(fp) || (count < 0))
-        {
-            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
-                "Error in reading file containing the attachment");
-            return AXIS2_FAILURE;
-        }
-
-        /* count == 0 is a valid case. If the file size is multiple of buffer_size, then last read
-         * will have count == 0
-         */
-
-        /*Writing the part we loaded to memory to the wire*/
-        while(written < count)
-        {
-            int len = axutil_http_chunked_stream_write(chunked_stream, env,
-                buffer + written, count - written);
-            if(len == -1)
-            {
-                AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "error in writing file to stream");
-                return AXIS2_FAILURE;
-            }
-
-            written += len;
-        }
-    }
-    while(!feof(fp));
-
-    return AXIS2_SUCCESS;
-}
-
 AXIS2_EXTERN void AXIS2_CALL
 axis2_http_transport_utils_destroy_mime_parts(
     axutil_array_list_t *mime_parts,
@@ -140,6 +140,10 @@ axis2_tcp_svr_thread_run(
 #endif
 
         socket = (int)axutil_network_handler_svr_socket_accept(env, svr_thread-> listen_socket);
+        if(socket < 0 && svr_thread->stopped)
+        {
+            break;
+        }
         if(!svr_thread->worker)
         {
             AXIS2_LOG_WARNING(env->log, AXIS2_LOG_SI, "Worker not ready yet."
@@ -191,6 +195,8 @@ axis2_tcp_svr_thread_destroy(
         "thread.");
     if(svr_thread->listen_socket)
     {
+        /* closing alone does not wake a thread blocked in accept */
+        shutdown(svr_thread->listen_socket, AXIS2_SHUT_RDWR);
         axutil_network_handler_close_socket(env, svr_thread->listen_socket);
         svr_thread->listen_socket = -1;
     }
@@ -210,7 +216,7 @@ axis2_tcp_svr_thread_is_running(
     axis2_tcp_svr_thread_t * svr_thread,
     const axutil_env_t * env)
 {
-    return svr_thread->port;
+    return !(svr_thread->stopped);
 }
 
 axis2_status_t AXIS2_CALL
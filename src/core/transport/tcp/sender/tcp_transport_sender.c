@@ -253,6 +253,7 @@ axis2_tcp_transport_sender_invoke(
         const axis2_char_t *host = NULL;
         int port = 0;
         int socket = -1;
+        axutil_socket_options_t socket_options;
         axutil_stream_t *stream;
         int write = -1;
         int read = -1;
@@ -301,8 +302,11 @@ axis2_tcp_transport_sender_invoke(
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "retrieving port failed");
             return AXIS2_FAILURE;
         }
-        socket = (int)axutil_network_handler_open_socket(env, (char *)host, port);
-        if(!socket)
+        axutil_socket_options_init(&socket_options);
+        socket_options.connect_timeout = AXIS2_INTF_TO_IMPL(transport_sender)->connection_timeout;
+        socket = (int)axutil_network_handler_open_socket_with_options(env, (char *)host, port,
+            &socket_options);
+        if(socket < 0)
         {
             AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "socket creation failed");
             return AXIS2_FAILURE;
@@ -422,8 +426,9 @@ axis2_tcp_transport_sender_init(
     {
         AXIS2_INTF_TO_IMPL(transport_sender)->so_timeout = AXIS2_ATOI(temp);
     }
-    temp = (axis2_char_t *)axutil_param_container_get_param(
-        axis2_transport_out_desc_param_container(out_desc, env), env, AXIS2_TCP_CONNECTION_TIMEOUT);
+    temp = NULL;
+    temp_param = axutil_param_container_get_param(axis2_transport_out_desc_param_container(
+        out_desc, env), env, AXIS2_TCP_CONNECTION_TIMEOUT);
     if(temp_param)
     {
         temp = axutil_param_get_value(temp_param, env);
@@ -107,7 +107,7 @@ axis2_core_utils_create_out_msg_ctx(
 #endif
     axis2_bool_t server_side = AXIS2_FALSE;
     axis2_svc_grp_ctx_t *svc_grp_ctx = NULL;
-    axis2_char_t *msg_uuid = NULL;
+    axis2_char_t msg_uuid[AXUTIL_UUID_STRING_SIZE];
     axutil_stream_t *out_stream = NULL;
     axutil_param_t *expose_headers_param = NULL;
     axis2_bool_t expose_headers = AXIS2_FALSE;
@@ -165,13 +165,7 @@ axis2_core_utils_create_out_msg_ctx(
         axis2_msg_ctx_set_msg_info_headers(new_msg_ctx, env, msg_info_headers);
     }
 
-    msg_uuid = axutil_uuid_gen(env);
-    axis2_msg_info_headers_set_message_id(msg_info_headers, env, msg_uuid);
-    if(msg_uuid)
-    {
-        AXIS2_FREE(env->allocator, msg_uuid);
-        msg_uuid = NULL;
-    }
+    axis2_msg_info_headers_set_message_id(msg_info_headers, env, axutil_uuid_gen_into(msg_uuid));
     reply_to = axis2_msg_info_headers_get_reply_to(old_msg_info_headers, env);
     axis2_msg_info_headers_set_to(msg_info_headers, env, reply_to);
 
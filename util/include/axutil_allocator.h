@@ -136,7 +136,8 @@ extern "C"
         axutil_allocator_t * allocator);
 
     /**
-     * Creates a clone of given allocator
+     * Creates a clone of given allocator. The clone of an arena is a
+     * clone of its parent, or a default allocator when it has none.
      * @param allocator user defined allocator. Cannot be NULL
      * @return initialized allocator. NULL on error.
      */
@@ -182,6 +183,102 @@ extern "C"
     axutil_allocator_switch_to_local_pool(
         axutil_allocator_t * allocator);
 
+    /** Size of the chunks an arena allocator carves blocks out of */
+#define AXUTIL_ALLOCATOR_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+    /**
+     * Creates an arena (region) allocator. Blocks are carved out of large
+     * chunks with a bump pointer and are only released all together, by
+     * axutil_allocator_arena_reset or axutil_allocator_free. This suits the
+     * memory of a single request, which dies with the request.
+     * While switched to the global pool with
+     * axutil_allocator_switch_to_global_pool, blocks come from the heap so
+     * that they can outlive the arena. Freeing such blocks through the
+     * arena or through any heap based allocator is fine.
+     * An arena must only be used by one thread at a time. Cloning it gives
+     * a heap allocator.
+     * @param chunk_size size of the chunks to allocate, 0 for the default
+     * @return arena allocator. NULL on error.
+     */
+    AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+    axutil_allocator_arena_create(
+        size_t chunk_size);
+
+    /**
+     * Creates an arena allocator like axutil_allocator_arena_create, except
+     * that blocks not carved out of the arena are allocated and freed by
+     * parent instead of the C library. Blocks of the parent allocator may
+     * then be freed through the arena, and the arena may be used for objects
+     * that also hold memory of the parent allocator.
+     * @param chunk_size size of the chunks to allocate, 0 for the default
+     * @param parent allocator for the blocks that are not in the arena
+     * @return arena allocator. NULL on error.
+     */
+    AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+    axutil_allocator_arena_create_with_parent(
+        size_t chunk_size,
+        axutil_allocator_t * parent);
+
+    /**
+     * Releases every block allocated from the arena, keeping one chunk for
+     * reuse. Has no effect on other allocators.
+     * @param allocator arena allocator to reset
+     * @return void
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_allocator_arena_reset(
+        axutil_allocator_t * allocator);
+
+    /**
+     * Usage of one size class of the slab allocator
+     */
+    typedef struct axutil_allocator_slab_stats
+    {
+        /** size of the blocks of the class */
+        size_t object_size;
+
+        /** blocks currently allocated */
+        unsigned long live_objects;
+
+        /** highest number of blocks held at once, counting blocks cached
+         *  by threads for reuse */
+        unsigned long peak_objects;
+
+        /** slabs the class has carved blocks out of */
+        unsigned long slabs;
+
+        /** memory taken by those slabs */
+        size_t bytes;
+    } axutil_allocator_slab_stats_t;
+
+    /** Number of size classes of the slab allocator */
+#define AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES 20
+
+    /**
+     * Creates a slab allocator. Small blocks (up to 1KB) are rounded up to
+     * a size class and served from slabs shared by all slab allocators,
+     * through a cache of free blocks per thread that needs no locking.
+     * Larger blocks come from the heap. Blocks allocated by any heap based
+     * allocator may be freed through a slab allocator.
+     * Clones are slab allocators too.
+     * @return slab allocator. NULL on error.
+     */
+    AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+    axutil_allocator_slab_create(
+        void);
+
+    /**
+     * Reports the usage of the slab allocator, one entry per size class,
+     * smallest class first.
+     * @param stats array to fill in
+     * @param size number of entries in stats
+     * @return number of entries filled in
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_allocator_slab_get_stats(
+        axutil_allocator_slab_stats_t * stats,
+        int size);
+
 #define AXIS2_MALLOC(allocator, size) \
      ((allocator)->malloc_fn(allocator, size))
 
@@ -16,6 +16,7 @@
  */
 
 #include <axutil_utils_defines.h>
+#include <axutil_env.h>
 
 /*
  * @file axutil_base64.h
@@ -114,6 +115,93 @@ extern "C"
         unsigned char *plain_dst,
         const char *coded_src);
 
+    /*
+     * Streaming encoder. Encodes data handed over piece by piece and passes
+     * the encoded text on in pieces of a few KB, so that large data can be
+     * written out without holding all of its encoded form in memory.
+     */
+    typedef struct axutil_base64_encoder axutil_base64_encoder_t;
+
+    struct axutil_stream;
+
+    /*
+     * Receives a piece of encoded text.
+     * @param ctx the context given when creating the encoder
+     * @param env pointer to environment struct
+     * @param text the encoded text, '\0' terminated
+     * @param len the length of the text
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE, which stops
+     * the encoder
+     */
+    typedef axis2_status_t(
+        AXIS2_CALL
+        * axutil_base64_encoder_write_t)(
+            void *ctx,
+            const axutil_env_t * env,
+            const axis2_char_t * text,
+            int len);
+
+    /*
+     * Creates a streaming encoder.
+     * @param env pointer to environment struct
+     * @param write function to pass the encoded text to
+     * @param ctx context to pass to write
+     * @return the encoder, NULL on error
+     */
+    AXIS2_EXTERN axutil_base64_encoder_t *AXIS2_CALL
+    axutil_base64_encoder_create(
+        const axutil_env_t * env,
+        axutil_base64_encoder_write_t write,
+        void *ctx);
+
+    /*
+     * Creates a streaming encoder that writes to a stream.
+     * @param env pointer to environment struct
+     * @param stream stream to write the encoded text to
+     * @return the encoder, NULL on error
+     */
+    AXIS2_EXTERN axutil_base64_encoder_t *AXIS2_CALL
+    axutil_base64_encoder_create_for_stream(
+        const axutil_env_t * env,
+        struct axutil_stream *stream);
+
+    /*
+     * Encodes the next piece of data.
+     * @param encoder the encoder
+     * @param env pointer to environment struct
+     * @param data the data
+     * @param len the length of the data
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_base64_encoder_update(
+        axutil_base64_encoder_t * encoder,
+        const axutil_env_t * env,
+        const unsigned char *data,
+        int len);
+
+    /*
+     * Encodes what is left of the data, with padding, and passes on all
+     * the encoded text. The encoder can be used for new data afterwards.
+     * @param encoder the encoder
+     * @param env pointer to environment struct
+     * @return AXIS2_SUCCESS if all the text was written, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_base64_encoder_finish(
+        axutil_base64_encoder_t * encoder,
+        const axutil_env_t * env);
+
+    /*
+     * Frees the encoder.
+     * @param encoder the encoder
+     * @param env pointer to environment struct
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_base64_encoder_free(
+        axutil_base64_encoder_t * encoder,
+        const axutil_env_t * env);
+
     /* @} */
 #ifdef __cplusplus
 }
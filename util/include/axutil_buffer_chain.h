@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AXUTIL_BUFFER_CHAIN_H
+#define AXUTIL_BUFFER_CHAIN_H
+
+#include <axutil_utils.h>
+#include <axutil_utils_defines.h>
+#include <axutil_env.h>
+#include <axutil_stream.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @defgroup axutil_buffer_chain buffer chain
+     * @ingroup axis2_util
+     * A buffer made of fixed size chunks. Appending never moves the data
+     * already in the chain, so a message of any size is built without
+     * reallocating and copying, and is sent with gather writes straight
+     * from the chunks. Chunks are taken from, and given back to, a pool
+     * shared by the whole process.
+     * @{
+     */
+
+    /** bytes in a chunk */
+#define AXUTIL_BUFFER_CHAIN_CHUNK_SIZE 16384
+
+    /** free chunks the pool keeps for reuse */
+#define AXUTIL_BUFFER_CHAIN_POOL_SIZE 64
+
+    typedef struct axutil_buffer_chain axutil_buffer_chain_t;
+
+    /**
+     * Creates an empty chain
+     * @return the chain, NULL on failure
+     */
+    AXIS2_EXTERN axutil_buffer_chain_t *AXIS2_CALL
+    axutil_buffer_chain_create(
+        const axutil_env_t * env);
+
+    /**
+     * Frees the chain, giving its chunks back to the pool
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_buffer_chain_free(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env);
+
+    /**
+     * Appends data to the end of the chain
+     * @param data data to append
+     * @param len no: of bytes to append
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_buffer_chain_append(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        const void *data,
+        size_t len);
+
+    /**
+     * Appends data to the end of the chain without splitting it between
+     * chunks. A new chunk is started when the data does not fit in the last
+     * one, larger than usual if need be. The data stays where it is put until
+     * it is consumed.
+     * @param data data to append
+     * @param len no: of bytes to append
+     * @return where the data was put in the chain, NULL on failure
+     */
+    AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+    axutil_buffer_chain_append_contiguous(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        const void *data,
+        size_t len);
+
+    /**
+     * @return no: of bytes in the chain
+     */
+    AXIS2_EXTERN size_t AXIS2_CALL
+    axutil_buffer_chain_get_len(
+        const axutil_buffer_chain_t * chain,
+        const axutil_env_t * env);
+
+    /**
+     * Gets the segments the data of the chain is in, from the start
+     * @param iov array to fill with the segments
+     * @param max size of iov
+     * @return no: of segments filled in. There are more when this is max.
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_buffer_chain_get_segments(
+        const axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        axutil_stream_iovec_t * iov,
+        int max);
+
+    /**
+     * Drops bytes from the start of the chain, giving back the chunks that
+     * become empty
+     * @param count no: of bytes to drop
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_buffer_chain_consume(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        size_t count);
+
+    /**
+     * Copies bytes from the start of the chain and drops them
+     * @param buffer buffer to copy into
+     * @param count size of buffer
+     * @return no: of bytes copied
+     */
+    AXIS2_EXTERN size_t AXIS2_CALL
+    axutil_buffer_chain_read(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        void *buffer,
+        size_t count);
+
+    /**
+     * Writes the whole chain to a stream with gather writes, dropping what
+     * has been written
+     * @param stream stream to write to
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_buffer_chain_write_to_stream(
+        axutil_buffer_chain_t * chain,
+        const axutil_env_t * env,
+        axutil_stream_t * stream);
+
+    /**
+     * Copies the chain into a single null terminated buffer, for callers
+     * that need the data in one piece. The chain is left as it is.
+     * @return the buffer, to be freed by the caller, NULL on failure
+     */
+    AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+    axutil_buffer_chain_flatten(
+        const axutil_buffer_chain_t * chain,
+        const axutil_env_t * env);
+
+    /** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                          /* AXUTIL_BUFFER_CHAIN_H */
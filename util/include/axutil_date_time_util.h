@@ -42,6 +42,50 @@ extern "C"
     axutil_get_milliseconds(
         const axutil_env_t * env);
 
+    /** size of a buffer for axutil_get_http_date, "Sun, 06 Nov 1994 08:49:37 GMT" */
+#define AXUTIL_HTTP_DATE_SIZE 30
+
+    /** size of a buffer for axutil_get_log_time, "Sun Nov  6 08:49:37 1994" */
+#define AXUTIL_LOG_TIME_SIZE 25
+
+    /** size of a buffer for axutil_get_date_time_str, "1994-11-06T08:49:37Z" */
+#define AXUTIL_DATE_TIME_STR_SIZE 21
+
+    /*
+     * The current time is formatted once a second into a small ring of
+     * slots that every thread reads without locking; the functions below
+     * copy the text of the current second into the given buffer.
+     */
+
+    /**
+     * Gets the current time as an RFC 1123 date, for the HTTP Date header.
+     * @param buffer at least AXUTIL_HTTP_DATE_SIZE chars
+     * @return length of the date
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_get_http_date(
+        axis2_char_t * buffer);
+
+    /**
+     * Gets the current local time in the format of ctime, without the
+     * newline, as used to stamp log lines.
+     * @param buffer at least AXUTIL_LOG_TIME_SIZE chars
+     * @return length of the time string
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_get_log_time(
+        axis2_char_t * buffer);
+
+    /**
+     * Gets the current UTC time as an xsd:dateTime without fractional
+     * seconds, as used for WS-Addressing and WS-Security timestamps.
+     * @param buffer at least AXUTIL_DATE_TIME_STR_SIZE chars
+     * @return length of the time string
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_get_date_time_str(
+        axis2_char_t * buffer);
+
     /** @} */
 
 #ifdef __cplusplus
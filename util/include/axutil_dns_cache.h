@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AXUTIL_DNS_CACHE_H
+#define AXUTIL_DNS_CACHE_H
+
+#include <axutil_utils.h>
+#include <axutil_utils_defines.h>
+#include <axutil_env.h>
+#include <platforms/axutil_platform_auto_sense.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @defgroup axutil_dns_cache DNS cache
+     * @ingroup axis2_util
+     * Host names are resolved with getaddrinfo, for IPv4 and IPv6, and the
+     * addresses are kept for a while in a cache shared by every connection
+     * made in the process. Names that do not resolve are remembered too,
+     * for a shorter time.
+     * @{
+     */
+
+    /** most addresses kept for a host */
+#define AXUTIL_DNS_CACHE_MAX_ADDRS 8
+
+    /** seconds addresses are kept for, by default */
+#define AXUTIL_DNS_CACHE_DEFAULT_TTL 60
+
+    /** seconds a name that did not resolve is remembered for, by default */
+#define AXUTIL_DNS_CACHE_DEFAULT_NEGATIVE_TTL 5
+
+    typedef struct axutil_dns_addr
+    {
+        int family;
+        int len;
+        struct sockaddr_storage addr;
+    } axutil_dns_addr_t;
+
+    /**
+     * Resolves a host name, or a numeric IPv4 or IPv6 address, to the
+     * addresses to connect to, in the order getaddrinfo gave them.
+     * @param host host name or address
+     * @param port port to put into the addresses
+     * @param addrs array to fill in
+     * @param max size of addrs
+     * @return no: of addresses, 0 if the host could not be resolved
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_dns_cache_resolve(
+        const axutil_env_t * env,
+        const axis2_char_t * host,
+        int port,
+        axutil_dns_addr_t * addrs,
+        int max);
+
+    /**
+     * Resolves a host name ahead of the first connection to it, so that the
+     * connection finds the addresses in the cache.
+     * @param host host name, or a URL to take the host name from
+     * @return AXIS2_SUCCESS if the host resolved, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_dns_cache_prewarm(
+        const axutil_env_t * env,
+        const axis2_char_t * host);
+
+    /**
+     * Sets how long results are cached for. A ttl of 0 turns caching off.
+     * @param ttl seconds addresses are kept for
+     * @param negative_ttl seconds a name that did not resolve is remembered
+     *        for
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_dns_cache_set_ttl(
+        const axutil_env_t * env,
+        int ttl,
+        int negative_ttl);
+
+    /**
+     * Drops a host from the cache, or every host if host is NULL.
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_dns_cache_invalidate(
+        const axutil_env_t * env,
+        const axis2_char_t * host);
+
+    /**
+     * Gets the no: of lookups answered from the cache and the no: that had
+     * to go to the resolver. Numeric addresses are not counted.
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_dns_cache_get_stats(
+        unsigned long *hits,
+        unsigned long *misses);
+
+    /** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                          /* AXUTIL_DNS_CACHE_H */
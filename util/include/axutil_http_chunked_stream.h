@@ -78,6 +78,23 @@ extern "C"
         const void *buffer,
         size_t count);
 
+    /**
+    * Writes count bytes of a file, from its current position, as chunks
+    * whose data is sent with axutil_stream_sendfile, so that socket streams
+    * do not copy the file through user space.
+    * @param chunked_stream pointer to chunked stream
+    * @param env pointer to environment struct
+    * @param file file opened for reading
+    * @param count no: of bytes to be written
+    * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+    */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_http_chunked_stream_write_file(
+        axutil_http_chunked_stream_t * chunked_stream,
+        const axutil_env_t * env,
+        FILE * file,
+        size_t count);
+
     /**
     * @param chunked_stream pointer to chunked stream
     * @param env pointer to environment struct
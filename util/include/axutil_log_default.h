@@ -55,6 +55,59 @@ extern "C"
     axutil_log_create_default(
         axutil_allocator_t * allocator);
 
+    /**
+     * What an asynchronous log does with a line when the buffer of the
+     * logging thread is full
+     */
+    typedef enum axutil_log_overflow
+    {
+        /** drop info, debug and trace lines, wait for space for the others */
+        AXUTIL_LOG_OVERFLOW_DROP = 0,
+
+        /** wait for space for every line */
+        AXUTIL_LOG_OVERFLOW_BLOCK
+    } axutil_log_overflow_t;
+
+    /**
+      * Switches a log created by axutil_log_create or
+      * axutil_log_create_default to asynchronous writing, or back.
+      * Asynchronously, every logging thread formats its lines into a buffer
+      * of its own, and a background thread writes the buffers out in
+      * batches, at least every 200 milliseconds. Critical lines are written
+      * out at once, together with everything logged before them.
+      * Must not be called while other threads log.
+      * @param log log to switch
+      * @param allocator allocator for the buffers and the background thread
+      * @param buffer_size size of the buffer of each thread, rounded up to
+      * a power of two. 0 or less switches back to synchronous writing after
+      * writing out what is buffered
+      * @param overflow what to do with lines that do not fit in a buffer
+      * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+      */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_log_set_async(
+        axutil_log_t * log,
+        axutil_allocator_t * allocator,
+        int buffer_size,
+        axutil_log_overflow_t overflow);
+
+    /**
+      * Writes out every line logged so far
+      * @param log log to flush
+      */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_log_flush(
+        axutil_log_t * log);
+
+    /**
+      * Returns the number of lines an asynchronous log has dropped
+      * @param log log to query
+      * @return lines dropped, 0 for a synchronous log
+      */
+    AXIS2_EXTERN unsigned long AXIS2_CALL
+    axutil_log_get_dropped(
+        axutil_log_t * log);
+
     /** @} */
 
 #ifdef __cplusplus
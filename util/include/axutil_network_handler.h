@@ -35,6 +35,46 @@ extern "C"
      * @{
      */
 
+    /**
+     * Milli seconds to wait on a connect before the next address of the
+     * server is tried alongside it
+     */
+#define AXUTIL_NETWORK_HANDLER_CONNECT_DELAY 250
+
+    /**
+     * Options applied to the sockets opened by
+     * axutil_network_handler_open_socket_with_options. Sizes and times of 0
+     * leave the system defaults.
+     */
+    typedef struct axutil_socket_options
+    {
+        /** milli seconds to wait for the connection, 0 waits as long as
+         * the system does */
+        int connect_timeout;
+
+        /** TCP_NODELAY, on by default */
+        axis2_bool_t nodelay;
+
+        /** SO_KEEPALIVE, off by default */
+        axis2_bool_t keepalive;
+
+        /** milli seconds sent data may stay unacknowledged before the
+         * connection is dropped (TCP_USER_TIMEOUT, where supported) */
+        int user_timeout;
+
+        /** SO_SNDBUF and SO_RCVBUF in bytes */
+        int send_buffer_size;
+        int recv_buffer_size;
+    } axutil_socket_options_t;
+
+    /**
+     * Sets options to the defaults used by axutil_network_handler_open_socket
+     * @param options options to initialize
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_socket_options_init(
+        axutil_socket_options_t * options);
+
     /**
      * open a socket for a given server
      * @param server ip address or the fqn of the server
@@ -48,6 +88,25 @@ extern "C"
         char *server,
         int port);
 
+    /**
+     * open a socket for a given server, with the given options. The
+     * addresses of the server are tried in turn, alternating between IPv6
+     * and IPv4, and a new one is started whenever the previous ones have
+     * not connected within AXUTIL_NETWORK_HANDLER_CONNECT_DELAY. The first
+     * to connect is used.
+     * @param server ip address or the fqn of the server
+     * @param port port of the service
+     * @param options socket options, NULL for the defaults
+     * @return opened socket, AXIS2_INVALID_SOCKET if no address connected
+     * within the connect timeout
+     */
+    AXIS2_EXTERN axis2_socket_t AXIS2_CALL
+    axutil_network_handler_open_socket_with_options(
+        const axutil_env_t * env,
+        char *server,
+        int port,
+        const axutil_socket_options_t * options);
+
     /**
      * creates a server socket for a given port
      * @param port port of the socket to be bound
@@ -29,6 +29,7 @@ extern "C"
 #endif
 
 #define AXIS2_STREAM_DEFAULT_BUF_SIZE 2048
+#define AXIS2_STREAM_SOCKET_BUF_SIZE 8192
 
     /**
      * @defgroup axutil_stream stream
@@ -47,12 +48,22 @@ extern "C"
         AXIS2_STREAM_BASIC = 0,
         AXIS2_STREAM_FILE,
         AXIS2_STREAM_SOCKET,
-        AXIS2_STREAM_MANAGED    /* Example Wrapper stream for Apache2 read mechanism */
+        AXIS2_STREAM_MANAGED,   /* Example Wrapper stream for Apache2 read mechanism */
+        AXIS2_STREAM_CHAIN
     };
 
     typedef enum axutil_stream_type axutil_stream_type_t;
     typedef struct axutil_stream axutil_stream_t;
 
+    /**
+     * A segment of a gather write
+     */
+    typedef struct axutil_stream_iovec
+    {
+        const void *base;
+        size_t len;
+    } axutil_stream_iovec_t;
+
     typedef int(
         AXIS2_CALL
         * AXUTIL_STREAM_READ)(
@@ -154,6 +165,13 @@ extern "C"
                 void *buffer,
                 size_t count);
 
+        /* writes collected by a corked socket stream, cork_len is -1 when
+         * the stream is not corked */
+        axis2_char_t *cork_buffer;
+        int cork_len;
+
+        /* data of a chain stream */
+        struct axutil_buffer_chain *chain;
     };
 
     /**
@@ -196,6 +214,64 @@ extern "C"
         const void *buffer,
         size_t count);
 
+    /**
+     * Writes all the given segments, in order. Socket streams hand the
+     * segments to the system in a single writev call where they can, other
+     * streams write them one by one.
+     * @param iov segments to be written
+     * @param iovcnt number of segments
+     * @return no: of bytes written, -1 on error
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_stream_writev(
+        axutil_stream_t * stream,
+        const axutil_env_t * env,
+        const axutil_stream_iovec_t * iov,
+        int iovcnt);
+
+    /**
+     * Corks a socket stream. Until the stream is uncorked, small writes are
+     * collected in a buffer instead of being sent, and a write that does not
+     * fit in the buffer is sent together with what was collected in one
+     * writev call. This lets the headers and body of a message go out in a
+     * single packet. Other streams are not affected.
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_stream_cork(
+        axutil_stream_t * stream,
+        const axutil_env_t * env);
+
+    /**
+     * Sends what a corked stream has collected and uncorks it. Every call to
+     * axutil_stream_cork must be followed by one to this, or the collected
+     * data is never sent.
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_stream_uncork(
+        axutil_stream_t * stream,
+        const axutil_env_t * env);
+
+    /**
+     * Writes count bytes of a file, from its current position, to the
+     * stream. Socket streams have the kernel send the file straight to the
+     * socket with sendfile where the system has it, without copying it
+     * through user space. Other streams, such as SSL streams, and files the
+     * kernel cannot send are copied through a buffer. What a corked stream
+     * has collected is sent before the file.
+     * @param file file opened for reading
+     * @param count no: of bytes to be written
+     * @return AXIS2_SUCCESS if all count bytes were written, else
+     *         AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_stream_sendfile(
+        axutil_stream_t * stream,
+        const axutil_env_t * env,
+        FILE * file,
+        size_t count);
+
     /**
     * Skips over and discards n bytes of data from this input stream.
     * @param count number of bytes to be discarded
@@ -222,8 +298,10 @@ extern "C"
 
 
     /**
-     * Returns the length of the stream (applicable only to basic stream)
-     * @return Length of the buffer if its type is basic, else -1
+     * Returns the length of the stream (applicable only to basic and chain
+     * streams). For a chain stream this counts data appended to the chain
+     * directly as well.
+     * @return Length of the buffer if its type is basic or chain, else -1
      * (we can't define a length of a stream unless it is just a buffer)
      */
     AXIS2_EXTERN int AXIS2_CALL
@@ -238,6 +316,24 @@ extern "C"
     axutil_stream_create_basic(
         const axutil_env_t * env);
 
+    /** \brief Constructor for creating an in memory stream that keeps its
+      * data in a buffer chain, so that writes never move what has already
+      * been written. axutil_stream_get_buffer copies the data into one
+      * buffer; use axutil_stream_get_chain to get at it without copying.
+      * @return axutil_stream (in memory)
+      */
+    AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
+    axutil_stream_create_chain(
+        const axutil_env_t * env);
+
+    /**
+     * @return the buffer chain of a chain stream, NULL for other streams
+     */
+    AXIS2_EXTERN struct axutil_buffer_chain *AXIS2_CALL
+    axutil_stream_get_chain(
+        const axutil_stream_t * stream,
+        const axutil_env_t * env);
+
     /** \brief Constructor for creating a file stream
       * @param valid file pointer (opened file)
       * @return axutil_stream (file)
@@ -256,6 +352,51 @@ extern "C"
         const axutil_env_t * env,
         int socket);
 
+    /** \brief Constructor for creating a buffered socket stream. Reads are
+      * served from a read ahead buffer, which is refilled with one recv call
+      * when empty. Bytes read ahead are only available through this stream,
+      * so the socket must not be read through anything else.
+      * @param valid socket (opened socket)
+      * @param buffer_size size of the read ahead buffer, 0 for
+      *        AXIS2_STREAM_SOCKET_BUF_SIZE
+      * @return axutil_stream (socket)
+      */
+    AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
+    axutil_stream_create_buffered_socket(
+        const axutil_env_t * env,
+        int socket,
+        int buffer_size);
+
+    /**
+     * Reads a line, up to and including the next line feed, into the buffer
+     * and null terminates it. At most size - 1 bytes are read, so a line
+     * longer than that is returned in parts, of which only the last one ends
+     * with a line feed. Buffered socket streams scan their buffer for the end
+     * of the line, other streams are read one byte at a time.
+     * @param buffer buffer into which the line is read
+     * @param size size of the buffer
+     * @return number of bytes read, 0 if the stream ended and -1 on error
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_stream_read_line(
+        axutil_stream_t * stream,
+        const axutil_env_t * env,
+        axis2_char_t * buffer,
+        size_t size);
+
+    /**
+     * Gives access to the bytes a buffered socket stream has read ahead but
+     * not handed out yet, so that a reader can use them in place. Bytes used
+     * this way are then consumed with axutil_stream_skip.
+     * @param data set to the first buffered byte
+     * @return number of buffered bytes, 0 for other streams
+     */
+    AXIS2_EXTERN int AXIS2_CALL
+    axutil_stream_get_buffered(
+        const axutil_stream_t * stream,
+        const axutil_env_t * env,
+        const axis2_char_t ** data);
+
     /**
     *Free stream
     */
@@ -291,7 +432,7 @@ extern "C"
     AXIS2_EXTERN int AXIS2_CALL
         axutil_stream_set_buffer_end_null(
                 axutil_stream_t *stream,
-                axutil_env_t *env);
+                const axutil_env_t *env);
 
     AXIS2_EXTERN axis2_status_t AXIS2_CALL
     axutil_stream_flush_buffer(
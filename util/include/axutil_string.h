@@ -74,6 +74,21 @@ extern "C"
         const axutil_env_t * env,
         axis2_char_t ** str);
 
+    /**
+     * Creates a string struct holding a copy of the first len bytes of str,
+     * which need not be null terminated. The struct and the copy are
+     * allocated together.
+     * @param env pointer to environment struct
+     * @param str pointer to the bytes to copy
+     * @param len no: of bytes to copy
+     * @return a pointer to newly created string struct
+     */
+    AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+    axutil_string_create_len(
+        const axutil_env_t * env,
+        const axis2_char_t * str,
+        unsigned int len);
+
     /**
      * Frees string struct.
      * @param string pointer to string struct
@@ -130,6 +145,81 @@ extern "C"
         const struct axutil_string *string,
         const axutil_env_t * env);
 
+    /** Strings longer than this are not interned */
+#define AXUTIL_STRING_INTERN_MAX_LENGTH 256
+
+    /** Number of strings the intern table holds at most */
+#define AXUTIL_STRING_INTERN_MAX_COUNT 4096
+
+    /**
+     * Gets the interned string (atom) for the given string. Atoms are shared
+     * by all threads and live as long as the process, so two atoms are equal
+     * if and only if they are the same pointer. Freeing and cloning an atom
+     * costs nothing. The atoms are the well known SOAP and WS-Addressing
+     * names and namespace URIs, and the names given to
+     * axutil_string_intern_register; strings are never added by interning
+     * them, so names read from documents cannot fill the table.
+     * If the string is not an atom, a new string is created as
+     * axutil_string_create does. Either way the result is to be freed with
+     * axutil_string_free.
+     * @param env pointer to environment struct
+     * @param str string to intern
+     * @return pointer to the atom or to a new string struct
+     */
+    AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+    axutil_string_intern(
+        const axutil_env_t * env,
+        const axis2_char_t * str);
+
+    /**
+     * Gets the atom for the first len bytes of str, which need not be null
+     * terminated, as axutil_string_intern does. If there is no atom, a new
+     * string is created as axutil_string_create_len does.
+     * @param env pointer to environment struct
+     * @param str bytes to intern
+     * @param len no: of bytes
+     * @return pointer to the atom or to a new string struct
+     */
+    AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+    axutil_string_intern_len(
+        const axutil_env_t * env,
+        const axis2_char_t * str,
+        unsigned int len);
+
+    /**
+     * Gets the buffer of the atom for the given string. The buffer must not
+     * be modified or freed.
+     * @param str string to intern
+     * @return buffer of the atom, NULL if str is NULL or is not an atom
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axutil_string_intern_buffer(
+        const axis2_char_t * str);
+
+    /**
+     * Makes the given string an atom, if it is not one yet. Meant for names
+     * taken from the configuration, such as service and operation names,
+     * not for names read from messages.
+     * @param str string to add
+     * @return buffer of the atom, NULL if str is NULL, is too long or the
+     * table is full
+     */
+    AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+    axutil_string_intern_register(
+        const axis2_char_t * str);
+
+    /**
+     * Checks whether a string is an atom.
+     * @param string pointer to string struct
+     * @param env pointer to environment struct
+     * @return AXIS2_TRUE if the string was returned by axutil_string_intern
+     * from the intern table, else AXIS2_FALSE
+     */
+    AXIS2_EXTERN axis2_bool_t AXIS2_CALL
+    axutil_string_is_interned(
+        const struct axutil_string *string,
+        const axutil_env_t * env);
+
     /** @} */
 
     /**
@@ -172,6 +172,38 @@ extern "C"
     axutil_thread_key_free(
         axutil_threadkey_t * axis2_key);
 
+    /**
+     * Called with the value of a key when a thread that set it exits
+     */
+    typedef void(
+        AXIS2_CALL * axutil_threadkey_destructor_t)(
+            void *value);
+
+    /**
+     * Allocates and creates a new thread private key. Use
+     * axutil_thread_getspecific and axutil_thread_setspecific to access the
+     * value of the calling thread.
+     * @param allocator allocator to allocate the key with
+     * @param destructor function called with the non NULL value of a thread
+     *        when that thread exits, can be NULL
+     * @return the new key, NULL on failure
+     */
+    AXIS2_EXTERN axutil_threadkey_t *AXIS2_CALL
+    axutil_threadkey_create(
+        axutil_allocator_t * allocator,
+        axutil_threadkey_destructor_t destructor);
+
+    /**
+     * Deletes a key created with axutil_threadkey_create. Depending on the
+     * platform, values still set may or may not be passed to the destructor.
+     * @param key key to free
+     * @param allocator allocator the key was created with
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_threadkey_free(
+        axutil_threadkey_t * key,
+        axutil_allocator_t * allocator);
+
     /**
      * Initialize the control variable for axutil_thread_once.
      * @param control The control variable to initialize
@@ -205,6 +237,18 @@ extern "C"
     axutil_thread_detach(
         axutil_thread_t * thd);
 
+    /**
+     * Release the memory held by a thread handle without touching the
+     * thread itself. Use this for threads that have been detached and have
+     * already returned from their start function.
+     * @param thd The thread handle to free
+     * @param allocator allocator that was used to create the thread
+     */
+    AXIS2_EXTERN void AXIS2_CALL
+    axutil_thread_free(
+        axutil_thread_t * thd,
+        axutil_allocator_t * allocator);
+
 
     /*************************Thread locking functions*****************************/
 
@@ -264,6 +308,72 @@ extern "C"
     axutil_thread_mutex_destroy(
         axutil_thread_mutex_t * mutex);
 
+    /*************************Condition variable functions*************************/
+
+    /** Opaque condition variable structure */
+    typedef struct axutil_thread_cond_t axutil_thread_cond_t;
+
+    /**
+     * Create and initialize a condition variable that can be used to signal
+     * and schedule threads in a single process.
+     * @param allocator Memory allocator to allocate memory for the condition
+     * @return the newly created condition variable, NULL on error
+     */
+    AXIS2_EXTERN axutil_thread_cond_t *AXIS2_CALL
+    axutil_thread_cond_create(
+        axutil_allocator_t * allocator);
+
+    /**
+     * Put the active calling thread to sleep until signaled to wake up. The
+     * given mutex must be locked by the caller; it is released while waiting
+     * and re-acquired before returning. Spurious wakeups are possible, so the
+     * caller must re-check its predicate.
+     * @param cond the condition variable on which to block.
+     * @param mutex the mutex that must be locked upon entering this function.
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_cond_wait(
+        axutil_thread_cond_t * cond,
+        axutil_thread_mutex_t * mutex);
+
+    /**
+     * Same as axutil_thread_cond_wait, but gives up after the given number of
+     * milliseconds.
+     * @param cond the condition variable on which to block.
+     * @param mutex the mutex that must be locked upon entering this function.
+     * @param timeout_ms time to wait in milliseconds
+     * @return AXIS2_SUCCESS if signalled, AXIS2_FAILURE on timeout or error
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_cond_timedwait(
+        axutil_thread_cond_t * cond,
+        axutil_thread_mutex_t * mutex,
+        long timeout_ms);
+
+    /**
+     * Wake one thread blocked on the given condition variable.
+     * @param cond the condition variable to signal.
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_cond_signal(
+        axutil_thread_cond_t * cond);
+
+    /**
+     * Wake all threads blocked on the given condition variable.
+     * @param cond the condition variable to broadcast.
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_cond_broadcast(
+        axutil_thread_cond_t * cond);
+
+    /**
+     * Destroy the condition variable and free the memory associated with it.
+     * @param cond the condition variable to destroy.
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_cond_destroy(
+        axutil_thread_cond_t * cond);
+
     /** @} */
 #ifdef __cplusplus
 }
@@ -42,8 +42,66 @@ extern "C"
     typedef struct axutil_thread_pool axutil_thread_pool_t;
     struct axutil_env;
 
+    /** Default number of pre-spawned worker threads */
+#define AXUTIL_THREAD_POOL_DEFAULT_MAX_WORKERS 32
+
+    /** Default number of tasks that may wait for a free worker */
+#define AXUTIL_THREAD_POOL_DEFAULT_MAX_QUEUE 256
+
+    /**
+     * What axutil_thread_pool_get_thread does when the task queue is full
+     */
+    typedef enum axutil_thread_pool_overflow
+    {
+        /** run the task on a dedicated thread, as if there were no pool */
+        AXUTIL_THREAD_POOL_OVERFLOW_SPAWN = 0,
+
+        /** block the caller until a worker dequeues a task */
+        AXUTIL_THREAD_POOL_OVERFLOW_WAIT
+    } axutil_thread_pool_overflow_t;
+
+    /**
+     * Snapshot of the thread pool counters
+     */
+    typedef struct axutil_thread_pool_stats
+    {
+        /** worker threads started so far */
+        int workers;
+
+        /** workers currently waiting for a task */
+        int idle_workers;
+
+        /** tasks currently waiting in the queues */
+        int queue_depth;
+
+        /** largest queue depth seen */
+        int peak_queue_depth;
+
+        /** tasks accepted by the pool */
+        unsigned long submitted;
+
+        /** tasks that have returned */
+        unsigned long completed;
+
+        /** tasks a worker took from another worker's queue */
+        unsigned long stolen;
+
+        /** tasks run on a dedicated thread because the queue was full */
+        unsigned long overflowed;
+
+        /** sum of the time tasks spent queued, in milliseconds */
+        unsigned long total_wait_millis;
+
+        /** longest time a task spent queued, in milliseconds */
+        unsigned long max_wait_millis;
+    } axutil_thread_pool_stats_t;
+
     /**
-     * Retrives a thread from the thread pool
+     * Retrives a thread from the thread pool. The function is queued and run
+     * by one of the pool workers; the returned handle identifies the task and
+     * is passed to func as its thread argument. The handle must be released
+     * with axutil_thread_pool_thread_detach, axutil_thread_pool_join_thread
+     * or axutil_thread_pool_exit_thread.
      * @param func function to be executed in the new thread
      * @param data arguments to be passed to the function
      * @return pointer to a thread in ready state.
@@ -65,7 +123,9 @@ extern "C"
         axutil_thread_t * thd);
 
     /**
-     * Stop the execution of current thread
+     * Stop the execution of current thread. For pooled tasks this releases
+     * the task handle; the worker thread itself goes back to the pool once
+     * the task function returns.
      * @param thd thread to be stopped
      * @return status of the operation
      */
@@ -101,6 +161,46 @@ extern "C"
     axutil_thread_pool_init(
         axutil_allocator_t * allocator);
 
+    /**
+     * Creates a thread pool with the given limits. Worker threads are
+     * started on demand, up to max_workers, and stay alive until the pool
+     * is freed.
+     * @param allocator user defined allocator for the memory allocation.
+     * @param max_workers maximum number of worker threads. If 0, every call
+     * to axutil_thread_pool_get_thread creates a new thread.
+     * @param max_queue maximum number of tasks waiting for a worker
+     * @return initialized thread_pool. NULL on error.
+     */
+    AXIS2_EXTERN axutil_thread_pool_t *AXIS2_CALL
+    axutil_thread_pool_create(
+        axutil_allocator_t * allocator,
+        int max_workers,
+        int max_queue);
+
+    /**
+     * Sets what happens when a task is submitted while the queue is full.
+     * AXUTIL_THREAD_POOL_OVERFLOW_WAIT must not be used by code that submits
+     * tasks from inside pool workers, as all workers may end up waiting.
+     * @param pool thread pool
+     * @param overflow overflow policy
+     * @return status of the operation
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_pool_set_overflow_policy(
+        axutil_thread_pool_t * pool,
+        axutil_thread_pool_overflow_t overflow);
+
+    /**
+     * Copies the current counters of the pool.
+     * @param pool thread pool
+     * @param stats structure to be filled
+     * @return status of the operation
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_thread_pool_get_stats(
+        axutil_thread_pool_t * pool,
+        axutil_thread_pool_stats_t * stats);
+
     /**
      * This function can be used to initialize the environment in case of
      * spawning a new thread via a thread function
@@ -34,6 +34,20 @@ extern "C"
      * @{
      */
 
+    /** size of a buffer holding a uuid string, including the terminator */
+#define AXUTIL_UUID_STRING_SIZE 37
+
+    /**
+     * Layout of generated uuids. Version 4 uuids are random. Version 7 uuids
+     * start with the time in milliseconds, so that ids generated later sort
+     * after earlier ones, and are random for the rest.
+     */
+    typedef enum axutil_uuid_version
+    {
+        AXUTIL_UUID_VERSION_4 = 4,
+        AXUTIL_UUID_VERSION_7 = 7
+    } axutil_uuid_version_t;
+
     /**
      * generate a uuid
      * @return generated uuid as a string
@@ -42,6 +56,35 @@ extern "C"
     axutil_uuid_gen(
         const axutil_env_t * env);
 
+    /**
+     * Generates a uuid into a buffer supplied by the caller. Each thread
+     * draws from its own pool of random bytes, so this does not lock.
+     * @param buffer buffer of at least AXUTIL_UUID_STRING_SIZE characters
+     * @return buffer holding the uuid, NULL on failure
+     */
+    AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+    axutil_uuid_gen_into(
+        axis2_char_t * buffer);
+
+    /**
+     * Sets the version of the uuids generated from now on, by all threads.
+     * The default is AXUTIL_UUID_VERSION_4.
+     * @param env pointer to environment struct
+     * @param version AXUTIL_UUID_VERSION_4 or AXUTIL_UUID_VERSION_7
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+    axutil_uuid_gen_set_version(
+        const axutil_env_t * env,
+        axutil_uuid_version_t version);
+
+    /**
+     * @return the version of the uuids generated
+     */
+    AXIS2_EXTERN axutil_uuid_version_t AXIS2_CALL
+    axutil_uuid_gen_get_version(void
+    );
+
     /** @} */
 
 #ifdef __cplusplus
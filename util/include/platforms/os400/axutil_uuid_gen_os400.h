@@ -85,6 +85,15 @@ extern "C"
     axutil_platform_uuid_gen(
         char *s);
 
+    /**
+     * Fills a buffer with random bytes from the operating system
+     * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+     */
+    axis2_status_t AXIS2_CALL
+    axutil_platform_uuid_random(
+        unsigned char *buf,
+        int len);
+
     /** @} */
 
 #ifdef __cplusplus
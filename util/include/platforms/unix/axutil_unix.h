@@ -257,6 +257,7 @@ extern "C"
 #define AXIS2_CLOSE_SOCKET_ON_EXIT(sock)    fcntl(sock,F_SETFD, FD_CLOEXEC)
 #define axis2_socket_len_t                  socklen_t
 #define AXIS2_SHUT_WR                       SHUT_WR
+#define AXIS2_SHUT_RDWR                     SHUT_RDWR
 
     /** getopt function */
 #define AXIS2_GETOPT getopt
@@ -278,6 +279,8 @@ extern "C"
 
 #define axis2_gmtime_r gmtime_r
 
+#define axis2_localtime_r localtime_r
+
     /** @} */
 #ifdef __cplusplus
 }
@@ -41,4 +41,14 @@ struct axutil_thread_mutex_t
     axutil_allocator_t *allocator;
 };
 
+/* Condition variables are built on a counting semaphore so that they work
+ * with the event based unnested mutex above.
+ */
+struct axutil_thread_cond_t
+{
+    HANDLE semaphore;
+    long num_waiting;
+    axutil_allocator_t *allocator;
+};
+
 #endif                          /* AXIS2_THREAD_MUTEX_WINDOWS_H */
@@ -46,6 +46,9 @@ struct axutil_threadattr_t
 struct axutil_threadkey_t
 {
     DWORD key;
+
+    /* keys with a destructor are fiber local storage indexes */
+    int fls;
 };
 
 struct axutil_thread_once_t
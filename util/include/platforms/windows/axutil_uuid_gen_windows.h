@@ -36,6 +36,16 @@ extern "C"
     AXIS2_EXTERN axis2_char_t * AXIS2_CALL
      axutil_platform_uuid_gen(
         char *s);
+
+
+    /**
+      * Fill a buffer with random bytes from the operating system
+      * @return AXIS2_SUCCESS on success, else AXIS2_FAILURE
+      */
+    AXIS2_EXTERN axis2_status_t AXIS2_CALL
+     axutil_platform_uuid_random(
+        unsigned char *buf,
+        int len);
     
 
     /** @} */
@@ -74,6 +74,11 @@ extern "C"
                     const time_t * timep,
                     struct tm *result);
 
+    AXIS2_EXTERN struct tm *AXIS2_CALL
+    axis2_win_localtime(
+                    const time_t * timep,
+                    struct tm *result);
+
 
 	/* Get the last Error */
     AXIS2_EXTERN void AXIS2_CALL 
@@ -245,6 +250,7 @@ extern "C"
 #define AXIS2_CLOSE_SOCKET_ON_EXIT(sock)
 #define axis2_socket_len_t               int
 #define AXIS2_SHUT_WR                       SD_SEND
+#define AXIS2_SHUT_RDWR                     SD_BOTH
 
     /**
      * Platform specific environment variable access method
@@ -274,6 +280,8 @@ extern "C"
 
 #define axis2_gmtime_r axis2_win_gmtime
 
+#define axis2_localtime_r axis2_win_localtime
+
     /** @} */
 #ifdef __cplusplus
 }
@@ -20,6 +20,68 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Every block handed out by an arena is aligned to this boundary */
+#define AXUTIL_ARENA_ALIGN 16
+#define AXUTIL_ARENA_ROUND(size) (((size) + AXUTIL_ARENA_ALIGN - 1) & ~((size_t)AXUTIL_ARENA_ALIGN - 1))
+
+/* Requests larger than a quarter of the chunk size get a chunk of their own,
+ * so that a single big buffer does not waste the rest of the current chunk */
+#define AXUTIL_ARENA_LARGE(arena, size) ((size) > (arena)->chunk_size / 4)
+
+typedef struct axutil_arena_chunk
+{
+    struct axutil_arena_chunk *next;
+    size_t size;
+    size_t used;
+} axutil_arena_chunk_t;
+
+#define AXUTIL_ARENA_CHUNK_HEADER AXUTIL_ARENA_ROUND(sizeof(axutil_arena_chunk_t))
+#define AXUTIL_ARENA_CHUNK_DATA(chunk) ((char *)(chunk) + AXUTIL_ARENA_CHUNK_HEADER)
+
+typedef struct axutil_arena
+{
+    /* must be the first member, the arena is used through this */
+    axutil_allocator_t allocator;
+
+    /* chunks, the one being filled is always the first */
+    axutil_arena_chunk_t *chunks;
+    size_t chunk_size;
+
+    /* the chunks again, sorted by address, so that free can tell arena
+     * blocks from others with a binary search */
+    axutil_arena_chunk_t **index;
+    int index_count;
+    int index_size;
+
+    /* start of the most recent allocation, so that it can be undone */
+    char *last;
+
+    /* allocator of the blocks that are not carved out of the arena, the C
+     * library when NULL */
+    axutil_allocator_t *parent;
+} axutil_arena_t;
+
+static void *AXIS2_CALL
+axutil_allocator_arena_malloc_impl(
+    axutil_allocator_t * allocator,
+    size_t size);
+
+/* in allocator_slab.c */
+axis2_bool_t
+axutil_allocator_slab_owns(
+    void *ptr);
+
+void *AXIS2_CALL
+axutil_allocator_slab_realloc_impl(
+    axutil_allocator_t * allocator,
+    void *ptr,
+    size_t size);
+
+void AXIS2_CALL
+axutil_allocator_slab_free_impl(
+    axutil_allocator_t * allocator,
+    void *ptr);
+
 void *AXIS2_CALL
 axutil_allocator_malloc_impl(
     axutil_allocator_t * allocator,
@@ -36,9 +98,13 @@ axutil_allocator_realloc_impl(
     void *ptr,
     size_t size)
 {
-    if (allocator)
-        return realloc(ptr, size);
-    return NULL;
+    if (!allocator)
+        return NULL;
+
+    /* slab blocks reach here through clones and shared structures */
+    if (ptr && axutil_allocator_slab_owns(ptr))
+        return axutil_allocator_slab_realloc_impl(allocator, ptr, size);
+    return realloc(ptr, size);
 }
 
 void AXIS2_CALL
@@ -46,7 +112,12 @@ axutil_allocator_free_impl(
     axutil_allocator_t * allocator,
     void *ptr)
 {
-    if (allocator && ptr)
+    if (!allocator || !ptr)
+        return;
+
+    if (axutil_allocator_slab_owns(ptr))
+        axutil_allocator_slab_free_impl(allocator, ptr);
+    else
         free(ptr);
 }
 
@@ -77,6 +148,16 @@ axutil_allocator_clone(
 {
     axutil_allocator_t* clone = NULL;
 
+    /* An arena belongs to a single request and thread. Threads spawned while
+     * serving the request get a copy of the arena's parent, so that the
+     * parent's blocks they free go back where they came from, or a heap
+     * allocator of their own when there is no parent. */
+    if (allocator && allocator->malloc_fn == axutil_allocator_arena_malloc_impl)
+    {
+        axutil_arena_t *arena = (axutil_arena_t *)allocator;
+        return arena->parent ? axutil_allocator_clone(arena->parent) : axutil_allocator_init(NULL);
+    }
+
     if (allocator)
     {
         clone = (axutil_allocator_t *)malloc(sizeof(axutil_allocator_t));
@@ -131,3 +212,321 @@ axutil_allocator_switch_to_local_pool(
     }
 }
 
+/* Creates a chunk and adds it to the index, but not to the list of chunks */
+static axutil_arena_chunk_t *
+axutil_arena_chunk_create(
+    axutil_arena_t * arena,
+    size_t size)
+{
+    axutil_arena_chunk_t *chunk = NULL;
+    int low = 0;
+    int high = 0;
+
+    if (arena->index_count == arena->index_size)
+    {
+        int index_size = arena->index_size ? arena->index_size * 2 : 16;
+        axutil_arena_chunk_t **index = (axutil_arena_chunk_t **)realloc(arena->index,
+            sizeof(axutil_arena_chunk_t *) * index_size);
+        if (!index)
+        {
+            return NULL;
+        }
+        arena->index = index;
+        arena->index_size = index_size;
+    }
+
+    chunk = (axutil_arena_chunk_t *)malloc(AXUTIL_ARENA_CHUNK_HEADER + size);
+    if (!chunk)
+    {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+
+    high = arena->index_count;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (arena->index[mid] < chunk)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    memmove(arena->index + low + 1, arena->index + low,
+        sizeof(axutil_arena_chunk_t *) * (arena->index_count - low));
+    arena->index[low] = chunk;
+    arena->index_count++;
+    return chunk;
+}
+
+/* Finds the chunk the block is in, NULL if it is not an arena block. Only
+ * the chunks are looked at, never the memory the pointer points to. */
+static axutil_arena_chunk_t *
+axutil_arena_find_chunk(
+    axutil_arena_t * arena,
+    void *ptr)
+{
+    axutil_arena_chunk_t *chunk = NULL;
+    int low = 0;
+    int high = arena->index_count;
+
+    /* the last chunk that starts before the block */
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if ((char *)arena->index[mid] < (char *)ptr)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if (!low)
+    {
+        return NULL;
+    }
+    chunk = arena->index[low - 1];
+    if ((char *)ptr >= AXUTIL_ARENA_CHUNK_DATA(chunk)
+        && (char *)ptr < AXUTIL_ARENA_CHUNK_DATA(chunk) + chunk->size)
+    {
+        return chunk;
+    }
+    return NULL;
+}
+
+static void
+axutil_arena_release_chunks(
+    axutil_arena_t * arena,
+    axis2_bool_t keep_one)
+{
+    axutil_arena_chunk_t *chunk = arena->chunks;
+    axutil_arena_chunk_t *kept = NULL;
+
+    while (chunk)
+    {
+        axutil_arena_chunk_t *next = chunk->next;
+        if (keep_one && !kept && chunk->size == arena->chunk_size)
+        {
+            kept = chunk;
+            kept->next = NULL;
+            kept->used = 0;
+        }
+        else
+        {
+            free(chunk);
+        }
+        chunk = next;
+    }
+    arena->chunks = kept;
+    arena->last = NULL;
+    arena->index_count = 0;
+    if (kept)
+    {
+        arena->index[arena->index_count++] = kept;
+    }
+}
+
+static void *AXIS2_CALL
+axutil_allocator_arena_malloc_impl(
+    axutil_allocator_t * allocator,
+    size_t size)
+{
+    axutil_arena_t *arena = (axutil_arena_t *)allocator;
+    axutil_arena_chunk_t *chunk = NULL;
+    char *ptr = NULL;
+
+    /* switched to the global pool: the block must outlive the request */
+    if (allocator->current_pool != allocator->local_pool)
+    {
+        return arena->parent ? AXIS2_MALLOC(arena->parent, size) : malloc(size);
+    }
+
+    size = AXUTIL_ARENA_ROUND(size ? size : 1);
+    chunk = arena->chunks;
+
+    if (!chunk || chunk->size - chunk->used < size)
+    {
+        if (AXUTIL_ARENA_LARGE(arena, size))
+        {
+            chunk = axutil_arena_chunk_create(arena, size);
+            if (!chunk)
+            {
+                return NULL;
+            }
+            chunk->used = size;
+
+            /* keep filling the current chunk */
+            if (arena->chunks)
+            {
+                chunk->next = arena->chunks->next;
+                arena->chunks->next = chunk;
+            }
+            else
+            {
+                arena->chunks = chunk;
+            }
+            return AXUTIL_ARENA_CHUNK_DATA(chunk);
+        }
+
+        chunk = axutil_arena_chunk_create(arena, arena->chunk_size);
+        if (!chunk)
+        {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    ptr = AXUTIL_ARENA_CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+static void *AXIS2_CALL
+axutil_allocator_arena_realloc_impl(
+    axutil_allocator_t * allocator,
+    void *ptr,
+    size_t size)
+{
+    axutil_arena_t *arena = (axutil_arena_t *)allocator;
+    axutil_arena_chunk_t *chunk = NULL;
+    char *data = NULL;
+    size_t available = 0;
+    void *new_ptr = NULL;
+
+    if (!ptr)
+    {
+        return axutil_allocator_arena_malloc_impl(allocator, size);
+    }
+
+    chunk = axutil_arena_find_chunk(arena, ptr);
+    if (!chunk)
+    {
+        return arena->parent ? AXIS2_REALLOC(arena->parent, ptr, size)
+            : axutil_allocator_realloc_impl(allocator, ptr, size);
+    }
+
+    data = AXUTIL_ARENA_CHUNK_DATA(chunk);
+
+    /* the most recent block can grow in place */
+    if ((char *)ptr == arena->last && chunk == arena->chunks
+        && (size_t)((char *)ptr - data) + AXUTIL_ARENA_ROUND(size) <= chunk->size)
+    {
+        chunk->used = (size_t)((char *)ptr - data) + AXUTIL_ARENA_ROUND(size);
+        return ptr;
+    }
+
+    new_ptr = AXIS2_MALLOC(allocator, size);
+    if (!new_ptr)
+    {
+        return NULL;
+    }
+
+    /* The old size is not recorded. Copying up to the end of the used part
+     * of the chunk is always safe and includes the whole old block. */
+    available = chunk->used - (size_t)((char *)ptr - data);
+    memcpy(new_ptr, ptr, available < size ? available : size);
+    return new_ptr;
+}
+
+static void AXIS2_CALL
+axutil_allocator_arena_free_impl(
+    axutil_allocator_t * allocator,
+    void *ptr)
+{
+    axutil_arena_t *arena = (axutil_arena_t *)allocator;
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    /* axutil_allocator_free passes the allocator itself */
+    if (ptr == (void *)allocator)
+    {
+        axutil_arena_release_chunks(arena, AXIS2_FALSE);
+        free(arena->index);
+        free(arena);
+        return;
+    }
+
+    if ((char *)ptr == arena->last && arena->chunks)
+    {
+        arena->chunks->used = (size_t)((char *)ptr - AXUTIL_ARENA_CHUNK_DATA(arena->chunks));
+        arena->last = NULL;
+        return;
+    }
+
+    /* Blocks in the arena are released all at once. Anything else was
+     * allocated from the heap while switched to the global pool, or by the
+     * parent allocator. */
+    if (!axutil_arena_find_chunk(arena, ptr))
+    {
+        if (arena->parent)
+        {
+            AXIS2_FREE(arena->parent, ptr);
+        }
+        else
+        {
+            axutil_allocator_free_impl(allocator, ptr);
+        }
+    }
+}
+
+AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+axutil_allocator_arena_create(
+    size_t chunk_size)
+{
+    return axutil_allocator_arena_create_with_parent(chunk_size, NULL);
+}
+
+AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+axutil_allocator_arena_create_with_parent(
+    size_t chunk_size,
+    axutil_allocator_t * parent)
+{
+    axutil_arena_t *arena = NULL;
+
+    arena = (axutil_arena_t *)malloc(sizeof(axutil_arena_t));
+    if (!arena)
+    {
+        return NULL;
+    }
+    memset(arena, 0, sizeof(axutil_arena_t));
+
+    arena->chunk_size = AXUTIL_ARENA_ROUND(chunk_size ? chunk_size :
+        AXUTIL_ALLOCATOR_ARENA_DEFAULT_CHUNK_SIZE);
+    arena->parent = parent;
+    arena->allocator.malloc_fn = axutil_allocator_arena_malloc_impl;
+    arena->allocator.realloc = axutil_allocator_arena_realloc_impl;
+    arena->allocator.free_fn = axutil_allocator_arena_free_impl;
+    arena->allocator.global_pool_ref = 0;
+
+    /* The arena is the local pool. The global pool has no backing object;
+     * while it is current, memory comes from the heap. */
+    arena->allocator.local_pool = (void *)arena;
+    arena->allocator.global_pool = NULL;
+    arena->allocator.current_pool = arena->allocator.local_pool;
+
+    return &arena->allocator;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_allocator_arena_reset(
+    axutil_allocator_t * allocator)
+{
+    if (allocator && allocator->malloc_fn == axutil_allocator_arena_malloc_impl)
+    {
+        axutil_arena_release_chunks((axutil_arena_t *)allocator, AXIS2_TRUE);
+        allocator->global_pool_ref = 0;
+        allocator->current_pool = allocator->local_pool;
+    }
+}
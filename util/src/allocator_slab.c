@@ -0,0 +1,614 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <axutil_allocator.h>
+#include <axutil_thread.h>
+#include <axutil_utils.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ * Slab allocator for small objects.
+ *
+ * Blocks of up to AXUTIL_SLAB_MAX_SIZE bytes are rounded up to one of a few
+ * size classes. Each class carves its blocks out of 64KB slabs, so that
+ * objects of the same kind built one after another sit next to each other.
+ * Slabs are cut from large regions that are never handed back, which lets
+ * free tell slab blocks from heap blocks with a range check. Anything that
+ * is not a slab block is given to the C library, so blocks may be freed
+ * through this allocator no matter which allocator created them. This also
+ * covers the blocks taken from the C library when the regions run out.
+ *
+ * Every thread keeps a magazine of free blocks per class and allocates and
+ * frees from it without locking. Only when a magazine runs empty or full is
+ * half of it exchanged with the shared depot of the class, under the class
+ * mutex.
+ */
+
+#define AXUTIL_SLAB_SIZE (64 * 1024)
+#define AXUTIL_SLAB_HEADER 64
+#define AXUTIL_SLAB_REGION_SIZE (16 * 1024 * 1024)
+#define AXUTIL_SLAB_MAX_REGIONS 256
+#define AXUTIL_SLAB_MAX_SIZE 1024
+#define AXUTIL_SLAB_NUM_CLASSES AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES
+#define AXUTIL_SLAB_MAGAZINE_SIZE 32
+
+static const size_t axutil_slab_class_sizes[AXUTIL_SLAB_NUM_CLASSES] = { 16, 32, 48, 64, 80, 96,
+    112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+
+typedef struct axutil_slab_class
+{
+    axutil_thread_mutex_t *mutex;
+
+    /* free blocks, linked through their first word */
+    void *free_list;
+
+    /* unused tail of the slab being carved */
+    char *carve;
+    char *carve_end;
+
+    unsigned long slabs;
+
+    /* blocks handed out of the depot, including those cached by threads */
+    unsigned long in_use;
+    unsigned long peak;
+} axutil_slab_class_t;
+
+typedef struct axutil_slab_magazine
+{
+    int count;
+    void *blocks[AXUTIL_SLAB_MAGAZINE_SIZE];
+} axutil_slab_magazine_t;
+
+typedef struct axutil_slab_cache
+{
+    axutil_slab_magazine_t magazines[AXUTIL_SLAB_NUM_CLASSES];
+    struct axutil_slab_cache *next;
+    struct axutil_slab_cache *prev;
+} axutil_slab_cache_t;
+
+typedef struct axutil_slab_region
+{
+    char *start;
+    char *end;
+} axutil_slab_region_t;
+
+static struct
+{
+    axutil_allocator_t *allocator;
+    axutil_slab_region_t regions[AXUTIL_SLAB_MAX_REGIONS];
+    volatile int num_regions;
+    char *region_next;
+    axutil_thread_mutex_t *region_mutex;
+    axutil_slab_class_t classes[AXUTIL_SLAB_NUM_CLASSES];
+    unsigned char size_to_class[AXUTIL_SLAB_MAX_SIZE / 16 + 1];
+    axutil_slab_cache_t *caches;
+    axutil_thread_mutex_t *cache_mutex;
+    axis2_bool_t initialized;
+} axutil_slab;
+
+#ifdef WIN32
+static INIT_ONCE axutil_slab_once = INIT_ONCE_STATIC_INIT;
+static DWORD axutil_slab_key = FLS_OUT_OF_INDEXES;
+#define AXUTIL_SLAB_GET_CACHE() ((axutil_slab_cache_t *)FlsGetValue(axutil_slab_key))
+#define AXUTIL_SLAB_SET_CACHE(cache) FlsSetValue(axutil_slab_key, cache)
+#else
+static pthread_once_t axutil_slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t axutil_slab_key;
+#define AXUTIL_SLAB_GET_CACHE() ((axutil_slab_cache_t *)pthread_getspecific(axutil_slab_key))
+#define AXUTIL_SLAB_SET_CACHE(cache) pthread_setspecific(axutil_slab_key, cache)
+#endif
+
+static void *AXIS2_CALL
+axutil_allocator_slab_malloc_impl(
+    axutil_allocator_t * allocator,
+    size_t size);
+
+void AXIS2_CALL
+axutil_allocator_slab_free_impl(
+    axutil_allocator_t * allocator,
+    void *ptr);
+
+static int
+axutil_slab_find_class(
+    void *ptr)
+{
+    int i = 0;
+    int num_regions = axutil_slab.num_regions;
+
+    for (i = num_regions - 1; i >= 0; i--)
+    {
+        if ((char *)ptr >= axutil_slab.regions[i].start && (char *)ptr < axutil_slab.regions[i].end)
+        {
+            char *slab = axutil_slab.regions[i].start + (((char *)ptr
+                - axutil_slab.regions[i].start) & ~((size_t)AXUTIL_SLAB_SIZE - 1));
+            return *(int *)slab;
+        }
+    }
+    return -1;
+}
+
+/* Lets the heap allocator hand slab blocks back here instead of to the C
+ * library. Safe to call before any slab allocator is created. */
+axis2_bool_t
+axutil_allocator_slab_owns(
+    void *ptr)
+{
+    return axutil_slab_find_class(ptr) >= 0;
+}
+
+/* Returns a new slab for the given class. Slabs are never released. */
+static char *
+axutil_slab_new_slab(
+    int class_index)
+{
+    char *slab = NULL;
+    axutil_slab_region_t *region = NULL;
+
+    axutil_thread_mutex_lock(axutil_slab.region_mutex);
+    if (axutil_slab.num_regions > 0)
+    {
+        region = &axutil_slab.regions[axutil_slab.num_regions - 1];
+    }
+    if (!region || axutil_slab.region_next >= region->end)
+    {
+        char *base = NULL;
+        size_t offset = 0;
+
+        if (axutil_slab.num_regions == AXUTIL_SLAB_MAX_REGIONS)
+        {
+            axutil_thread_mutex_unlock(axutil_slab.region_mutex);
+            return NULL;
+        }
+
+        /* regions are leaked on purpose: blocks may be freed at any time */
+        base = (char *)malloc(AXUTIL_SLAB_REGION_SIZE + AXUTIL_SLAB_SIZE);
+        if (!base)
+        {
+            axutil_thread_mutex_unlock(axutil_slab.region_mutex);
+            return NULL;
+        }
+        offset = (size_t)base & (AXUTIL_SLAB_SIZE - 1);
+        region = &axutil_slab.regions[axutil_slab.num_regions];
+        region->start = offset ? base + (AXUTIL_SLAB_SIZE - offset) : base;
+        region->end = region->start + AXUTIL_SLAB_REGION_SIZE;
+        axutil_slab.region_next = region->start;
+
+        /* publish the region only once it is filled in */
+        axutil_slab.num_regions++;
+    }
+    slab = axutil_slab.region_next;
+    axutil_slab.region_next += AXUTIL_SLAB_SIZE;
+    axutil_thread_mutex_unlock(axutil_slab.region_mutex);
+
+    *(int *)slab = class_index;
+    return slab;
+}
+
+/* Moves up to count blocks from the depot into the given array. Must be
+ * called with the class mutex held. */
+static int
+axutil_slab_depot_get(
+    int class_index,
+    void **blocks,
+    int count)
+{
+    axutil_slab_class_t *slab_class = &axutil_slab.classes[class_index];
+    size_t size = axutil_slab_class_sizes[class_index];
+    int n = 0;
+
+    while (n < count && slab_class->free_list)
+    {
+        blocks[n] = slab_class->free_list;
+        slab_class->free_list = *(void **)slab_class->free_list;
+        n++;
+    }
+    while (n < count)
+    {
+        if (slab_class->carve + size > slab_class->carve_end)
+        {
+            char *slab = axutil_slab_new_slab(class_index);
+            if (!slab)
+            {
+                break;
+            }
+            slab_class->slabs++;
+            slab_class->carve = slab + AXUTIL_SLAB_HEADER;
+            slab_class->carve_end = slab + AXUTIL_SLAB_SIZE;
+        }
+        blocks[n++] = slab_class->carve;
+        slab_class->carve += size;
+    }
+
+    slab_class->in_use += n;
+    if (slab_class->in_use > slab_class->peak)
+    {
+        slab_class->peak = slab_class->in_use;
+    }
+    return n;
+}
+
+/* Must be called with the class mutex held */
+static void
+axutil_slab_depot_put(
+    int class_index,
+    void **blocks,
+    int count)
+{
+    axutil_slab_class_t *slab_class = &axutil_slab.classes[class_index];
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        *(void **)blocks[i] = slab_class->free_list;
+        slab_class->free_list = blocks[i];
+    }
+    slab_class->in_use -= count;
+}
+
+static void
+axutil_slab_cache_free(
+    void *data)
+{
+    axutil_slab_cache_t *cache = (axutil_slab_cache_t *)data;
+    int i = 0;
+
+    if (!cache)
+    {
+        return;
+    }
+    for (i = 0; i < AXUTIL_SLAB_NUM_CLASSES; i++)
+    {
+        axutil_slab_magazine_t *magazine = &cache->magazines[i];
+        if (magazine->count)
+        {
+            axutil_thread_mutex_lock(axutil_slab.classes[i].mutex);
+            axutil_slab_depot_put(i, magazine->blocks, magazine->count);
+            axutil_thread_mutex_unlock(axutil_slab.classes[i].mutex);
+            magazine->count = 0;
+        }
+    }
+
+    axutil_thread_mutex_lock(axutil_slab.cache_mutex);
+    if (cache->prev)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        axutil_slab.caches = cache->next;
+    }
+    if (cache->next)
+    {
+        cache->next->prev = cache->prev;
+    }
+    axutil_thread_mutex_unlock(axutil_slab.cache_mutex);
+    free(cache);
+}
+
+#ifdef WIN32
+static void WINAPI
+axutil_slab_fls_free(
+    void *data)
+{
+    axutil_slab_cache_free(data);
+}
+#endif
+
+static axutil_slab_cache_t *
+axutil_slab_get_cache(
+    void)
+{
+    axutil_slab_cache_t *cache = AXUTIL_SLAB_GET_CACHE();
+
+    if (cache)
+    {
+        return cache;
+    }
+
+    cache = (axutil_slab_cache_t *)malloc(sizeof(axutil_slab_cache_t));
+    if (!cache)
+    {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(axutil_slab_cache_t));
+    AXUTIL_SLAB_SET_CACHE(cache);
+
+    axutil_thread_mutex_lock(axutil_slab.cache_mutex);
+    cache->next = axutil_slab.caches;
+    if (axutil_slab.caches)
+    {
+        axutil_slab.caches->prev = cache;
+    }
+    axutil_slab.caches = cache;
+    axutil_thread_mutex_unlock(axutil_slab.cache_mutex);
+    return cache;
+}
+
+#ifdef WIN32
+static BOOL CALLBACK
+axutil_slab_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+axutil_slab_init(
+    void)
+#endif
+{
+    int i = 0;
+    int size = 0;
+
+    axutil_slab.allocator = axutil_allocator_init(NULL);
+    if (!axutil_slab.allocator)
+    {
+#ifdef WIN32
+        return FALSE;
+#else
+        return;
+#endif
+    }
+    axutil_slab.region_mutex = axutil_thread_mutex_create(axutil_slab.allocator,
+        AXIS2_THREAD_MUTEX_DEFAULT);
+    axutil_slab.cache_mutex = axutil_thread_mutex_create(axutil_slab.allocator,
+        AXIS2_THREAD_MUTEX_DEFAULT);
+    for (i = 0; i < AXUTIL_SLAB_NUM_CLASSES; i++)
+    {
+        axutil_slab.classes[i].mutex = axutil_thread_mutex_create(axutil_slab.allocator,
+            AXIS2_THREAD_MUTEX_DEFAULT);
+        if (!axutil_slab.classes[i].mutex)
+        {
+            break;
+        }
+    }
+    if (!axutil_slab.region_mutex || !axutil_slab.cache_mutex || i < AXUTIL_SLAB_NUM_CLASSES)
+    {
+        /* left uninitialized, so that axutil_allocator_slab_create fails */
+        while (--i >= 0)
+        {
+            axutil_thread_mutex_destroy(axutil_slab.classes[i].mutex);
+        }
+        if (axutil_slab.region_mutex)
+        {
+            axutil_thread_mutex_destroy(axutil_slab.region_mutex);
+        }
+        if (axutil_slab.cache_mutex)
+        {
+            axutil_thread_mutex_destroy(axutil_slab.cache_mutex);
+        }
+#ifdef WIN32
+        return FALSE;
+#else
+        return;
+#endif
+    }
+
+    for (size = 0, i = 0; size <= AXUTIL_SLAB_MAX_SIZE / 16; size++)
+    {
+        while (axutil_slab_class_sizes[i] < (size_t)size * 16)
+        {
+            i++;
+        }
+        axutil_slab.size_to_class[size] = (unsigned char)i;
+    }
+
+#ifdef WIN32
+    axutil_slab_key = FlsAlloc(axutil_slab_fls_free);
+#else
+    pthread_key_create(&axutil_slab_key, axutil_slab_cache_free);
+#endif
+    axutil_slab.initialized = AXIS2_TRUE;
+#ifdef WIN32
+    return TRUE;
+#endif
+}
+
+static void *AXIS2_CALL
+axutil_allocator_slab_malloc_impl(
+    axutil_allocator_t * allocator,
+    size_t size)
+{
+    axutil_slab_cache_t *cache = NULL;
+    axutil_slab_magazine_t *magazine = NULL;
+    void *block = NULL;
+    int class_index = 0;
+
+    if (size > AXUTIL_SLAB_MAX_SIZE)
+    {
+        return malloc(size);
+    }
+    class_index = axutil_slab.size_to_class[(size + 15) / 16];
+
+    cache = axutil_slab_get_cache();
+    if (!cache)
+    {
+        axutil_thread_mutex_lock(axutil_slab.classes[class_index].mutex);
+        axutil_slab_depot_get(class_index, &block, 1);
+        axutil_thread_mutex_unlock(axutil_slab.classes[class_index].mutex);
+        return block ? block : malloc(size);
+    }
+
+    magazine = &cache->magazines[class_index];
+    if (!magazine->count)
+    {
+        axutil_thread_mutex_lock(axutil_slab.classes[class_index].mutex);
+        magazine->count = axutil_slab_depot_get(class_index, magazine->blocks,
+            AXUTIL_SLAB_MAGAZINE_SIZE / 2);
+        axutil_thread_mutex_unlock(axutil_slab.classes[class_index].mutex);
+        if (!magazine->count)
+        {
+            /* no more regions; free knows the block is not a slab block */
+            return malloc(size);
+        }
+    }
+    return magazine->blocks[--magazine->count];
+}
+
+void AXIS2_CALL
+axutil_allocator_slab_free_impl(
+    axutil_allocator_t * allocator,
+    void *ptr)
+{
+    axutil_slab_cache_t *cache = NULL;
+    axutil_slab_magazine_t *magazine = NULL;
+    int class_index = 0;
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    class_index = axutil_slab_find_class(ptr);
+    if (class_index < 0)
+    {
+        /* heap block, or the allocator itself from axutil_allocator_free */
+        free(ptr);
+        return;
+    }
+
+    cache = axutil_slab_get_cache();
+    if (!cache)
+    {
+        axutil_thread_mutex_lock(axutil_slab.classes[class_index].mutex);
+        axutil_slab_depot_put(class_index, &ptr, 1);
+        axutil_thread_mutex_unlock(axutil_slab.classes[class_index].mutex);
+        return;
+    }
+
+    magazine = &cache->magazines[class_index];
+    if (magazine->count == AXUTIL_SLAB_MAGAZINE_SIZE)
+    {
+        magazine->count -= AXUTIL_SLAB_MAGAZINE_SIZE / 2;
+        axutil_thread_mutex_lock(axutil_slab.classes[class_index].mutex);
+        axutil_slab_depot_put(class_index, magazine->blocks + magazine->count,
+            AXUTIL_SLAB_MAGAZINE_SIZE / 2);
+        axutil_thread_mutex_unlock(axutil_slab.classes[class_index].mutex);
+    }
+    magazine->blocks[magazine->count++] = ptr;
+}
+
+void *AXIS2_CALL
+axutil_allocator_slab_realloc_impl(
+    axutil_allocator_t * allocator,
+    void *ptr,
+    size_t size)
+{
+    int class_index = 0;
+    void *new_ptr = NULL;
+
+    if (!ptr)
+    {
+        return axutil_allocator_slab_malloc_impl(allocator, size);
+    }
+
+    class_index = axutil_slab_find_class(ptr);
+    if (class_index < 0)
+    {
+        return realloc(ptr, size);
+    }
+    if (size <= axutil_slab_class_sizes[class_index])
+    {
+        return ptr;
+    }
+
+    new_ptr = axutil_allocator_slab_malloc_impl(allocator, size);
+    if (new_ptr)
+    {
+        memcpy(new_ptr, ptr, axutil_slab_class_sizes[class_index]);
+        axutil_allocator_slab_free_impl(allocator, ptr);
+    }
+    return new_ptr;
+}
+
+AXIS2_EXTERN axutil_allocator_t *AXIS2_CALL
+axutil_allocator_slab_create(
+    void)
+{
+    axutil_allocator_t *allocator = NULL;
+
+#ifdef WIN32
+    InitOnceExecuteOnce(&axutil_slab_once, axutil_slab_init, NULL, NULL);
+#else
+    pthread_once(&axutil_slab_once, axutil_slab_init);
+#endif
+    if (!axutil_slab.initialized)
+    {
+        return NULL;
+    }
+
+    allocator = (axutil_allocator_t *)malloc(sizeof(axutil_allocator_t));
+    if (allocator)
+    {
+        memset(allocator, 0, sizeof(axutil_allocator_t));
+        allocator->malloc_fn = axutil_allocator_slab_malloc_impl;
+        allocator->realloc = axutil_allocator_slab_realloc_impl;
+        allocator->free_fn = axutil_allocator_slab_free_impl;
+        allocator->global_pool_ref = 0;
+    }
+    return allocator;
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_allocator_slab_get_stats(
+    axutil_allocator_slab_stats_t * stats,
+    int size)
+{
+    axutil_slab_cache_t *cache = NULL;
+    int i = 0;
+
+    if (!axutil_slab.initialized || !stats)
+    {
+        return 0;
+    }
+    if (size > AXUTIL_SLAB_NUM_CLASSES)
+    {
+        size = AXUTIL_SLAB_NUM_CLASSES;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        axutil_slab_class_t *slab_class = &axutil_slab.classes[i];
+
+        axutil_thread_mutex_lock(slab_class->mutex);
+        stats[i].object_size = axutil_slab_class_sizes[i];
+        stats[i].live_objects = slab_class->in_use;
+        stats[i].peak_objects = slab_class->peak;
+        stats[i].slabs = slab_class->slabs;
+        stats[i].bytes = slab_class->slabs * AXUTIL_SLAB_SIZE;
+        axutil_thread_mutex_unlock(slab_class->mutex);
+    }
+
+    /* Blocks cached in magazines are free. The counts are read without
+     * locking, so they are only exact while the other threads are quiet. */
+    axutil_thread_mutex_lock(axutil_slab.cache_mutex);
+    for (cache = axutil_slab.caches; cache; cache = cache->next)
+    {
+        for (i = 0; i < size; i++)
+        {
+            stats[i].live_objects -= cache->magazines[i].count;
+        }
+    }
+    axutil_thread_mutex_unlock(axutil_slab.cache_mutex);
+
+    return size;
+}
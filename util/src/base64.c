@@ -23,6 +23,31 @@
  */
 
 #include <axutil_base64.h>
+#include <axutil_utils.h>
+#include <axutil_stream.h>
+#include <string.h>
+
+/*
+ * On x86 the bulk of the data is encoded and decoded with SSSE3 or AVX2,
+ * picked at run time, and the scalar code does the remainder. The decoder
+ * handles blocks that hold only base64 characters and leaves the first
+ * block holding anything else to the scalar code, which knows where the
+ * encoded data ends.
+ */
+#if !defined(__OS400__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AXUTIL_BASE64_SIMD
+#define AXUTIL_BASE64_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif !defined(__OS400__) && defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define AXUTIL_BASE64_SIMD
+#define AXUTIL_BASE64_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#define AXUTIL_BASE64_SCALAR 0
+#define AXUTIL_BASE64_SSSE3 1
+#define AXUTIL_BASE64_AVX2 2
 
 static const unsigned char pr2six[256] = {
 #ifndef __OS400__
@@ -90,6 +115,277 @@ static unsigned char os_toascii[256] = {
 
 #endif                          /* __OS400__ */
 
+#ifdef AXUTIL_BASE64_SIMD
+
+static int axutil_base64_isa = -1;
+
+static int
+axutil_base64_get_isa(
+    void)
+{
+    int isa = axutil_base64_isa;
+
+    if(isa >= 0)
+    {
+        return isa;
+    }
+
+    isa = AXUTIL_BASE64_SCALAR;
+#ifdef __GNUC__
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        isa = AXUTIL_BASE64_AVX2;
+    }
+    else if(__builtin_cpu_supports("ssse3"))
+    {
+        isa = AXUTIL_BASE64_SSSE3;
+    }
+#else
+    {
+        int info[4];
+        int max_leaf = 0;
+
+        __cpuid(info, 0);
+        max_leaf = info[0];
+        __cpuid(info, 1);
+        if(info[2] & (1 << 9))
+        {
+            isa = AXUTIL_BASE64_SSSE3;
+        }
+        /* AVX2 needs the OS to save the YMM registers too */
+        if(max_leaf >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28))
+            && (_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(info, 7, 0);
+            if(info[1] & (1 << 5))
+            {
+                isa = AXUTIL_BASE64_AVX2;
+            }
+        }
+    }
+#endif
+    axutil_base64_isa = isa;
+    return isa;
+}
+
+/* Stores the 12 decoded bytes at the start of the vector */
+AXUTIL_BASE64_TARGET("ssse3")
+static void
+axutil_base64_store12(
+    unsigned char *out,
+    __m128i bytes)
+{
+    int last = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+
+    _mm_storel_epi64((__m128i *)out, bytes);
+    memcpy(out + 8, &last, 4);
+}
+
+/*
+ * Encodes 12 bytes per step. The bytes are spread so that each 32 bit lane
+ * holds three of them, the four 6 bit groups are moved to bytes of their
+ * own with two multiplications, and every group is turned into its
+ * character by adding the offset of its range.
+ * Returns the number of bytes encoded.
+ */
+AXUTIL_BASE64_TARGET("ssse3")
+static int
+axutil_base64_encode_ssse3(
+    char *out,
+    const unsigned char *in,
+    int len)
+{
+    int i = 0;
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    /* 16 bytes are loaded for the 12 used */
+    for(i = 0; i + 16 <= len; i += 12)
+    {
+        __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i)), spread);
+        __m128i groups = _mm_or_si128(_mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(
+            0x0fc0fc00)), _mm_set1_epi32(0x04000040)), _mm_mullo_epi16(_mm_and_si128(bytes,
+            _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010)));
+
+        /* 0..25 map to 13, 26..51 to 0, 52..61 to 1..10, 62 to 11, 63 to 12 */
+        __m128i range = _mm_or_si128(_mm_subs_epu8(groups, _mm_set1_epi8(51)), _mm_and_si128(
+            _mm_cmpgt_epi8(_mm_set1_epi8(26), groups), _mm_set1_epi8(13)));
+
+        _mm_storeu_si128((__m128i *)out, _mm_add_epi8(groups, _mm_shuffle_epi8(offsets, range)));
+        out += 16;
+    }
+    return i;
+}
+
+AXUTIL_BASE64_TARGET("avx2")
+static int
+axutil_base64_encode_avx2(
+    char *out,
+    const unsigned char *in,
+    int len)
+{
+    int i = 0;
+    const __m256i spread = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+        4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8('a' - 26, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '+' - 62, '/' - 63, 'A', 0, 0));
+
+    /* 24 bytes per step, the second half is loaded from 12 bytes on */
+    for(i = 0; i + 28 <= len; i += 24)
+    {
+        __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(
+            (const __m128i *)(in + i))), _mm_loadu_si128((const __m128i *)(in + i + 12)), 1);
+        __m256i groups;
+        __m256i range;
+
+        bytes = _mm256_shuffle_epi8(bytes, spread);
+        groups = _mm256_or_si256(_mm256_mulhi_epu16(_mm256_and_si256(bytes, _mm256_set1_epi32(
+            0x0fc0fc00)), _mm256_set1_epi32(0x04000040)), _mm256_mullo_epi16(_mm256_and_si256(
+            bytes, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010)));
+        range = _mm256_or_si256(_mm256_subs_epu8(groups, _mm256_set1_epi8(51)), _mm256_and_si256(
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(26), groups), _mm256_set1_epi8(13)));
+
+        _mm256_storeu_si256((__m256i *)out, _mm256_add_epi8(groups, _mm256_shuffle_epi8(offsets,
+            range)));
+        out += 32;
+    }
+    return i;
+}
+
+/*
+ * Decodes 16 characters per step, as long as all of them are base64
+ * characters. Each character is classified by range, which gives both its
+ * validity and the offset to its 6 bit value, and the values are packed
+ * back into bytes with two multiply-adds.
+ * Returns the number of characters decoded, and the bytes written in
+ * decoded.
+ */
+AXUTIL_BASE64_TARGET("ssse3")
+static int
+axutil_base64_decode_ssse3(
+    unsigned char *out,
+    const unsigned char *in,
+    int len,
+    int *decoded)
+{
+    int i = 0;
+    unsigned char *p = out;
+    const __m128i order = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)),
+            _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(chars, _mm_set1_epi8('z' + 1)));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+        __m128i plus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+        __m128i slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+        __m128i values;
+
+        if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower),
+            _mm_or_si128(digit, plus)), slash)) != 0xFFFF)
+        {
+            break;
+        }
+
+        values = _mm_add_epi8(chars, _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(upper,
+            _mm_set1_epi8(-65)), _mm_and_si128(lower, _mm_set1_epi8(-71))), _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(4)), _mm_and_si128(plus, _mm_set1_epi8(19)))),
+            _mm_and_si128(slash, _mm_set1_epi8(16))));
+        values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+        axutil_base64_store12(p, _mm_shuffle_epi8(values, order));
+        p += 12;
+    }
+    *decoded = (int)(p - out);
+    return i;
+}
+
+AXUTIL_BASE64_TARGET("avx2")
+static int
+axutil_base64_decode_avx2(
+    unsigned char *out,
+    const unsigned char *in,
+    int len,
+    int *decoded)
+{
+    int i = 0;
+    unsigned char *p = out;
+    const __m256i order = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+        14, 13, 12, -1, -1, -1, -1));
+
+    for(i = 0; i + 32 <= len; i += 32)
+    {
+        __m256i chars = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i upper = _mm256_andnot_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('Z')),
+            _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('A' - 1)));
+        __m256i lower = _mm256_andnot_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('z')),
+            _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('a' - 1)));
+        __m256i digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('9')),
+            _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)));
+        __m256i plus = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+'));
+        __m256i slash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+        __m256i values;
+
+        if(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower),
+            _mm256_or_si256(digit, plus)), slash)) != -1)
+        {
+            break;
+        }
+
+        values = _mm256_add_epi8(chars, _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(
+            _mm256_and_si256(upper, _mm256_set1_epi8(-65)), _mm256_and_si256(lower,
+            _mm256_set1_epi8(-71))), _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(4)),
+            _mm256_and_si256(plus, _mm256_set1_epi8(19)))), _mm256_and_si256(slash,
+            _mm256_set1_epi8(16))));
+        values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+        values = _mm256_shuffle_epi8(values, order);
+        axutil_base64_store12(p, _mm256_castsi256_si128(values));
+        axutil_base64_store12(p + 12, _mm256_extracti128_si256(values, 1));
+        p += 24;
+    }
+    *decoded = (int)(p - out);
+    return i;
+}
+
+/* Returns the number of characters at the start of in, a multiple of 16,
+ * that are all base64 characters */
+AXUTIL_BASE64_TARGET("ssse3")
+static int
+axutil_base64_scan_ssse3(
+    const unsigned char *in,
+    int len)
+{
+    int i = 0;
+
+    for(i = 0; i + 16 <= len; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i valid = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(chars,
+            _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1))),
+            _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(chars,
+            _mm_set1_epi8('z' + 1)))), _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(chars,
+            _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1))),
+            _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')), _mm_cmpeq_epi8(chars,
+            _mm_set1_epi8('/')))));
+
+        if(_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+#endif                          /* AXUTIL_BASE64_SIMD */
+
 AXIS2_EXTERN int AXIS2_CALL
 axutil_base64_decode_len(
     const char *bufcoded)
@@ -104,6 +400,12 @@ axutil_base64_decode_len(
     }
 
     bufin = (const unsigned char *)bufcoded;
+#ifdef AXUTIL_BASE64_SIMD
+    if(axutil_base64_get_isa() != AXUTIL_BASE64_SCALAR)
+    {
+        bufin += axutil_base64_scan_ssse3(bufin, (int)strlen(bufcoded));
+    }
+#endif
     while(pr2six[*(bufin++)] <= 63)
         ;
 
@@ -143,12 +445,33 @@ axutil_base64_decode_binary(
     register const unsigned char *bufin;
     register unsigned char *bufout;
     register int nprbytes;
+    int simd_decoded = 0;
 
     if(!bufcoded)
     {
         return -1;
     }
 
+#ifdef AXUTIL_BASE64_SIMD
+    if(axutil_base64_get_isa() != AXUTIL_BASE64_SCALAR)
+    {
+        int len = (int)strlen(bufcoded);
+        int consumed = 0;
+        int decoded = 0;
+
+        if(axutil_base64_get_isa() == AXUTIL_BASE64_AVX2)
+        {
+            consumed = axutil_base64_decode_avx2(bufplain, (const unsigned char *)bufcoded, len,
+                &decoded);
+        }
+        consumed += axutil_base64_decode_ssse3(bufplain + decoded,
+            (const unsigned char *)bufcoded + consumed, len - consumed, &simd_decoded);
+        simd_decoded += decoded;
+        bufplain += simd_decoded;
+        bufcoded += consumed;
+    }
+#endif
+
     bufin = (const unsigned char *)bufcoded;
     while(pr2six[*(bufin++)] <= 63)
         ;
@@ -183,7 +506,7 @@ axutil_base64_decode_binary(
     }
 
     nbytesdecoded -= (4 - nprbytes) & 3;
-    return nbytesdecoded;
+    return nbytesdecoded + simd_decoded;
 }
 
 static const char basis_64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
@@ -251,11 +574,23 @@ axutil_base64_encode_binary(
     const unsigned char *string,
     int len)
 {
-    int i;
+    int i = 0;
     char *p;
 
     p = encoded;
-    for(i = 0; i < len - 2; i += 3)
+#ifdef AXUTIL_BASE64_SIMD
+    if(axutil_base64_get_isa() != AXUTIL_BASE64_SCALAR)
+    {
+        if(axutil_base64_get_isa() == AXUTIL_BASE64_AVX2)
+        {
+            i = axutil_base64_encode_avx2(p, string, len);
+            p += i / 3 * 4;
+        }
+        i += axutil_base64_encode_ssse3(p, string + i, len - i);
+        p = encoded + i / 3 * 4;
+    }
+#endif
+    for(; i < len - 2; i += 3)
     {
         *p++ = basis_64[(string[i] >> 2) & 0x3F];
         *p++ = basis_64[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
@@ -282,3 +617,171 @@ axutil_base64_encode_binary(
     return (int)(p - encoded);
     /* We are sure that the difference lies within the int range */
 }
+
+/* Bytes of input encoded at a time by the streaming encoder, a multiple
+ * of 3. The characters are handed over 4096 at a time. */
+#define AXUTIL_BASE64_ENCODER_CHUNK 3072
+
+struct axutil_base64_encoder
+{
+    axutil_base64_encoder_write_t write;
+    void *ctx;
+
+    /* bytes left over from the last update, less than 3 */
+    unsigned char pending[3];
+    int pending_len;
+
+    char out[AXUTIL_BASE64_ENCODER_CHUNK / 3 * 4 + 1];
+    int out_len;
+    axis2_status_t status;
+};
+
+static axis2_status_t AXIS2_CALL
+axutil_base64_encoder_write_stream(
+    void *ctx,
+    const axutil_env_t *env,
+    const axis2_char_t *text,
+    int len)
+{
+    return axutil_stream_write((axutil_stream_t *)ctx, env, text, len) == len ? AXIS2_SUCCESS
+        : AXIS2_FAILURE;
+}
+
+AXIS2_EXTERN axutil_base64_encoder_t *AXIS2_CALL
+axutil_base64_encoder_create(
+    const axutil_env_t *env,
+    axutil_base64_encoder_write_t write,
+    void *ctx)
+{
+    axutil_base64_encoder_t *encoder = NULL;
+
+    AXIS2_PARAM_CHECK(env->error, write, NULL);
+
+    encoder = AXIS2_MALLOC(env->allocator, sizeof(axutil_base64_encoder_t));
+    if(!encoder)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory");
+        return NULL;
+    }
+    encoder->write = write;
+    encoder->ctx = ctx;
+    encoder->pending_len = 0;
+    encoder->out_len = 0;
+    encoder->status = AXIS2_SUCCESS;
+    return encoder;
+}
+
+AXIS2_EXTERN axutil_base64_encoder_t *AXIS2_CALL
+axutil_base64_encoder_create_for_stream(
+    const axutil_env_t *env,
+    axutil_stream_t *stream)
+{
+    AXIS2_PARAM_CHECK(env->error, stream, NULL);
+    return axutil_base64_encoder_create(env, axutil_base64_encoder_write_stream, stream);
+}
+
+static void
+axutil_base64_encoder_flush(
+    axutil_base64_encoder_t *encoder,
+    const axutil_env_t *env)
+{
+    if(encoder->out_len && encoder->status == AXIS2_SUCCESS)
+    {
+        encoder->out[encoder->out_len] = '\0';
+        encoder->status = encoder->write(encoder->ctx, env, encoder->out, encoder->out_len);
+    }
+    encoder->out_len = 0;
+}
+
+/* Encodes whole groups of 3 bytes into the output buffer */
+static void
+axutil_base64_encoder_encode(
+    axutil_base64_encoder_t *encoder,
+    const axutil_env_t *env,
+    const unsigned char *data,
+    int len)
+{
+    while(len > 0)
+    {
+        int room = (int)sizeof(encoder->out) - 1 - encoder->out_len;
+        int n = len < room / 4 * 3 ? len : room / 4 * 3;
+
+        axutil_base64_encode_binary(encoder->out + encoder->out_len, data, n);
+        encoder->out_len += n / 3 * 4;
+        data += n;
+        len -= n;
+        if(encoder->out_len + 4 >= (int)sizeof(encoder->out))
+        {
+            axutil_base64_encoder_flush(encoder, env);
+        }
+    }
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_base64_encoder_update(
+    axutil_base64_encoder_t *encoder,
+    const axutil_env_t *env,
+    const unsigned char *data,
+    int len)
+{
+    int whole = 0;
+
+    AXIS2_PARAM_CHECK(env->error, encoder, AXIS2_FAILURE);
+    if(len <= 0)
+    {
+        return encoder->status;
+    }
+    AXIS2_PARAM_CHECK(env->error, data, AXIS2_FAILURE);
+
+    if(encoder->pending_len)
+    {
+        while(encoder->pending_len < 3 && len > 0)
+        {
+            encoder->pending[encoder->pending_len++] = *data++;
+            len--;
+        }
+        if(encoder->pending_len < 3)
+        {
+            return encoder->status;
+        }
+        axutil_base64_encoder_encode(encoder, env, encoder->pending, 3);
+        encoder->pending_len = 0;
+    }
+
+    whole = len - len % 3;
+    axutil_base64_encoder_encode(encoder, env, data, whole);
+    memcpy(encoder->pending, data + whole, len - whole);
+    encoder->pending_len = len - whole;
+    return encoder->status;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_base64_encoder_finish(
+    axutil_base64_encoder_t *encoder,
+    const axutil_env_t *env)
+{
+    AXIS2_PARAM_CHECK(env->error, encoder, AXIS2_FAILURE);
+
+    if(encoder->pending_len)
+    {
+        /* the buffer always has room for the last, padded, group */
+        axutil_base64_encode_binary(encoder->out + encoder->out_len, encoder->pending,
+            encoder->pending_len);
+        encoder->out_len += 4;
+        encoder->pending_len = 0;
+    }
+    axutil_base64_encoder_flush(encoder, env);
+    return encoder->status;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_base64_encoder_free(
+    axutil_base64_encoder_t *encoder,
+    const axutil_env_t *env)
+{
+    if(encoder)
+    {
+        AXIS2_FREE(env->allocator, encoder);
+    }
+}
@@ -0,0 +1,415 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <axutil_buffer_chain.h>
+#include <axutil_thread.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ * Chunks are allocated from an allocator of the pool's own rather than from
+ * the allocator of the env a chain is created with, as a chunk given back by
+ * one request is handed out again to another one, with a different env.
+ * Only chunks of the standard size go back to the pool; the larger ones made
+ * for contiguous appends that do not fit in a chunk are freed.
+ */
+
+/* segments written to a stream in one go by write_to_stream */
+#define AXUTIL_BUFFER_CHAIN_IOV_MAX 16
+
+typedef struct axutil_buffer_chunk axutil_buffer_chunk_t;
+
+struct axutil_buffer_chunk
+{
+    axutil_buffer_chunk_t *next;
+
+    /* data is in [start, end) */
+    size_t start;
+    size_t end;
+    size_t size;
+    axis2_char_t data[1];
+};
+
+struct axutil_buffer_chain
+{
+    axutil_buffer_chunk_t *head;
+    axutil_buffer_chunk_t *tail;
+    size_t len;
+};
+
+static struct
+{
+    axutil_buffer_chunk_t *free_list;
+    int free_count;
+    axutil_allocator_t *allocator;
+    axutil_thread_mutex_t *mutex;
+} axutil_buffer_chain_pool = { NULL, 0, NULL, NULL };
+
+#ifdef WIN32
+static INIT_ONCE axutil_buffer_chain_pool_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t axutil_buffer_chain_pool_once = PTHREAD_ONCE_INIT;
+#endif
+
+#ifdef WIN32
+static BOOL CALLBACK
+axutil_buffer_chain_pool_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+axutil_buffer_chain_pool_init(
+    void)
+#endif
+{
+    axutil_buffer_chain_pool.allocator = axutil_allocator_init(NULL);
+    if(axutil_buffer_chain_pool.allocator)
+    {
+        axutil_buffer_chain_pool.mutex = axutil_thread_mutex_create(
+            axutil_buffer_chain_pool.allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+    }
+#ifdef WIN32
+    return TRUE;
+#endif
+}
+
+static axutil_buffer_chunk_t *
+axutil_buffer_chain_get_chunk(
+    const axutil_env_t *env,
+    size_t size)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+
+#ifdef WIN32
+    InitOnceExecuteOnce(&axutil_buffer_chain_pool_once, axutil_buffer_chain_pool_init, NULL,
+        NULL);
+#else
+    pthread_once(&axutil_buffer_chain_pool_once, axutil_buffer_chain_pool_init);
+#endif
+    if(!axutil_buffer_chain_pool.mutex)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        return NULL;
+    }
+
+    if(size <= AXUTIL_BUFFER_CHAIN_CHUNK_SIZE)
+    {
+        size = AXUTIL_BUFFER_CHAIN_CHUNK_SIZE;
+        axutil_thread_mutex_lock(axutil_buffer_chain_pool.mutex);
+        chunk = axutil_buffer_chain_pool.free_list;
+        if(chunk)
+        {
+            axutil_buffer_chain_pool.free_list = chunk->next;
+            axutil_buffer_chain_pool.free_count--;
+        }
+        axutil_thread_mutex_unlock(axutil_buffer_chain_pool.mutex);
+    }
+
+    if(!chunk)
+    {
+        chunk = AXIS2_MALLOC(axutil_buffer_chain_pool.allocator, sizeof(axutil_buffer_chunk_t)
+            - 1 + size);
+        if(!chunk)
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory");
+            return NULL;
+        }
+    }
+    chunk->next = NULL;
+    chunk->start = 0;
+    chunk->end = 0;
+    chunk->size = size;
+    return chunk;
+}
+
+static void
+axutil_buffer_chain_put_chunk(
+    axutil_buffer_chunk_t *chunk)
+{
+    axutil_thread_mutex_lock(axutil_buffer_chain_pool.mutex);
+    if(chunk->size == AXUTIL_BUFFER_CHAIN_CHUNK_SIZE
+        && axutil_buffer_chain_pool.free_count < AXUTIL_BUFFER_CHAIN_POOL_SIZE)
+    {
+        chunk->next = axutil_buffer_chain_pool.free_list;
+        axutil_buffer_chain_pool.free_list = chunk;
+        axutil_buffer_chain_pool.free_count++;
+        chunk = NULL;
+    }
+    axutil_thread_mutex_unlock(axutil_buffer_chain_pool.mutex);
+    if(chunk)
+    {
+        AXIS2_FREE(axutil_buffer_chain_pool.allocator, chunk);
+    }
+}
+
+AXIS2_EXTERN axutil_buffer_chain_t *AXIS2_CALL
+axutil_buffer_chain_create(
+    const axutil_env_t *env)
+{
+    axutil_buffer_chain_t *chain = NULL;
+
+    chain = AXIS2_MALLOC(env->allocator, sizeof(axutil_buffer_chain_t));
+    if(!chain)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory");
+        return NULL;
+    }
+    chain->head = NULL;
+    chain->tail = NULL;
+    chain->len = 0;
+    return chain;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_buffer_chain_free(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env)
+{
+    axutil_buffer_chain_consume(chain, env, chain->len);
+    AXIS2_FREE(env->allocator, chain);
+}
+
+/* Adds a chunk with room for at least size bytes to the end of the chain */
+static axutil_buffer_chunk_t *
+axutil_buffer_chain_add_chunk(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    size_t size)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+
+    chunk = axutil_buffer_chain_get_chunk(env, size);
+    if(!chunk)
+    {
+        return NULL;
+    }
+    if(chain->tail)
+    {
+        chain->tail->next = chunk;
+    }
+    else
+    {
+        chain->head = chunk;
+    }
+    chain->tail = chunk;
+    return chunk;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_buffer_chain_append(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    const void *data,
+    size_t len)
+{
+    const axis2_char_t *src = (const axis2_char_t *)data;
+    axutil_buffer_chunk_t *chunk = NULL;
+    size_t room = 0;
+
+    while(len > 0)
+    {
+        chunk = chain->tail;
+        if(!chunk || chunk->end == chunk->size)
+        {
+            chunk = axutil_buffer_chain_add_chunk(chain, env, AXUTIL_BUFFER_CHAIN_CHUNK_SIZE);
+            if(!chunk)
+            {
+                return AXIS2_FAILURE;
+            }
+        }
+        room = chunk->size - chunk->end;
+        if(room > len)
+        {
+            room = len;
+        }
+        memcpy(chunk->data + chunk->end, src, room);
+        chunk->end += room;
+        chain->len += room;
+        src += room;
+        len -= room;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+axutil_buffer_chain_append_contiguous(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    const void *data,
+    size_t len)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+    axis2_char_t *dest = NULL;
+
+    chunk = chain->tail;
+    if(!chunk || chunk->size - chunk->end < len)
+    {
+        chunk = axutil_buffer_chain_add_chunk(chain, env, len);
+        if(!chunk)
+        {
+            return NULL;
+        }
+    }
+    dest = chunk->data + chunk->end;
+    memcpy(dest, data, len);
+    chunk->end += len;
+    chain->len += len;
+    return dest;
+}
+
+AXIS2_EXTERN size_t AXIS2_CALL
+axutil_buffer_chain_get_len(
+    const axutil_buffer_chain_t *chain,
+    const axutil_env_t *env)
+{
+    return chain->len;
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_buffer_chain_get_segments(
+    const axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    axutil_stream_iovec_t *iov,
+    int max)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+    int count = 0;
+
+    for(chunk = chain->head; chunk && count < max; chunk = chunk->next)
+    {
+        if(chunk->end > chunk->start)
+        {
+            iov[count].base = chunk->data + chunk->start;
+            iov[count].len = chunk->end - chunk->start;
+            count++;
+        }
+    }
+    return count;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_buffer_chain_consume(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    size_t count)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+    size_t avail = 0;
+
+    if(count > chain->len)
+    {
+        count = chain->len;
+    }
+    chain->len -= count;
+    while((chunk = chain->head) != NULL)
+    {
+        avail = chunk->end - chunk->start;
+        if(count < avail)
+        {
+            chunk->start += count;
+            break;
+        }
+        count -= avail;
+        chain->head = chunk->next;
+        if(!chain->head)
+        {
+            chain->tail = NULL;
+        }
+        axutil_buffer_chain_put_chunk(chunk);
+    }
+}
+
+AXIS2_EXTERN size_t AXIS2_CALL
+axutil_buffer_chain_read(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count)
+{
+    axis2_char_t *dest = (axis2_char_t *)buffer;
+    axutil_buffer_chunk_t *chunk = NULL;
+    size_t copied = 0;
+    size_t len = 0;
+
+    for(chunk = chain->head; chunk && copied < count; chunk = chunk->next)
+    {
+        len = chunk->end - chunk->start;
+        if(len > count - copied)
+        {
+            len = count - copied;
+        }
+        memcpy(dest + copied, chunk->data + chunk->start, len);
+        copied += len;
+    }
+    axutil_buffer_chain_consume(chain, env, copied);
+    return copied;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_buffer_chain_write_to_stream(
+    axutil_buffer_chain_t *chain,
+    const axutil_env_t *env,
+    axutil_stream_t *stream)
+{
+    axutil_stream_iovec_t iov[AXUTIL_BUFFER_CHAIN_IOV_MAX];
+    int iovcnt = 0;
+    int written = 0;
+
+    while(chain->len > 0)
+    {
+        iovcnt = axutil_buffer_chain_get_segments(chain, env, iov, AXUTIL_BUFFER_CHAIN_IOV_MAX);
+        written = axutil_stream_writev(stream, env, iov, iovcnt);
+        if(written <= 0)
+        {
+            return AXIS2_FAILURE;
+        }
+        axutil_buffer_chain_consume(chain, env, (size_t)written);
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+axutil_buffer_chain_flatten(
+    const axutil_buffer_chain_t *chain,
+    const axutil_env_t *env)
+{
+    axutil_buffer_chunk_t *chunk = NULL;
+    axis2_char_t *buffer = NULL;
+    size_t pos = 0;
+
+    buffer = AXIS2_MALLOC(env->allocator, chain->len + 1);
+    if(!buffer)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory");
+        return NULL;
+    }
+    for(chunk = chain->head; chunk; chunk = chunk->next)
+    {
+        memcpy(buffer + pos, chunk->data + chunk->start, chunk->end - chunk->start);
+        pos += chunk->end - chunk->start;
+    }
+    buffer[pos] = '\0';
+    return buffer;
+}
@@ -37,6 +37,203 @@ struct axutil_date_time
     int tz_min;
 };
 
+/*
+ * The lexical forms are read and written here directly instead of through
+ * sscanf and sprintf, which are slow and, for the fraction of a second,
+ * depend on the locale.
+ */
+
+/* Reads an unsigned number, of at least one digit */
+static axis2_bool_t
+axutil_date_time_parse_int(
+    const axis2_char_t **str,
+    int *value)
+{
+    const axis2_char_t *p = *str;
+    int result = 0;
+
+    if(*p < '0' || *p > '9')
+        return AXIS2_FALSE;
+    for(; *p >= '0' && *p <= '9'; p++)
+    {
+        if(result > 99999999)
+            return AXIS2_FALSE;
+        result = result * 10 + (*p - '0');
+    }
+    *value = result;
+    *str = p;
+    return AXIS2_TRUE;
+}
+
+/* Skips leading white space, which sscanf used to skip */
+static void
+axutil_date_time_skip_space(
+    const axis2_char_t **str)
+{
+    while(**str == ' ' || **str == '\t' || **str == '\n' || **str == '\r'
+        || **str == '\f' || **str == '\v')
+        (*str)++;
+}
+
+static axis2_bool_t
+axutil_date_time_parse_char(
+    const axis2_char_t **str,
+    axis2_char_t c)
+{
+    if(**str != c)
+        return AXIS2_FALSE;
+    (*str)++;
+    return AXIS2_TRUE;
+}
+
+/* [-]yyyy-mm-dd */
+static axis2_bool_t
+axutil_date_time_parse_date(
+    const axis2_char_t **str,
+    int *year,
+    int *mon,
+    int *day)
+{
+    axis2_bool_t is_year_neg = axutil_date_time_parse_char(str, '-');
+
+    if(!axutil_date_time_parse_int(str, year) || !axutil_date_time_parse_char(str, '-')
+        || !axutil_date_time_parse_int(str, mon) || !axutil_date_time_parse_char(str, '-')
+        || !axutil_date_time_parse_int(str, day))
+        return AXIS2_FALSE;
+    if(is_year_neg)
+        *year *= -1;
+    return AXIS2_TRUE;
+}
+
+/* hh:mm:ss[.s+] */
+static axis2_bool_t
+axutil_date_time_parse_clock(
+    const axis2_char_t **str,
+    int *hour,
+    int *min,
+    float *sec)
+{
+    int whole = 0;
+    double fraction = 0;
+    double scale = 1;
+
+    if(!axutil_date_time_parse_int(str, hour) || !axutil_date_time_parse_char(str, ':')
+        || !axutil_date_time_parse_int(str, min) || !axutil_date_time_parse_char(str, ':')
+        || !axutil_date_time_parse_int(str, &whole))
+        return AXIS2_FALSE;
+    if(axutil_date_time_parse_char(str, '.'))
+    {
+        for(; **str >= '0' && **str <= '9'; (*str)++)
+        {
+            /* digits beyond a nanosecond do not change a float */
+            if(scale < 1e9)
+            {
+                fraction = fraction * 10 + (**str - '0');
+                scale *= 10;
+            }
+        }
+    }
+    *sec = (float)(whole + fraction / scale);
+    return AXIS2_TRUE;
+}
+
+/* +hh:mm or -hh:mm */
+static axis2_bool_t
+axutil_date_time_parse_time_zone(
+    const axis2_char_t **str,
+    axis2_bool_t *tz_pos,
+    int *tz_hour,
+    int *tz_min)
+{
+    if(axutil_date_time_parse_char(str, '+'))
+        *tz_pos = AXIS2_TRUE;
+    else if(axutil_date_time_parse_char(str, '-'))
+        *tz_pos = AXIS2_FALSE;
+    else
+        return AXIS2_FALSE;
+    return axutil_date_time_parse_int(str, tz_hour) && axutil_date_time_parse_char(str, ':')
+        && axutil_date_time_parse_int(str, tz_min);
+}
+
+/* Writes value in decimal, zero padded to width digits */
+static axis2_char_t *
+axutil_date_time_put_int(
+    axis2_char_t *p,
+    int value,
+    int width)
+{
+    axis2_char_t digits[16];
+    int len = 0;
+    unsigned int u = (unsigned int)value;
+
+    if(value < 0)
+    {
+        *p++ = '-';
+        u = 0u - u;
+    }
+    do
+    {
+        digits[len++] = (axis2_char_t)('0' + u % 10);
+        u /= 10;
+    }
+    while(u);
+    while(width-- > len)
+        *p++ = '0';
+    while(len)
+        *p++ = digits[--len];
+    return p;
+}
+
+/* yyyy-mm-dd */
+static axis2_char_t *
+axutil_date_time_put_date(
+    axis2_char_t *p,
+    const axutil_date_time_t *date_time)
+{
+    p = axutil_date_time_put_int(p, date_time->year + 1900, 1);
+    *p++ = '-';
+    p = axutil_date_time_put_int(p, date_time->mon + 1, 2);
+    *p++ = '-';
+    return axutil_date_time_put_int(p, date_time->day, 2);
+}
+
+/* hh:mm:ss.sss, or hh:mm:ss rounded to the second */
+static axis2_char_t *
+axutil_date_time_put_clock(
+    axis2_char_t *p,
+    const axutil_date_time_t *date_time,
+    axis2_bool_t with_msec)
+{
+    int msec = (int)((double)date_time->sec * 1000 + 0.5);
+
+    p = axutil_date_time_put_int(p, date_time->hour, 2);
+    *p++ = ':';
+    p = axutil_date_time_put_int(p, date_time->min, 2);
+    *p++ = ':';
+    if(!with_msec)
+        return axutil_date_time_put_int(p, (int)((double)date_time->sec + 0.5), 2);
+    p = axutil_date_time_put_int(p, msec / 1000, 2);
+    *p++ = '.';
+    return axutil_date_time_put_int(p, msec % 1000, 3);
+}
+
+/* Z, or +hh:mm / -hh:mm */
+static axis2_char_t *
+axutil_date_time_put_time_zone(
+    axis2_char_t *p,
+    const axutil_date_time_t *date_time)
+{
+    if(!date_time->tz_hour && !date_time->tz_min)
+    {
+        *p++ = 'Z';
+        return p;
+    }
+    *p++ = date_time->tz_pos ? '+' : '-';
+    p = axutil_date_time_put_int(p, date_time->tz_hour, 2);
+    *p++ = ':';
+    return axutil_date_time_put_int(p, date_time->tz_min, 2);
+}
+
 AXIS2_EXTERN axutil_date_time_t *AXIS2_CALL
 axutil_date_time_create_with_offset(
     const axutil_env_t *env,
@@ -44,6 +241,7 @@ axutil_date_time_create_with_offset(
 {
     axutil_date_time_t *date_time = NULL;
     time_t t;
+    struct tm result;
     struct tm *utc_time = NULL;
     AXIS2_ENV_CHECK(env, NULL);
 
@@ -58,7 +256,12 @@ axutil_date_time_create_with_offset(
 
     t = time(NULL) + offset;
 
-    utc_time = gmtime(&t);
+    utc_time = axis2_gmtime_r(&t, &result);
+    if(!utc_time)
+    {
+        AXIS2_FREE(env->allocator, date_time);
+        return NULL;
+    }
 
     date_time->year = utc_time->tm_year;
     date_time->mon = utc_time->tm_mon;
@@ -106,7 +309,13 @@ axutil_date_time_deserialize_time(
     float sec;
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
 
-    sscanf(time_str, "%d:%d:%fZ", &hour, &min, &sec);
+    if (!time_str)
+        return AXIS2_FAILURE;
+
+    axutil_date_time_skip_space(&time_str);
+    if (!axutil_date_time_parse_clock(&time_str, &hour, &min, &sec))
+        return AXIS2_FAILURE;
+
     if (hour < 0 || hour > 23)
         return AXIS2_FAILURE;
 
@@ -138,15 +347,13 @@ axutil_date_time_deserialize_time_with_time_zone(
 
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
 
-    if (strchr(time_str, 'Z'))
+    if (!time_str)
         return AXIS2_FAILURE;
-    else if (!strchr(time_str, '+'))
-        tz_pos = AXIS2_FALSE;
 
-    if (tz_pos)
-        sscanf(time_str, "%d:%d:%f+%d:%d", &hour, &min, &sec, &tz_hour, &tz_min);
-    else
-        sscanf(time_str, "%d:%d:%f-%d:%d", &hour, &min, &sec, &tz_hour, &tz_min);
+    axutil_date_time_skip_space(&time_str);
+    if (!axutil_date_time_parse_clock(&time_str, &hour, &min, &sec)
+        || !axutil_date_time_parse_time_zone(&time_str, &tz_pos, &tz_hour, &tz_min))
+        return AXIS2_FAILURE;
 
     if (hour < 0 || hour > 23)
         return AXIS2_FAILURE;
@@ -184,21 +391,20 @@ axutil_date_time_deserialize_date(
     int year;
     int mon;
     int day;
-    int is_year_neg = 0;
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
 
-    if (!date_str || *date_str == '+')
+    if (!date_str)
         return AXIS2_FAILURE;
 
-	if (strchr(date_str,'T'))
-		return AXIS2_FAILURE;
+    axutil_date_time_skip_space(&date_str);
+    if (*date_str == '+')
+        return AXIS2_FAILURE;
 
-    if (*date_str == '-')
-        is_year_neg++;
+    if (strchr(date_str,'T'))
+        return AXIS2_FAILURE;
 
-    sscanf(date_str + is_year_neg, "%d-%d-%d", &year, &mon, &day);
-    if (is_year_neg)
-        year *= -1;
+    if (!axutil_date_time_parse_date(&date_str, &year, &mon, &day))
+        return AXIS2_FAILURE;
 
     if (mon < 1 || mon > 12)
         return AXIS2_FAILURE;
@@ -236,19 +442,19 @@ axutil_date_time_deserialize_date_time(
     int hour;
     int min;
     float sec;
-    int is_year_neg = 0;
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
 
-    if (!date_time_str || *date_time_str == '+')
+    if (!date_time_str)
         return AXIS2_FAILURE;
 
-    if (*date_time_str == '-')
-        is_year_neg++;
-
-    sscanf(date_time_str + is_year_neg, "%d-%d-%dT%d:%d:%fZ", &year, &mon, &day, &hour, &min, &sec);
+    axutil_date_time_skip_space(&date_time_str);
+    if (*date_time_str == '+')
+        return AXIS2_FAILURE;
 
-    if (is_year_neg)
-        year *= -1;
+    if (!axutil_date_time_parse_date(&date_time_str, &year, &mon, &day)
+        || !axutil_date_time_parse_char(&date_time_str, 'T')
+        || !axutil_date_time_parse_clock(&date_time_str, &hour, &min, &sec))
+        return AXIS2_FAILURE;
 
     if (mon < 1 || mon > 12)
         return AXIS2_FAILURE;
@@ -300,37 +506,22 @@ axutil_date_time_deserialize_date_time_with_time_zone(
     float sec;
     int tz_hour;
     int tz_min;
-    int is_year_neg = 0;
     axis2_bool_t tz_pos = AXIS2_FALSE;
 
     AXIS2_ENV_CHECK(env, AXIS2_FAILURE);
 
-    if (!date_time_str || *date_time_str == '+')
+    if (!date_time_str)
         return AXIS2_FAILURE;
 
-    if (*date_time_str == '-')
-        is_year_neg++;
-
-    if (strchr(date_time_str, 'Z'))
+    axutil_date_time_skip_space(&date_time_str);
+    if (*date_time_str == '+')
         return AXIS2_FAILURE;
-    else if(strchr(date_time_str, '+'))
-        tz_pos = AXIS2_TRUE;
 
-    if (tz_pos)
-    {
-        sscanf(date_time_str + is_year_neg,
-                "%d-%d-%dT%d:%d:%f+%d:%d",
-                &year, &mon, &day, &hour, &min, &sec, &tz_hour, &tz_min);
-    }
-    else
-    {
-        sscanf(date_time_str + is_year_neg,
-                "%d-%d-%dT%d:%d:%f-%d:%d",
-                &year, &mon, &day, &hour, &min, &sec, &tz_hour, &tz_min);
-    }
-
-    if (is_year_neg)
-        year *= -1;
+    if (!axutil_date_time_parse_date(&date_time_str, &year, &mon, &day)
+        || !axutil_date_time_parse_char(&date_time_str, 'T')
+        || !axutil_date_time_parse_clock(&date_time_str, &hour, &min, &sec)
+        || !axutil_date_time_parse_time_zone(&date_time_str, &tz_pos, &tz_hour, &tz_min))
+        return AXIS2_FAILURE;
 
     if (mon < 1 || mon > 12)
         return AXIS2_FAILURE;
@@ -535,16 +726,12 @@ axutil_date_time_serialize_time(
     AXIS2_ENV_CHECK(env, NULL);
 
     time_str = (axis2_char_t *)AXIS2_MALLOC(env->allocator, sizeof(axis2_char_t) * 32);
-    sprintf(time_str, "%02d:%02d:%06.3fZ", date_time->hour, date_time->min, date_time->sec);
-
-    /* 
-     * Ensure that milliseconds are separated with dot, 
-     * no matter which separator is specified in locale.
-     * Dot is required by http://www.w3.org/TR/xmlschema-2/#dateTime 
-     */
-    p = axutil_strchr(time_str, ',');
-    if (p) *p = '.';
+    if (!time_str)
+        return NULL;
 
+    p = axutil_date_time_put_clock(time_str, date_time, AXIS2_TRUE);
+    *p++ = 'Z';
+    *p = '\0';
     return time_str;
 }
 
@@ -557,24 +744,13 @@ axutil_date_time_serialize_time_with_time_zone(
 
     AXIS2_ENV_CHECK(env, NULL);
 
-    if (!date_time->tz_hour && !date_time->tz_min)
-    {
-        return axutil_date_time_serialize_time(date_time, env);
-    }
-
     time_str = (axis2_char_t *)AXIS2_MALLOC(env->allocator, sizeof(axis2_char_t) * 37);
-    sprintf(time_str, "%02d:%02d:%06.3f%c%02d:%02d",
-            date_time->hour, date_time->min,
-            date_time->sec, date_time->tz_pos ? '+' : '-', date_time->tz_hour, date_time->tz_min);
-
-    /* 
-     * Ensure that milliseconds are separated with dot, 
-     * no matter which separator is specified in locale.
-     * Dot is required by http://www.w3.org/TR/xmlschema-2/#dateTime 
-     */
-    p = axutil_strchr(time_str, ',');
-    if (p) *p = '.';
+    if (!time_str)
+        return NULL;
 
+    p = axutil_date_time_put_clock(time_str, date_time, AXIS2_TRUE);
+    p = axutil_date_time_put_time_zone(p, date_time);
+    *p = '\0';
     return time_str;
 }
 
@@ -583,14 +759,16 @@ axutil_date_time_serialize_date(
     axutil_date_time_t *date_time,
     const axutil_env_t *env)
 {
-    axis2_char_t *date_str = NULL;
+    axis2_char_t *date_str = NULL, *p = NULL;
 
     AXIS2_ENV_CHECK(env, NULL);
 
     date_str = (axis2_char_t *)AXIS2_MALLOC(env->allocator, sizeof(axis2_char_t) * 32);
+    if (!date_str)
+        return NULL;
 
-    sprintf(date_str, "%d-%02d-%02d",
-            date_time->year + 1900, date_time->mon + 1, date_time->day);
+    p = axutil_date_time_put_date(date_str, date_time);
+    *p = '\0';
     return date_str;
 }
 
@@ -604,19 +782,14 @@ axutil_date_time_serialize_date_time(
     AXIS2_ENV_CHECK(env, NULL);
 
     date_time_str = AXIS2_MALLOC(env->allocator, sizeof(char) * 32);
-    sprintf(date_time_str,
-            "%d-%02d-%02dT%02d:%02d:%06.3fZ",
-            date_time->year + 1900, date_time->mon + 1, date_time->day,
-            date_time->hour, date_time->min, date_time->sec);
-    
-    /* 
-     * Ensure that milliseconds are separated with dot, 
-     * no matter which separator is specified in locale.
-     * Dot is required by http://www.w3.org/TR/xmlschema-2/#dateTime 
-     */
-    p = axutil_strchr(date_time_str, ',');
-    if (p) *p = '.';
+    if (!date_time_str)
+        return NULL;
 
+    p = axutil_date_time_put_date(date_time_str, date_time);
+    *p++ = 'T';
+    p = axutil_date_time_put_clock(p, date_time, AXIS2_TRUE);
+    *p++ = 'Z';
+    *p = '\0';
     return date_time_str;
 }
 
@@ -625,15 +798,19 @@ axutil_date_time_serialize_date_time_without_millisecond(
     axutil_date_time_t *date_time,
     const axutil_env_t *env)
 {
-    axis2_char_t *date_time_str = NULL;
+    axis2_char_t *date_time_str = NULL, *p = NULL;
 
     AXIS2_ENV_CHECK(env, NULL);
 
     date_time_str = AXIS2_MALLOC(env->allocator, sizeof(char) * 32);
-    sprintf(date_time_str,
-            "%d-%02d-%02dT%02d:%02d:%02.0fZ",
-            date_time->year + 1900, date_time->mon + 1, date_time->day,
-            date_time->hour, date_time->min, date_time->sec);
+    if (!date_time_str)
+        return NULL;
+
+    p = axutil_date_time_put_date(date_time_str, date_time);
+    *p++ = 'T';
+    p = axutil_date_time_put_clock(p, date_time, AXIS2_FALSE);
+    *p++ = 'Z';
+    *p = '\0';
     return date_time_str;
 }
 
@@ -646,26 +823,15 @@ axutil_date_time_serialize_date_time_with_time_zone(
 
     AXIS2_ENV_CHECK(env, NULL);
 
-    if (!date_time->tz_hour && !date_time->tz_min)
-    {
-        return axutil_date_time_serialize_date_time(date_time, env);
-    }
-
     date_time_str = AXIS2_MALLOC(env->allocator, sizeof(char) * 37);
-    sprintf(date_time_str,
-            "%d-%02d-%02dT%02d:%02d:%06.3f%c%02d:%02d",
-            date_time->year + 1900, date_time->mon + 1, date_time->day,
-            date_time->hour, date_time->min, date_time->sec,
-            date_time->tz_pos ? '+' : '-', date_time->tz_hour, date_time->tz_min);
-
-    /* 
-     * Ensure that milliseconds are separated with dot, 
-     * no matter which separator is specified in locale.
-     * Dot is required by http://www.w3.org/TR/xmlschema-2/#dateTime 
-     */
-    p = axutil_strchr(date_time_str, ',');
-    if (p) *p = '.';
+    if (!date_time_str)
+        return NULL;
 
+    p = axutil_date_time_put_date(date_time_str, date_time);
+    *p++ = 'T';
+    p = axutil_date_time_put_clock(p, date_time, AXIS2_TRUE);
+    p = axutil_date_time_put_time_zone(p, date_time);
+    *p = '\0';
     return date_time_str;
 }
 
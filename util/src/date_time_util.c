@@ -15,8 +15,220 @@
  * limitations under the License.
  */
 
+#include <string.h>
+#include <time.h>
 #include <axutil_date_time_util.h>
 
+/*
+ * Timestamps of the current second are formatted by the first thread that
+ * notices the second has changed, into the next slot of a ring, and then
+ * published by moving the current index. Readers only copy out of the
+ * published slot, so they never lock. A slot is not written again until
+ * the ring has gone round, which takes AXUTIL_TIME_SLOTS seconds. A thread
+ * that finds another one formatting the new second formats its own copy.
+ */
+
+#define AXUTIL_TIME_SLOTS 8
+
+#if defined(WIN32)
+#define AXUTIL_TIME_BARRIER() MemoryBarrier()
+#define AXUTIL_TIME_TRYLOCK(lock) (InterlockedCompareExchange(&(lock), 1, 0) == 0)
+#elif defined(__GNUC__)
+#define AXUTIL_TIME_BARRIER() __sync_synchronize()
+#define AXUTIL_TIME_TRYLOCK(lock) __sync_bool_compare_and_swap(&(lock), 0, 1)
+#else
+#define AXUTIL_TIME_BARRIER()
+#define AXUTIL_TIME_TRYLOCK(lock) 0
+#endif
+
+typedef struct axutil_time_slot
+{
+    time_t time;
+    axis2_char_t http_date[AXUTIL_HTTP_DATE_SIZE];
+    axis2_char_t log_time[AXUTIL_LOG_TIME_SIZE];
+    axis2_char_t date_time[AXUTIL_DATE_TIME_STR_SIZE];
+} axutil_time_slot_t;
+
+static axutil_time_slot_t axutil_time_slots[AXUTIL_TIME_SLOTS];
+static volatile unsigned int axutil_time_current = 0;
+static volatile long axutil_time_lock = 0;
+
+static const axis2_char_t axutil_time_days[7][4] =
+    { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+static const axis2_char_t axutil_time_months[12][4] =
+    { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+static axis2_char_t *
+axutil_time_put_2digits(
+    axis2_char_t *p,
+    int value)
+{
+    p[0] = (axis2_char_t)('0' + value / 10);
+    p[1] = (axis2_char_t)('0' + value % 10);
+    return p + 2;
+}
+
+static axis2_char_t *
+axutil_time_put_year(
+    axis2_char_t *p,
+    int year)
+{
+    p = axutil_time_put_2digits(p, year / 100 % 100);
+    return axutil_time_put_2digits(p, year % 100);
+}
+
+/* hh:mm:ss */
+static axis2_char_t *
+axutil_time_put_clock(
+    axis2_char_t *p,
+    const struct tm *tm)
+{
+    p = axutil_time_put_2digits(p, tm->tm_hour);
+    *p++ = ':';
+    p = axutil_time_put_2digits(p, tm->tm_min);
+    *p++ = ':';
+    return axutil_time_put_2digits(p, tm->tm_sec);
+}
+
+static void
+axutil_time_format(
+    axutil_time_slot_t *slot,
+    time_t now)
+{
+    struct tm result;
+    struct tm *tm = NULL;
+    axis2_char_t *p = NULL;
+
+    slot->http_date[0] = '\0';
+    slot->date_time[0] = '\0';
+    slot->log_time[0] = '\0';
+
+    tm = axis2_gmtime_r(&now, &result);
+    if(tm)
+    {
+        /* Sun, 06 Nov 1994 08:49:37 GMT */
+        p = slot->http_date;
+        memcpy(p, axutil_time_days[tm->tm_wday], 3);
+        p += 3;
+        *p++ = ',';
+        *p++ = ' ';
+        p = axutil_time_put_2digits(p, tm->tm_mday);
+        *p++ = ' ';
+        memcpy(p, axutil_time_months[tm->tm_mon], 3);
+        p += 3;
+        *p++ = ' ';
+        p = axutil_time_put_year(p, tm->tm_year + 1900);
+        *p++ = ' ';
+        p = axutil_time_put_clock(p, tm);
+        memcpy(p, " GMT", 5);
+
+        /* 1994-11-06T08:49:37Z */
+        p = slot->date_time;
+        p = axutil_time_put_year(p, tm->tm_year + 1900);
+        *p++ = '-';
+        p = axutil_time_put_2digits(p, tm->tm_mon + 1);
+        *p++ = '-';
+        p = axutil_time_put_2digits(p, tm->tm_mday);
+        *p++ = 'T';
+        p = axutil_time_put_clock(p, tm);
+        memcpy(p, "Z", 2);
+    }
+
+    tm = axis2_localtime_r(&now, &result);
+    if(tm)
+    {
+        /* Sun Nov  6 08:49:37 1994 */
+        p = slot->log_time;
+        memcpy(p, axutil_time_days[tm->tm_wday], 3);
+        p += 3;
+        *p++ = ' ';
+        memcpy(p, axutil_time_months[tm->tm_mon], 3);
+        p += 3;
+        *p++ = ' ';
+        p = axutil_time_put_2digits(p, tm->tm_mday);
+        if(tm->tm_mday < 10)
+        {
+            p[-2] = ' ';
+        }
+        *p++ = ' ';
+        p = axutil_time_put_clock(p, tm);
+        *p++ = ' ';
+        p = axutil_time_put_year(p, tm->tm_year + 1900);
+        *p = '\0';
+    }
+    slot->time = now;
+}
+
+/* Returns the slot of the current second, or formats it into scratch */
+static const axutil_time_slot_t *
+axutil_time_get_slot(
+    axutil_time_slot_t *scratch)
+{
+    time_t now = time(NULL);
+    unsigned int current = axutil_time_current;
+    axutil_time_slot_t *slot = NULL;
+
+    AXUTIL_TIME_BARRIER();
+    slot = &axutil_time_slots[current % AXUTIL_TIME_SLOTS];
+    if(slot->time == now)
+    {
+        return slot;
+    }
+
+    if(AXUTIL_TIME_TRYLOCK(axutil_time_lock))
+    {
+        /* the second may have been published since it was looked at */
+        current = axutil_time_current;
+        slot = &axutil_time_slots[current % AXUTIL_TIME_SLOTS];
+        if(slot->time != now)
+        {
+            slot = &axutil_time_slots[(current + 1) % AXUTIL_TIME_SLOTS];
+            axutil_time_format(slot, now);
+            AXUTIL_TIME_BARRIER();
+            axutil_time_current = current + 1;
+        }
+        AXUTIL_TIME_BARRIER();
+        axutil_time_lock = 0;
+        return slot;
+    }
+
+    axutil_time_format(scratch, now);
+    return scratch;
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_get_http_date(
+    axis2_char_t *buffer)
+{
+    axutil_time_slot_t scratch;
+    const axutil_time_slot_t *slot = axutil_time_get_slot(&scratch);
+
+    memcpy(buffer, slot->http_date, AXUTIL_HTTP_DATE_SIZE);
+    return (int)strlen(buffer);
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_get_log_time(
+    axis2_char_t *buffer)
+{
+    axutil_time_slot_t scratch;
+    const axutil_time_slot_t *slot = axutil_time_get_slot(&scratch);
+
+    memcpy(buffer, slot->log_time, AXUTIL_LOG_TIME_SIZE);
+    return (int)strlen(buffer);
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_get_date_time_str(
+    axis2_char_t *buffer)
+{
+    axutil_time_slot_t scratch;
+    const axutil_time_slot_t *slot = axutil_time_get_slot(&scratch);
+
+    memcpy(buffer, slot->date_time, AXUTIL_DATE_TIME_STR_SIZE);
+    return (int)strlen(buffer);
+}
+
 AXIS2_EXTERN int AXIS2_CALL
 axutil_get_milliseconds(
     const axutil_env_t *env)
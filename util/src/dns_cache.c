@@ -0,0 +1,462 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <time.h>
+#include <axutil_dns_cache.h>
+#include <axutil_hash.h>
+#include <axutil_thread.h>
+#include <axutil_string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ * Hosts are kept in a chained table under a mutex, which is only held to
+ * look an entry up or to store one; names are resolved with the mutex
+ * released, so a slow resolver does not hold up lookups of other hosts.
+ * When the table is full, expired entries are dropped, and if that does
+ * not make room, every entry is.
+ */
+
+#define AXUTIL_DNS_CACHE_BUCKETS 256
+#define AXUTIL_DNS_CACHE_MAX_HOSTS 1024
+
+#if defined(WIN32)
+axis2_bool_t axis2_init_socket(
+);
+#endif
+
+typedef struct axutil_dns_cache_entry axutil_dns_cache_entry_t;
+
+struct axutil_dns_cache_entry
+{
+    axutil_dns_cache_entry_t *next;
+    unsigned int hash;
+    time_t expires;
+
+    /* 0 when the name did not resolve */
+    int count;
+    axutil_dns_addr_t addrs[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    axis2_char_t host[1];
+};
+
+static struct
+{
+    axutil_dns_cache_entry_t *buckets[AXUTIL_DNS_CACHE_BUCKETS];
+    int count;
+    int ttl;
+    int negative_ttl;
+    unsigned long hits;
+    unsigned long misses;
+    axutil_allocator_t *allocator;
+    axutil_thread_mutex_t *mutex;
+} axutil_dns_cache = { { NULL }, 0, AXUTIL_DNS_CACHE_DEFAULT_TTL,
+    AXUTIL_DNS_CACHE_DEFAULT_NEGATIVE_TTL, 0, 0, NULL, NULL };
+
+#ifdef WIN32
+static INIT_ONCE axutil_dns_cache_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t axutil_dns_cache_once = PTHREAD_ONCE_INIT;
+#endif
+
+#ifdef WIN32
+static BOOL CALLBACK
+axutil_dns_cache_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+axutil_dns_cache_init(
+    void)
+#endif
+{
+#if defined(WIN32)
+    axis2_init_socket();
+#endif
+    axutil_dns_cache.allocator = axutil_allocator_init(NULL);
+    if(axutil_dns_cache.allocator)
+    {
+        axutil_dns_cache.mutex = axutil_thread_mutex_create(axutil_dns_cache.allocator,
+            AXIS2_THREAD_MUTEX_DEFAULT);
+    }
+#ifdef WIN32
+    return TRUE;
+#endif
+}
+
+static axutil_thread_mutex_t *
+axutil_dns_cache_get_mutex(
+    void)
+{
+#ifdef WIN32
+    InitOnceExecuteOnce(&axutil_dns_cache_once, axutil_dns_cache_init, NULL, NULL);
+#else
+    pthread_once(&axutil_dns_cache_once, axutil_dns_cache_init);
+#endif
+    return axutil_dns_cache.mutex;
+}
+
+/* Runs getaddrinfo and copies out up to max stream socket addresses */
+static int
+axutil_dns_cache_getaddrinfo(
+    const axis2_char_t *host,
+    int flags,
+    axutil_dns_addr_t *addrs,
+    int max)
+{
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    struct addrinfo *ai = NULL;
+    int count = 0;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = flags;
+    if(getaddrinfo(host, NULL, &hints, &result) != 0)
+    {
+        return 0;
+    }
+    for(ai = result; ai && count < max; ai = ai->ai_next)
+    {
+        if((ai->ai_family != AF_INET && ai->ai_family != AF_INET6)
+            || ai->ai_addrlen > sizeof(addrs[count].addr))
+        {
+            continue;
+        }
+        addrs[count].family = ai->ai_family;
+        addrs[count].len = (int)ai->ai_addrlen;
+        memset(&addrs[count].addr, 0, sizeof(addrs[count].addr));
+        memcpy(&addrs[count].addr, ai->ai_addr, ai->ai_addrlen);
+        count++;
+    }
+    freeaddrinfo(result);
+    return count;
+}
+
+static axutil_dns_cache_entry_t **
+axutil_dns_cache_find(
+    const axis2_char_t *host,
+    unsigned int hash)
+{
+    axutil_dns_cache_entry_t **entryp = NULL;
+
+    entryp = &axutil_dns_cache.buckets[hash % AXUTIL_DNS_CACHE_BUCKETS];
+    for(; *entryp; entryp = &(*entryp)->next)
+    {
+        if((*entryp)->hash == hash && !strcmp((*entryp)->host, host))
+        {
+            break;
+        }
+    }
+    return entryp;
+}
+
+/* Drops the expired entries, or all of them if none has expired.
+ * Must be called with the mutex held. */
+static void
+axutil_dns_cache_evict(
+    time_t now,
+    axis2_bool_t all)
+{
+    axutil_dns_cache_entry_t **entryp = NULL;
+    axutil_dns_cache_entry_t *entry = NULL;
+    int i = 0;
+
+    for(i = 0; i < AXUTIL_DNS_CACHE_BUCKETS; i++)
+    {
+        entryp = &axutil_dns_cache.buckets[i];
+        while(*entryp)
+        {
+            entry = *entryp;
+            if(all || entry->expires <= now)
+            {
+                *entryp = entry->next;
+                AXIS2_FREE(axutil_dns_cache.allocator, entry);
+                axutil_dns_cache.count--;
+            }
+            else
+            {
+                entryp = &entry->next;
+            }
+        }
+    }
+}
+
+/* Must be called with the mutex held */
+static void
+axutil_dns_cache_store(
+    const axis2_char_t *host,
+    unsigned int hash,
+    const axutil_dns_addr_t *addrs,
+    int count,
+    time_t expires)
+{
+    axutil_dns_cache_entry_t **entryp = NULL;
+    axutil_dns_cache_entry_t *entry = NULL;
+
+    entryp = axutil_dns_cache_find(host, hash);
+    entry = *entryp;
+    if(!entry)
+    {
+        if(axutil_dns_cache.count >= AXUTIL_DNS_CACHE_MAX_HOSTS)
+        {
+            axutil_dns_cache_evict(time(NULL), AXIS2_FALSE);
+            if(axutil_dns_cache.count >= AXUTIL_DNS_CACHE_MAX_HOSTS)
+            {
+                axutil_dns_cache_evict(0, AXIS2_TRUE);
+            }
+            entryp = axutil_dns_cache_find(host, hash);
+        }
+        entry = AXIS2_MALLOC(axutil_dns_cache.allocator, sizeof(axutil_dns_cache_entry_t)
+            + strlen(host));
+        if(!entry)
+        {
+            return;
+        }
+        strcpy(entry->host, host);
+        entry->hash = hash;
+        entry->next = NULL;
+        *entryp = entry;
+        axutil_dns_cache.count++;
+    }
+    entry->expires = expires;
+    entry->count = count;
+    memcpy(entry->addrs, addrs, count * sizeof(axutil_dns_addr_t));
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_dns_cache_resolve(
+    const axutil_env_t *env,
+    const axis2_char_t *host,
+    int port,
+    axutil_dns_addr_t *addrs,
+    int max)
+{
+    axutil_thread_mutex_t *mutex = NULL;
+    axutil_dns_cache_entry_t *entry = NULL;
+    axutil_dns_addr_t found[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    axis2_ssize_t len = AXIS2_HASH_KEY_STRING;
+    unsigned int hash = 0;
+    time_t now;
+    int count = -1;
+    int ttl = 0;
+    int i = 0;
+
+    AXIS2_PARAM_CHECK(env->error, host, 0);
+    AXIS2_PARAM_CHECK(env->error, addrs, 0);
+
+    mutex = axutil_dns_cache_get_mutex();
+
+    /* numeric addresses need no lookup and are not cached */
+    if((*host >= '0' && *host <= '9') || strchr(host, ':'))
+    {
+        count = axutil_dns_cache_getaddrinfo(host, AI_NUMERICHOST, found,
+            AXUTIL_DNS_CACHE_MAX_ADDRS);
+        if(!count)
+        {
+            count = -1;
+        }
+    }
+
+    if(count < 0)
+    {
+        hash = axutil_hashfunc_default(host, &len);
+        now = time(NULL);
+        if(mutex)
+        {
+            axutil_thread_mutex_lock(mutex);
+            entry = *axutil_dns_cache_find(host, hash);
+            if(entry && entry->expires > now)
+            {
+                count = entry->count;
+                memcpy(found, entry->addrs, count * sizeof(axutil_dns_addr_t));
+                axutil_dns_cache.hits++;
+            }
+            else
+            {
+                axutil_dns_cache.misses++;
+            }
+            axutil_thread_mutex_unlock(mutex);
+        }
+
+        if(count < 0)
+        {
+            count = axutil_dns_cache_getaddrinfo(host, AI_ADDRCONFIG, found,
+                AXUTIL_DNS_CACHE_MAX_ADDRS);
+            AXIS2_LOG_DEBUG(env->log, AXIS2_LOG_SI, "Resolved %s to %d addresses", host, count);
+            if(mutex)
+            {
+                axutil_thread_mutex_lock(mutex);
+                ttl = count ? axutil_dns_cache.ttl : axutil_dns_cache.negative_ttl;
+                if(ttl > 0 && axutil_dns_cache.ttl > 0)
+                {
+                    axutil_dns_cache_store(host, hash, found, count, now + ttl);
+                }
+                axutil_thread_mutex_unlock(mutex);
+            }
+        }
+    }
+
+    if(!count)
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to resolve host %s", host);
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_ADDRESS, AXIS2_FAILURE);
+        return 0;
+    }
+
+    if(count > max)
+    {
+        count = max;
+    }
+    for(i = 0; i < count; i++)
+    {
+        addrs[i] = found[i];
+        if(AF_INET6 == found[i].family)
+        {
+            ((struct sockaddr_in6 *)&addrs[i].addr)->sin6_port
+                = htons((axis2_unsigned_short_t)port);
+        }
+        else
+        {
+            ((struct sockaddr_in *)&addrs[i].addr)->sin_port
+                = htons((axis2_unsigned_short_t)port);
+        }
+    }
+    return count;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_dns_cache_prewarm(
+    const axutil_env_t *env,
+    const axis2_char_t *host)
+{
+    axis2_char_t name[256];
+    axutil_dns_addr_t addr;
+    const axis2_char_t *start = NULL;
+    const axis2_char_t *end = NULL;
+    size_t len = 0;
+
+    AXIS2_PARAM_CHECK(env->error, host, AXIS2_FAILURE);
+
+    /* take the host out of scheme://host:port/path, or [v6]:port */
+    start = strstr(host, "://");
+    start = start ? start + 3 : host;
+    if('[' == *start)
+    {
+        start++;
+        end = strchr(start, ']');
+    }
+    else
+    {
+        end = start + strcspn(start, ":/");
+    }
+    len = end ? (size_t)(end - start) : strlen(start);
+    if(!len || len >= sizeof(name))
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_ADDRESS, AXIS2_FAILURE);
+        return AXIS2_FAILURE;
+    }
+    memcpy(name, start, len);
+    name[len] = '\0';
+
+    return axutil_dns_cache_resolve(env, name, 0, &addr, 1) ? AXIS2_SUCCESS : AXIS2_FAILURE;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_dns_cache_set_ttl(
+    const axutil_env_t *env,
+    int ttl,
+    int negative_ttl)
+{
+    axutil_thread_mutex_t *mutex = axutil_dns_cache_get_mutex();
+
+    if(!mutex)
+    {
+        return;
+    }
+    axutil_thread_mutex_lock(mutex);
+    axutil_dns_cache.ttl = ttl > 0 ? ttl : 0;
+    axutil_dns_cache.negative_ttl = negative_ttl > 0 ? negative_ttl : 0;
+    if(!axutil_dns_cache.ttl)
+    {
+        axutil_dns_cache_evict(0, AXIS2_TRUE);
+    }
+    axutil_thread_mutex_unlock(mutex);
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_dns_cache_invalidate(
+    const axutil_env_t *env,
+    const axis2_char_t *host)
+{
+    axutil_thread_mutex_t *mutex = axutil_dns_cache_get_mutex();
+    axutil_dns_cache_entry_t **entryp = NULL;
+    axutil_dns_cache_entry_t *entry = NULL;
+    axis2_ssize_t len = AXIS2_HASH_KEY_STRING;
+
+    if(!mutex)
+    {
+        return;
+    }
+    axutil_thread_mutex_lock(mutex);
+    if(!host)
+    {
+        axutil_dns_cache_evict(0, AXIS2_TRUE);
+    }
+    else
+    {
+        entryp = axutil_dns_cache_find(host, axutil_hashfunc_default(host, &len));
+        entry = *entryp;
+        if(entry)
+        {
+            *entryp = entry->next;
+            AXIS2_FREE(axutil_dns_cache.allocator, entry);
+            axutil_dns_cache.count--;
+        }
+    }
+    axutil_thread_mutex_unlock(mutex);
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_dns_cache_get_stats(
+    unsigned long *hits,
+    unsigned long *misses)
+{
+    axutil_thread_mutex_t *mutex = axutil_dns_cache_get_mutex();
+
+    if(mutex)
+    {
+        axutil_thread_mutex_lock(mutex);
+    }
+    if(hits)
+    {
+        *hits = axutil_dns_cache.hits;
+    }
+    if(misses)
+    {
+        *misses = axutil_dns_cache.misses;
+    }
+    if(mutex)
+    {
+        axutil_thread_mutex_unlock(mutex);
+    }
+}
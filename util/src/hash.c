@@ -23,72 +23,86 @@
 /*
  * The internal form of a hash table.
  *
- * The table is an array indexed by the hash of the key; collisions
- * are resolved by hanging a linked list of hash entries off each
- * element of the array. Although this is a really simple design it
- * isn't too bad given that environments have a low allocation overhead.
+ * The table uses open addressing with linear probing. Entries live inline
+ * in one array, together with their hash and key length, and a parallel
+ * array holds one control byte per slot: empty, deleted, or the top seven
+ * bits of the hash of the entry stored there. Probing mostly looks at the
+ * control bytes, so a lookup touches an entry only when the tag matches.
+ *
+ * Deleted entries leave a tombstone behind instead of moving other entries
+ * around, which keeps the slot of every live entry stable while the table
+ * is iterated and the current entry is deleted.
  */
 
 typedef struct axutil_hash_entry_t axutil_hash_entry_t;
 
 struct axutil_hash_entry_t
 {
-    axutil_hash_entry_t *next;
-    unsigned int hash;
     const void *key;
-    axis2_ssize_t klen;
     const void *val;
+    axis2_ssize_t klen;
+    unsigned int hash;
 };
 
 /*
  * Data structure for iterating through a hash table.
- * We keep a pointer to the next hash entry here to allow the current
- * hash entry to be freed or otherwise mangled between calls to
- * axutil_hash_next().
+ * Slots do not move while entries are deleted, so the index of the
+ * current slot is all the state needed.
  */
 struct axutil_hash_index_t
 {
     axutil_hash_t *ht;
-    axutil_hash_entry_t *this, *next;
+    unsigned int this;
     unsigned int index;
 };
 
 /*
- * The size of the array is always a power of two. We use the maximum
- * index rather than the size so that we can use bitwise-AND for
- * modular arithmetic.
- * The count of hash entries may be greater depending on the chosen
- * collision rate.
+ * The size of the array is always a power of two, or zero until the first
+ * entry is added. We keep the size minus one as mask so that we can use
+ * bitwise-AND for modular arithmetic.
  */
 struct axutil_hash_t
 {
     const axutil_env_t *env;
-    axutil_hash_entry_t **array;
+    axutil_hash_entry_t *entries;
+    unsigned char *ctrl;
     axutil_hash_index_t iterator; /* For axutil_hash_first(NULL, ...) */
     unsigned int count;
-    unsigned int max;
+    unsigned int deleted;
+    unsigned int size;
+    unsigned int mask;
     axutil_hashfunc_t hash_func;
-    axutil_hash_entry_t *free; /* List of recycled entries */
+
+    /* the array shares the block of the table, see axutil_hash_copy */
+    axis2_bool_t inline_entries;
 };
 
-#define INITIAL_MAX 15          /* tunable == 2^n - 1 */
+#define INITIAL_SIZE 8          /* tunable == 2^n */
+
+#define AXUTIL_HASH_EMPTY 0
+#define AXUTIL_HASH_DELETED 1
+#define AXUTIL_HASH_TAG(hash) ((unsigned char)(0x80 | ((hash) >> 25)))
+
+/* at most 7/8 of the slots are used, counting tombstones */
+#define AXUTIL_HASH_FULL(ht, n) ((n) > (ht)->size - ((ht)->size >> 3))
 
 /*
  * Hash creation functions.
  */
 
-static axutil_hash_entry_t **
+static axutil_hash_entry_t *
 axutil_hash_alloc_array(
     axutil_hash_t *ht,
-    unsigned int max)
+    unsigned int size)
 {
-    axutil_hash_entry_t **he = AXIS2_MALLOC(ht->env->allocator, sizeof(*ht->array) * (max + 1));
+    axutil_hash_entry_t *entries = AXIS2_MALLOC(ht->env->allocator,
+        (sizeof(axutil_hash_entry_t) + 1) * size);
 
-    if (!he)
+    if (!entries)
         return NULL;
 
-    memset(he, 0, sizeof(*ht->array) * (max + 1));
-    return he;
+    memset(entries + size, AXUTIL_HASH_EMPTY, size);
+    return entries;
 }
 
 AXIS2_EXTERN axutil_hash_t *AXIS2_CALL
@@ -106,11 +120,16 @@ axutil_hash_make(
     }
     axutil_env_increment_ref((axutil_env_t*)env);
     ht->env = env;
-    ht->free = NULL;
     ht->count = 0;
-    ht->max = INITIAL_MAX;
-    ht->array = axutil_hash_alloc_array(ht, ht->max);
+    ht->deleted = 0;
+
+    /* the array is allocated when the first entry is added */
+    ht->size = 0;
+    ht->mask = 0;
+    ht->entries = NULL;
+    ht->ctrl = NULL;
     ht->hash_func = axutil_hashfunc_default;
+    ht->inline_entries = AXIS2_FALSE;
     return ht;
 }
 
@@ -138,20 +157,21 @@ axutil_hash_next(
     const axutil_env_t *env,
     axutil_hash_index_t *hi)
 {
-    hi->this = hi->next;
-    while(!hi->this)
+    axutil_hash_t *ht = hi->ht;
+
+    while(hi->index < ht->size)
     {
-        if(hi->index > hi->ht->max)
+        if(ht->ctrl[hi->index] & 0x80)
         {
-            if(env)
-                AXIS2_FREE(env->allocator, hi);
-            return NULL;
+            hi->this = hi->index++;
+            return hi;
         }
-
-        hi->this = hi->ht->array[hi->index++];
+        hi->index++;
     }
-    hi->next = hi->this->next;
-    return hi;
+
+    if(env)
+        AXIS2_FREE(env->allocator, hi);
+    return NULL;
 }
 
 AXIS2_EXTERN axutil_hash_index_t *AXIS2_CALL
@@ -167,8 +187,7 @@ axutil_hash_first(
 
     hi->ht = ht;
     hi->index = 0;
-    hi->this = NULL;
-    hi->next = NULL;
+    hi->this = 0;
     return axutil_hash_next(env, hi);
 }
 
@@ -179,38 +198,69 @@ axutil_hash_this(
     axis2_ssize_t *klen,
     void **val)
 {
+    axutil_hash_entry_t *he = &hi->ht->entries[hi->this];
+
     if(key)
-        *key = hi->this->key;
+        *key = he->key;
     if(klen)
-        *klen = hi->this->klen;
+        *klen = he->klen;
     if(val)
-        *val = (void *)hi->this->val;
+        *val = (void *)he->val;
 }
 
 /*
- * Expanding a hash table
+ * Resizing a hash table. Also drops the tombstones.
  */
 
 static void
-axutil_hash_expand_array(
-    axutil_hash_t *ht)
+axutil_hash_place(
+    axutil_hash_t *ht,
+    const axutil_hash_entry_t *he)
 {
-    axutil_hash_index_t *hi;
+    unsigned int i = he->hash & ht->mask;
+
+    while(ht->ctrl[i] != AXUTIL_HASH_EMPTY)
+    {
+        i = (i + 1) & ht->mask;
+    }
+    ht->ctrl[i] = AXUTIL_HASH_TAG(he->hash);
+    ht->entries[i] = *he;
+}
 
-    axutil_hash_entry_t **new_array;
-    unsigned int new_max;
+static axis2_status_t
+axutil_hash_resize(
+    axutil_hash_t *ht,
+    unsigned int new_size)
+{
+    axutil_hash_entry_t *old_entries = ht->entries;
+    unsigned char *old_ctrl = ht->ctrl;
+    unsigned int old_size = ht->size;
+    unsigned int i;
 
-    new_max = ht->max * 2 + 1;
-    new_array = axutil_hash_alloc_array(ht, new_max);
-    for(hi = axutil_hash_first(ht, NULL); hi; hi = axutil_hash_next(NULL, hi))
+    ht->entries = axutil_hash_alloc_array(ht, new_size);
+    if(!ht->entries)
     {
-        unsigned int i = hi->this->hash & new_max;
-        hi->this->next = new_array[i];
-        new_array[i] = hi->this;
+        ht->entries = old_entries;
+        return AXIS2_FAILURE;
+    }
+    ht->ctrl = (unsigned char *)(ht->entries + new_size);
+    ht->size = new_size;
+    ht->mask = new_size - 1;
+    ht->deleted = 0;
+
+    for(i = 0; i < old_size; i++)
+    {
+        if(old_ctrl[i] & 0x80)
+        {
+            axutil_hash_place(ht, &old_entries[i]);
+        }
     }
-    AXIS2_FREE(ht->env->allocator, ht->array);
-    ht->array = new_array;
-    ht->max = new_max;
+    if(old_entries && !ht->inline_entries)
+    {
+        AXIS2_FREE(ht->env->allocator, old_entries);
+    }
+    ht->inline_entries = AXIS2_FALSE;
+    return AXIS2_SUCCESS;
 }
 
 unsigned int
@@ -218,114 +268,147 @@ axutil_hashfunc_default(
     const char *char_key,
     axis2_ssize_t *klen)
 {
-    unsigned int hash = 0;
     const unsigned char *key = (const unsigned char *)char_key;
-    const unsigned char *p;
+    uint64_t hash = 0;
+    uint64_t word;
+    axis2_ssize_t len;
     axis2_ssize_t i;
 
     /*
-     * This is the popular `times 33' hash algorithm which is used by
-     * perl and also appears in Berkeley DB. This is one of the best
-     * known hash functions for strings because it is both computed
-     * very fast and distributes very well.
-     *
-     * The originator may be Dan Bernstein but the code in Berkeley DB
-     * cites Chris Torek as the source. The best citation I have found
-     * is "Chris Torek, Hash function for text in C, Usenet message
-     * <27038@mimsy.umd.edu> in comp.lang.c , October, 1990." in Rich
-     * Salz's USENIX 1992 paper about INN which can be found at
-     * <http://citeseer.nj.nec.com/salz92internetnews.html>.
-     *
-     * The magic of number 33, i.e. why it works better than many other
-     * constants, prime or not, has never been adequately explained by
-     * anyone. So I try an explanation: if one experimentally tests all
-     * multipliers between 1 and 256 (as I did while writing a low-level
-     * data structure library some time ago) one detects that even
-     * numbers are not useable at all. The remaining 128 odd numbers
-     * (except for the number 1) work more or less all equally well.
-     * They all distribute in an acceptable way and this way fill a hash
-     * table with an average percent of approx. 86%.
-     *
-     * If one compares the chi^2 values of the variants (see
-     * Bob Jenkins ``Hashing Frequently Asked Questions'' at
-     * http://burtleburtle.net/bob/hash/hashfaq.html for a description
-     * of chi^2), the number 33 not even has the best value. But the
-     * number 33 and a few other equally good numbers like 17, 31, 63,
-     * 127 and 129 have nevertheless a great advantage to the remaining
-     * numbers in the large set of possible multipliers: their multiply
-     * op can be replaced by a faster op based on just one
-     * shift plus either a single addition or subtraction op. And
-     * because a hash function has to both distribute good _and_ has to
-     * be very fast to compute, those few numbers should be preferred.
-     *
-     *                  -- Ralf S. Engelschall <rse@engelschall.com>
+     * The key is consumed eight bytes at a time: each word is folded into
+     * the state with one multiplication by the 64 bit golden ratio and a
+     * shift that brings the well mixed high half back down. A final round
+     * with a second multiplier spreads every input bit over the whole
+     * result, so both the low bits used as index and the high bits used as
+     * tag are well distributed even for keys that differ only in their
+     * last character, which is common for property names and QNames.
+     * This is several times faster than hashing a byte at a time for keys
+     * of the usual length. The hash value depends on the byte order, so it
+     * must not be stored.
      */
 
     if(*klen == AXIS2_HASH_KEY_STRING)
     {
-        for(p = key; *p; p++)
-        {
-            hash = hash * 33 + *p;
-        }
-        *klen = (axis2_ssize_t)(p - key);
-        /* We are sure that the difference lies within the axis2_ssize_t range */
+        *klen = (axis2_ssize_t)strlen(char_key);
     }
-    else
+    len = *klen;
+
+    for(i = 0; i + 8 <= len; i += 8)
+    {
+        memcpy(&word, key + i, 8);
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 32;
+    }
+
+    word = 0;
+    switch(len & 7)
     {
-        for(p = key, i = *klen; i; i--, p++)
+        case 7:
+            word |= (uint64_t)key[i + 6] << 48;
+            /* fall through */
+        case 6:
+            word |= (uint64_t)key[i + 5] << 40;
+            /* fall through */
+        case 5:
+            word |= (uint64_t)key[i + 4] << 32;
+            /* fall through */
+        case 4:
+            word |= (uint64_t)key[i + 3] << 24;
+            /* fall through */
+        case 3:
+            word |= (uint64_t)key[i + 2] << 16;
+            /* fall through */
+        case 2:
+            word |= (uint64_t)key[i + 1] << 8;
+            /* fall through */
+        case 1:
+            word |= key[i];
+    }
+
+    hash = (hash ^ word ^ ((uint64_t)len << 56)) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 32;
+    hash *= 0xd6e8feb86659fd93ULL;
+    hash ^= hash >> 32;
+
+    return (unsigned int)hash;
+}
+
+/*
+ * Looks up the slot of a key. Returns the slot holding the key, or
+ * ht->size if it is not there, in which case *free_slot is set to the
+ * slot a new entry for the key should take.
+ */
+
+static unsigned int
+axutil_hash_find_slot(
+    const axutil_hash_t *ht,
+    const void *key,
+    axis2_ssize_t klen,
+    unsigned int hash,
+    unsigned int *free_slot)
+{
+    unsigned char tag = AXUTIL_HASH_TAG(hash);
+    unsigned int i = hash & ht->mask;
+    unsigned int tombstone = ht->size;
+
+    while(ht->ctrl[i] != AXUTIL_HASH_EMPTY)
+    {
+        if(ht->ctrl[i] == tag)
+        {
+            const axutil_hash_entry_t *he = &ht->entries[i];
+            if(he->hash == hash && he->klen == klen && memcmp(he->key, key, klen) == 0)
+                return i;
+        }
+        else if(ht->ctrl[i] == AXUTIL_HASH_DELETED && tombstone == ht->size)
         {
-            hash = hash * 33 + *p;
+            tombstone = i;
         }
+        i = (i + 1) & ht->mask;
     }
 
-    return hash;
+    if(free_slot)
+        *free_slot = (tombstone != ht->size) ? tombstone : i;
+    return ht->size;
 }
 
 /*
- * This is where we keep the details of the hash function and control
- * the maximum collision rate.
- *
- * If val is non-NULL it creates and initializes a new hash entry if
- * there isn't already one there; it returns an updatable pointer so
- * that hash entries can be removed.
+ * Adds an entry for a key known not to be in the table, growing the table
+ * as needed.
  */
 
-static axutil_hash_entry_t **
-axutil_hash_find_entry(
+static void
+axutil_hash_insert(
     axutil_hash_t *ht,
     const void *key,
     axis2_ssize_t klen,
-    const void *val)
+    unsigned int hash,
+    const void *val,
+    unsigned int slot)
 {
-    axutil_hash_entry_t **hep, *he;
-    unsigned int hash;
-
-    hash = ht->hash_func(key, &klen);
+    axutil_hash_entry_t *he;
 
-    /* scan linked list */
-    for(hep = &ht->array[hash & ht->max], he = *hep; he; hep = &he->next, he = *hep)
+    if(!ht->size || (ht->ctrl[slot] == AXUTIL_HASH_EMPTY && AXUTIL_HASH_FULL(ht, ht->count
+        + ht->deleted + 1)))
     {
-        if(he->hash == hash && he->klen == klen && memcmp(he->key, key, klen) == 0)
-            break;
+        unsigned int new_size = ht->size ? ht->size : INITIAL_SIZE;
+
+        /* drop the tombstones in place unless the table is half full */
+        if(ht->size && ht->count >= ht->size / 2)
+            new_size *= 2;
+        if(axutil_hash_resize(ht, new_size) != AXIS2_SUCCESS)
+            return;
+        axutil_hash_find_slot(ht, key, klen, hash, &slot);
     }
 
-    if(he || !val)
-        return hep;
-
-    /* add a new entry for non-NULL values */
-    he = ht->free;
-    if(he)
-        ht->free = he->next;
-    else
-        he = AXIS2_MALLOC(ht->env->allocator, sizeof(*he));
-    he->next = NULL;
+    if(ht->ctrl[slot] == AXUTIL_HASH_DELETED)
+        ht->deleted--;
+    ht->ctrl[slot] = AXUTIL_HASH_TAG(hash);
+    he = &ht->entries[slot];
     he->hash = hash;
     he->key = key;
     he->klen = klen;
     he->val = val;
-    *hep = he;
     ht->count++;
-    return hep;
 }
 
 AXIS2_EXTERN axutil_hash_t *AXIS2_CALL
@@ -334,37 +417,28 @@ axutil_hash_copy(
     const axutil_env_t *env)
 {
     axutil_hash_t *ht;
-    axutil_hash_entry_t *new_vals;
-    unsigned int i, j;
 
-    ht = AXIS2_MALLOC(env->allocator, sizeof(axutil_hash_t) + sizeof(*ht->array) * (orig->max + 1)
-        + sizeof(axutil_hash_entry_t) * orig->count);
+    ht = AXIS2_MALLOC(env->allocator, sizeof(axutil_hash_t) + (sizeof(axutil_hash_entry_t) + 1)
+        * orig->size);
     ht->env = env;
     axutil_env_increment_ref((axutil_env_t*)env);
-    ht->free = NULL;
     ht->count = orig->count;
-    ht->max = orig->max;
+    ht->deleted = orig->deleted;
+    ht->size = orig->size;
+    ht->mask = orig->mask;
     ht->hash_func = orig->hash_func;
-    ht->array = (axutil_hash_entry_t **)((char *)ht + sizeof(axutil_hash_t));
-
-    new_vals = (axutil_hash_entry_t *)((char *)(ht) + sizeof(axutil_hash_t) + sizeof(*ht->array)
-        * (orig->max + 1));
-    j = 0;
-    for(i = 0; i <= ht->max; i++)
+    if(orig->size)
     {
-        axutil_hash_entry_t **new_entry = &(ht->array[i]);
-        axutil_hash_entry_t *orig_entry = orig->array[i];
-        while(orig_entry)
-        {
-            *new_entry = &new_vals[j++];
-            (*new_entry)->hash = orig_entry->hash;
-            (*new_entry)->key = orig_entry->key;
-            (*new_entry)->klen = orig_entry->klen;
-            (*new_entry)->val = orig_entry->val;
-            new_entry = &((*new_entry)->next);
-            orig_entry = orig_entry->next;
-        }
-        *new_entry = NULL;
+        ht->entries = (axutil_hash_entry_t *)(ht + 1);
+        ht->ctrl = (unsigned char *)(ht->entries + ht->size);
+        ht->inline_entries = AXIS2_TRUE;
+        memcpy(ht->entries, orig->entries, (sizeof(axutil_hash_entry_t) + 1) * orig->size);
+    }
+    else
+    {
+        ht->entries = NULL;
+        ht->ctrl = NULL;
+        ht->inline_entries = AXIS2_FALSE;
     }
     return ht;
 }
@@ -375,10 +449,16 @@ axutil_hash_get(
     const void *key,
     axis2_ssize_t klen)
 {
-    axutil_hash_entry_t *he;
-    he = *axutil_hash_find_entry(ht, key, klen, NULL);
-    if(he)
-        return (void *)he->val;
+    unsigned int hash;
+    unsigned int i;
+
+    if(!ht->count)
+        return NULL;
+
+    hash = ht->hash_func(key, &klen);
+    i = axutil_hash_find_slot(ht, key, klen, hash, NULL);
+    if(i != ht->size)
+        return (void *)ht->entries[i].val;
     else
         return NULL;
 }
@@ -390,30 +470,36 @@ axutil_hash_set(
     axis2_ssize_t klen,
     const void *val)
 {
-    axutil_hash_entry_t **hep;
-    hep = axutil_hash_find_entry(ht, key, klen, val);
-    if(*hep)
+    unsigned int hash;
+    unsigned int i;
+    unsigned int slot = 0;
+
+    if(!val && !ht->count)
+        return;
+
+    hash = ht->hash_func(key, &klen);
+    i = ht->size ? axutil_hash_find_slot(ht, key, klen, hash, &slot) : 0;
+    if(i != ht->size)
     {
         if(!val)
         {
             /* delete entry */
-            axutil_hash_entry_t *old = *hep;
-            *hep = (*hep)->next;
-            old->next = ht->free;
-            ht->free = old;
+            ht->ctrl[i] = AXUTIL_HASH_DELETED;
+            ht->entries[i].key = NULL;
+            ht->entries[i].val = NULL;
+            ht->deleted++;
             --ht->count;
         }
         else
         {
             /* replace entry */
-            (*hep)->val = val;
-            /* check that the collision rate isn't too high */
-            if(ht->count > ht->max)
-            {
-                axutil_hash_expand_array(ht);
-            }
+            ht->entries[i].val = val;
         }
     }
+    else if(val)
+    {
+        axutil_hash_insert(ht, key, klen, hash, val, slot);
+    }
     /* else key not present and val==NULL */
 }
 
@@ -449,9 +535,8 @@ axutil_hash_merge(
     const void *data)
 {
     axutil_hash_t *res;
-    axutil_hash_entry_t *new_vals = NULL;
-    axutil_hash_entry_t *iter;
-    axutil_hash_entry_t *ent;
+    const axutil_hash_entry_t *iter;
+    unsigned int size;
     unsigned int i, k;
 
 #if AXIS2_POOL_DEBUG
@@ -473,65 +558,57 @@ axutil_hash_merge(
     }
 #endif
 
-    res = AXIS2_MALLOC(env->allocator, sizeof(axutil_hash_t));
-    res->env = env;
-    axutil_env_increment_ref((axutil_env_t*)env);
-    res->free = NULL;
+    res = axutil_hash_make(env);
+    if(!res)
+        return NULL;
     res->hash_func = base->hash_func;
-    res->count = base->count;
-    res->max = (overlay->max > base->max) ? overlay->max : base->max;
-    if(base->count + overlay->count > res->max)
+
+    /* size the result for both tables up front */
+    size = INITIAL_SIZE;
+    while(size - (size >> 3) < base->count + overlay->count + 1)
     {
-        res->max = res->max * 2 + 1;
+        size *= 2;
     }
-    res->array = axutil_hash_alloc_array(res, res->max);
-    for(k = 0; k <= base->max; k++)
+    if(axutil_hash_resize(res, size) != AXIS2_SUCCESS)
     {
-        for(iter = base->array[k]; iter; iter = iter->next)
+        axutil_hash_free(res, env);
+        return NULL;
+    }
+
+    for(k = 0; k < base->size; k++)
+    {
+        if(base->ctrl[k] & 0x80)
         {
-            i = iter->hash & res->max;
-            new_vals = AXIS2_MALLOC(env->allocator, sizeof(axutil_hash_entry_t));
-            new_vals->klen = iter->klen;
-            new_vals->key = iter->key;
-            new_vals->val = iter->val;
-            new_vals->hash = iter->hash;
-            new_vals->next = res->array[i];
-            res->array[i] = new_vals;
+            axutil_hash_place(res, &base->entries[k]);
+            res->count++;
         }
     }
 
-    for(k = 0; k <= overlay->max; k++)
+    for(k = 0; k < overlay->size; k++)
     {
-        for(iter = overlay->array[k]; iter; iter = iter->next)
+        unsigned int slot = 0;
+
+        if(!(overlay->ctrl[k] & 0x80))
+            continue;
+
+        iter = &overlay->entries[k];
+        i = axutil_hash_find_slot(res, iter->key, iter->klen, iter->hash, &slot);
+        if(i != res->size)
         {
-            i = iter->hash & res->max;
-            for(ent = res->array[i]; ent; ent = ent->next)
+            if(merger)
             {
-                if((ent->klen == iter->klen) && (memcmp(ent->key, iter->key, iter->klen) == 0))
-                {
-                    if(merger)
-                    {
-                        ent->val = (*merger)(env, iter->key, iter->klen, iter->val, ent->val, data);
-                    }
-                    else
-                    {
-                        ent->val = iter->val;
-                    }
-                    break;
-                }
+                res->entries[i].val = (*merger)(env, iter->key, iter->klen, iter->val,
+                    res->entries[i].val, data);
             }
-            if(!ent)
+            else
             {
-                new_vals = AXIS2_MALLOC(env->allocator, sizeof(axutil_hash_entry_t));
-                new_vals->klen = iter->klen;
-                new_vals->key = iter->key;
-                new_vals->val = iter->val;
-                new_vals->hash = iter->hash;
-                new_vals->next = res->array[i];
-                res->array[i] = new_vals;
-                res->count++;
+                res->entries[i].val = iter->val;
             }
         }
+        else
+        {
+            axutil_hash_insert(res, iter->key, iter->klen, iter->hash, iter->val, slot);
+        }
     }
     return res;
 }
@@ -558,56 +635,13 @@ axutil_hash_contains_key(
     return AXIS2_FALSE;
 }
 
-/*
- void
- axutil_hash_entry_free(
- const axutil_env_t *env,
- axutil_hash_entry_t *hash_entry)
- {
- if (!hash_entry)
- return;
- if (hash_entry->next)
- {
- axutil_hash_entry_free(env, hash_entry->next);
- }
- AXIS2_FREE(env->allocator, hash_entry);
- return;
- }
- */
-
 AXIS2_EXTERN void AXIS2_CALL
 axutil_hash_free(
     axutil_hash_t *ht,
     const axutil_env_t *env)
 {
-    unsigned int i = 0;
     if(ht)
     {
-        for(i = 0; i <= ht->max; i++)
-        {
-            axutil_hash_entry_t *next = NULL;
-            axutil_hash_entry_t *current = ht->array[i];
-            while(current)
-            {
-                next = current->next;
-                AXIS2_FREE(env->allocator, current);
-                current = NULL;
-                current = next;
-            }
-        }
-        if(ht->free)
-        {
-            axutil_hash_entry_t *next = NULL;
-            axutil_hash_entry_t *current = ht->free;
-            while(current)
-            {
-                next = current->next;
-                AXIS2_FREE(env->allocator, current);
-                current = NULL;
-                current = next;
-            }
-        }
-
         if(ht->env)
         {
             /*since we now keep a ref count in env and incrementing it
@@ -619,7 +653,10 @@ axutil_hash_free(
             ht->env = NULL;
         }
 
-        AXIS2_FREE(env->allocator, (ht->array));
+        if(ht->entries && !ht->inline_entries)
+        {
+            AXIS2_FREE(env->allocator, ht->entries);
+        }
         AXIS2_FREE(env->allocator, ht);
     }
     return;
@@ -630,22 +667,13 @@ axutil_hash_free_void_arg(
     void *ht_void,
     const axutil_env_t *env)
 {
-    unsigned int i = 0;
     axutil_hash_t *ht = (axutil_hash_t *)ht_void;
     if(ht)
     {
-        for(i = 0; i < ht->max; i++)
+        if(ht->entries && !ht->inline_entries)
         {
-            axutil_hash_entry_t *next = NULL;
-            axutil_hash_entry_t *current = ht->array[i];
-            while(current)
-            {
-                next = current->next;
-                AXIS2_FREE(env->allocator, current);
-                current = next;
-            }
+            AXIS2_FREE(env->allocator, ht->entries);
         }
-        AXIS2_FREE(env->allocator, (ht->array));
         AXIS2_FREE(env->allocator, ht);
     }
     return;
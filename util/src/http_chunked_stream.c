@@ -22,6 +22,9 @@
 
 #define AXIS2_HTTP_CRLF "\r\n"
 
+/* largest chunk a file is sent in, readers keep the chunk size in an int */
+#define AXUTIL_HTTP_CHUNKED_FILE_CHUNK_SIZE 0x40000000
+
 struct axutil_http_chunked_stream
 {
     axutil_stream_t *stream;
@@ -132,8 +135,8 @@ axutil_http_chunked_stream_write(
     size_t count)
 {
     axutil_stream_t *stream = chunked_stream->stream;
-    int len = -1;
-    axis2_char_t tmp_buf[10];
+    axis2_char_t tmp_buf[16];
+    axutil_stream_iovec_t iov[3];
 
     if(!buffer)
     {
@@ -145,10 +148,53 @@ axutil_http_chunked_stream_write(
         return -1;
     }
     sprintf(tmp_buf, "%x%s", (unsigned int)count, AXIS2_HTTP_CRLF);
-    axutil_stream_write(stream, env, tmp_buf, axutil_strlen(tmp_buf));
-    len = axutil_stream_write(stream, env, buffer, count);
-    axutil_stream_write(stream, env, AXIS2_HTTP_CRLF, 2);
-    return len;
+
+    /* chunk size, data and trailing CRLF in one write */
+    iov[0].base = tmp_buf;
+    iov[0].len = axutil_strlen(tmp_buf);
+    iov[1].base = buffer;
+    iov[1].len = count;
+    iov[2].base = AXIS2_HTTP_CRLF;
+    iov[2].len = 2;
+    if(axutil_stream_writev(stream, env, iov, 3) < 0)
+    {
+        return -1;
+    }
+    return (int)count;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_http_chunked_stream_write_file(
+    axutil_http_chunked_stream_t *chunked_stream,
+    const axutil_env_t *env,
+    FILE *file,
+    size_t count)
+{
+    axutil_stream_t *stream = chunked_stream->stream;
+    axis2_char_t tmp_buf[16];
+    size_t len = 0;
+    int tmp_len = 0;
+
+    if(!stream)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NULL_STREAM_IN_CHUNKED_STREAM, AXIS2_FAILURE);
+        return AXIS2_FAILURE;
+    }
+    while(count > 0)
+    {
+        len = count < AXUTIL_HTTP_CHUNKED_FILE_CHUNK_SIZE ? count
+            : AXUTIL_HTTP_CHUNKED_FILE_CHUNK_SIZE;
+        sprintf(tmp_buf, "%x%s", (unsigned int)len, AXIS2_HTTP_CRLF);
+        tmp_len = axutil_strlen(tmp_buf);
+        if(axutil_stream_write(stream, env, tmp_buf, tmp_len) != tmp_len
+            || axutil_stream_sendfile(stream, env, file, len) != AXIS2_SUCCESS
+            || axutil_stream_write(stream, env, AXIS2_HTTP_CRLF, 2) != 2)
+        {
+            return AXIS2_FAILURE;
+        }
+        count -= len;
+    }
+    return AXIS2_SUCCESS;
 }
 
 AXIS2_EXTERN int AXIS2_CALL
@@ -167,24 +213,15 @@ axutil_http_chunked_stream_start_chunk(
     axis2_char_t tmp_buf[3] = "";
     axis2_char_t str_chunk_len[512] = "";
     axis2_char_t *tmp = NULL;
-    int read = -1;
 
     /* remove the last CRLF of the previous chunk if any */
     if(AXIS2_TRUE == chunked_stream->chunk_started)
     {
-        read = axutil_stream_read(chunked_stream->stream, env, tmp_buf, 2);
+        axutil_stream_read_line(chunked_stream->stream, env, tmp_buf, sizeof(tmp_buf));
         chunked_stream->chunk_started = AXIS2_FALSE;
     }
     /* read the len and chunk extension */
-    while((read = axutil_stream_read(chunked_stream->stream, env, tmp_buf, 1)) > 0)
-    {
-        tmp_buf[read] = '\0';
-        strcat(str_chunk_len, tmp_buf);
-        if(0 != strstr(str_chunk_len, AXIS2_HTTP_CRLF))
-        {
-            break;
-        }
-    }
+    axutil_stream_read_line(chunked_stream->stream, env, str_chunk_len, sizeof(str_chunk_len));
     /* check whether we have extensions */
     tmp = strchr(str_chunk_len, ';');
     if(tmp)
@@ -196,7 +233,7 @@ axutil_http_chunked_stream_start_chunk(
     if(0 == chunked_stream->current_chunk_size)
     {
         /* Read the last CRLF */
-        read = axutil_stream_read(chunked_stream->stream, env, tmp_buf, 2);
+        axutil_stream_read_line(chunked_stream->stream, env, tmp_buf, sizeof(tmp_buf));
         chunked_stream->end_of_chunks = AXIS2_TRUE;
     }
     else
@@ -22,9 +22,13 @@
 #include <axutil_log_default.h>
 #include <axutil_file_handler.h>
 #include <axutil_thread.h>
+#include <axutil_date_time_util.h>
 #include <signal.h>
+#include <time.h>
 
 typedef struct axutil_log_impl axutil_log_impl_t;
+typedef struct axutil_log_ring axutil_log_ring_t;
+typedef struct axutil_log_async axutil_log_async_t;
 
 static axis2_status_t
 axutil_log_impl_rotate(
@@ -49,6 +53,13 @@ static void AXIS2_CALL axutil_log_impl_free(
     axutil_allocator_t *allocator,
     axutil_log_t *log);
 
+static void axutil_log_impl_write_async(
+    axutil_log_impl_t *log_impl,
+    axutil_log_levels_t level,
+    const axis2_char_t *file,
+    const int line,
+    const axis2_char_t *value);
+
 typedef enum axutil_log_stream_type
 {
     AXUTIL_LOG_FILE = 1,
@@ -62,6 +73,83 @@ struct axutil_log_impl
     axutil_log_stream_type_t stream_type;
     axis2_char_t *file_name;
     axutil_thread_mutex_t *mutex;
+
+    /* size of the log file, counted as lines are written */
+    long file_size;
+
+    /* when file_size was last taken from the file itself */
+    time_t size_time;
+
+    /* set while lines are written asynchronously */
+    axutil_log_async_t *async;
+};
+
+/*
+ * Asynchronous mode.
+ *
+ * Every thread that logs gets a ring buffer of its own. The thread is the
+ * only one that moves the head of its ring and the flusher thread is the
+ * only one that moves the tail, so formatted lines are handed over without
+ * any locking. The flusher wakes up periodically, or when a ring is half
+ * full, copies what the rings hold into one batch and writes the batch to
+ * the file with a single call.
+ */
+
+#define AXUTIL_LOG_LINE_SIZE (AXIS2_LEN_VALUE + 512)
+#define AXUTIL_LOG_MIN_RING_SIZE (4 * AXUTIL_LOG_LINE_SIZE)
+#define AXUTIL_LOG_BATCH_SIZE (64 * 1024)
+#define AXUTIL_LOG_FLUSH_INTERVAL 200
+
+#if defined(WIN32)
+#define AXUTIL_LOG_BARRIER() MemoryBarrier()
+#elif defined(__GNUC__)
+#define AXUTIL_LOG_BARRIER() __sync_synchronize()
+#else
+#define AXUTIL_LOG_BARRIER()
+#endif
+
+struct axutil_log_ring
+{
+    axutil_log_ring_t *next;
+    axis2_char_t *buffer;
+
+    /* a power of two */
+    unsigned long size;
+
+    /* moved by the owning thread only */
+    volatile unsigned long head;
+
+    /* moved by the flusher only */
+    volatile unsigned long tail;
+
+    volatile unsigned long dropped;
+
+    /* set when the owning thread has exited */
+    volatile int closed;
+};
+
+struct axutil_log_async
+{
+    axutil_allocator_t *allocator;
+    axutil_threadkey_t *key;
+    axutil_log_overflow_t overflow;
+    unsigned long ring_size;
+
+    /* guards the list of rings and the conditions */
+    axutil_thread_mutex_t *mutex;
+    axutil_log_ring_t *rings;
+    axutil_thread_cond_t *flush_cond;
+    axutil_thread_cond_t *space_cond;
+
+    axutil_thread_t *flusher;
+    volatile int running;
+
+    /* dropped lines of freed rings, and dropped lines reported so far */
+    unsigned long dropped_freed;
+    unsigned long dropped_reported;
+
+    axis2_char_t *batch;
+    size_t batch_used;
 };
 
 #define AXUTIL_INTF_TO_IMPL(log) ((axutil_log_impl_t*)(log))
@@ -79,6 +167,10 @@ axutil_log_impl_free(
     {
         log_impl = AXUTIL_INTF_TO_IMPL(log);
 
+        if(log_impl->async)
+        {
+            axutil_log_set_async(log, NULL, 0, AXUTIL_LOG_OVERFLOW_DROP);
+        }
         if(log_impl->mutex)
         {
             axutil_thread_mutex_destroy(log_impl->mutex);
@@ -169,6 +261,9 @@ axutil_log_create(
     log_impl->file_name = AXIS2_MALLOC(allocator, AXUTIL_LOG_FILE_NAME_SIZE);
     log_impl->log.size = AXUTIL_LOG_FILE_SIZE;
     sprintf(log_impl->file_name, "%s", log_file_name);
+    log_impl->file_size = 0;
+    log_impl->size_time = 0;
+    log_impl->async = NULL;
 
     axutil_thread_mutex_lock(log_impl->mutex);
 
@@ -221,7 +316,10 @@ axutil_log_impl_write(
             fprintf(stderr, "Stream is not found\n");
         if(level <= log->level || level == AXIS2_LOG_LEVEL_CRITICAL)
         {
-            axutil_log_impl_write_to_file(log, l->mutex, level, file, line, buffer);
+            if(l->async)
+                axutil_log_impl_write_async(l, level, file, line, buffer);
+            else
+                axutil_log_impl_write_to_file(log, l->mutex, level, file, line, buffer);
         }
     }
 #ifndef AXIS2_NO_LOG_FILE
@@ -232,6 +330,58 @@ axutil_log_impl_write(
         fprintf(stderr, "please check your log and buffer");
 }
 
+static const char *
+axutil_log_impl_level_str(
+    axutil_log_levels_t level)
+{
+    switch(level)
+    {
+        case AXIS2_LOG_LEVEL_CRITICAL:
+            return "[critical] ";
+        case AXIS2_LOG_LEVEL_ERROR:
+            return "[error] ";
+        case AXIS2_LOG_LEVEL_WARNING:
+            return "[warning] ";
+        case AXIS2_LOG_LEVEL_INFO:
+            return "[info] ";
+        case AXIS2_LOG_LEVEL_DEBUG:
+            return "[debug] ";
+        case AXIS2_LOG_LEVEL_TRACE:
+            return "[...TRACE...] ";
+        case AXIS2_LOG_LEVEL_USER:
+            break;
+    }
+    return "";
+}
+
+/* Formats a log line, newline included, and returns its length */
+static int
+axutil_log_impl_format_line(
+    axis2_char_t *buffer,
+    const axis2_char_t *time_str,
+    axutil_log_levels_t level,
+    const axis2_char_t *file,
+    const int line,
+    const axis2_char_t *value)
+{
+    int len = 0;
+
+    if(file)
+        len = AXIS2_SNPRINTF(buffer, AXUTIL_LOG_LINE_SIZE, "[%s] %s%s(%d) %s\n", time_str,
+            axutil_log_impl_level_str(level), file, line, value);
+    else
+        len = AXIS2_SNPRINTF(buffer, AXUTIL_LOG_LINE_SIZE, "[%s] %s %s\n", time_str,
+            axutil_log_impl_level_str(level), value);
+
+    if(len < 0 || len >= AXUTIL_LOG_LINE_SIZE)
+    {
+        /* truncated, keep the line terminated */
+        len = AXUTIL_LOG_LINE_SIZE - 1;
+        buffer[len - 1] = '\n';
+    }
+    return len;
+}
+
 AXIS2_EXTERN void AXIS2_CALL
 axutil_log_impl_write_to_file(
     axutil_log_t *log,
@@ -244,34 +394,15 @@ axutil_log_impl_write_to_file(
     const char *level_str = "";
     axutil_log_impl_t *log_impl = AXUTIL_INTF_TO_IMPL(log);
     FILE *fd = NULL;
+    axis2_char_t time_str[AXUTIL_LOG_TIME_SIZE];
+    int written = 0;
 
     /**
      * print all critical and error logs irrespective of log->level setting
      */
 
-    switch(level)
-    {
-        case AXIS2_LOG_LEVEL_CRITICAL:
-            level_str = "[critical] ";
-            break;
-        case AXIS2_LOG_LEVEL_ERROR:
-            level_str = "[error] ";
-            break;
-        case AXIS2_LOG_LEVEL_WARNING:
-            level_str = "[warning] ";
-            break;
-        case AXIS2_LOG_LEVEL_INFO:
-            level_str = "[info] ";
-            break;
-        case AXIS2_LOG_LEVEL_DEBUG:
-            level_str = "[debug] ";
-            break;
-        case AXIS2_LOG_LEVEL_TRACE:
-            level_str = "[...TRACE...] ";
-            break;
-        case AXIS2_LOG_LEVEL_USER:
-            break;
-    }
+    level_str = axutil_log_impl_level_str(level);
+    axutil_get_log_time(time_str);
     axutil_thread_mutex_lock(mutex);
 
     axutil_log_impl_rotate(log);
@@ -280,15 +411,417 @@ axutil_log_impl_write_to_file(
     if(fd)
     {
         if(file)
-            fprintf(fd, "[%s] %s%s(%d) %s\n", axutil_log_impl_get_time_str(), level_str, file,
-                line, value);
+            written = fprintf(fd, "[%s] %s%s(%d) %s\n", time_str, level_str, file, line, value);
         else
-            fprintf(fd, "[%s] %s %s\n", axutil_log_impl_get_time_str(), level_str, value);
+            written = fprintf(fd, "[%s] %s %s\n", time_str, level_str, value);
         fflush(fd);
+        if(written > 0)
+            log_impl->file_size += written;
     }
     axutil_thread_mutex_unlock(mutex);
 }
 
+/* Writes out the batch. Must be called with the log mutex held. */
+static void
+axutil_log_impl_write_batch(
+    axutil_log_impl_t *log_impl,
+    const axis2_char_t *data,
+    size_t len)
+{
+    FILE *fd = NULL;
+
+    axutil_log_impl_rotate(&log_impl->log);
+    fd = log_impl->stream;
+    if(fd && len && fwrite(data, 1, len, fd) == len)
+    {
+        log_impl->file_size += (long)len;
+    }
+}
+
+static void
+axutil_log_impl_batch_append(
+    axutil_log_impl_t *log_impl,
+    const axis2_char_t *data,
+    size_t len)
+{
+    axutil_log_async_t *async = log_impl->async;
+
+    if(async->batch_used + len > AXUTIL_LOG_BATCH_SIZE)
+    {
+        axutil_log_impl_write_batch(log_impl, async->batch, async->batch_used);
+        async->batch_used = 0;
+    }
+    if(len >= AXUTIL_LOG_BATCH_SIZE)
+    {
+        axutil_log_impl_write_batch(log_impl, data, len);
+    }
+    else
+    {
+        memcpy(async->batch + async->batch_used, data, len);
+        async->batch_used += len;
+    }
+}
+
+/*
+ * Moves everything the rings hold to the log file, followed by the given
+ * line if any, and frees the rings of threads that have exited. Must be
+ * called with the async mutex held.
+ */
+static void
+axutil_log_impl_drain(
+    axutil_log_impl_t *log_impl,
+    const axis2_char_t *extra,
+    size_t extra_len)
+{
+    axutil_log_async_t *async = log_impl->async;
+    axutil_log_ring_t **ringp = &async->rings;
+    unsigned long dropped = async->dropped_freed;
+
+    axutil_thread_mutex_lock(log_impl->mutex);
+    while(*ringp)
+    {
+        axutil_log_ring_t *ring = *ringp;
+        unsigned long head = ring->head;
+        unsigned long tail = ring->tail;
+
+        /* read the lines only after reading the head that covers them */
+        AXUTIL_LOG_BARRIER();
+        while(tail != head)
+        {
+            unsigned long pos = tail & (ring->size - 1);
+            unsigned long len = head - tail;
+            if(len > ring->size - pos)
+                len = ring->size - pos;
+            axutil_log_impl_batch_append(log_impl, ring->buffer + pos, len);
+            tail += len;
+        }
+
+        /* hand the space back only once the lines are copied */
+        AXUTIL_LOG_BARRIER();
+        ring->tail = tail;
+
+        dropped += ring->dropped;
+        if(ring->closed && ring->head == tail)
+        {
+            *ringp = ring->next;
+            async->dropped_freed += ring->dropped;
+            AXIS2_FREE(async->allocator, ring->buffer);
+            AXIS2_FREE(async->allocator, ring);
+        }
+        else
+        {
+            ringp = &ring->next;
+        }
+    }
+
+    if(dropped != async->dropped_reported)
+    {
+        axis2_char_t line[AXUTIL_LOG_LINE_SIZE];
+        axis2_char_t value[64];
+        axis2_char_t time_str[AXUTIL_LOG_TIME_SIZE];
+        int len = 0;
+
+        AXIS2_SNPRINTF(value, sizeof(value), "%lu log lines dropped, the log buffers were full",
+            dropped - async->dropped_reported);
+        axutil_get_log_time(time_str);
+        len = axutil_log_impl_format_line(line, time_str, AXIS2_LOG_LEVEL_WARNING,
+            NULL, -1, value);
+        axutil_log_impl_batch_append(log_impl, line, len);
+        async->dropped_reported = dropped;
+    }
+    if(extra)
+    {
+        axutil_log_impl_batch_append(log_impl, extra, extra_len);
+    }
+
+    axutil_log_impl_write_batch(log_impl, async->batch, async->batch_used);
+    async->batch_used = 0;
+    if(log_impl->stream)
+    {
+        fflush(log_impl->stream);
+    }
+    axutil_thread_mutex_unlock(log_impl->mutex);
+
+    axutil_thread_cond_broadcast(async->space_cond);
+}
+
+static void *AXIS2_THREAD_FUNC
+axutil_log_impl_flusher(
+    axutil_thread_t *thd,
+    void *data)
+{
+    axutil_log_impl_t *log_impl = (axutil_log_impl_t *)data;
+    axutil_log_async_t *async = log_impl->async;
+
+    axutil_thread_mutex_lock(async->mutex);
+    while(async->running)
+    {
+        axutil_log_impl_drain(log_impl, NULL, 0);
+        axutil_thread_cond_timedwait(async->flush_cond, async->mutex, AXUTIL_LOG_FLUSH_INTERVAL);
+    }
+    axutil_log_impl_drain(log_impl, NULL, 0);
+    axutil_thread_mutex_unlock(async->mutex);
+    return NULL;
+}
+
+/* Called when a thread that has a ring exits */
+static void AXIS2_CALL
+axutil_log_impl_ring_close(
+    void *ring)
+{
+    AXUTIL_LOG_BARRIER();
+    ((axutil_log_ring_t *)ring)->closed = 1;
+}
+
+static axutil_log_ring_t *
+axutil_log_impl_get_ring(
+    axutil_log_impl_t *log_impl)
+{
+    axutil_log_async_t *async = log_impl->async;
+    axutil_log_ring_t *ring = NULL;
+
+    ring = axutil_thread_getspecific(async->key);
+    if(ring)
+        return ring;
+
+    ring = AXIS2_MALLOC(async->allocator, sizeof(axutil_log_ring_t));
+    if(!ring)
+        return NULL;
+    memset(ring, 0, sizeof(axutil_log_ring_t));
+    ring->size = async->ring_size;
+    ring->buffer = AXIS2_MALLOC(async->allocator, ring->size);
+    if(!ring->buffer)
+    {
+        AXIS2_FREE(async->allocator, ring);
+        return NULL;
+    }
+    axutil_thread_setspecific(async->key, ring);
+
+    axutil_thread_mutex_lock(async->mutex);
+    ring->next = async->rings;
+    async->rings = ring;
+    axutil_thread_mutex_unlock(async->mutex);
+    return ring;
+}
+
+static void
+axutil_log_impl_write_async(
+    axutil_log_impl_t *log_impl,
+    axutil_log_levels_t level,
+    const axis2_char_t *file,
+    const int line,
+    const axis2_char_t *value)
+{
+    axutil_log_async_t *async = log_impl->async;
+    axutil_log_ring_t *ring = NULL;
+    axis2_char_t buffer[AXUTIL_LOG_LINE_SIZE];
+    axis2_char_t time_str[AXUTIL_LOG_TIME_SIZE];
+    unsigned long len = 0;
+    unsigned long pos = 0;
+    unsigned long first = 0;
+
+    ring = axutil_log_impl_get_ring(log_impl);
+    if(!ring)
+    {
+        axutil_log_impl_write_to_file(&log_impl->log, log_impl->mutex, level, file, line, value);
+        return;
+    }
+
+    axutil_get_log_time(time_str);
+    len = (unsigned long)axutil_log_impl_format_line(buffer, time_str, level, file, line, value);
+
+    /* write critical lines through at once, after everything before them */
+    if(level == AXIS2_LOG_LEVEL_CRITICAL)
+    {
+        axutil_thread_mutex_lock(async->mutex);
+        axutil_log_impl_drain(log_impl, buffer, len);
+        axutil_thread_mutex_unlock(async->mutex);
+        return;
+    }
+
+    while(ring->size - (ring->head - ring->tail) < len)
+    {
+        if(async->overflow == AXUTIL_LOG_OVERFLOW_DROP && level > AXIS2_LOG_LEVEL_WARNING
+            && level != AXIS2_LOG_LEVEL_USER)
+        {
+            ring->dropped++;
+            return;
+        }
+        axutil_thread_mutex_lock(async->mutex);
+        axutil_thread_cond_signal(async->flush_cond);
+        axutil_thread_cond_timedwait(async->space_cond, async->mutex, 10);
+        axutil_thread_mutex_unlock(async->mutex);
+    }
+
+    /* overwrite the space only after reading the tail that frees it */
+    AXUTIL_LOG_BARRIER();
+    pos = ring->head & (ring->size - 1);
+    first = ring->size - pos;
+    if(first >= len)
+    {
+        memcpy(ring->buffer + pos, buffer, len);
+    }
+    else
+    {
+        memcpy(ring->buffer + pos, buffer, first);
+        memcpy(ring->buffer, buffer + first, len - first);
+    }
+
+    /* publish the line only once it is in place */
+    AXUTIL_LOG_BARRIER();
+    ring->head += len;
+
+    if(ring->head - ring->tail > ring->size / 2)
+    {
+        axutil_thread_cond_signal(async->flush_cond);
+    }
+}
+
+static void
+axutil_log_impl_async_free(
+    axutil_log_async_t *async)
+{
+    axutil_allocator_t *allocator = async->allocator;
+
+    while(async->rings)
+    {
+        axutil_log_ring_t *ring = async->rings;
+        async->rings = ring->next;
+        AXIS2_FREE(allocator, ring->buffer);
+        AXIS2_FREE(allocator, ring);
+    }
+    if(async->key)
+        axutil_threadkey_free(async->key, allocator);
+    if(async->flush_cond)
+        axutil_thread_cond_destroy(async->flush_cond);
+    if(async->space_cond)
+        axutil_thread_cond_destroy(async->space_cond);
+    if(async->mutex)
+        axutil_thread_mutex_destroy(async->mutex);
+    if(async->batch)
+        AXIS2_FREE(allocator, async->batch);
+    AXIS2_FREE(allocator, async);
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_log_set_async(
+    axutil_log_t *log,
+    axutil_allocator_t *allocator,
+    int buffer_size,
+    axutil_log_overflow_t overflow)
+{
+    axutil_log_impl_t *log_impl = NULL;
+    axutil_log_async_t *async = NULL;
+    unsigned long ring_size = 1;
+
+    if(!log || log->ops != &axutil_log_ops_var)
+        return AXIS2_FAILURE;
+    log_impl = AXUTIL_INTF_TO_IMPL(log);
+
+    if(log_impl->async)
+    {
+        /* stop the flusher, which writes out what is left */
+        async = log_impl->async;
+        axutil_thread_mutex_lock(async->mutex);
+        async->running = 0;
+        axutil_thread_cond_signal(async->flush_cond);
+        axutil_thread_mutex_unlock(async->mutex);
+        axutil_thread_join(async->flusher);
+        axutil_thread_free(async->flusher, async->allocator);
+
+        log_impl->async = NULL;
+        axutil_log_impl_async_free(async);
+        async = NULL;
+    }
+    if(buffer_size <= 0)
+        return AXIS2_SUCCESS;
+    if(!allocator)
+        return AXIS2_FAILURE;
+
+    while(ring_size < (unsigned long)buffer_size || ring_size < AXUTIL_LOG_MIN_RING_SIZE)
+    {
+        ring_size *= 2;
+    }
+
+    async = AXIS2_MALLOC(allocator, sizeof(axutil_log_async_t));
+    if(!async)
+        return AXIS2_FAILURE;
+    memset(async, 0, sizeof(axutil_log_async_t));
+    async->allocator = allocator;
+    async->overflow = overflow;
+    async->ring_size = ring_size;
+    async->key = axutil_threadkey_create(allocator, axutil_log_impl_ring_close);
+    async->mutex = axutil_thread_mutex_create(allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+    async->flush_cond = axutil_thread_cond_create(allocator);
+    async->space_cond = axutil_thread_cond_create(allocator);
+    async->batch = AXIS2_MALLOC(allocator, AXUTIL_LOG_BATCH_SIZE);
+    if(!async->key || !async->mutex || !async->flush_cond || !async->space_cond || !async->batch)
+    {
+        axutil_log_impl_async_free(async);
+        return AXIS2_FAILURE;
+    }
+
+    async->running = 1;
+    log_impl->async = async;
+    async->flusher = axutil_thread_create(allocator, NULL, axutil_log_impl_flusher, log_impl);
+    if(!async->flusher)
+    {
+        log_impl->async = NULL;
+        axutil_log_impl_async_free(async);
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_log_flush(
+    axutil_log_t *log)
+{
+    axutil_log_impl_t *log_impl = NULL;
+
+    if(!log || log->ops != &axutil_log_ops_var)
+        return;
+    log_impl = AXUTIL_INTF_TO_IMPL(log);
+
+    if(log_impl->async)
+    {
+        axutil_thread_mutex_lock(log_impl->async->mutex);
+        axutil_log_impl_drain(log_impl, NULL, 0);
+        axutil_thread_mutex_unlock(log_impl->async->mutex);
+    }
+    else
+    {
+        axutil_thread_mutex_lock(log_impl->mutex);
+        if(log_impl->stream)
+            fflush(log_impl->stream);
+        axutil_thread_mutex_unlock(log_impl->mutex);
+    }
+}
+
+AXIS2_EXTERN unsigned long AXIS2_CALL
+axutil_log_get_dropped(
+    axutil_log_t *log)
+{
+    axutil_log_impl_t *log_impl = NULL;
+    axutil_log_ring_t *ring = NULL;
+    unsigned long dropped = 0;
+
+    if(!log || log->ops != &axutil_log_ops_var)
+        return 0;
+    log_impl = AXUTIL_INTF_TO_IMPL(log);
+    if(!log_impl->async)
+        return 0;
+
+    axutil_thread_mutex_lock(log_impl->async->mutex);
+    dropped = log_impl->async->dropped_freed;
+    for(ring = log_impl->async->rings; ring; ring = ring->next)
+    {
+        dropped += ring->dropped;
+    }
+    axutil_thread_mutex_unlock(log_impl->async->mutex);
+    return dropped;
+}
+
 static axis2_status_t
 axutil_log_impl_rotate(
     axutil_log_t *log)
@@ -297,12 +830,23 @@ axutil_log_impl_rotate(
     FILE *old_log_fd = NULL;
     axis2_char_t old_log_file_name[AXUTIL_LOG_FILE_NAME_SIZE];
     axutil_log_impl_t *log_impl = AXUTIL_INTF_TO_IMPL(log);
+    time_t now;
 
     /*If the log stream is a file*/
     if(log_impl->stream_type == AXUTIL_LOG_FILE)
     {
-        if(log_impl->file_name)
+        /* The size is counted as lines are written. As other processes may
+         * write to the same file, the file itself is looked at once a
+         * second and before rotating. */
+        now = time(NULL);
+        if(log_impl->file_name && (log_impl->file_size >= log->size || now
+            != log_impl->size_time))
+        {
             size = axutil_file_handler_size(log_impl->file_name);
+            log_impl->file_size = size;
+            log_impl->size_time = now;
+        }
+        size = log_impl->file_size;
 
         if(size >= log->size)
         {
@@ -328,6 +872,7 @@ axutil_log_impl_rotate(
                 axutil_file_handler_close(log_impl->stream);
             }
             log_impl->stream = axutil_file_handler_open(log_impl->file_name, "w+");
+            log_impl->file_size = 0;
         }
     }
     return AXIS2_SUCCESS;
@@ -485,18 +1030,9 @@ AXIS2_EXTERN axis2_char_t *AXIS2_CALL
 axutil_log_impl_get_time_str(
     void)
 {
-    time_t tp;
-    char *time_str;
-    tp = time(&tp);
-    time_str = ctime(&tp);
-    if(!time_str)
-    {
-        return NULL;
-    }
-    if('\n' == time_str[strlen(time_str) - 1])
-    {
-        time_str[strlen(time_str) - 1] = '\0';
-    }
+    static axis2_char_t time_str[AXUTIL_LOG_TIME_SIZE];
+
+    axutil_get_log_time(time_str);
     return time_str;
 }
 
@@ -524,6 +1060,9 @@ axutil_log_create_default(
 
     axutil_thread_mutex_lock(log_impl->mutex);
     log_impl->file_name = NULL;
+    log_impl->file_size = 0;
+    log_impl->size_time = 0;
+    log_impl->async = NULL;
     log_impl->log.size = AXUTIL_LOG_FILE_SIZE;
     log_impl->stream = stderr;
     /* This log doesn't own the stream (stderr) */
@@ -18,8 +18,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 #include <axutil_network_handler.h>
+#include <axutil_dns_cache.h>
 #include <fcntl.h>
+#ifndef WIN32
+#include <poll.h>
+#endif
 
 
 #if defined(WIN32)
@@ -35,16 +40,176 @@ axis2_bool_t axis2_init_socket(
 );
 #endif
 
+AXIS2_EXTERN void AXIS2_CALL
+axutil_socket_options_init(
+    axutil_socket_options_t *options)
+{
+    memset(options, 0, sizeof(axutil_socket_options_t));
+    options->nodelay = AXIS2_TRUE;
+}
+
+static long
+axutil_network_handler_get_ticks(
+    void)
+{
+#if defined(WIN32)
+    return (long)GetTickCount();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+static void
+axutil_network_handler_set_blocking(
+    axis2_socket_t sock,
+    axis2_bool_t blocking)
+{
+#if defined(WIN32)
+    u_long mode = blocking ? 0 : 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+#endif
+}
+
+/*
+ * Orders the addresses so that the address families alternate, starting
+ * with the family of the first address, as RFC 8305 suggests
+ */
+static void
+axutil_network_handler_interleave(
+    axutil_dns_addr_t *found,
+    int count,
+    axutil_dns_addr_t **addrs)
+{
+    int family = found[0].family;
+    int same = 0;
+    int other = 0;
+    int n = 0;
+
+    while(n < count)
+    {
+        while(same < count && found[same].family != family)
+        {
+            same++;
+        }
+        if(same < count)
+        {
+            addrs[n++] = &found[same++];
+        }
+        while(other < count && found[other].family == family)
+        {
+            other++;
+        }
+        if(other < count)
+        {
+            addrs[n++] = &found[other++];
+        }
+    }
+}
+
+/*
+ * Starts a non blocking connect to addr. Returns the socket, or
+ * AXIS2_INVALID_SOCKET if the connect failed at once; connected is set if
+ * it completed at once.
+ */
+static axis2_socket_t
+axutil_network_handler_start_connect(
+    const axutil_env_t *env,
+    const axutil_dns_addr_t *addr,
+    const axutil_socket_options_t *options,
+    axis2_bool_t *connected)
+{
+    axis2_socket_t sock = AXIS2_INVALID_SOCKET;
+
+#ifndef WIN32
+    if((sock = socket(addr->family, SOCK_STREAM, 0)) < 0)
+    {
+        return AXIS2_INVALID_SOCKET;
+    }
+#else
+    if ((sock = socket(addr->family, SOCK_STREAM, 0)) == INVALID_SOCKET)
+    /* In Win 32 if the socket creation failed it return 0 not a negative value */
+    {
+        char buf[AXUTIL_WIN32_ERROR_BUFSIZE];
+        /* Get the detailed error message */
+        axutil_win32_get_last_wsa_error(buf, AXUTIL_WIN32_ERROR_BUFSIZE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, buf);
+        return AXIS2_INVALID_SOCKET;
+    }
+#endif
+
+    /* buffer sizes must be set before the connect to affect window scaling */
+    if(options->send_buffer_size > 0)
+    {
+        setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char *)&options->send_buffer_size,
+            sizeof(options->send_buffer_size));
+    }
+    if(options->recv_buffer_size > 0)
+    {
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&options->recv_buffer_size,
+            sizeof(options->recv_buffer_size));
+    }
+
+    axutil_network_handler_set_blocking(sock, AXIS2_FALSE);
+    if(connect(sock, (struct sockaddr *)&addr->addr, addr->len) == 0)
+    {
+        *connected = AXIS2_TRUE;
+        return sock;
+    }
+#ifndef WIN32
+    if(errno == EINPROGRESS || errno == EINTR)
+#else
+    if(WSAGetLastError() == WSAEWOULDBLOCK)
+#endif
+    {
+        return sock;
+    }
+    AXIS2_CLOSE_SOCKET(sock);
+    return AXIS2_INVALID_SOCKET;
+}
+
 AXIS2_EXTERN axis2_socket_t AXIS2_CALL
 axutil_network_handler_open_socket(
     const axutil_env_t *env,
     char *server,
     int port)
+{
+    return axutil_network_handler_open_socket_with_options(env, server, port, NULL);
+}
+
+AXIS2_EXTERN axis2_socket_t AXIS2_CALL
+axutil_network_handler_open_socket_with_options(
+    const axutil_env_t *env,
+    char *server,
+    int port,
+    const axutil_socket_options_t *options)
 {
     axis2_socket_t sock = AXIS2_INVALID_SOCKET;
-    struct sockaddr_in sock_addr;
+    axutil_socket_options_t defaults;
+    axutil_dns_addr_t found[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    axutil_dns_addr_t *addrs[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    struct pollfd fds[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    axis2_bool_t connected = AXIS2_FALSE;
+    axis2_bool_t timed_out = AXIS2_FALSE;
     struct linger ll;
     int nodelay = 1;
+    int keepalive = 1;
+    long start = 0;
+    long now = 0;
+    long next_start = 0;
+    long wait = 0;
+    int count = 0;
+    int pending = 0;
+    int next = 0;
+    int i = 0;
 
 #if defined(WIN32)
     if (is_init_socket == 0)
@@ -57,60 +222,133 @@ axutil_network_handler_open_socket(
     AXIS2_ENV_CHECK(env, AXIS2_CRITICAL_FAILURE);
     AXIS2_PARAM_CHECK(env->error, server, AXIS2_INVALID_SOCKET);
 
-#ifndef WIN32
-    if((sock = socket(AF_INET, SOCK_STREAM, 0)) < 0)
-    /*AF_INET is not defined in sys/socket.h but PF_INET */
+    if(!options)
     {
-        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
-        return AXIS2_INVALID_SOCKET;
+        axutil_socket_options_init(&defaults);
+        options = &defaults;
     }
-#else
-    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
-    /* In Win 32 if the socket creation failed it return 0 not a negative value */
+
+    count = axutil_dns_cache_resolve(env, server, port, found, AXUTIL_DNS_CACHE_MAX_ADDRS);
+    if(!count)
     {
-        char buf[AXUTIL_WIN32_ERROR_BUFSIZE];
-        /* Get the detailed error message */
-        axutil_win32_get_last_wsa_error(buf, AXUTIL_WIN32_ERROR_BUFSIZE);
-        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, buf);
-        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
         return AXIS2_INVALID_SOCKET;
     }
-#endif 
-
-    memset(&sock_addr, 0, sizeof(sock_addr));
-    sock_addr.sin_family = AF_INET;
-    sock_addr.sin_addr.s_addr = inet_addr(server); /*arpa/inet.d */
+    axutil_network_handler_interleave(found, count, addrs);
 
-    if(sock_addr.sin_addr.s_addr == AXIS2_INADDR_NONE) /*netinet/in.h */
+    /*
+     * Connect to the addresses in turn, starting the next one when the
+     * earlier ones fail or have not connected within the connect delay,
+     * and keep the first that connects
+     */
+    start = now = axutil_network_handler_get_ticks();
+    while(!connected)
     {
-        /*
-         * server may be a host name
-         */
-        struct hostent *lphost = NULL;
-        lphost = gethostbyname(server);
+        if(next < count && (!pending || now >= next_start))
+        {
+            sock = axutil_network_handler_start_connect(env, addrs[next++], options, &connected);
+            if(sock == AXIS2_INVALID_SOCKET)
+            {
+                next_start = now;
+            }
+            else if(!connected)
+            {
+                fds[pending].fd = sock;
+                fds[pending].events = POLLOUT;
+                fds[pending].revents = 0;
+                pending++;
+                next_start = now + AXUTIL_NETWORK_HANDLER_CONNECT_DELAY;
+            }
+            continue;
+        }
+        if(!pending)
+        {
+            break;
+        }
 
-        if(lphost)
+        wait = -1;
+        if(options->connect_timeout > 0)
         {
-            sock_addr.sin_addr.s_addr = ((struct in_addr *)lphost->h_addr)->s_addr;
+            wait = start + options->connect_timeout - now;
+            if(wait <= 0)
+            {
+                timed_out = AXIS2_TRUE;
+                break;
+            }
         }
-        else
+        if(next < count && (wait < 0 || next_start - now < wait))
         {
+            wait = next_start - now;
+        }
+
+#ifndef WIN32
+        if(poll(fds, pending, (int)wait) < 0 && errno != EINTR)
+#else
+        if(WSAPoll(fds, pending, (int)wait) == SOCKET_ERROR)
+#endif
+        {
+            break;
+        }
+        for(i = 0; i < pending;)
+        {
+            int error = 0;
+            axis2_socket_len_t len = sizeof(error);
+
+            if(!fds[i].revents)
+            {
+                i++;
+                continue;
+            }
+            sock = fds[i].fd;
+            fds[i] = fds[--pending];
+            if(!getsockopt(sock, SOL_SOCKET, SO_ERROR, (char *)&error, &len) && !error)
+            {
+                connected = AXIS2_TRUE;
+                break;
+            }
             AXIS2_CLOSE_SOCKET(sock);
-            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_ADDRESS, AXIS2_FAILURE);
-            return AXIS2_INVALID_SOCKET;
+            next_start = 0;
         }
+        now = axutil_network_handler_get_ticks();
     }
 
-    sock_addr.sin_port = htons((axis2_unsigned_short_t)port);
-
-    /* Connect to server */
-    if(connect(sock, (struct sockaddr *)&sock_addr, sizeof(sock_addr)) < 0)
+    for(i = 0; i < pending; i++)
     {
-        AXIS2_CLOSE_SOCKET(sock);
+        AXIS2_CLOSE_SOCKET(fds[i].fd);
+    }
+    if(!connected)
+    {
+        /* the cached addresses may be stale, so look the host up afresh next time */
+        axutil_dns_cache_invalidate(env, server);
+        if(timed_out)
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Connecting to %s:%d timed out after %d ms",
+                server, port, options->connect_timeout);
+        }
+        else
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unable to connect to %s:%d", server, port);
+        }
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
         return AXIS2_INVALID_SOCKET;
     }
-    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay, sizeof(nodelay));
+
+    axutil_network_handler_set_blocking(sock, AXIS2_TRUE);
+    if(options->nodelay)
+    {
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay, sizeof(nodelay));
+    }
+    if(options->keepalive)
+    {
+        setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const char *)&keepalive, sizeof(keepalive));
+    }
+#ifdef TCP_USER_TIMEOUT
+    if(options->user_timeout > 0)
+    {
+        unsigned int user_timeout = (unsigned int)options->user_timeout;
+        setsockopt(sock, IPPROTO_TCP, TCP_USER_TIMEOUT, (const char *)&user_timeout,
+            sizeof(user_timeout));
+    }
+#endif
     ll.l_onoff = 1;
     ll.l_linger = 5;
     setsockopt(sock, SOL_SOCKET, SO_LINGER, (const char *)&ll, sizeof(struct linger));
@@ -481,6 +719,9 @@ axutil_network_handler_send_dgram(
     int *source_port)
 {
     struct sockaddr_in recv_addr, source_addr;
+    axutil_dns_addr_t addrs[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    int count = 0;
+    int i = 0;
     int send_bytes = 0;
     unsigned int recv_addr_size = 0;
     socklen_t source_addr_size = sizeof(source_addr);
@@ -489,28 +730,21 @@ axutil_network_handler_send_dgram(
     memset(&recv_addr, 0, sizeof(recv_addr));
     memset(&recv_addr, 0, sizeof(source_addr));
 
-    recv_addr.sin_addr.s_addr = inet_addr(addr);
-    if(recv_addr.sin_addr.s_addr == AXIS2_INADDR_NONE) /*netinet/in.h */
+    /* The datagram sockets are IPv4, so take the first IPv4 address */
+    count = axutil_dns_cache_resolve(env, addr, dest_port, addrs, AXUTIL_DNS_CACHE_MAX_ADDRS);
+    for(i = 0; i < count; i++)
     {
-        /*
-         * server may be a host name
-         */
-        struct hostent *lphost = NULL;
-        lphost = gethostbyname(addr);
-
-        if(lphost)
+        if(AF_INET == addrs[i].family)
         {
-            recv_addr.sin_addr.s_addr = ((struct in_addr *)lphost->h_addr)->s_addr;
-        }
-        else
-        {
-            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_ADDRESS, AXIS2_FAILURE);
-            return AXIS2_FAILURE;
+            break;
         }
     }
-
-    recv_addr.sin_family = AF_INET;
-    recv_addr.sin_port = htons((axis2_unsigned_short_t)dest_port);
+    if(i == count)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_ADDRESS, AXIS2_FAILURE);
+        return AXIS2_FAILURE;
+    }
+    memcpy(&recv_addr, &addrs[i].addr, sizeof(recv_addr));
 
     send_bytes = sendto(sock, buff, *buf_len, 0, (struct sockaddr *)&recv_addr, recv_addr_size);
 
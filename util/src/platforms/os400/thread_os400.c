@@ -18,6 +18,7 @@
 
 
 #include "axutil_thread_os400.h"
+#include <sys/time.h>
 
 AXIS2_EXTERN axutil_threadattr_t *AXIS2_CALL
 axutil_threadattr_create(
@@ -202,6 +203,22 @@ axutil_thread_detach(
     return AXIS2_FAILURE;
 }
 
+AXIS2_EXTERN void AXIS2_CALL
+axutil_thread_free(
+    axutil_thread_t * thd,
+    axutil_allocator_t * allocator)
+{
+    if (!thd)
+    {
+        return;
+    }
+    if (thd->td)
+    {
+        AXIS2_FREE(allocator, thd->td);
+    }
+    AXIS2_FREE(allocator, thd);
+}
+
 void
 axutil_thread_yield(
     void)
@@ -268,6 +285,38 @@ axutil_thread_key_free(
     pthread_key_delete(key);
 }
 
+AXIS2_EXTERN axutil_threadkey_t *AXIS2_CALL
+axutil_threadkey_create(
+    axutil_allocator_t * allocator,
+    axutil_threadkey_destructor_t destructor)
+{
+    axutil_threadkey_t *key = NULL;
+
+    key = AXIS2_MALLOC(allocator, sizeof(axutil_threadkey_t));
+    if(!key)
+    {
+        return NULL;
+    }
+    if(pthread_key_create(&key->key, (void (*)(void *))destructor) != 0)
+    {
+        AXIS2_FREE(allocator, key);
+        return NULL;
+    }
+    return key;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_threadkey_free(
+    axutil_threadkey_t * key,
+    axutil_allocator_t * allocator)
+{
+    if(key)
+    {
+        pthread_key_delete(key->key);
+        AXIS2_FREE(allocator, key);
+    }
+}
+
 AXIS2_EXTERN axis2_os_thread_t *AXIS2_CALL
 axis2_os_thread_get(
     axutil_thread_t * thd)
@@ -351,3 +400,96 @@ axutil_thread_mutex_destroy(
     AXIS2_FREE(mutex->allocator, mutex);
     return AXIS2_SUCCESS;
 }
+
+/*************************Condition variable functions*************************/
+AXIS2_EXTERN axutil_thread_cond_t *AXIS2_CALL
+axutil_thread_cond_create(
+    axutil_allocator_t * allocator)
+{
+    axutil_thread_cond_t *new_cond = NULL;
+
+    new_cond = AXIS2_MALLOC(allocator, sizeof(axutil_thread_cond_t));
+    if (!new_cond)
+    {
+        return NULL;
+    }
+    new_cond->allocator = allocator;
+
+    if (pthread_cond_init(&(new_cond->cond), NULL) != 0)
+    {
+        AXIS2_FREE(allocator, new_cond);
+        return NULL;
+    }
+    return new_cond;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_wait(
+    axutil_thread_cond_t * cond,
+    axutil_thread_mutex_t * mutex)
+{
+    if (pthread_cond_wait(&(cond->cond), &(mutex->mutex)) != 0)
+    {
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_timedwait(
+    axutil_thread_cond_t * cond,
+    axutil_thread_mutex_t * mutex,
+    long timeout_ms)
+{
+    struct timeval now;
+    struct timespec abstime;
+
+    gettimeofday(&now, NULL);
+    abstime.tv_sec = now.tv_sec + timeout_ms / 1000;
+    abstime.tv_nsec = (now.tv_usec + (timeout_ms % 1000) * 1000) * 1000;
+    if (abstime.tv_nsec >= 1000000000)
+    {
+        abstime.tv_sec++;
+        abstime.tv_nsec -= 1000000000;
+    }
+
+    if (pthread_cond_timedwait(&(cond->cond), &(mutex->mutex), &abstime) != 0)
+    {
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_signal(
+    axutil_thread_cond_t * cond)
+{
+    if (pthread_cond_signal(&(cond->cond)) != 0)
+    {
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_broadcast(
+    axutil_thread_cond_t * cond)
+{
+    if (pthread_cond_broadcast(&(cond->cond)) != 0)
+    {
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_destroy(
+    axutil_thread_cond_t * cond)
+{
+    if (0 != pthread_cond_destroy(&(cond->cond)))
+    {
+        return AXIS2_FAILURE;
+    }
+    AXIS2_FREE(cond->allocator, cond);
+    return AXIS2_SUCCESS;
+}
@@ -187,6 +187,34 @@ axutil_platform_uuid_gen(
     return uuid_str;
 }
 
+axis2_status_t AXIS2_CALL
+axutil_platform_uuid_random(
+    unsigned char *buf,
+    int len)
+{
+    int fd = -1;
+    ssize_t got = 0;
+
+    fd = open("/dev/urandom", O_RDONLY);
+    if(fd < 0)
+    {
+        return AXIS2_FAILURE;
+    }
+    while(len > 0)
+    {
+        got = read(fd, buf, len);
+        if(got <= 0)
+        {
+            close(fd);
+            return AXIS2_FAILURE;
+        }
+        buf += got;
+        len -= (int)got;
+    }
+    close(fd);
+    return AXIS2_SUCCESS;
+}
+
 char *AXIS2_CALL
 axutil_uuid_get_mac_addr(
     )
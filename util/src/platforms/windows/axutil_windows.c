@@ -58,6 +58,14 @@ axis2_win_gmtime(
     return gmtime(timep);
 }
 
+AXIS2_EXTERN struct tm *AXIS2_CALL
+axis2_win_localtime(
+    const time_t * timep,
+    struct tm *result)
+{
+    return localtime_s(result, timep) ? NULL : result;
+}
+
 AXIS2_EXTERN void AXIS2_CALL
 axutil_win32_get_last_error(
     axis2_char_t *buf,
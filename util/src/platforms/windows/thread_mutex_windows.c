@@ -146,3 +146,108 @@ axutil_thread_mutex_destroy(
 {
     return thread_mutex_cleanup((void *)mutex);
 }
+
+/*************************Condition variable functions*************************/
+AXIS2_EXTERN axutil_thread_cond_t *AXIS2_CALL
+axutil_thread_cond_create(
+    axutil_allocator_t * allocator)
+{
+    axutil_thread_cond_t *cond = NULL;
+
+    cond = (axutil_thread_cond_t *)AXIS2_MALLOC(allocator, sizeof(axutil_thread_cond_t));
+    if(!cond)
+    {
+        return NULL;
+    }
+    cond->allocator = allocator;
+    cond->num_waiting = 0;
+    cond->semaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+    if(!cond->semaphore)
+    {
+        AXIS2_FREE(allocator, cond);
+        return NULL;
+    }
+    return cond;
+}
+
+static axis2_status_t
+thread_cond_wait(
+    axutil_thread_cond_t * cond,
+    axutil_thread_mutex_t * mutex,
+    DWORD timeout_ms)
+{
+    DWORD rv;
+
+    /* num_waiting is protected by the caller's mutex */
+    cond->num_waiting++;
+    axutil_thread_mutex_unlock(mutex);
+    rv = WaitForSingleObject(cond->semaphore, timeout_ms);
+    axutil_thread_mutex_lock(mutex);
+    if(rv != WAIT_OBJECT_0)
+    {
+        cond->num_waiting--;
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_wait(
+    axutil_thread_cond_t * cond,
+    axutil_thread_mutex_t * mutex)
+{
+    return thread_cond_wait(cond, mutex, INFINITE);
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_timedwait(
+    axutil_thread_cond_t * cond,
+    axutil_thread_mutex_t * mutex,
+    long timeout_ms)
+{
+    return thread_cond_wait(cond, mutex, (DWORD)timeout_ms);
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_signal(
+    axutil_thread_cond_t * cond)
+{
+    if(cond->num_waiting > 0)
+    {
+        cond->num_waiting--;
+        if(!ReleaseSemaphore(cond->semaphore, 1, NULL))
+        {
+            return AXIS2_FAILURE;
+        }
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_broadcast(
+    axutil_thread_cond_t * cond)
+{
+    long waiting = cond->num_waiting;
+
+    if(waiting > 0)
+    {
+        cond->num_waiting = 0;
+        if(!ReleaseSemaphore(cond->semaphore, waiting, NULL))
+        {
+            return AXIS2_FAILURE;
+        }
+    }
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_cond_destroy(
+    axutil_thread_cond_t * cond)
+{
+    if(!CloseHandle(cond->semaphore))
+    {
+        return AXIS2_FAILURE;
+    }
+    AXIS2_FREE(cond->allocator, cond);
+    return AXIS2_SUCCESS;
+}
@@ -227,6 +227,22 @@ axutil_thread_detach(
     }
 }
 
+AXIS2_EXTERN void AXIS2_CALL
+axutil_thread_free(
+    axutil_thread_t * thd,
+    axutil_allocator_t * allocator)
+{
+    if(!thd)
+    {
+        return;
+    }
+    if(thd->td)
+    {
+        CloseHandle(thd->td);
+    }
+    AXIS2_FREE(allocator, thd);
+}
+
 AXIS2_EXTERN axis2_os_thread_t AXIS2_CALL
 axis2_os_thread_get(
     axutil_thread_t * thd,
@@ -251,6 +267,8 @@ axutil_thread_key_create(
     }
     else
     {
+        axis2_key->key = tls_key;
+        axis2_key->fls = 0;
         return AXIS2_SUCCESS;
     }
 }
@@ -265,7 +283,10 @@ axutil_thread_getspecific(
 {
     void *value = NULL;
     DWORD tls_key = axis2_key->key;
-    value = TlsGetValue(tls_key);
+    if(axis2_key->fls)
+        value = FlsGetValue(tls_key);
+    else
+        value = TlsGetValue(tls_key);
     return value;
 }
 
@@ -280,7 +301,7 @@ axutil_thread_setspecific(
     void *value)
 {
     DWORD tls_key = axis2_key->key;
-    if(!TlsSetValue(tls_key, value))
+    if(!(axis2_key->fls ? FlsSetValue(tls_key, value) : TlsSetValue(tls_key, value)))
     {
         return AXIS2_FAILURE;
     }
@@ -295,7 +316,45 @@ axutil_thread_key_free(
     axutil_threadkey_t * axis2_key)
 {
     DWORD tls_key = axis2_key->key;
-    TlsFree(tls_key);
+    if(axis2_key->fls)
+        FlsFree(tls_key);
+    else
+        TlsFree(tls_key);
+}
+
+AXIS2_EXTERN axutil_threadkey_t *AXIS2_CALL
+axutil_threadkey_create(
+    axutil_allocator_t * allocator,
+    axutil_threadkey_destructor_t destructor)
+{
+    axutil_threadkey_t *key = NULL;
+
+    key = AXIS2_MALLOC(allocator, sizeof(axutil_threadkey_t));
+    if(!key)
+    {
+        return NULL;
+    }
+    /* unlike TLS, fiber local storage calls a destructor at thread exit */
+    key->key = FlsAlloc((PFLS_CALLBACK_FUNCTION)destructor);
+    if(key->key == FLS_OUT_OF_INDEXES)
+    {
+        AXIS2_FREE(allocator, key);
+        return NULL;
+    }
+    key->fls = 1;
+    return key;
+}
+
+AXIS2_EXTERN void AXIS2_CALL
+axutil_threadkey_free(
+    axutil_threadkey_t * key,
+    axutil_allocator_t * allocator)
+{
+    if(key)
+    {
+        axutil_thread_key_free(key);
+        AXIS2_FREE(allocator, key);
+    }
 }
 
 AXIS2_EXTERN axutil_thread_once_t *AXIS2_CALL
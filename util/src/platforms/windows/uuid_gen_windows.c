@@ -15,11 +15,15 @@
  * limitations under the License.
  */
 
+/* rand_s is only declared when this is defined before stdlib.h */
+#define _CRT_RAND_S
+#include <stdlib.h>
 #include <platforms/windows/axutil_uuid_gen_windows.h>
 #include <rpc.h>
 #include <stdio.h>
 #include <string.h>
 #include <axutil_utils_defines.h>
+#include <axutil_error.h>
 
 AXIS2_EXTERN axis2_char_t * AXIS2_CALL
 axutil_platform_uuid_gen(
@@ -59,3 +63,25 @@ axutil_platform_uuid_gen(
     }
     return retstr;
 }
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_platform_uuid_random(
+    unsigned char *buf,
+    int len)
+{
+    unsigned int value;
+    int i;
+
+    while(len > 0)
+    {
+        if(rand_s(&value) != 0)
+        {
+            return AXIS2_FAILURE;
+        }
+        for(i = 0; i < 4 && len > 0; i++, len--)
+        {
+            *buf++ = (unsigned char)(value >> (i * 8));
+        }
+    }
+    return AXIS2_SUCCESS;
+}
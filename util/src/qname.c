@@ -37,8 +37,30 @@ struct axutil_qname
     /** qname represented as a string, used as keys in hash tables, etc. */
     axis2_char_t *qname_string;
     unsigned int ref;
+
+    /** the parts that are atoms, which are shared and not freed */
+    axis2_bool_t localpart_interned;
+    axis2_bool_t namespace_uri_interned;
+    axis2_bool_t prefix_interned;
 };
 
+/* Interns the given part of a qname, or copies it if it cannot be interned */
+static axis2_char_t *
+axutil_qname_intern(
+    const axutil_env_t *env,
+    const axis2_char_t *str,
+    axis2_bool_t *interned)
+{
+    axis2_char_t *atom = (axis2_char_t *)axutil_string_intern_buffer(str);
+
+    *interned = (atom != NULL);
+    if(atom)
+    {
+        return atom;
+    }
+    return (axis2_char_t *)axutil_strdup(env, str);
+}
+
 AXIS2_EXTERN axutil_qname_t *AXIS2_CALL
 axutil_qname_create(
     const axutil_env_t *env,
@@ -72,8 +94,11 @@ axutil_qname_create(
     qname->prefix = NULL;
     qname->namespace_uri = NULL;
     qname->ref = 1;
+    qname->localpart_interned = AXIS2_FALSE;
+    qname->namespace_uri_interned = AXIS2_FALSE;
+    qname->prefix_interned = AXIS2_FALSE;
 
-    qname->localpart = (axis2_char_t *)axutil_strdup(env, localpart);
+    qname->localpart = axutil_qname_intern(env, localpart, &qname->localpart_interned);
     if(!(qname->localpart))
     {
         AXIS2_ERROR_SET_ERROR_NUMBER(env->error, AXIS2_ERROR_NO_MEMORY);
@@ -85,7 +110,7 @@ axutil_qname_create(
 
     if(prefix)
     {
-        qname->prefix = (axis2_char_t *)axutil_strdup(env, prefix);
+        qname->prefix = axutil_qname_intern(env, prefix, &qname->prefix_interned);
     }
 
     if(prefix && !(qname->prefix))
@@ -99,7 +124,8 @@ axutil_qname_create(
 
     if(namespace_uri)
     {
-        qname->namespace_uri = (axis2_char_t *)axutil_strdup(env, namespace_uri);
+        qname->namespace_uri = axutil_qname_intern(env, namespace_uri,
+            &qname->namespace_uri_interned);
     }
 
     if(namespace_uri && !(qname->namespace_uri))
@@ -127,15 +153,15 @@ axutil_qname_free(
         return;
     }
 
-    if(qname->localpart)
+    if(qname->localpart && !qname->localpart_interned)
     {
         AXIS2_FREE(env->allocator, qname->localpart);
     }
-    if(qname->namespace_uri)
+    if(qname->namespace_uri && !qname->namespace_uri_interned)
     {
         AXIS2_FREE(env->allocator, qname->namespace_uri);
     }
-    if(qname->prefix)
+    if(qname->prefix && !qname->prefix_interned)
     {
         AXIS2_FREE(env->allocator, qname->prefix);
     }
@@ -169,7 +195,16 @@ axutil_qname_equals(
         return AXIS2_FALSE;
     }
 
-    if(qname->localpart && qname2->localpart)
+    /* atoms are equal only if they are the same */
+    if(qname->localpart == qname2->localpart)
+    {
+        localparts_differ = 0;
+    }
+    else if(qname->localpart_interned && qname2->localpart_interned)
+    {
+        localparts_differ = 1;
+    }
+    else if(qname->localpart && qname2->localpart)
     {
         localparts_differ = axutil_strcmp(qname->localpart, qname2->localpart);
     }
@@ -178,7 +213,15 @@ axutil_qname_equals(
         localparts_differ = ((qname->localpart) || (qname2->localpart));
     }
 
-    if(qname->namespace_uri && qname2->namespace_uri)
+    if(qname->namespace_uri == qname2->namespace_uri)
+    {
+        uris_differ = 0;
+    }
+    else if(qname->namespace_uri_interned && qname2->namespace_uri_interned)
+    {
+        uris_differ = 1;
+    }
+    else if(qname->namespace_uri && qname2->namespace_uri)
     {
         uris_differ = axutil_strcmp(qname->namespace_uri, qname2->namespace_uri);
     }
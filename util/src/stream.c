@@ -18,7 +18,18 @@
 #include <string.h>
 #include <stdlib.h>
 #include <axutil_stream.h>
+#include <axutil_buffer_chain.h>
 #include <platforms/axutil_platform_auto_sense.h>
+#ifndef WIN32
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+
+/* segments handed to the system in one gather write */
+#define AXUTIL_STREAM_IOV_BATCH 16
 
 /** basic stream operatons **/
 int AXIS2_CALL axutil_stream_write_basic(
@@ -38,6 +49,24 @@ int AXIS2_CALL axutil_stream_skip_basic(
     const axutil_env_t *env,
     int count);
 
+/** chain stream operations **/
+int AXIS2_CALL axutil_stream_write_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count);
+
+int AXIS2_CALL axutil_stream_read_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count);
+
+int AXIS2_CALL axutil_stream_skip_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    int count);
+
 /** file stream operations **/
 int AXIS2_CALL axutil_stream_write_file(
     axutil_stream_t *stream,
@@ -74,6 +103,30 @@ int AXIS2_CALL axutil_stream_skip_socket(
     const axutil_env_t *env,
     int count);
 
+int AXIS2_CALL axutil_stream_write_corked_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count);
+
+/** buffered socket stream operations **/
+int AXIS2_CALL axutil_stream_read_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count);
+
+int AXIS2_CALL axutil_stream_skip_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    int count);
+
+int AXIS2_CALL axutil_stream_peek_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count);
+
 AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
 axutil_stream_create_internal(
     const axutil_env_t *env)
@@ -93,6 +146,9 @@ axutil_stream_create_internal(
     stream->len = -1;
     stream->max_len = -1;
     stream->axis2_eof = EOF;
+    stream->cork_buffer = NULL;
+    stream->cork_len = -1;
+    stream->chain = NULL;
 
     return stream;
 }
@@ -122,6 +178,19 @@ axutil_stream_free(
             stream->len = -1;
             break;
         }
+        case AXIS2_STREAM_CHAIN:
+        {
+            if(stream->chain)
+            {
+                axutil_buffer_chain_free(stream->chain, env);
+            }
+            if(stream->buffer_head)
+            {
+                AXIS2_FREE(env->allocator, stream->buffer_head);
+            }
+            stream->len = -1;
+            break;
+        }
         case AXIS2_STREAM_FILE:
         {
             stream->fp = NULL;
@@ -134,6 +203,14 @@ axutil_stream_free(
             {
                 fclose(stream->fp);
             }
+            if(stream->buffer_head)
+            {
+                AXIS2_FREE(env->allocator, stream->buffer_head);
+            }
+            if(stream->cork_buffer)
+            {
+                AXIS2_FREE(env->allocator, stream->cork_buffer);
+            }
             stream->socket = -1;
             stream->len = -1;
             break;
@@ -157,11 +234,22 @@ axutil_stream_free_void_arg(
     return;
 }
 
+static axis2_status_t
+axutil_stream_send_cork(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count);
+
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
 axutil_stream_flush(
     axutil_stream_t *stream,
     const axutil_env_t *env)
 {
+    if(AXIS2_STREAM_SOCKET == stream->stream_type && stream->cork_len > 0)
+    {
+        return axutil_stream_send_cork(stream, env, NULL, 0);
+    }
     if(stream->fp)
     {
         if(fflush(stream->fp))
@@ -189,6 +277,22 @@ axutil_stream_close(
             stream->len = -1;
             break;
         }
+        case AXIS2_STREAM_CHAIN:
+        {
+            if(stream->chain)
+            {
+                axutil_buffer_chain_free(stream->chain, env);
+            }
+            if(stream->buffer_head)
+            {
+                AXIS2_FREE(env->allocator, stream->buffer_head);
+            }
+            stream->chain = NULL;
+            stream->buffer = NULL;
+            stream->buffer_head = NULL;
+            stream->len = -1;
+            break;
+        }
         case AXIS2_STREAM_FILE:
         {
             if(stream->fp)
@@ -211,6 +315,19 @@ axutil_stream_close(
                     return AXIS2_FAILURE;
                 }
             }
+            if(stream->buffer_head)
+            {
+                AXIS2_FREE(env->allocator, stream->buffer_head);
+            }
+            if(stream->cork_buffer)
+            {
+                AXIS2_FREE(env->allocator, stream->cork_buffer);
+            }
+            stream->buffer = NULL;
+            stream->buffer_head = NULL;
+            stream->cork_buffer = NULL;
+            stream->cork_len = -1;
+            stream->write = axutil_stream_write_socket;
             stream->socket = -1;
             stream->len = -1;
             break;
@@ -341,6 +458,11 @@ axutil_stream_get_len(
     axutil_stream_t *stream,
     const axutil_env_t *env)
 {
+    if(AXIS2_STREAM_CHAIN == stream->stream_type)
+    {
+        /* the chain may have been appended to directly */
+        stream->len = (int)axutil_buffer_chain_get_len(stream->chain, env);
+    }
     return stream->len;
 }
 
@@ -369,21 +491,55 @@ axutil_stream_skip_basic(
     return -1;
 }
 
+/* Copies the data of a chain stream into buffer_head */
+static axis2_char_t *
+axutil_stream_flatten_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env)
+{
+    axis2_char_t *buffer = NULL;
+
+    buffer = axutil_buffer_chain_flatten(stream->chain, env);
+    if(!buffer)
+    {
+        return NULL;
+    }
+    stream->len = (int)axutil_buffer_chain_get_len(stream->chain, env);
+    if(stream->buffer_head)
+    {
+        AXIS2_FREE(env->allocator, stream->buffer_head);
+    }
+    stream->buffer = buffer;
+    stream->buffer_head = buffer;
+    stream->max_len = stream->len + 1;
+    return buffer;
+}
+
 AXIS2_EXTERN axis2_char_t *AXIS2_CALL
 axutil_stream_get_buffer(
     const axutil_stream_t *stream,
     const axutil_env_t *env)
 {
+    if(AXIS2_STREAM_CHAIN == stream->stream_type)
+    {
+        /* the data stays in the chain, buffer_head is only a copy of it */
+        return axutil_stream_flatten_chain((axutil_stream_t *)stream, env);
+    }
     return stream->buffer;
 }
 
 AXIS2_EXTERN int AXIS2_CALL
 axutil_stream_set_buffer_end_null(
     axutil_stream_t *stream,
-    axutil_env_t *env)
+    const axutil_env_t *env)
 {
     if (!stream || !env) return -1;
 
+    if(AXIS2_STREAM_CHAIN == stream->stream_type)
+    {
+        return axutil_stream_flatten_chain(stream, env) ? stream->len + 1 : -1;
+    }
+
     if (stream->len + 1 >= stream->max_len) {
 
         axis2_char_t *tmp = (axis2_char_t *)AXIS2_MALLOC(env->allocator,
@@ -409,12 +565,110 @@ axutil_stream_flush_buffer(
     axutil_stream_t *stream,
     const axutil_env_t *env)
 {
+    if(AXIS2_STREAM_CHAIN == stream->stream_type)
+    {
+        axutil_buffer_chain_consume(stream->chain, env,
+            axutil_buffer_chain_get_len(stream->chain, env));
+    }
     stream->len = 0;
     return AXIS2_SUCCESS;
 }
 
 /********************* End of Basic Stream Operations *************************/
 
+/************************** Chain Stream Operations ***************************/
+AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
+axutil_stream_create_chain(
+    const axutil_env_t *env)
+{
+    axutil_stream_t *stream = NULL;
+
+    AXIS2_ENV_CHECK(env, NULL);
+    stream = axutil_stream_create_internal(env);
+    if(!stream)
+    {
+        return NULL;
+    }
+    stream->stream_type = AXIS2_STREAM_CHAIN;
+    stream->read = axutil_stream_read_chain;
+    stream->write = axutil_stream_write_chain;
+    stream->skip = axutil_stream_skip_chain;
+    stream->len = 0;
+    stream->chain = axutil_buffer_chain_create(env);
+    if(!stream->chain)
+    {
+        axutil_stream_free(stream, env);
+        return NULL;
+    }
+    return stream;
+}
+
+AXIS2_EXTERN struct axutil_buffer_chain *AXIS2_CALL
+axutil_stream_get_chain(
+    const axutil_stream_t *stream,
+    const axutil_env_t *env)
+{
+    return AXIS2_STREAM_CHAIN == stream->stream_type ? stream->chain : NULL;
+}
+
+int AXIS2_CALL
+axutil_stream_read_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count)
+{
+    int len = 0;
+
+    if(!buffer)
+    {
+        return -1;
+    }
+    len = (int)axutil_buffer_chain_read(stream->chain, env, buffer, count);
+    stream->len = (int)axutil_buffer_chain_get_len(stream->chain, env);
+    return len;
+}
+
+int AXIS2_CALL
+axutil_stream_write_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count)
+{
+    if(!buffer)
+    {
+        return -1;
+    }
+    if(axutil_buffer_chain_append(stream->chain, env, buffer, count) != AXIS2_SUCCESS)
+    {
+        return -1;
+    }
+    stream->len = (int)axutil_buffer_chain_get_len(stream->chain, env);
+    return (int)count;
+}
+
+int AXIS2_CALL
+axutil_stream_skip_chain(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    int count)
+{
+    if(count <= 0)
+    {
+        return -1;
+    }
+    if(count > axutil_stream_get_len(stream, env))
+    {
+        count = stream->len;
+    }
+    axutil_buffer_chain_consume(stream->chain, env, (size_t)count);
+    stream->len -= count;
+    return count;
+}
+
+/*********************** End of Chain Stream Operations ***********************/
+
 /************************** File Stream Operations ****************************/
 AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
 axutil_stream_create_file(
@@ -693,6 +947,444 @@ axutil_stream_peek_socket(
     return len;
 }
 
+/*
+ * A buffered socket stream keeps its read ahead buffer in buffer_head, with
+ * max_len bytes of room. buffer points to the next byte to hand out and len
+ * is the number of bytes left from there.
+ */
+AXIS2_EXTERN axutil_stream_t *AXIS2_CALL
+axutil_stream_create_buffered_socket(
+    const axutil_env_t *env,
+    int socket,
+    int buffer_size)
+{
+    axutil_stream_t *stream = NULL;
+
+    stream = axutil_stream_create_socket(env, socket);
+    if(!stream)
+    {
+        return NULL;
+    }
+    if(buffer_size <= 0)
+    {
+        buffer_size = AXIS2_STREAM_SOCKET_BUF_SIZE;
+    }
+    stream->buffer_head = (axis2_char_t *)AXIS2_MALLOC(env->allocator, buffer_size
+        * sizeof(axis2_char_t));
+    if(!stream->buffer_head)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory. Cannot create socket buffer");
+        axutil_stream_free(stream, env);
+        return NULL;
+    }
+    stream->buffer = stream->buffer_head;
+    stream->len = 0;
+    stream->max_len = buffer_size;
+    stream->read = axutil_stream_read_buffered_socket;
+    stream->skip = axutil_stream_skip_buffered_socket;
+    stream->peek = axutil_stream_peek_buffered_socket;
+
+    return stream;
+}
+
+/* Refills the empty read ahead buffer with a single recv */
+static int
+axutil_stream_fill_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env)
+{
+    int len = 0;
+
+    len = axutil_stream_read_socket(stream, env, stream->buffer_head, stream->max_len);
+    stream->buffer = stream->buffer_head;
+    stream->len = len > 0 ? len : 0;
+    return len;
+}
+
+int AXIS2_CALL
+axutil_stream_read_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count)
+{
+    int len = 0;
+
+    if(!buffer)
+    {
+        return -1;
+    }
+    if(stream->len <= 0)
+    {
+        /* reads that would fill the whole buffer go straight to the caller */
+        if(count >= (size_t)stream->max_len)
+        {
+            return axutil_stream_read_socket(stream, env, buffer, count);
+        }
+        len = axutil_stream_fill_buffered_socket(stream, env);
+        if(len <= 0)
+        {
+            return len;
+        }
+    }
+
+    len = (size_t)stream->len < count ? stream->len : (int)count;
+    memcpy(buffer, stream->buffer, len);
+    stream->buffer += len;
+    stream->len -= len;
+    return len;
+}
+
+int AXIS2_CALL
+axutil_stream_skip_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    int count)
+{
+    int skipped = 0;
+    int len = 0;
+
+    while(skipped < count)
+    {
+        if(stream->len <= 0 && axutil_stream_fill_buffered_socket(stream, env) <= 0)
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error while trying to read the socket");
+            return -1;
+        }
+        len = stream->len < count - skipped ? stream->len : count - skipped;
+        stream->buffer += len;
+        stream->len -= len;
+        skipped += len;
+    }
+    return skipped;
+}
+
+int AXIS2_CALL
+axutil_stream_peek_buffered_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    void *buffer,
+    size_t count)
+{
+    int len = 0;
+
+    if(!buffer)
+    {
+        return -1;
+    }
+    if(stream->len <= 0)
+    {
+        len = axutil_stream_fill_buffered_socket(stream, env);
+        if(len <= 0)
+        {
+            return len;
+        }
+    }
+
+    len = (size_t)stream->len < count ? stream->len : (int)count;
+    memcpy(buffer, stream->buffer, len);
+    return len;
+}
+
+/* Writes all the segments to the socket, going on after partial writes */
+static int
+axutil_stream_writev_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const axutil_stream_iovec_t *iov,
+    int iovcnt)
+{
+#ifdef WIN32
+    WSABUF vec[AXUTIL_STREAM_IOV_BATCH];
+    DWORD sent = 0;
+#else
+    struct iovec vec[AXUTIL_STREAM_IOV_BATCH];
+    ssize_t sent = 0;
+#endif
+    int total = 0;
+    int first = 0;
+    size_t offset = 0;
+    size_t left = 0;
+    int n = 0;
+
+    if(-1 == stream->socket)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_SOCKET, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+            "Trying to do operation on closed/not-opened socket");
+        return -1;
+    }
+
+    while(first < iovcnt)
+    {
+        /* offset is how much of the first segment has been sent already */
+        for(n = 0; n < AXUTIL_STREAM_IOV_BATCH && first + n < iovcnt; n++)
+        {
+            const axis2_char_t *base = (const axis2_char_t *)iov[first + n].base;
+            size_t len = iov[first + n].len;
+            if(!n)
+            {
+                base += offset;
+                len -= offset;
+            }
+#ifdef WIN32
+            vec[n].buf = (CHAR *)base;
+            vec[n].len = (ULONG)len;
+#else
+            vec[n].iov_base = (void *)base;
+            vec[n].iov_len = len;
+#endif
+        }
+
+#ifdef WIN32
+        if(WSASend(stream->socket, vec, n, &sent, 0, NULL, NULL) != 0)
+        {
+            sent = (DWORD)-1;
+        }
+        if((DWORD)-1 == sent)
+#else
+        sent = writev(stream->socket, vec, n);
+        if(sent < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if(sent < 0)
+#endif
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error while trying to write to the socket");
+            return -1;
+        }
+        total += (int)sent;
+
+        while(first < iovcnt)
+        {
+            left = iov[first].len - offset;
+            if((size_t)sent < left)
+            {
+                offset += sent;
+                break;
+            }
+            sent -= (int)left;
+            first++;
+            offset = 0;
+        }
+    }
+    return total;
+}
+
+/* Sends the collected writes of a corked stream, followed by buffer */
+static axis2_status_t
+axutil_stream_send_cork(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count)
+{
+    axutil_stream_iovec_t iov[2];
+    int len = 0;
+
+    iov[0].base = stream->cork_buffer;
+    iov[0].len = stream->cork_len > 0 ? stream->cork_len : 0;
+    iov[1].base = buffer;
+    iov[1].len = count;
+    len = axutil_stream_writev_socket(stream, env, iov, buffer ? 2 : 1);
+    stream->cork_len = 0;
+    return len < 0 ? AXIS2_FAILURE : AXIS2_SUCCESS;
+}
+
+int AXIS2_CALL
+axutil_stream_write_corked_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const void *buffer,
+    size_t count)
+{
+    if(!buffer)
+    {
+        return -1;
+    }
+    if(stream->cork_len + count <= AXIS2_STREAM_SOCKET_BUF_SIZE)
+    {
+        memcpy(stream->cork_buffer + stream->cork_len, buffer, count);
+        stream->cork_len += (int)count;
+        return (int)count;
+    }
+    if(axutil_stream_send_cork(stream, env, buffer, count) != AXIS2_SUCCESS)
+    {
+        return -1;
+    }
+    return (int)count;
+}
+
+/*
+ * Segments that fit in the cork buffer are collected like other writes. When
+ * they do not, what was collected goes out in the same writev call as the
+ * first batch of segments.
+ */
+static int
+axutil_stream_writev_corked_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const axutil_stream_iovec_t *iov,
+    int iovcnt)
+{
+    axutil_stream_iovec_t vec[AXUTIL_STREAM_IOV_BATCH];
+    size_t total = 0;
+    int n = 0;
+    int i = 0;
+    int len = 0;
+
+    for(i = 0; i < iovcnt; i++)
+    {
+        total += iov[i].len;
+    }
+    if(stream->cork_len + total <= AXIS2_STREAM_SOCKET_BUF_SIZE)
+    {
+        for(i = 0; i < iovcnt; i++)
+        {
+            memcpy(stream->cork_buffer + stream->cork_len, iov[i].base, iov[i].len);
+            stream->cork_len += (int)iov[i].len;
+        }
+        return (int)total;
+    }
+
+    vec[0].base = stream->cork_buffer;
+    vec[0].len = stream->cork_len;
+    for(n = 1; n < AXUTIL_STREAM_IOV_BATCH && n <= iovcnt; n++)
+    {
+        vec[n] = iov[n - 1];
+    }
+    len = axutil_stream_writev_socket(stream, env, vec, n);
+    stream->cork_len = 0;
+    if(len < 0)
+    {
+        return -1;
+    }
+    if(n - 1 < iovcnt
+        && axutil_stream_writev_socket(stream, env, iov + n - 1, iovcnt - n + 1) < 0)
+    {
+        return -1;
+    }
+    return (int)total;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_stream_cork(
+    axutil_stream_t *stream,
+    const axutil_env_t *env)
+{
+    if(!stream || AXIS2_STREAM_SOCKET != stream->stream_type || stream->cork_len >= 0)
+    {
+        return AXIS2_SUCCESS;
+    }
+    if(!stream->cork_buffer)
+    {
+        stream->cork_buffer = (axis2_char_t *)AXIS2_MALLOC(env->allocator,
+            AXIS2_STREAM_SOCKET_BUF_SIZE * sizeof(axis2_char_t));
+        if(!stream->cork_buffer)
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory. Cannot cork stream");
+            return AXIS2_FAILURE;
+        }
+    }
+    stream->cork_len = 0;
+    stream->write = axutil_stream_write_corked_socket;
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_stream_uncork(
+    axutil_stream_t *stream,
+    const axutil_env_t *env)
+{
+    axis2_status_t status = AXIS2_SUCCESS;
+
+    if(!stream || AXIS2_STREAM_SOCKET != stream->stream_type || stream->cork_len < 0)
+    {
+        return AXIS2_SUCCESS;
+    }
+    if(stream->cork_len > 0)
+    {
+        status = axutil_stream_send_cork(stream, env, NULL, 0);
+    }
+    stream->cork_len = -1;
+    stream->write = axutil_stream_write_socket;
+    return status;
+}
+
+#ifdef HAVE_SYS_SENDFILE_H
+/* Sends up to count bytes of the file with sendfile and leaves the file
+ * positioned after them. *sent is how much went out, which is short of
+ * count when the kernel cannot send this file and the rest must be copied */
+static axis2_status_t
+axutil_stream_sendfile_socket(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    FILE *file,
+    size_t count,
+    size_t *sent)
+{
+    off_t offset = 0;
+    ssize_t len = 0;
+    long pos = 0;
+
+    *sent = 0;
+    if(-1 == stream->socket)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_SOCKET, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+            "Trying to do operation on closed/not-opened socket");
+        return AXIS2_FAILURE;
+    }
+    pos = ftell(file);
+    if(pos < 0)
+    {
+        return AXIS2_SUCCESS;
+    }
+    if(stream->cork_len > 0 && axutil_stream_send_cork(stream, env, NULL, 0) != AXIS2_SUCCESS)
+    {
+        return AXIS2_FAILURE;
+    }
+
+    offset = (off_t)pos;
+    while(*sent < count)
+    {
+        len = sendfile(stream->socket, fileno(file), &offset, count - *sent);
+        if(len < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if(len < 0 && !*sent && (EINVAL == errno || ENOSYS == errno))
+        {
+            /* not a file the kernel can send from */
+            break;
+        }
+        if(len < 0)
+        {
+            AXIS2_ERROR_SET(env->error, AXIS2_ERROR_SOCKET_ERROR, AXIS2_FAILURE);
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error while trying to send file to the socket");
+            return AXIS2_FAILURE;
+        }
+        if(!len)
+        {
+            /* end of file, the copy below reports it */
+            break;
+        }
+        *sent += len;
+    }
+    if(fseek(file, (long)offset, SEEK_SET))
+    {
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Error while seeking in the file being sent");
+        return AXIS2_FAILURE;
+    }
+    return AXIS2_SUCCESS;
+}
+#endif
+
 /********************** End of Socket Stream Operations ***********************/
 
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
@@ -755,6 +1447,92 @@ axutil_stream_write(
     return stream->write(stream, env, buffer, count);
 }
 
+AXIS2_EXTERN int AXIS2_CALL
+axutil_stream_writev(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const axutil_stream_iovec_t *iov,
+    int iovcnt)
+{
+    int total = 0;
+    int i = 0;
+    size_t done = 0;
+    int len = 0;
+
+    if(AXIS2_STREAM_SOCKET == stream->stream_type && stream->write == axutil_stream_write_socket)
+    {
+        return axutil_stream_writev_socket(stream, env, iov, iovcnt);
+    }
+    if(AXIS2_STREAM_SOCKET == stream->stream_type
+        && stream->write == axutil_stream_write_corked_socket)
+    {
+        return axutil_stream_writev_corked_socket(stream, env, iov, iovcnt);
+    }
+
+    for(i = 0; i < iovcnt; i++)
+    {
+        for(done = 0; done < iov[i].len; done += len)
+        {
+            len = stream->write(stream, env, (const axis2_char_t *)iov[i].base + done,
+                iov[i].len - done);
+            if(len <= 0)
+            {
+                return -1;
+            }
+        }
+        total += (int)iov[i].len;
+    }
+    return total;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_stream_sendfile(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    FILE *file,
+    size_t count)
+{
+    axis2_char_t buffer[AXIS2_STREAM_SOCKET_BUF_SIZE];
+    size_t done = 0;
+    size_t want = 0;
+    int read = 0;
+    int written = 0;
+    int len = 0;
+
+    AXIS2_PARAM_CHECK(env->error, file, AXIS2_FAILURE);
+#ifdef HAVE_SYS_SENDFILE_H
+    if(AXIS2_STREAM_SOCKET == stream->stream_type && count > 0)
+    {
+        if(axutil_stream_sendfile_socket(stream, env, file, count, &done) != AXIS2_SUCCESS)
+        {
+            return AXIS2_FAILURE;
+        }
+    }
+#endif
+
+    while(done < count)
+    {
+        want = count - done < sizeof(buffer) ? count - done : sizeof(buffer);
+        read = (int)fread(buffer, 1, want, file);
+        if(read <= 0)
+        {
+            AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+                "Error in reading file, %d of %d bytes were sent", (int)done, (int)count);
+            return AXIS2_FAILURE;
+        }
+        for(written = 0; written < read; written += len)
+        {
+            len = stream->write(stream, env, buffer + written, read - written);
+            if(len <= 0)
+            {
+                return AXIS2_FAILURE;
+            }
+        }
+        done += read;
+    }
+    return AXIS2_SUCCESS;
+}
+
 AXIS2_EXTERN int AXIS2_CALL
 axutil_stream_skip(
     axutil_stream_t *stream,
@@ -774,3 +1552,93 @@ axutil_stream_peek(
     return stream->peek(stream, env, buffer, count);
 }
 
+AXIS2_EXTERN int AXIS2_CALL
+axutil_stream_read_line(
+    axutil_stream_t *stream,
+    const axutil_env_t *env,
+    axis2_char_t *buffer,
+    size_t size)
+{
+    int total = 0;
+    int max = 0;
+    int len = 0;
+    axis2_char_t *end = NULL;
+
+    if(!buffer || size < 2)
+    {
+        return -1;
+    }
+    max = (int)size - 1;
+
+    if(AXIS2_STREAM_SOCKET == stream->stream_type && stream->buffer_head)
+    {
+        while(total < max)
+        {
+            if(stream->len <= 0)
+            {
+                len = axutil_stream_fill_buffered_socket(stream, env);
+                if(len <= 0)
+                {
+                    if(!total)
+                    {
+                        return len;
+                    }
+                    break;
+                }
+            }
+            len = stream->len < max - total ? stream->len : max - total;
+            end = memchr(stream->buffer, '\n', len);
+            if(end)
+            {
+                len = (int)(end - stream->buffer) + 1;
+            }
+            memcpy(buffer + total, stream->buffer, len);
+            stream->buffer += len;
+            stream->len -= len;
+            total += len;
+            if(end)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        while(total < max)
+        {
+            len = axutil_stream_read(stream, env, buffer + total, 1);
+            if(len <= 0)
+            {
+                if(!total)
+                {
+                    return len;
+                }
+                break;
+            }
+            if(buffer[total++] == '\n')
+            {
+                break;
+            }
+        }
+    }
+
+    buffer[total] = '\0';
+    return total;
+}
+
+AXIS2_EXTERN int AXIS2_CALL
+axutil_stream_get_buffered(
+    const axutil_stream_t *stream,
+    const axutil_env_t *env,
+    const axis2_char_t **data)
+{
+    if(AXIS2_STREAM_SOCKET != stream->stream_type || !stream->buffer_head || stream->len <= 0)
+    {
+        return 0;
+    }
+    if(data)
+    {
+        *data = stream->buffer;
+    }
+    return stream->len;
+}
@@ -20,7 +20,14 @@
 #include <ctype.h>
 #include <axutil_utils.h>
 #include <axutil_utils_defines.h>
+#include <axutil_hash.h>
+#include <axutil_thread.h>
 #include <stdarg.h>             /* NULL */
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 struct axutil_string
 {
@@ -28,8 +35,72 @@ struct axutil_string
     unsigned int length;
     unsigned int ref_count;
     axis2_bool_t owns_buffer;
+
+    /* atoms are never freed, nor reference counted */
+    axis2_bool_t is_atom;
 };
 
+/*
+ * Intern table. Atoms are only ever added, so lookups read the table
+ * without locking; a slot is filled in before it is published and never
+ * changes afterwards. Additions are serialized by the mutex. The table has
+ * a fixed number of slots, twice the maximum number of atoms, so it never
+ * has to be resized under the readers.
+ *
+ * Only well known names and names registered with
+ * axutil_string_intern_register are atoms. Interning looks a string up
+ * without adding it, so that names read from documents, which are not to
+ * be trusted, cannot fill the table for the rest of the process.
+ */
+
+#define AXUTIL_STRING_INTERN_SLOTS (2 * AXUTIL_STRING_INTERN_MAX_COUNT)
+
+#if defined(WIN32)
+#define AXUTIL_STRING_BARRIER() MemoryBarrier()
+#elif defined(__GNUC__)
+#define AXUTIL_STRING_BARRIER() __sync_synchronize()
+#else
+#define AXUTIL_STRING_BARRIER()
+#endif
+
+static struct
+{
+    axutil_string_t *volatile slots[AXUTIL_STRING_INTERN_SLOTS];
+    unsigned int hashes[AXUTIL_STRING_INTERN_SLOTS];
+    unsigned int count;
+    axutil_allocator_t *allocator;
+    axutil_thread_mutex_t *mutex;
+} axutil_string_atoms;
+
+#ifdef WIN32
+static INIT_ONCE axutil_string_atoms_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t axutil_string_atoms_once = PTHREAD_ONCE_INIT;
+#endif
+
+/* names the table starts with */
+static const axis2_char_t *axutil_string_atom_names[] = {
+    /* SOAP 1.1 and 1.2 */
+    "http://schemas.xmlsoap.org/soap/envelope/", "http://www.w3.org/2003/05/soap-envelope",
+    "Envelope", "Header", "Body", "Fault", "faultcode", "faultstring", "faultactor", "detail",
+    "Code", "Subcode", "Value", "Reason", "Text", "Node", "Role", "Detail", "mustUnderstand",
+    "actor", "role", "relay", "encodingStyle",
+    /* WS-Addressing */
+    "http://www.w3.org/2005/08/addressing", "http://schemas.xmlsoap.org/ws/2004/08/addressing",
+    "To", "From", "ReplyTo", "FaultTo", "Action", "MessageID", "RelatesTo", "Address",
+    "ReferenceParameters", "Metadata", "RelationshipType", "IsReferenceParameter",
+    /* schema instance and XOP */
+    "http://www.w3.org/2001/XMLSchema-instance", "type", "nil",
+    "http://www.w3.org/2004/08/xop/include", "Include", "href",
+    /* usual prefixes */
+    "", "soapenv", "soap", "wsa", "xsi", "xop"
+};
+
+static axutil_string_t *
+axutil_string_atom_add(
+    const axis2_char_t *str,
+    axis2_ssize_t length);
+
 AXIS2_EXTERN axutil_string_t *AXIS2_CALL
 axutil_string_create(
     const axutil_env_t *env,
@@ -58,6 +129,7 @@ axutil_string_create(
     string->buffer = NULL;
     string->ref_count = 1;
     string->owns_buffer = AXIS2_TRUE;
+    string->is_atom = AXIS2_FALSE;
 
     string->length = axutil_strlen(str);
 
@@ -113,6 +185,7 @@ axutil_string_create_assume_ownership(
     string->length = axutil_strlen(*str);
     string->ref_count = 1;
     string->owns_buffer = AXIS2_TRUE;
+    string->is_atom = AXIS2_FALSE;
 
     if(string->length < 0)
     {
@@ -156,6 +229,7 @@ axutil_string_create_const(
     string->length = axutil_strlen(*str);
     string->ref_count = 1;
     string->owns_buffer = AXIS2_FALSE;
+    string->is_atom = AXIS2_FALSE;
 
     if(string->length < 0)
     {
@@ -169,12 +243,46 @@ axutil_string_create_const(
     return string;
 }
 
+AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+axutil_string_create_len(
+    const axutil_env_t *env,
+    const axis2_char_t *str,
+    unsigned int len)
+{
+    axutil_string_t *string = NULL;
+
+    if(!str)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_INVALID_NULL_PARAM, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI,
+            "NULL parameter was passed when a non NULL parameter was expected");
+        return NULL;
+    }
+
+    /* the copy follows the struct, which is freed with it */
+    string = (axutil_string_t *)AXIS2_MALLOC(env->allocator, sizeof(axutil_string_t) + len + 1);
+    if(!string)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_NO_MEMORY, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Out of memory");
+        return NULL;
+    }
+    string->buffer = (axis2_char_t *)(string + 1);
+    memcpy(string->buffer, str, len);
+    string->buffer[len] = '\0';
+    string->length = len;
+    string->ref_count = 1;
+    string->owns_buffer = AXIS2_FALSE;
+    string->is_atom = AXIS2_FALSE;
+    return string;
+}
+
 AXIS2_EXTERN void AXIS2_CALL
 axutil_string_free(
     struct axutil_string *string,
     const axutil_env_t *env)
 {
-    if(!string)
+    if(!string || string->is_atom)
     {
         return;
     }
@@ -219,7 +327,10 @@ axutil_string_clone(
         return NULL;
     }
 
-    string->ref_count++;
+    if(!string->is_atom)
+    {
+        string->ref_count++;
+    }
 
     return string;
 }
@@ -251,6 +362,215 @@ axutil_string_get_length(
     return string->length;
 }
 
+#ifdef WIN32
+static BOOL CALLBACK
+axutil_string_atoms_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+axutil_string_atoms_init(
+    void)
+#endif
+{
+    unsigned int i = 0;
+
+    axutil_string_atoms.allocator = axutil_allocator_init(NULL);
+    if(axutil_string_atoms.allocator)
+    {
+        axutil_string_atoms.mutex = axutil_thread_mutex_create(axutil_string_atoms.allocator,
+            AXIS2_THREAD_MUTEX_DEFAULT);
+    }
+    if(axutil_string_atoms.mutex)
+    {
+        axutil_thread_mutex_lock(axutil_string_atoms.mutex);
+        for(i = 0; i < sizeof(axutil_string_atom_names) / sizeof(axutil_string_atom_names[0]);
+            i++)
+        {
+            axutil_string_atom_add(axutil_string_atom_names[i], AXIS2_HASH_KEY_STRING);
+        }
+        axutil_thread_mutex_unlock(axutil_string_atoms.mutex);
+    }
+#ifdef WIN32
+    return TRUE;
+#endif
+}
+
+/*
+ * Adds the string to the intern table, unless it is there already. The mutex must be held.
+ */
+static axutil_string_t *
+axutil_string_atom_add(
+    const axis2_char_t *str,
+    axis2_ssize_t length)
+{
+    unsigned int hash = 0;
+    unsigned int i = 0;
+    axutil_string_t *atom = NULL;
+
+    hash = axutil_hashfunc_default(str, &length);
+    if(length > AXUTIL_STRING_INTERN_MAX_LENGTH)
+    {
+        return NULL;
+    }
+
+    for(i = hash & (AXUTIL_STRING_INTERN_SLOTS - 1); (atom = axutil_string_atoms.slots[i]); i
+        = (i + 1) & (AXUTIL_STRING_INTERN_SLOTS - 1))
+    {
+        if(axutil_string_atoms.hashes[i] == hash && atom->length == length && !memcmp(
+            atom->buffer, str, length))
+        {
+            return atom;
+        }
+    }
+
+    if(axutil_string_atoms.count >= AXUTIL_STRING_INTERN_MAX_COUNT)
+    {
+        return NULL;
+    }
+
+    atom = AXIS2_MALLOC(axutil_string_atoms.allocator, sizeof(axutil_string_t) + length + 1);
+    if(atom)
+    {
+        atom->buffer = (axis2_char_t *)(atom + 1);
+        memcpy(atom->buffer, str, length);
+        atom->buffer[length] = '\0';
+        atom->length = length;
+        atom->ref_count = 1;
+        atom->owns_buffer = AXIS2_FALSE;
+        atom->is_atom = AXIS2_TRUE;
+        axutil_string_atoms.hashes[i] = hash;
+
+        /* publish the atom only once it is filled in */
+        AXUTIL_STRING_BARRIER();
+        axutil_string_atoms.slots[i] = atom;
+        axutil_string_atoms.count++;
+    }
+    return atom;
+}
+
+/*
+ * Looks the string up in the intern table, and adds it if add is set and it is missing.
+ * length may be AXIS2_HASH_KEY_STRING for a null terminated string.
+ */
+static axutil_string_t *
+axutil_string_atom_get(
+    const axis2_char_t *str,
+    axis2_ssize_t length,
+    axis2_bool_t add)
+{
+    unsigned int hash = 0;
+    unsigned int i = 0;
+    axutil_string_t *atom = NULL;
+
+#ifdef WIN32
+    InitOnceExecuteOnce(&axutil_string_atoms_once, axutil_string_atoms_init, NULL, NULL);
+#else
+    pthread_once(&axutil_string_atoms_once, axutil_string_atoms_init);
+#endif
+
+    hash = axutil_hashfunc_default(str, &length);
+    if(length > AXUTIL_STRING_INTERN_MAX_LENGTH)
+    {
+        return NULL;
+    }
+
+    for(i = hash & (AXUTIL_STRING_INTERN_SLOTS - 1); (atom = axutil_string_atoms.slots[i]); i
+        = (i + 1) & (AXUTIL_STRING_INTERN_SLOTS - 1))
+    {
+        if(axutil_string_atoms.hashes[i] == hash && atom->length == length && !memcmp(
+            atom->buffer, str, length))
+        {
+            return atom;
+        }
+    }
+
+    if(!add || !axutil_string_atoms.mutex)
+    {
+        return NULL;
+    }
+
+    /* another thread may have added it meanwhile, which adding finds */
+    axutil_thread_mutex_lock(axutil_string_atoms.mutex);
+    atom = axutil_string_atom_add(str, length);
+    axutil_thread_mutex_unlock(axutil_string_atoms.mutex);
+    return atom;
+}
+
+AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+axutil_string_intern(
+    const axutil_env_t *env,
+    const axis2_char_t *str)
+{
+    axutil_string_t *atom = NULL;
+
+    if(str)
+    {
+        atom = axutil_string_atom_get(str, AXIS2_HASH_KEY_STRING, AXIS2_FALSE);
+    }
+    if(atom)
+    {
+        return atom;
+    }
+    return axutil_string_create(env, str);
+}
+
+AXIS2_EXTERN axutil_string_t *AXIS2_CALL
+axutil_string_intern_len(
+    const axutil_env_t *env,
+    const axis2_char_t *str,
+    unsigned int len)
+{
+    axutil_string_t *atom = NULL;
+
+    if(str)
+    {
+        atom = axutil_string_atom_get(str, (axis2_ssize_t)len, AXIS2_FALSE);
+    }
+    if(atom)
+    {
+        return atom;
+    }
+    return axutil_string_create_len(env, str, len);
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axutil_string_intern_buffer(
+    const axis2_char_t *str)
+{
+    axutil_string_t *atom = NULL;
+
+    if(!str)
+    {
+        return NULL;
+    }
+    atom = axutil_string_atom_get(str, AXIS2_HASH_KEY_STRING, AXIS2_FALSE);
+    return atom ? atom->buffer : NULL;
+}
+
+AXIS2_EXTERN const axis2_char_t *AXIS2_CALL
+axutil_string_intern_register(
+    const axis2_char_t *str)
+{
+    axutil_string_t *atom = NULL;
+
+    if(!str)
+    {
+        return NULL;
+    }
+    atom = axutil_string_atom_get(str, AXIS2_HASH_KEY_STRING, AXIS2_TRUE);
+    return atom ? atom->buffer : NULL;
+}
+
+AXIS2_EXTERN axis2_bool_t AXIS2_CALL
+axutil_string_is_interned(
+    const struct axutil_string *string,
+    const axutil_env_t *env)
+{
+    return string && string->is_atom;
+}
+
 /* END of string struct implementation */
 
 /** this is used to cache lengths in axutil_strcat */
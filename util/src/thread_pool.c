@@ -18,33 +18,555 @@
 #include <axutil_thread_pool.h>
 #include <axutil_env.h>
 #include <axutil_error_default.h>
+#include <platforms/axutil_platform_auto_sense.h>
+
+#define AXUTIL_THREAD_POOL_TASK_RUNNING  0x1
+#define AXUTIL_THREAD_POOL_TASK_DONE     0x2
+#define AXUTIL_THREAD_POOL_TASK_RELEASED 0x4
+
+/* A unit of work handed out by axutil_thread_pool_get_thread. Callers only
+ * ever see it through an opaque axutil_thread_t pointer. */
+typedef struct axutil_thread_pool_task
+{
+    axutil_thread_pool_t *pool;
+    axutil_thread_start_t func;
+    void *data;
+    unsigned long queued_at;
+    int state;
+} axutil_thread_pool_task_t;
+
+/* Each worker owns a ring buffer of tasks. Idle workers steal from the
+ * queues of busy ones. */
+typedef struct axutil_thread_pool_queue
+{
+    axutil_thread_mutex_t *mutex;
+    axutil_thread_pool_task_t **tasks;
+    int capacity;
+    int head;
+    int count;
+} axutil_thread_pool_queue_t;
+
+typedef struct axutil_thread_pool_worker
+{
+    axutil_thread_pool_t *pool;
+    int index;
+} axutil_thread_pool_worker_t;
 
 struct axutil_thread_pool
 {
     axutil_allocator_t *allocator;
+    axutil_thread_mutex_t *mutex;
+
+    /* signalled when a task is queued */
+    axutil_thread_cond_t *work_cond;
+
+    /* signalled when a task is dequeued and there is room in the queue */
+    axutil_thread_cond_t *space_cond;
+
+    /* broadcast when a task completes */
+    axutil_thread_cond_t *done_cond;
+
+    axutil_thread_pool_queue_t *queues;
+    axutil_thread_pool_worker_t *workers;
+    int max_workers;
+    int max_queue;
+
+    /* number of workers started; workers are never stopped before free */
+    int num_workers;
+
+    /* workers and overflow threads that have not yet returned */
+    int live_threads;
+    int idle_workers;
+    int queued;
+    int waiting_submitters;
+    unsigned int next_queue;
+    unsigned long epoch;
+    axutil_thread_pool_overflow_t overflow;
+    axis2_bool_t shutdown;
+    axutil_thread_pool_stats_t stats;
 };
 
+static void
+axutil_thread_pool_destroy(
+    axutil_thread_pool_t *pool);
+
+/* Monotonic clock in milliseconds, so that waits are not skewed when the
+ * time of day is changed */
+static unsigned long
+axutil_thread_pool_ticks(
+    void)
+{
+#if defined(WIN32)
+    return (unsigned long)GetTickCount();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (unsigned long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+static unsigned long
+axutil_thread_pool_millis(
+    axutil_thread_pool_t *pool)
+{
+    return axutil_thread_pool_ticks() - pool->epoch;
+}
+
+static axutil_thread_pool_task_t *
+axutil_thread_pool_queue_pop(
+    axutil_thread_pool_queue_t *queue)
+{
+    axutil_thread_pool_task_t *task = NULL;
+
+    axutil_thread_mutex_lock(queue->mutex);
+    if(queue->count > 0)
+    {
+        task = queue->tasks[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+    }
+    axutil_thread_mutex_unlock(queue->mutex);
+    return task;
+}
+
+static axis2_bool_t
+axutil_thread_pool_queue_push(
+    axutil_thread_pool_queue_t *queue,
+    axutil_thread_pool_task_t *task)
+{
+    axis2_bool_t pushed = AXIS2_FALSE;
+
+    axutil_thread_mutex_lock(queue->mutex);
+    if(queue->count < queue->capacity)
+    {
+        queue->tasks[(queue->head + queue->count) % queue->capacity] = task;
+        queue->count++;
+        pushed = AXIS2_TRUE;
+    }
+    axutil_thread_mutex_unlock(queue->mutex);
+    return pushed;
+}
+
+/* Marks the task as finished and frees it if its owner has let go of it */
+static void
+axutil_thread_pool_task_done(
+    axutil_thread_pool_t *pool,
+    axutil_thread_pool_task_t *task)
+{
+    axis2_bool_t release = AXIS2_FALSE;
+
+    axutil_thread_mutex_lock(pool->mutex);
+    pool->stats.completed++;
+    task->state &= ~AXUTIL_THREAD_POOL_TASK_RUNNING;
+    task->state |= AXUTIL_THREAD_POOL_TASK_DONE;
+    release = (task->state & AXUTIL_THREAD_POOL_TASK_RELEASED) ? AXIS2_TRUE : AXIS2_FALSE;
+    axutil_thread_cond_broadcast(pool->done_cond);
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    if(release)
+    {
+        AXIS2_FREE(pool->allocator, task);
+    }
+}
+
+static void
+axutil_thread_pool_task_release(
+    axutil_thread_pool_t *pool,
+    axutil_thread_pool_task_t *task)
+{
+    axis2_bool_t done = AXIS2_FALSE;
+
+    axutil_thread_mutex_lock(pool->mutex);
+    if(task->state & AXUTIL_THREAD_POOL_TASK_RELEASED)
+    {
+        axutil_thread_mutex_unlock(pool->mutex);
+        return;
+    }
+    task->state |= AXUTIL_THREAD_POOL_TASK_RELEASED;
+    done = (task->state & AXUTIL_THREAD_POOL_TASK_DONE) ? AXIS2_TRUE : AXIS2_FALSE;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    if(done)
+    {
+        AXIS2_FREE(pool->allocator, task);
+    }
+}
+
+/* Called by a worker or overflow thread right before it returns. The last
+ * thread out of a pool that has already been freed destroys it. */
+static void
+axutil_thread_pool_leave(
+    axutil_thread_pool_t *pool,
+    axutil_thread_t *thd)
+{
+    axis2_bool_t last = AXIS2_FALSE;
+
+    /* The handle is not touched once the start function returns */
+    axutil_thread_free(thd, pool->allocator);
+
+    axutil_thread_mutex_lock(pool->mutex);
+    pool->live_threads--;
+    last = (pool->shutdown && pool->live_threads == 0) ? AXIS2_TRUE : AXIS2_FALSE;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    if(last)
+    {
+        axutil_thread_pool_destroy(pool);
+    }
+}
+
+/* Blocks until there is a task for the given worker. Returns NULL when the
+ * pool is shutting down and all queues are drained. */
+static axutil_thread_pool_task_t *
+axutil_thread_pool_take(
+    axutil_thread_pool_t *pool,
+    int index)
+{
+    axutil_thread_pool_task_t *task = NULL;
+    axis2_bool_t stolen = AXIS2_FALSE;
+    unsigned long waited = 0;
+    int num_workers = 0;
+    int i = 0;
+
+    /* workers are started under the mutex, so the count is only read under it */
+    axutil_thread_mutex_lock(pool->mutex);
+    num_workers = pool->num_workers;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    while(1)
+    {
+        task = axutil_thread_pool_queue_pop(&pool->queues[index]);
+        for(i = 1; !task && i < num_workers; i++)
+        {
+            task = axutil_thread_pool_queue_pop(&pool->queues[(index + i) % num_workers]);
+            stolen = task ? AXIS2_TRUE : AXIS2_FALSE;
+        }
+
+        axutil_thread_mutex_lock(pool->mutex);
+        if(task)
+        {
+            task->state |= AXUTIL_THREAD_POOL_TASK_RUNNING;
+            pool->queued--;
+            if(stolen)
+            {
+                pool->stats.stolen++;
+            }
+            waited = axutil_thread_pool_millis(pool) - task->queued_at;
+            pool->stats.total_wait_millis += waited;
+            if(waited > pool->stats.max_wait_millis)
+            {
+                pool->stats.max_wait_millis = waited;
+            }
+            if(pool->waiting_submitters > 0)
+            {
+                axutil_thread_cond_signal(pool->space_cond);
+            }
+            axutil_thread_mutex_unlock(pool->mutex);
+            return task;
+        }
+
+        if(pool->queued > 0)
+        {
+            /* A task is being pushed or popped right now; look again */
+            num_workers = pool->num_workers;
+            axutil_thread_mutex_unlock(pool->mutex);
+            axutil_thread_yield();
+            continue;
+        }
+
+        if(pool->shutdown)
+        {
+            axutil_thread_mutex_unlock(pool->mutex);
+            return NULL;
+        }
+
+        pool->idle_workers++;
+        axutil_thread_cond_wait(pool->work_cond, pool->mutex);
+        pool->idle_workers--;
+        num_workers = pool->num_workers;
+        axutil_thread_mutex_unlock(pool->mutex);
+    }
+}
+
+static void *AXIS2_THREAD_FUNC
+axutil_thread_pool_worker_func(
+    axutil_thread_t *thd,
+    void *data)
+{
+    axutil_thread_pool_worker_t *worker = (axutil_thread_pool_worker_t *)data;
+    axutil_thread_pool_t *pool = worker->pool;
+    axutil_thread_pool_task_t *task = NULL;
+
+    while((task = axutil_thread_pool_take(pool, worker->index)))
+    {
+        task->func((axutil_thread_t *)task, task->data);
+        axutil_thread_pool_task_done(pool, task);
+    }
+
+    axutil_thread_pool_leave(pool, thd);
+    return NULL;
+}
+
+static void *AXIS2_THREAD_FUNC
+axutil_thread_pool_overflow_func(
+    axutil_thread_t *thd,
+    void *data)
+{
+    axutil_thread_pool_task_t *task = (axutil_thread_pool_task_t *)data;
+    axutil_thread_pool_t *pool = task->pool;
+
+    axutil_thread_mutex_lock(pool->mutex);
+    task->state |= AXUTIL_THREAD_POOL_TASK_RUNNING;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    task->func((axutil_thread_t *)task, task->data);
+    axutil_thread_pool_task_done(pool, task);
+
+    axutil_thread_pool_leave(pool, thd);
+    return NULL;
+}
+
+/* Starts one more worker. Must be called with the pool mutex held. */
+static axis2_status_t
+axutil_thread_pool_start_worker(
+    axutil_thread_pool_t *pool)
+{
+    axutil_thread_pool_queue_t *queue = NULL;
+    axutil_thread_pool_worker_t *worker = NULL;
+    axutil_thread_t *thd = NULL;
+
+    queue = &pool->queues[pool->num_workers];
+    if(!queue->tasks)
+    {
+        queue->tasks = AXIS2_MALLOC(pool->allocator,
+            sizeof(axutil_thread_pool_task_t *) * pool->max_queue);
+        if(!queue->tasks)
+        {
+            return AXIS2_FAILURE;
+        }
+        queue->mutex = axutil_thread_mutex_create(pool->allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+        if(!queue->mutex)
+        {
+            AXIS2_FREE(pool->allocator, queue->tasks);
+            queue->tasks = NULL;
+            return AXIS2_FAILURE;
+        }
+        queue->capacity = pool->max_queue;
+        queue->head = 0;
+        queue->count = 0;
+    }
+
+    worker = &pool->workers[pool->num_workers];
+    worker->pool = pool;
+    worker->index = pool->num_workers;
+
+    thd = axutil_thread_create(pool->allocator, NULL, axutil_thread_pool_worker_func, worker);
+    if(!thd)
+    {
+        return AXIS2_FAILURE;
+    }
+    axutil_thread_detach(thd);
+
+    /* Publish the queue only after it is fully set up, so that thieves
+     * never see a half initialized one */
+    pool->num_workers++;
+    pool->live_threads++;
+    pool->stats.workers = pool->num_workers;
+    return AXIS2_SUCCESS;
+}
+
+/* Runs the task on a thread of its own. Must be called with the pool mutex
+ * held. */
+static axis2_status_t
+axutil_thread_pool_spawn(
+    axutil_thread_pool_t *pool,
+    axutil_thread_pool_task_t *task)
+{
+    axutil_thread_t *thd = NULL;
+
+    thd = axutil_thread_create(pool->allocator, NULL, axutil_thread_pool_overflow_func, task);
+    if(!thd)
+    {
+        return AXIS2_FAILURE;
+    }
+    axutil_thread_detach(thd);
+    pool->live_threads++;
+    pool->stats.submitted++;
+    pool->stats.overflowed++;
+    return AXIS2_SUCCESS;
+}
+
+static void
+axutil_thread_pool_destroy(
+    axutil_thread_pool_t *pool)
+{
+    axutil_allocator_t *allocator = pool->allocator;
+    int max_workers = pool->max_workers;
+    int i = 0;
+
+    if(pool->queues)
+    {
+        for(i = 0; i < pool->max_workers; i++)
+        {
+            if(pool->queues[i].mutex)
+            {
+                axutil_thread_mutex_destroy(pool->queues[i].mutex);
+            }
+            if(pool->queues[i].tasks)
+            {
+                AXIS2_FREE(allocator, pool->queues[i].tasks);
+            }
+        }
+        AXIS2_FREE(allocator, pool->queues);
+    }
+    if(pool->workers)
+    {
+        AXIS2_FREE(allocator, pool->workers);
+    }
+    if(pool->work_cond)
+    {
+        axutil_thread_cond_destroy(pool->work_cond);
+    }
+    if(pool->space_cond)
+    {
+        axutil_thread_cond_destroy(pool->space_cond);
+    }
+    if(pool->done_cond)
+    {
+        axutil_thread_cond_destroy(pool->done_cond);
+    }
+    if(pool->mutex)
+    {
+        axutil_thread_mutex_destroy(pool->mutex);
+    }
+    AXIS2_FREE(allocator, pool);
+    if(max_workers)
+    {
+        axutil_allocator_free(allocator);
+    }
+}
+
 AXIS2_EXTERN axutil_thread_pool_t *AXIS2_CALL
 axutil_thread_pool_init(
     axutil_allocator_t *allocator)
+{
+    return axutil_thread_pool_create(allocator, AXUTIL_THREAD_POOL_DEFAULT_MAX_WORKERS,
+        AXUTIL_THREAD_POOL_DEFAULT_MAX_QUEUE);
+}
+
+AXIS2_EXTERN axutil_thread_pool_t *AXIS2_CALL
+axutil_thread_pool_create(
+    axutil_allocator_t *allocator,
+    int max_workers,
+    int max_queue)
 {
     axutil_thread_pool_t *pool = NULL;
+    axutil_allocator_t *pool_allocator = NULL;
 
-    pool = (axutil_thread_pool_t *)AXIS2_MALLOC(allocator, sizeof(axutil_thread_pool_t));
+    if(!allocator)
+    {
+        return NULL;
+    }
+
+    /* Workers may outlive the caller's allocator when the pool is freed while
+     * a long running task is still executing, so the pool keeps its own. */
+    pool_allocator = max_workers > 0 ? axutil_allocator_clone(allocator) : allocator;
+    if(!pool_allocator)
+    {
+        return NULL;
+    }
+
+    pool = (axutil_thread_pool_t *)AXIS2_MALLOC(pool_allocator, sizeof(axutil_thread_pool_t));
 
     if(!pool)
     {
+        if(pool_allocator != allocator)
+        {
+            axutil_allocator_free(pool_allocator);
+        }
+        return NULL;
+    }
+    memset(pool, 0, sizeof(axutil_thread_pool_t));
+    pool->allocator = pool_allocator;
+    pool->max_workers = max_workers > 0 ? max_workers : 0;
+    pool->max_queue = max_queue > 0 ? max_queue : 1;
+    pool->overflow = AXUTIL_THREAD_POOL_OVERFLOW_SPAWN;
+    pool->shutdown = AXIS2_FALSE;
+    pool->epoch = axutil_thread_pool_ticks();
+
+    if(!pool->max_workers)
+    {
+        return pool;
+    }
+
+    pool->mutex = axutil_thread_mutex_create(pool_allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+    pool->work_cond = axutil_thread_cond_create(pool_allocator);
+    pool->space_cond = axutil_thread_cond_create(pool_allocator);
+    pool->done_cond = axutil_thread_cond_create(pool_allocator);
+    pool->queues = AXIS2_MALLOC(pool_allocator,
+        sizeof(axutil_thread_pool_queue_t) * pool->max_workers);
+    pool->workers = AXIS2_MALLOC(pool_allocator,
+        sizeof(axutil_thread_pool_worker_t) * pool->max_workers);
+
+    if(!pool->mutex || !pool->work_cond || !pool->space_cond || !pool->done_cond
+        || !pool->queues || !pool->workers)
+    {
+        axutil_thread_pool_destroy(pool);
         return NULL;
     }
-    pool->allocator = allocator;
+    memset(pool->queues, 0, sizeof(axutil_thread_pool_queue_t) * pool->max_workers);
+    memset(pool->workers, 0, sizeof(axutil_thread_pool_worker_t) * pool->max_workers);
 
     return pool;
 }
 
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_pool_set_overflow_policy(
+    axutil_thread_pool_t *pool,
+    axutil_thread_pool_overflow_t overflow)
+{
+    if(!pool)
+    {
+        return AXIS2_FAILURE;
+    }
+    pool->overflow = overflow;
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_thread_pool_get_stats(
+    axutil_thread_pool_t *pool,
+    axutil_thread_pool_stats_t *stats)
+{
+    if(!pool || !stats)
+    {
+        return AXIS2_FAILURE;
+    }
+    if(!pool->max_workers)
+    {
+        memset(stats, 0, sizeof(axutil_thread_pool_stats_t));
+        return AXIS2_SUCCESS;
+    }
+
+    axutil_thread_mutex_lock(pool->mutex);
+    *stats = pool->stats;
+    stats->workers = pool->num_workers;
+    stats->idle_workers = pool->idle_workers;
+    stats->queue_depth = pool->queued;
+    axutil_thread_mutex_unlock(pool->mutex);
+    return AXIS2_SUCCESS;
+}
+
 AXIS2_EXTERN void AXIS2_CALL
 axutil_thread_pool_free(
     axutil_thread_pool_t *pool)
 {
+    axis2_bool_t last = AXIS2_FALSE;
+
     if(!pool)
     {
         return;
@@ -53,7 +575,25 @@ axutil_thread_pool_free(
     {
         return;
     }
-    AXIS2_FREE(pool->allocator, pool);
+    if(!pool->max_workers)
+    {
+        axutil_thread_pool_destroy(pool);
+        return;
+    }
+
+    /* Idle workers drain the queues and return. Workers still running a
+     * task finish it first; whoever leaves last releases the pool. */
+    axutil_thread_mutex_lock(pool->mutex);
+    pool->shutdown = AXIS2_TRUE;
+    axutil_thread_cond_broadcast(pool->work_cond);
+    axutil_thread_cond_broadcast(pool->space_cond);
+    last = (pool->live_threads == 0) ? AXIS2_TRUE : AXIS2_FALSE;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    if(last)
+    {
+        axutil_thread_pool_destroy(pool);
+    }
     return;
 }
 
@@ -63,6 +603,10 @@ axutil_thread_pool_get_thread(
     axutil_thread_start_t func,
     void *data)
 {
+    axutil_thread_pool_task_t *task = NULL;
+    axutil_thread_pool_queue_t *queue = NULL;
+    int i = 0;
+
     if(!pool)
     {
         return NULL;
@@ -71,7 +615,74 @@ axutil_thread_pool_get_thread(
     {
         return NULL;
     }
-    return axutil_thread_create(pool->allocator, NULL, func, data);
+    if(!pool->max_workers)
+    {
+        return axutil_thread_create(pool->allocator, NULL, func, data);
+    }
+
+    task = (axutil_thread_pool_task_t *)AXIS2_MALLOC(pool->allocator,
+        sizeof(axutil_thread_pool_task_t));
+    if(!task)
+    {
+        return NULL;
+    }
+    task->pool = pool;
+    task->func = func;
+    task->data = data;
+    task->state = 0;
+
+    axutil_thread_mutex_lock(pool->mutex);
+    while(!pool->shutdown && pool->queued >= pool->max_queue
+        && pool->overflow == AXUTIL_THREAD_POOL_OVERFLOW_WAIT)
+    {
+        pool->waiting_submitters++;
+        axutil_thread_cond_wait(pool->space_cond, pool->mutex);
+        pool->waiting_submitters--;
+    }
+
+    if(pool->shutdown)
+    {
+        axutil_thread_mutex_unlock(pool->mutex);
+        AXIS2_FREE(pool->allocator, task);
+        return NULL;
+    }
+
+    if(pool->idle_workers <= pool->queued && pool->num_workers < pool->max_workers)
+    {
+        axutil_thread_pool_start_worker(pool);
+    }
+
+    if(pool->queued >= pool->max_queue || !pool->num_workers)
+    {
+        if(AXIS2_SUCCESS != axutil_thread_pool_spawn(pool, task))
+        {
+            axutil_thread_mutex_unlock(pool->mutex);
+            AXIS2_FREE(pool->allocator, task);
+            return NULL;
+        }
+        axutil_thread_mutex_unlock(pool->mutex);
+        return (axutil_thread_t *)task;
+    }
+
+    task->queued_at = axutil_thread_pool_millis(pool);
+    for(i = 0; i < pool->num_workers; i++)
+    {
+        queue = &pool->queues[pool->next_queue++ % pool->num_workers];
+        if(axutil_thread_pool_queue_push(queue, task))
+        {
+            break;
+        }
+    }
+    pool->queued++;
+    pool->stats.submitted++;
+    if(pool->queued > pool->stats.peak_queue_depth)
+    {
+        pool->stats.peak_queue_depth = pool->queued;
+    }
+    axutil_thread_cond_signal(pool->work_cond);
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    return (axutil_thread_t *)task;
 }
 
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
@@ -79,11 +690,27 @@ axutil_thread_pool_join_thread(
     axutil_thread_pool_t *pool,
     axutil_thread_t *thd)
 {
+    axutil_thread_pool_task_t *task = NULL;
+
     if(!pool || !thd)
     {
         return AXIS2_FAILURE;
     }
-    return axutil_thread_join(thd);
+    if(!pool->max_workers)
+    {
+        return axutil_thread_join(thd);
+    }
+
+    task = (axutil_thread_pool_task_t *)thd;
+    axutil_thread_mutex_lock(pool->mutex);
+    while(!(task->state & AXUTIL_THREAD_POOL_TASK_DONE))
+    {
+        axutil_thread_cond_wait(pool->done_cond, pool->mutex);
+    }
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    axutil_thread_pool_task_release(pool, task);
+    return AXIS2_SUCCESS;
 }
 
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
@@ -91,11 +718,33 @@ axutil_thread_pool_exit_thread(
     axutil_thread_pool_t *pool,
     axutil_thread_t *thd)
 {
+    axutil_thread_pool_task_t *task = NULL;
+    axis2_bool_t running = AXIS2_FALSE;
+
     if(!pool || !thd)
     {
         return AXIS2_FAILURE;
     }
-    return axutil_thread_exit(thd, pool->allocator);
+    if(!pool->max_workers)
+    {
+        return axutil_thread_exit(thd, pool->allocator);
+    }
+
+    task = (axutil_thread_pool_task_t *)thd;
+
+    /* Task functions call this on their way out, which used to terminate
+     * the thread. A pooled task is simply left to return to its worker, and
+     * the handle stays valid for the owner to detach or join. A task that is
+     * not running any more is released. */
+    axutil_thread_mutex_lock(pool->mutex);
+    running = (task->state & AXUTIL_THREAD_POOL_TASK_RUNNING) ? AXIS2_TRUE : AXIS2_FALSE;
+    axutil_thread_mutex_unlock(pool->mutex);
+
+    if(!running)
+    {
+        axutil_thread_pool_task_release(pool, task);
+    }
+    return AXIS2_SUCCESS;
 }
 
 AXIS2_EXTERN axis2_status_t AXIS2_CALL
@@ -107,7 +756,13 @@ axutil_thread_pool_thread_detach(
     {
         return AXIS2_FAILURE;
     }
-    return axutil_thread_detach(thd);
+    if(!pool->max_workers)
+    {
+        return axutil_thread_detach(thd);
+    }
+
+    axutil_thread_pool_task_release(pool, (axutil_thread_pool_task_t *)thd);
+    return AXIS2_SUCCESS;
 }
 
 AXIS2_EXTERN axutil_env_t *AXIS2_CALL
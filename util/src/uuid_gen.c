@@ -16,19 +16,312 @@
  */
 
 #include <axutil_uuid_gen.h>
+#include <axutil_thread.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
+/*
+ * Every thread keeps a pool of random bytes from the operating system and
+ * only goes back to the system when the pool runs out, once for every 128
+ * random uuids. The state of a thread is only ever used by that thread, so
+ * nothing is locked. A child process starts with a copy of the pool of the
+ * thread that forked it, so the pools of all threads are refilled after a
+ * fork, or parent and child would generate the same uuids.
+ */
+
+#define AXUTIL_UUID_POOL_SIZE 2048
+
+typedef struct axutil_uuid_state
+{
+    unsigned char pool[AXUTIL_UUID_POOL_SIZE];
+    unsigned int pos;
+    unsigned int generation;
+
+    /* time and counter of the last version 7 uuid */
+    unsigned long long last_ms;
+    unsigned int seq;
+} axutil_uuid_state_t;
+
+static const char axutil_uuid_hex[] = "0123456789abcdef";
+
+static volatile axutil_uuid_version_t axutil_uuid_version = AXUTIL_UUID_VERSION_4;
+
+/* changed in a forked child to invalidate the pools */
+static volatile unsigned int axutil_uuid_generation = 1;
+
+static axutil_allocator_t *axutil_uuid_allocator = NULL;
+static axutil_threadkey_t *axutil_uuid_key = NULL;
+
+#ifdef WIN32
+static INIT_ONCE axutil_uuid_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t axutil_uuid_once = PTHREAD_ONCE_INIT;
+
+static void
+axutil_uuid_atfork_child(
+    void)
+{
+    axutil_uuid_generation++;
+}
+#endif
+
+static void AXIS2_CALL
+axutil_uuid_state_free(
+    void *state)
+{
+    AXIS2_FREE(axutil_uuid_allocator, state);
+}
+
+#ifdef WIN32
+static BOOL CALLBACK
+axutil_uuid_init(
+    PINIT_ONCE once,
+    PVOID param,
+    PVOID *context)
+#else
+static void
+axutil_uuid_init(
+    void)
+#endif
+{
+    axutil_uuid_allocator = axutil_allocator_init(NULL);
+    if(axutil_uuid_allocator)
+    {
+        axutil_uuid_key = axutil_threadkey_create(axutil_uuid_allocator, axutil_uuid_state_free);
+    }
+#ifdef WIN32
+    return TRUE;
+#else
+    pthread_atfork(NULL, NULL, axutil_uuid_atfork_child);
+#endif
+}
+
+static unsigned long long
+axutil_uuid_now_ms(
+    void)
+{
+#ifdef WIN32
+    FILETIME file_time;
+    ULARGE_INTEGER now;
+
+    GetSystemTimeAsFileTime(&file_time);
+    now.LowPart = file_time.dwLowDateTime;
+    now.HighPart = file_time.dwHighDateTime;
+    /* 100ns intervals since 1601 */
+    return (now.QuadPart - 116444736000000000ULL) / 10000;
+#else
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return (unsigned long long)now.tv_sec * 1000 + now.tv_usec / 1000;
+#endif
+}
+
+/*
+ * Fills the pool. Should the system have no random bytes to give, which is
+ * not expected, the pool is filled from the clock and the address of the
+ * state so that ids are at least still unique.
+ */
+static void
+axutil_uuid_state_fill(
+    axutil_uuid_state_t *state)
+{
+    unsigned long long mix = 0;
+    unsigned long long z = 0;
+    unsigned int i = 0;
+
+    state->pos = 0;
+    state->generation = axutil_uuid_generation;
+    if(axutil_platform_uuid_random(state->pool, AXUTIL_UUID_POOL_SIZE) == AXIS2_SUCCESS)
+    {
+        return;
+    }
+
+    /* splitmix64 */
+    mix = axutil_uuid_now_ms() ^ ((unsigned long long)(size_t)state << 16) ^ state->last_ms;
+    for(i = 0; i < AXUTIL_UUID_POOL_SIZE; i += 8)
+    {
+        mix += 0x9E3779B97F4A7C15ULL;
+        z = mix;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        memcpy(state->pool + i, &z, 8);
+    }
+}
+
+/* Takes len random bytes from the pool, refilling it when needed */
+static const unsigned char *
+axutil_uuid_state_take(
+    axutil_uuid_state_t *state,
+    unsigned int len)
+{
+    const unsigned char *bytes = NULL;
+
+    if(state->pos + len > AXUTIL_UUID_POOL_SIZE || state->generation != axutil_uuid_generation)
+    {
+        axutil_uuid_state_fill(state);
+    }
+    bytes = state->pool + state->pos;
+    state->pos += len;
+    return bytes;
+}
+
+/*
+ * Version 7 layout: 48 bits of unix time in milliseconds, the version, a
+ * 12 bit counter, the variant and 62 random bits. The counter starts at a
+ * random value below 2048 every millisecond, and when it overflows the time
+ * is moved on by one, so a thread never generates a uuid that sorts before
+ * its previous one, even when the clock is set back.
+ */
+static void
+axutil_uuid_state_gen_v7(
+    axutil_uuid_state_t *state,
+    unsigned char *uuid)
+{
+    unsigned long long now = axutil_uuid_now_ms();
+    const unsigned char *random = NULL;
+    int i = 0;
+
+    if(now > state->last_ms || ++state->seq > 0xFFF)
+    {
+        if(now > state->last_ms)
+        {
+            state->last_ms = now;
+        }
+        else
+        {
+            state->last_ms++;
+        }
+        random = axutil_uuid_state_take(state, 2);
+        state->seq = ((random[0] << 8) | random[1]) & 0x7FF;
+    }
+    for(i = 0; i < 6; i++)
+    {
+        uuid[i] = (unsigned char)(state->last_ms >> (40 - i * 8));
+    }
+    uuid[6] = (unsigned char)(0x70 | (state->seq >> 8));
+    uuid[7] = (unsigned char)state->seq;
+    memcpy(uuid + 8, axutil_uuid_state_take(state, 8), 8);
+}
+
+static void
+axutil_uuid_state_gen(
+    axutil_uuid_state_t *state,
+    axis2_char_t *buffer)
+{
+    unsigned char uuid[16];
+    axis2_char_t *out = buffer;
+    int i = 0;
+
+    if(axutil_uuid_version == AXUTIL_UUID_VERSION_7)
+    {
+        axutil_uuid_state_gen_v7(state, uuid);
+    }
+    else
+    {
+        memcpy(uuid, axutil_uuid_state_take(state, 16), 16);
+        uuid[6] = (unsigned char)((uuid[6] & 0x0F) | 0x40);
+    }
+    uuid[8] = (unsigned char)((uuid[8] & 0x3F) | 0x80);
+
+    for(i = 0; i < 16; i++)
+    {
+        if(i == 4 || i == 6 || i == 8 || i == 10)
+        {
+            *out++ = '-';
+        }
+        *out++ = axutil_uuid_hex[uuid[i] >> 4];
+        *out++ = axutil_uuid_hex[uuid[i] & 0x0F];
+    }
+    *out = '\0';
+}
+
+AXIS2_EXTERN axis2_char_t *AXIS2_CALL
+axutil_uuid_gen_into(
+    axis2_char_t *buffer)
+{
+    axutil_uuid_state_t *state = NULL;
+    axutil_uuid_state_t local;
+
+    if(!buffer)
+    {
+        return NULL;
+    }
+
+#ifdef WIN32
+    InitOnceExecuteOnce(&axutil_uuid_once, axutil_uuid_init, NULL, NULL);
+#else
+    pthread_once(&axutil_uuid_once, axutil_uuid_init);
+#endif
+    if(axutil_uuid_key)
+    {
+        state = axutil_thread_getspecific(axutil_uuid_key);
+        if(!state)
+        {
+            state = AXIS2_MALLOC(axutil_uuid_allocator, sizeof(axutil_uuid_state_t));
+            if(state)
+            {
+                memset(state, 0, sizeof(axutil_uuid_state_t));
+                state->pos = AXUTIL_UUID_POOL_SIZE;
+                if(axutil_thread_setspecific(axutil_uuid_key, state) != AXIS2_SUCCESS)
+                {
+                    AXIS2_FREE(axutil_uuid_allocator, state);
+                    state = NULL;
+                }
+            }
+        }
+    }
+    if(!state)
+    {
+        /* no per thread state, fall back to a fresh pool for this uuid */
+        memset(&local, 0, sizeof(local));
+        local.pos = AXUTIL_UUID_POOL_SIZE;
+        state = &local;
+    }
+
+    axutil_uuid_state_gen(state, buffer);
+    return buffer;
+}
 
 AXIS2_EXTERN axis2_char_t *AXIS2_CALL
 axutil_uuid_gen(
     const axutil_env_t *env)
 {
-
-    axis2_char_t *str = AXIS2_MALLOC(env->allocator, 40 * sizeof(char));
-    axutil_platform_uuid_gen(str);
+    axis2_char_t *str = AXIS2_MALLOC(env->allocator, AXUTIL_UUID_STRING_SIZE * sizeof(char));
     if(!str)
     {
         AXIS2_ERROR_SET(env->error, AXIS2_ERROR_UUID_GEN_FAILED, AXIS2_FAILURE);
         AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "AXIS2_ERROR_UUID_GEN_FAILED");
         return NULL;
     }
+    axutil_uuid_gen_into(str);
     return str;
 }
+
+AXIS2_EXTERN axis2_status_t AXIS2_CALL
+axutil_uuid_gen_set_version(
+    const axutil_env_t *env,
+    axutil_uuid_version_t version)
+{
+    if(version != AXUTIL_UUID_VERSION_4 && version != AXUTIL_UUID_VERSION_7)
+    {
+        AXIS2_ERROR_SET(env->error, AXIS2_ERROR_UNSUPPORTED_TYPE, AXIS2_FAILURE);
+        AXIS2_LOG_ERROR(env->log, AXIS2_LOG_SI, "Unsupported uuid version %d", version);
+        return AXIS2_FAILURE;
+    }
+    axutil_uuid_version = version;
+    return AXIS2_SUCCESS;
+}
+
+AXIS2_EXTERN axutil_uuid_version_t AXIS2_CALL
+axutil_uuid_gen_get_version(
+    void)
+{
+    return axutil_uuid_version;
+}
@@ -117,3 +117,227 @@ TEST_F(TestAllocator, test_base64)
     AXIS2_FREE(m_env->allocator, plain_binary);
 }
 
+
+TEST_F(TestAllocator, test_arena)
+{
+    axutil_allocator_t *arena = NULL;
+    axutil_allocator_t *clone = NULL;
+    char *small = NULL;
+    char *grown = NULL;
+    char *large = NULL;
+    char *global = NULL;
+    int i;
+
+    arena = axutil_allocator_arena_create(1024);
+    ASSERT_NE(arena, nullptr);
+
+    small = (char *) AXIS2_MALLOC(arena, 10);
+    ASSERT_NE(small, nullptr);
+    ASSERT_EQ((size_t) small % 16, 0u);
+    strcpy(small, "arena");
+
+    /* the most recent block grows in place */
+    grown = (char *) AXIS2_REALLOC(arena, small, 100);
+    ASSERT_EQ(grown, small);
+    ASSERT_STREQ(grown, "arena");
+
+    /* freeing the most recent block hands its memory back */
+    AXIS2_FREE(arena, grown);
+    small = (char *) AXIS2_MALLOC(arena, 10);
+    ASSERT_EQ(small, grown);
+
+    /* blocks larger than a quarter chunk get a chunk of their own */
+    large = (char *) AXIS2_MALLOC(arena, 4096);
+    ASSERT_NE(large, nullptr);
+    memset(large, 'x', 4096);
+
+    for (i = 0; i < 1000; i++)
+    {
+        char *p = (char *) AXIS2_MALLOC(arena, 24);
+        ASSERT_NE(p, nullptr);
+        memset(p, i, 24);
+    }
+
+    /* blocks allocated while switched to the global pool outlive the arena */
+    axutil_allocator_switch_to_global_pool(arena);
+    global = (char *) AXIS2_MALLOC(arena, 32);
+    axutil_allocator_switch_to_local_pool(arena);
+    ASSERT_NE(global, nullptr);
+    strcpy(global, "global");
+
+    /* cloning an arena gives a heap allocator */
+    clone = axutil_allocator_clone(arena);
+    ASSERT_NE(clone, nullptr);
+    ASSERT_NE(clone->malloc_fn, arena->malloc_fn);
+    axutil_allocator_free(clone);
+
+    axutil_allocator_arena_reset(arena);
+    small = (char *) AXIS2_MALLOC(arena, 10);
+    ASSERT_NE(small, nullptr);
+    axutil_allocator_free(arena);
+
+    ASSERT_STREQ(global, "global");
+    AXIS2_FREE(m_allocator, global);
+}
+
+TEST_F(TestAllocator, test_arena_with_parent)
+{
+    axutil_allocator_t *parent = NULL;
+    axutil_allocator_t *arena = NULL;
+    axutil_allocator_t *clone = NULL;
+    axutil_allocator_slab_stats_t before[AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES];
+    axutil_allocator_slab_stats_t stats[AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES];
+    char *blocks[200];
+    char *owned = NULL;
+    char *p = NULL;
+    int i;
+
+    parent = axutil_allocator_slab_create();
+    ASSERT_NE(parent, nullptr);
+    arena = axutil_allocator_arena_create_with_parent(1024, parent);
+    ASSERT_NE(arena, nullptr);
+    axutil_allocator_slab_get_stats(before, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+
+    /* blocks spread over many chunks are all recognized as the arena's */
+    for (i = 0; i < 200; i++)
+    {
+        blocks[i] = (char *) AXIS2_MALLOC(arena, (i % 10) ? 40 : 600);
+        ASSERT_NE(blocks[i], nullptr);
+        memset(blocks[i], i, 40);
+    }
+    p = (char *) AXIS2_REALLOC(arena, blocks[3], 80);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(p[39], 3);
+    for (i = 0; i < 200; i++)
+    {
+        AXIS2_FREE(arena, blocks[i]);
+    }
+    axutil_allocator_slab_get_stats(stats, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(stats[2].live_objects, before[2].live_objects);
+
+    /* blocks of the parent go back to it */
+    owned = (char *) AXIS2_MALLOC(parent, 40);
+    ASSERT_NE(owned, nullptr);
+    owned = (char *) AXIS2_REALLOC(arena, owned, 48);
+    ASSERT_NE(owned, nullptr);
+    AXIS2_FREE(arena, owned);
+    axutil_allocator_slab_get_stats(stats, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(stats[2].live_objects, before[2].live_objects);
+
+    /* a clone of the arena frees the parent's blocks like the parent */
+    clone = axutil_allocator_clone(arena);
+    ASSERT_NE(clone, nullptr);
+    ASSERT_EQ(clone->free_fn, parent->free_fn);
+    owned = (char *) AXIS2_MALLOC(parent, 40);
+    ASSERT_NE(owned, nullptr);
+    AXIS2_FREE(clone, owned);
+    axutil_allocator_free(clone);
+
+    /* and so does a heap allocator */
+    owned = (char *) AXIS2_MALLOC(parent, 40);
+    ASSERT_NE(owned, nullptr);
+    owned = (char *) AXIS2_REALLOC(m_allocator, owned, 44);
+    ASSERT_NE(owned, nullptr);
+    AXIS2_FREE(m_allocator, owned);
+    axutil_allocator_slab_get_stats(stats, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(stats[2].live_objects, before[2].live_objects);
+
+    axutil_allocator_free(arena);
+    axutil_allocator_free(parent);
+}
+
+
+static void *AXIS2_THREAD_FUNC
+slab_thread_func(
+    axutil_thread_t *,
+    void *data)
+{
+    axutil_allocator_t *slab = (axutil_allocator_t *) data;
+    void *blocks[100];
+    int i, round;
+
+    for (round = 0; round < 50; round++)
+    {
+        for (i = 0; i < 100; i++)
+        {
+            blocks[i] = AXIS2_MALLOC(slab, 8 + (i % 8) * 8);
+            memset(blocks[i], i, 8 + (i % 8) * 8);
+        }
+        for (i = 0; i < 100; i++)
+        {
+            AXIS2_FREE(slab, blocks[i]);
+        }
+    }
+    return NULL;
+}
+
+TEST_F(TestAllocator, test_slab)
+{
+    axutil_allocator_t *slab = NULL;
+    axutil_allocator_t *clone = NULL;
+    axutil_allocator_slab_stats_t before[AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES];
+    axutil_allocator_slab_stats_t stats[AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES];
+    axutil_thread_t *threads[4];
+    char *blocks[500];
+    char *p = NULL;
+    char *heap = NULL;
+    int i;
+
+    slab = axutil_allocator_slab_create();
+    ASSERT_NE(slab, nullptr);
+    ASSERT_EQ(axutil_allocator_slab_get_stats(before, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES),
+        AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(before[0].object_size, 16u);
+
+    /* objects of one class are laid out next to each other */
+    for (i = 0; i < 500; i++)
+    {
+        blocks[i] = (char *) AXIS2_MALLOC(slab, 40);
+        ASSERT_NE(blocks[i], nullptr);
+        memset(blocks[i], i, 40);
+    }
+    ASSERT_EQ(labs((long) (blocks[1] - blocks[0])), 48);
+    axutil_allocator_slab_get_stats(stats, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(stats[2].object_size, 48u);
+    ASSERT_EQ(stats[2].live_objects, before[2].live_objects + 500);
+    ASSERT_GE(stats[2].peak_objects, stats[2].live_objects);
+    ASSERT_GE(stats[2].slabs, 1u);
+
+    /* growing within the size class keeps the block */
+    p = (char *) AXIS2_REALLOC(slab, blocks[0], 48);
+    ASSERT_EQ(p, blocks[0]);
+    p = (char *) AXIS2_REALLOC(slab, blocks[0], 100);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(p[39], 0);
+    blocks[0] = p;
+
+    for (i = 0; i < 500; i++)
+    {
+        AXIS2_FREE(slab, blocks[i]);
+    }
+    axutil_allocator_slab_get_stats(stats, AXUTIL_ALLOCATOR_SLAB_NUM_CLASSES);
+    ASSERT_EQ(stats[2].live_objects, before[2].live_objects);
+
+    /* large blocks and blocks of other allocators go to the heap */
+    p = (char *) AXIS2_MALLOC(slab, 4096);
+    ASSERT_NE(p, nullptr);
+    AXIS2_FREE(slab, p);
+    heap = (char *) AXIS2_MALLOC(m_allocator, 20);
+    AXIS2_FREE(slab, heap);
+
+    /* clones share the slabs, and threads have caches of their own */
+    clone = axutil_allocator_clone(slab);
+    ASSERT_EQ(clone->malloc_fn, slab->malloc_fn);
+    for (i = 0; i < 4; i++)
+    {
+        threads[i] = axutil_thread_create(m_allocator, NULL, slab_thread_func, clone);
+        ASSERT_NE(threads[i], nullptr);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        axutil_thread_join(threads[i]);
+        axutil_thread_free(threads[i], m_allocator);
+    }
+    axutil_allocator_free(clone);
+    axutil_allocator_free(slab);
+}
@@ -128,3 +128,98 @@ TEST_F(TestDateTime, test_date_time) {
    }
 }
 
+
+TEST_F(TestDateTime, test_date_time_lexical) {
+
+    axutil_date_time_t *date_time = axutil_date_time_create(m_env);
+    axis2_char_t *str = NULL;
+
+    ASSERT_NE(date_time, nullptr);
+    ASSERT_EQ(axutil_date_time_deserialize_date_time(date_time, m_env,
+        "2008-01-08T02:03:04.5Z"), AXIS2_SUCCESS);
+    str = axutil_date_time_serialize_date_time(date_time, m_env);
+    EXPECT_STREQ(str, "2008-01-08T02:03:04.500Z");
+    AXIS2_FREE(m_allocator, str);
+    str = axutil_date_time_serialize_date_time_without_millisecond(date_time, m_env);
+    EXPECT_STREQ(str, "2008-01-08T02:03:05Z");
+    AXIS2_FREE(m_allocator, str);
+    str = axutil_date_time_serialize_date(date_time, m_env);
+    EXPECT_STREQ(str, "2008-01-08");
+    AXIS2_FREE(m_allocator, str);
+    str = axutil_date_time_serialize_time(date_time, m_env);
+    EXPECT_STREQ(str, "02:03:04.500Z");
+    AXIS2_FREE(m_allocator, str);
+
+    ASSERT_EQ(axutil_date_time_deserialize_date_time_with_time_zone(date_time, m_env,
+        "-0044-03-15T12:00:00.123-05:30"), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_date_time_get_year(date_time, m_env), -44);
+    EXPECT_EQ(axutil_date_time_get_msec(date_time, m_env), 123);
+    EXPECT_FALSE(axutil_date_time_is_time_zone_positive(date_time, m_env));
+    str = axutil_date_time_serialize_date_time_with_time_zone(date_time, m_env);
+    EXPECT_STREQ(str, "-44-03-15T12:00:00.123-05:30");
+    AXIS2_FREE(m_allocator, str);
+
+    ASSERT_EQ(axutil_date_time_deserialize_time_with_time_zone(date_time, m_env,
+        "23:59:59+14:00"), AXIS2_SUCCESS);
+    str = axutil_date_time_serialize_time_with_time_zone(date_time, m_env);
+    EXPECT_STREQ(str, "23:59:59.000+14:00");
+    AXIS2_FREE(m_allocator, str);
+
+    /* leading white space is skipped, as sscanf did */
+    ASSERT_EQ(axutil_date_time_deserialize_date_time(date_time, m_env,
+        " \n\t2008-01-08T02:03:04Z"), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_date_time_get_hour(date_time, m_env), 2);
+    EXPECT_EQ(axutil_date_time_deserialize_time(date_time, m_env, "  12:30:00"),
+        AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_date_time_deserialize_date(date_time, m_env, " 2008-02-28"),
+        AXIS2_SUCCESS);
+
+    /* malformed values are rejected instead of being half read */
+    EXPECT_EQ(axutil_date_time_deserialize_date_time(date_time, m_env, "2008-01"),
+        AXIS2_FAILURE);
+    EXPECT_EQ(axutil_date_time_deserialize_date_time(date_time, m_env,
+        "2008-01-08 02:03:04Z"), AXIS2_FAILURE);
+    EXPECT_EQ(axutil_date_time_deserialize_time(date_time, m_env, "12:x:00"), AXIS2_FAILURE);
+    EXPECT_EQ(axutil_date_time_deserialize_time_with_time_zone(date_time, m_env,
+        "12:00:00Z"), AXIS2_FAILURE);
+    EXPECT_EQ(axutil_date_time_deserialize_date(date_time, m_env, "2008-02-30"),
+        AXIS2_FAILURE);
+
+    axutil_date_time_free(date_time, m_env);
+}
+
+TEST_F(TestDateTime, test_time_cache) {
+
+    axis2_char_t http_date[AXUTIL_HTTP_DATE_SIZE];
+    axis2_char_t log_time[AXUTIL_LOG_TIME_SIZE];
+    axis2_char_t date_time_str[AXUTIL_DATE_TIME_STR_SIZE];
+    axis2_char_t expected[64];
+    char ctime_buf[32];
+    struct tm result;
+    time_t now;
+
+    /* retry if the second changes in between */
+    do
+    {
+        now = time(NULL);
+        ASSERT_EQ(axutil_get_http_date(http_date), AXUTIL_HTTP_DATE_SIZE - 1);
+        ASSERT_EQ(axutil_get_log_time(log_time), AXUTIL_LOG_TIME_SIZE - 1);
+        ASSERT_EQ(axutil_get_date_time_str(date_time_str), AXUTIL_DATE_TIME_STR_SIZE - 1);
+    }
+    while (now != time(NULL));
+
+    strftime(expected, sizeof(expected), "%a, %d %b %Y %H:%M:%S GMT", gmtime_r(&now, &result));
+    EXPECT_STREQ(http_date, expected);
+    strftime(expected, sizeof(expected), "%Y-%m-%dT%H:%M:%SZ", gmtime_r(&now, &result));
+    EXPECT_STREQ(date_time_str, expected);
+    ASSERT_NE(ctime_r(&now, ctime_buf), nullptr);
+    ctime_buf[24] = '\0';
+    EXPECT_STREQ(log_time, ctime_buf);
+
+    /* the published second is handed out again */
+    ASSERT_EQ(axutil_get_http_date(expected), AXUTIL_HTTP_DATE_SIZE - 1);
+    if (now == time(NULL))
+    {
+        EXPECT_STREQ(expected, http_date);
+    }
+}
@@ -0,0 +1,354 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Microbenchmark of axutil_hash_t against the chained table with the
+ * times 33 hash it replaced, which is kept below for comparison.
+ *
+ * Usage: bench_hash [ROUNDS]
+ *
+ * Each workload builds tables of a given size with keys shaped like
+ * property names and QNames, looks every key up, looks up as many missing
+ * keys, iterates the table and deletes every key. Times are nanoseconds
+ * per operation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <axutil_hash.h>
+#include <axutil_error_default.h>
+#include <axutil_log_default.h>
+
+typedef struct chained_entry
+{
+    struct chained_entry *next;
+    unsigned int hash;
+    const void *key;
+    axis2_ssize_t klen;
+    const void *val;
+} chained_entry;
+
+typedef struct chained_hash
+{
+    const axutil_env_t *env;
+    chained_entry **array;
+    unsigned int count;
+    unsigned int max;
+    chained_entry *free;
+} chained_hash;
+
+static unsigned int
+chained_hashfunc(
+    const char *char_key,
+    axis2_ssize_t *klen)
+{
+    unsigned int hash = 0;
+    const unsigned char *key = (const unsigned char *) char_key;
+    const unsigned char *p;
+    axis2_ssize_t i;
+
+    if (*klen == AXIS2_HASH_KEY_STRING)
+    {
+        for (p = key; *p; p++)
+        {
+            hash = hash * 33 + *p;
+        }
+        *klen = (axis2_ssize_t) (p - key);
+    }
+    else
+    {
+        for (p = key, i = *klen; i; i--, p++)
+        {
+            hash = hash * 33 + *p;
+        }
+    }
+    return hash;
+}
+
+static chained_hash *
+chained_make(
+    const axutil_env_t *env)
+{
+    chained_hash *ht = (chained_hash *) AXIS2_MALLOC(env->allocator, sizeof(chained_hash));
+    ht->env = env;
+    ht->free = NULL;
+    ht->count = 0;
+    ht->max = 15;
+    ht->array = (chained_entry **) AXIS2_MALLOC(env->allocator, sizeof(chained_entry *) * 16);
+    memset(ht->array, 0, sizeof(chained_entry *) * 16);
+    return ht;
+}
+
+static void
+chained_expand(
+    chained_hash *ht)
+{
+    unsigned int new_max = ht->max * 2 + 1;
+    chained_entry **new_array = (chained_entry **) AXIS2_MALLOC(ht->env->allocator,
+        sizeof(chained_entry *) * (new_max + 1));
+    unsigned int i;
+
+    memset(new_array, 0, sizeof(chained_entry *) * (new_max + 1));
+    for (i = 0; i <= ht->max; i++)
+    {
+        chained_entry *he = ht->array[i];
+        while (he)
+        {
+            chained_entry *next = he->next;
+            he->next = new_array[he->hash & new_max];
+            new_array[he->hash & new_max] = he;
+            he = next;
+        }
+    }
+    AXIS2_FREE(ht->env->allocator, ht->array);
+    ht->array = new_array;
+    ht->max = new_max;
+}
+
+static chained_entry **
+chained_find_entry(
+    chained_hash *ht,
+    const void *key,
+    axis2_ssize_t klen,
+    const void *val)
+{
+    chained_entry **hep, *he;
+    unsigned int hash = chained_hashfunc((const char *) key, &klen);
+
+    for (hep = &ht->array[hash & ht->max], he = *hep; he; hep = &he->next, he = *hep)
+    {
+        if (he->hash == hash && he->klen == klen && memcmp(he->key, key, klen) == 0)
+            break;
+    }
+    if (he || !val)
+        return hep;
+
+    he = ht->free;
+    if (he)
+        ht->free = he->next;
+    else
+        he = (chained_entry *) AXIS2_MALLOC(ht->env->allocator, sizeof(*he));
+    he->next = NULL;
+    he->hash = hash;
+    he->key = key;
+    he->klen = klen;
+    he->val = val;
+    *hep = he;
+    ht->count++;
+    return hep;
+}
+
+static void *
+chained_get(
+    chained_hash *ht,
+    const void *key,
+    axis2_ssize_t klen)
+{
+    chained_entry *he = *chained_find_entry(ht, key, klen, NULL);
+    return he ? (void *) he->val : NULL;
+}
+
+static void
+chained_set(
+    chained_hash *ht,
+    const void *key,
+    axis2_ssize_t klen,
+    const void *val)
+{
+    chained_entry **hep = chained_find_entry(ht, key, klen, val);
+    if (*hep)
+    {
+        if (!val)
+        {
+            chained_entry *old = *hep;
+            *hep = old->next;
+            old->next = ht->free;
+            ht->free = old;
+            --ht->count;
+        }
+        else
+        {
+            (*hep)->val = val;
+            if (ht->count > ht->max)
+                chained_expand(ht);
+        }
+    }
+}
+
+static unsigned int
+chained_iterate(
+    chained_hash *ht)
+{
+    unsigned int i, n = 0;
+    for (i = 0; i <= ht->max; i++)
+    {
+        chained_entry *he;
+        for (he = ht->array[i]; he; he = he->next)
+            n += he->val != NULL;
+    }
+    return n;
+}
+
+static void
+chained_free(
+    chained_hash *ht)
+{
+    unsigned int i;
+    chained_entry *he, *next;
+
+    for (i = 0; i <= ht->max; i++)
+    {
+        for (he = ht->array[i]; he; he = next)
+        {
+            next = he->next;
+            AXIS2_FREE(ht->env->allocator, he);
+        }
+    }
+    for (he = ht->free; he; he = next)
+    {
+        next = he->next;
+        AXIS2_FREE(ht->env->allocator, he);
+    }
+    AXIS2_FREE(ht->env->allocator, ht->array);
+    AXIS2_FREE(ht->env->allocator, ht);
+}
+
+static unsigned int
+current_iterate(
+    axutil_hash_t *ht)
+{
+    axutil_hash_index_t *hi;
+    unsigned int n = 0;
+    void *v;
+
+    for (hi = axutil_hash_first(ht, NULL); hi; hi = axutil_hash_next(NULL, hi))
+    {
+        axutil_hash_this(hi, NULL, NULL, &v);
+        n += v != NULL;
+    }
+    return n;
+}
+
+/* Every phase runs over all tables at once, so that even tiny tables are
+ * timed over enough operations for clock() */
+#define BENCH_PHASE(result, body) \
+    do { \
+        clock_t start = clock(); \
+        for (r = 0; r < rounds; r++) \
+        { \
+            body; \
+        } \
+        result = (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double) size * rounds); \
+    } while (0)
+
+static void
+run_workload(
+    const axutil_env_t *env,
+    int size,
+    int rounds)
+{
+    char **keys = (char **) malloc(sizeof(char *) * size * 2);
+    chained_hash **chained = (chained_hash **) malloc(sizeof(chained_hash *) * rounds);
+    axutil_hash_t **open = (axutil_hash_t **) malloc(sizeof(axutil_hash_t *) * rounds);
+    double build[2], hit[2], miss[2], iter[2], del[2];
+    unsigned int sink = 0;
+    int i, r;
+
+    for (i = 0; i < size * 2; i++)
+    {
+        keys[i] = (char *) malloc(64);
+        if (i % 2)
+            sprintf(keys[i], "{http://ws.apache.org/axis2/c/samples}element%d", i);
+        else
+            sprintf(keys[i], "TRANSPORT_PROPERTY_%d", i);
+    }
+
+    /* keys [size, 2 * size) are never added */
+    BENCH_PHASE(build[0],
+        chained[r] = chained_make(env);
+        for (i = 0; i < size; i++)
+            chained_set(chained[r], keys[i], AXIS2_HASH_KEY_STRING, keys[i]));
+    BENCH_PHASE(hit[0],
+        for (i = 0; i < size; i++)
+            sink += chained_get(chained[r], keys[i], AXIS2_HASH_KEY_STRING) != NULL);
+    BENCH_PHASE(miss[0],
+        for (i = size; i < size * 2; i++)
+            sink += chained_get(chained[r], keys[i], AXIS2_HASH_KEY_STRING) != NULL);
+    BENCH_PHASE(iter[0], sink += chained_iterate(chained[r]));
+    BENCH_PHASE(del[0],
+        for (i = 0; i < size; i++)
+            chained_set(chained[r], keys[i], AXIS2_HASH_KEY_STRING, NULL);
+        chained_free(chained[r]));
+
+    BENCH_PHASE(build[1],
+        open[r] = axutil_hash_make(env);
+        for (i = 0; i < size; i++)
+            axutil_hash_set(open[r], keys[i], AXIS2_HASH_KEY_STRING, keys[i]));
+    BENCH_PHASE(hit[1],
+        for (i = 0; i < size; i++)
+            sink += axutil_hash_get(open[r], keys[i], AXIS2_HASH_KEY_STRING) != NULL);
+    BENCH_PHASE(miss[1],
+        for (i = size; i < size * 2; i++)
+            sink += axutil_hash_get(open[r], keys[i], AXIS2_HASH_KEY_STRING) != NULL);
+    BENCH_PHASE(iter[1], sink += current_iterate(open[r]));
+    BENCH_PHASE(del[1],
+        for (i = 0; i < size; i++)
+            axutil_hash_set(open[r], keys[i], AXIS2_HASH_KEY_STRING, NULL);
+        axutil_hash_free(open[r], env));
+
+    printf("%7d entries  %-8s %9s %9s %9s %9s %9s\n", size, "", "build", "hit", "miss",
+        "iterate", "delete");
+    for (i = 0; i < 2; i++)
+    {
+        printf("%16s %-8s %9.1f %9.1f %9.1f %9.1f %9.1f\n", "", i ? "open" : "chained",
+            build[i], hit[i], miss[i], iter[i], del[i]);
+    }
+    if (sink == 0)
+        printf("no entries found\n");
+
+    for (i = 0; i < size * 2; i++)
+        free(keys[i]);
+    free(keys);
+    free(chained);
+    free(open);
+}
+
+int
+main(
+    int argc,
+    char **argv)
+{
+    axutil_allocator_t *allocator = axutil_allocator_init(NULL);
+    axutil_error_t *error = axutil_error_create(allocator);
+    axutil_log_t *log = axutil_log_create(allocator, NULL, NULL);
+    axutil_env_t *env = axutil_env_create_with_error_log(allocator, error, log);
+    int rounds = argc > 1 ? atoi(argv[1]) : 1;
+    int sizes[] = { 4, 16, 64, 1024, 65536 };
+    unsigned int i;
+
+    printf("times in ns per operation\n");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        /* roughly the same number of operations for every size */
+        run_workload(env, sizes[i], rounds * (400000 / sizes[i] + 1));
+    }
+
+    axutil_env_free(env);
+    return 0;
+}
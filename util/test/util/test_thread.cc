@@ -25,6 +25,7 @@
 #include <axutil_log_default.h>
 #include <axutil_allocator.h>
 #include <axutil_utils.h>
+#include <axutil_thread_pool.h>
 #include "test_thread.h"
 
 const axutil_env_t *env = NULL;
@@ -235,3 +236,103 @@ TEST_F(TestThread, test_thread)
 
     axutil_thread_mutex_destroy(thread_lock);
 }
+
+static int pool_counter = 0;
+
+void *AXIS2_CALL
+test_pool_function(
+    axutil_thread_t * td,
+    void *param)
+{
+    axutil_thread_pool_t *pool = (axutil_thread_pool_t *) param;
+    axutil_thread_mutex_lock(thread_lock);
+    pool_counter++;
+    axutil_thread_mutex_unlock(thread_lock);
+    /* task functions release themselves on the way out */
+    axutil_thread_pool_exit_thread(pool, td);
+    return NULL;
+}
+
+TEST_F(TestThread, test_thread_pool)
+{
+    axutil_thread_pool_t *pool = NULL;
+    axutil_thread_pool_stats_t stats;
+    axutil_thread_t *thd = NULL;
+    int i;
+
+    thread_lock = axutil_thread_mutex_create(m_allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+    pool_counter = 0;
+
+    pool = axutil_thread_pool_create(m_allocator, 4, 8);
+    ASSERT_NE(pool, nullptr);
+    axutil_thread_pool_set_overflow_policy(pool, AXUTIL_THREAD_POOL_OVERFLOW_WAIT);
+
+    for (i = 0; i < 200; i++)
+    {
+        thd = axutil_thread_pool_get_thread(pool, test_pool_function, pool);
+        ASSERT_NE(thd, nullptr);
+        if (i == 199)
+        {
+            /* keep the last one to join on */
+            break;
+        }
+        axutil_thread_pool_thread_detach(pool, thd);
+    }
+    ASSERT_EQ(axutil_thread_pool_join_thread(pool, thd), AXIS2_SUCCESS);
+
+    /* the joined task is the last one submitted, others may still run */
+    for (i = 0; i < 100; i++)
+    {
+        axutil_thread_pool_get_stats(pool, &stats);
+        if (stats.completed == 200)
+        {
+            break;
+        }
+        AXIS2_USLEEP(10000);
+    }
+
+    ASSERT_EQ(stats.submitted, 200u);
+    ASSERT_EQ(stats.completed, 200u);
+    ASSERT_EQ(stats.overflowed, 0u);
+    ASSERT_LE(stats.workers, 4);
+    ASSERT_LE(stats.peak_queue_depth, 8);
+    ASSERT_EQ(stats.queue_depth, 0);
+    ASSERT_EQ(pool_counter, 200);
+
+    axutil_thread_pool_free(pool);
+    axutil_thread_mutex_destroy(thread_lock);
+}
+
+TEST_F(TestThread, test_thread_pool_overflow)
+{
+    axutil_thread_pool_t *pool = NULL;
+    axutil_thread_pool_stats_t stats;
+    axutil_thread_t *threads[16];
+    int i;
+
+    thread_lock = axutil_thread_mutex_create(m_allocator, AXIS2_THREAD_MUTEX_DEFAULT);
+    pool_counter = 0;
+
+    /* hold the lock so that the single worker blocks and the queue fills up */
+    axutil_thread_mutex_lock(thread_lock);
+    pool = axutil_thread_pool_create(m_allocator, 1, 2);
+    ASSERT_NE(pool, nullptr);
+    for (i = 0; i < 16; i++)
+    {
+        threads[i] = axutil_thread_pool_get_thread(pool, test_pool_function, pool);
+        ASSERT_NE(threads[i], nullptr);
+    }
+    axutil_thread_pool_get_stats(pool, &stats);
+    ASSERT_EQ(stats.submitted, 16u);
+    ASSERT_GE(stats.overflowed, 13u);
+    axutil_thread_mutex_unlock(thread_lock);
+
+    for (i = 0; i < 16; i++)
+    {
+        ASSERT_EQ(axutil_thread_pool_join_thread(pool, threads[i]), AXIS2_SUCCESS);
+    }
+    ASSERT_EQ(pool_counter, 16);
+
+    axutil_thread_pool_free(pool);
+    axutil_thread_mutex_destroy(thread_lock);
+}
@@ -20,6 +20,13 @@
 
 #include <stdio.h>
 #include <axutil_hash.h>
+#include <axutil_qname.h>
+#include <axutil_base64.h>
+#include <axutil_stream.h>
+#include <axutil_buffer_chain.h>
+#include <axutil_http_chunked_stream.h>
+#include <axutil_dns_cache.h>
+#include <axutil_network_handler.h>
 #include <axutil_string.h>
 #include <axutil_error_default.h>
 #include <axutil_array_list.h>
@@ -29,6 +36,8 @@
 #include <axutil_log.h>
 #include <axutil_dir_handler.h>
 #include <axutil_file.h>
+#include <axutil_thread.h>
+#include <string.h>
 #include "axutil_log.h"
 #include "test_thread.h"
 #include "test_log.h"
@@ -131,6 +140,98 @@ TEST_F(TestUtil, test_hash_get)
     AXIS2_FREE(m_env->allocator, a4);
 }
 
+TEST_F(TestUtil, test_hash_grow_and_delete)
+{
+    axutil_hash_t *ht;
+    axutil_hash_t *copy;
+    axutil_hash_t *merged;
+    axutil_hash_index_t *hi;
+    char keys[1000][16];
+    int binary[4] = { 1, 2, 3, 4 };
+    const void *k = NULL;
+    axis2_ssize_t klen = 0;
+    void *v = NULL;
+    unsigned int seen = 0;
+    int i;
+
+    ht = axutil_hash_make(m_env);
+    ASSERT_EQ(axutil_hash_get(ht, "missing", AXIS2_HASH_KEY_STRING), nullptr);
+    ASSERT_EQ(axutil_hash_first(ht, m_env), nullptr);
+
+    for (i = 0; i < 1000; i++)
+    {
+        sprintf(keys[i], "key%d", i);
+        axutil_hash_set(ht, keys[i], AXIS2_HASH_KEY_STRING, keys[i]);
+    }
+    ASSERT_EQ(axutil_hash_count(ht), 1000u);
+    for (i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(axutil_hash_get(ht, keys[i], AXIS2_HASH_KEY_STRING), keys[i]);
+    }
+
+    /* keys with an explicit length need not be strings */
+    axutil_hash_set(ht, binary, sizeof(binary), keys[0]);
+    ASSERT_EQ(axutil_hash_get(ht, binary, sizeof(binary)), keys[0]);
+    axutil_hash_set(ht, binary, sizeof(binary), NULL);
+
+    /* deleting the current entry while iterating visits every entry once */
+    for (hi = axutil_hash_first(ht, m_env); hi; hi = axutil_hash_next(m_env, hi))
+    {
+        axutil_hash_this(hi, &k, &klen, &v);
+        ASSERT_EQ(k, v);
+        ASSERT_EQ(klen, strlen((const char *) k));
+        seen++;
+        if (atoi((const char *) k + 3) % 2)
+        {
+            axutil_hash_set(ht, k, klen, NULL);
+        }
+    }
+    ASSERT_EQ(seen, 1000u);
+    ASSERT_EQ(axutil_hash_count(ht), 500u);
+    ASSERT_EQ(axutil_hash_get(ht, keys[1], AXIS2_HASH_KEY_STRING), nullptr);
+    ASSERT_EQ(axutil_hash_get(ht, keys[2], AXIS2_HASH_KEY_STRING), keys[2]);
+
+    /* slots of deleted entries are reused */
+    for (i = 0; i < 10000; i++)
+    {
+        axutil_hash_set(ht, keys[i % 1000], AXIS2_HASH_KEY_STRING, keys[i % 1000]);
+        axutil_hash_set(ht, keys[(i + 500) % 1000], AXIS2_HASH_KEY_STRING, NULL);
+    }
+    ASSERT_EQ(axutil_hash_count(ht), 500u);
+    ASSERT_EQ(axutil_hash_get(ht, keys[499], AXIS2_HASH_KEY_STRING), nullptr);
+    ASSERT_EQ(axutil_hash_get(ht, keys[999], AXIS2_HASH_KEY_STRING), keys[999]);
+
+    copy = axutil_hash_copy(ht, m_env);
+    ASSERT_EQ(axutil_hash_count(copy), 500u);
+    ASSERT_EQ(axutil_hash_get(copy, keys[999], AXIS2_HASH_KEY_STRING), keys[999]);
+
+    /* a copy outgrowing the array it was made with */
+    for (i = 0; i < 1000; i++)
+    {
+        axutil_hash_set(copy, keys[i], AXIS2_HASH_KEY_STRING, keys[i]);
+    }
+    ASSERT_EQ(axutil_hash_count(copy), 1000u);
+    for (i = 0; i < 1000; i += 2)
+    {
+        axutil_hash_set(copy, keys[i], AXIS2_HASH_KEY_STRING, NULL);
+    }
+    ASSERT_EQ(axutil_hash_count(copy), 500u);
+
+    merged = axutil_hash_make(m_env);
+    axutil_hash_set(merged, keys[999], AXIS2_HASH_KEY_STRING, keys[1]);
+    axutil_hash_set(merged, "extra", AXIS2_HASH_KEY_STRING, keys[2]);
+    v = merged;
+    merged = axutil_hash_overlay((axutil_hash_t *) v, m_env, copy);
+    axutil_hash_free((axutil_hash_t *) v, m_env);
+    ASSERT_EQ(axutil_hash_count(merged), axutil_hash_count(copy) + 1);
+    ASSERT_EQ(axutil_hash_get(merged, keys[999], AXIS2_HASH_KEY_STRING), keys[1]);
+    ASSERT_EQ(axutil_hash_get(merged, "extra", AXIS2_HASH_KEY_STRING), keys[2]);
+
+    axutil_hash_free(merged, m_env);
+    axutil_hash_free(copy, m_env);
+    axutil_hash_free(ht, m_env);
+}
+
 TEST_F(TestUtil, test_axutil_dir_handler_list_service_or_module_dirs)
 {
     int i,
@@ -248,6 +349,650 @@ TEST_F(TestUtil, test_array_list)
 }
 
 
+TEST_F(TestUtil, test_string_intern)
+{
+    axutil_string_t *atom1 = NULL;
+    axutil_string_t *atom2 = NULL;
+    axutil_string_t *other = NULL;
+    axutil_string_t *long_str = NULL;
+    axutil_qname_t *qname1 = NULL;
+    axutil_qname_t *qname2 = NULL;
+    axis2_char_t name[16];
+    axis2_char_t long_name[AXUTIL_STRING_INTERN_MAX_LENGTH + 2];
+
+    /* a copy, so that the atom cannot be the literal itself */
+    strcpy(name, "Envelope");
+    atom1 = axutil_string_intern(m_env, "Envelope");
+    atom2 = axutil_string_intern(m_env, name);
+    other = axutil_string_intern(m_env, "Body");
+    ASSERT_NE(atom1, nullptr);
+    ASSERT_NE(other, nullptr);
+    EXPECT_EQ(atom1, atom2);
+    EXPECT_NE(atom1, other);
+    EXPECT_TRUE(axutil_string_is_interned(atom1, m_env));
+    EXPECT_STREQ(axutil_string_get_buffer(atom1, m_env), "Envelope");
+    EXPECT_EQ(axutil_string_get_length(atom1, m_env), 8U);
+    EXPECT_EQ(axutil_string_get_buffer(atom1, m_env), axutil_string_intern_buffer(name));
+
+    /* atoms outlive any number of frees */
+    axutil_string_free(atom1, m_env);
+    axutil_string_free(atom2, m_env);
+    axutil_string_free(axutil_string_clone(atom1, m_env), m_env);
+    EXPECT_STREQ(axutil_string_get_buffer(atom1, m_env), "Envelope");
+    axutil_string_free(other, m_env);
+
+    /* other strings are not added by interning them */
+    other = axutil_string_intern(m_env, "echoStringRequest");
+    ASSERT_NE(other, nullptr);
+    EXPECT_FALSE(axutil_string_is_interned(other, m_env));
+    EXPECT_EQ(axutil_string_intern_buffer("echoStringRequest"), nullptr);
+    axutil_string_free(other, m_env);
+    strcpy(name, "echoString");
+    EXPECT_STREQ(axutil_string_intern_register(name), "echoString");
+    other = axutil_string_intern_len(m_env, "echoStringRequest", 10);
+    EXPECT_TRUE(axutil_string_is_interned(other, m_env));
+    EXPECT_EQ(axutil_string_get_buffer(other, m_env), axutil_string_intern_buffer(name));
+    strcpy(name, "Envelope");
+
+    /* long strings get a string of their own */
+    memset(long_name, 'a', sizeof(long_name) - 1);
+    long_name[sizeof(long_name) - 1] = '\0';
+    long_str = axutil_string_intern(m_env, long_name);
+    ASSERT_NE(long_str, nullptr);
+    EXPECT_FALSE(axutil_string_is_interned(long_str, m_env));
+    EXPECT_EQ(axutil_string_intern_buffer(long_name), nullptr);
+    EXPECT_EQ(axutil_string_intern_register(long_name), nullptr);
+    EXPECT_STREQ(axutil_string_get_buffer(long_str, m_env), long_name);
+    axutil_string_free(long_str, m_env);
+
+    qname1 = axutil_qname_create(m_env, "Envelope", "http://www.w3.org/2003/05/soap-envelope",
+        "soapenv");
+    qname2 = axutil_qname_create(m_env, name, "http://www.w3.org/2003/05/soap-envelope", NULL);
+    EXPECT_EQ(axutil_qname_get_localpart(qname1, m_env), axutil_qname_get_localpart(qname2,
+        m_env));
+    EXPECT_TRUE(axutil_qname_equals(qname1, m_env, qname2));
+    axutil_qname_free(qname2, m_env);
+    qname2 = axutil_qname_create(m_env, "Body", "http://www.w3.org/2003/05/soap-envelope", NULL);
+    EXPECT_FALSE(axutil_qname_equals(qname1, m_env, qname2));
+    axutil_qname_free(qname1, m_env);
+    axutil_qname_free(qname2, m_env);
+}
+
+/* Plain encoder to check the results against */
+static int
+reference_base64_encode(
+    char *out,
+    const unsigned char *in,
+    int len)
+{
+    static const char chars[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char *p = out;
+    int i;
+
+    for (i = 0; i < len; i += 3)
+    {
+        unsigned long group = (unsigned long) in[i] << 16;
+        if (i + 1 < len)
+            group |= (unsigned long) in[i + 1] << 8;
+        if (i + 2 < len)
+            group |= in[i + 2];
+        *p++ = chars[(group >> 18) & 0x3F];
+        *p++ = chars[(group >> 12) & 0x3F];
+        *p++ = i + 1 < len ? chars[(group >> 6) & 0x3F] : '=';
+        *p++ = i + 2 < len ? chars[group & 0x3F] : '=';
+    }
+    *p = '\0';
+    return (int) (p - out);
+}
+
+TEST_F(TestUtil, test_base64)
+{
+    const int max_len = 70000;
+    unsigned char *plain = (unsigned char *) malloc(max_len);
+    unsigned char *decoded = (unsigned char *) malloc(max_len + 1);
+    char *encoded = (char *) malloc(axutil_base64_encode_len(max_len));
+    char *expected = (char *) malloc(axutil_base64_encode_len(max_len));
+    int lengths[] = { 0, 1, 2, 3, 11, 12, 15, 16, 17, 27, 28, 29, 47, 48, 49, 95, 96, 97, 1000,
+        max_len };
+    unsigned int i;
+    int j;
+
+    srand(7);
+    for (j = 0; j < max_len; j++)
+        plain[j] = (unsigned char) rand();
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        int len = lengths[i];
+        int encoded_len = reference_base64_encode(expected, plain, len);
+
+        EXPECT_EQ(axutil_base64_encode_binary(encoded, plain, len), encoded_len + 1);
+        EXPECT_STREQ(encoded, expected);
+        EXPECT_EQ(axutil_base64_decode_len(encoded), len);
+        EXPECT_EQ(axutil_base64_decode_binary(decoded, encoded), len);
+        EXPECT_EQ(memcmp(decoded, plain, len), 0);
+    }
+
+    /* decoding stops at the first character that is not base64 */
+    reference_base64_encode(expected, plain, 300);
+    for (j = 0; j < 100; j++)
+    {
+        strcpy(encoded, expected);
+        encoded[j * 4] = j % 2 ? '\n' : '*';
+        EXPECT_EQ(axutil_base64_decode_len(encoded), j * 3);
+        EXPECT_EQ(axutil_base64_decode_binary(decoded, encoded), j * 3);
+        EXPECT_EQ(memcmp(decoded, plain, j * 3), 0);
+    }
+    encoded[0] = (char) 0xC1;
+    EXPECT_EQ(axutil_base64_decode_binary(decoded, encoded), 0);
+
+    free(plain);
+    free(decoded);
+    free(encoded);
+    free(expected);
+}
+
+TEST_F(TestUtil, test_base64_encoder)
+{
+    const int len = 20000;
+    unsigned char *plain = (unsigned char *) malloc(len);
+    char *expected = (char *) malloc(axutil_base64_encode_len(len));
+    axutil_stream_t *stream = axutil_stream_create_basic(m_env);
+    axutil_base64_encoder_t *encoder = NULL;
+    int done = 0;
+    int j;
+
+    ASSERT_NE(stream, nullptr);
+    for (j = 0; j < len; j++)
+        plain[j] = (unsigned char) (j * 7);
+    reference_base64_encode(expected, plain, len);
+
+    encoder = axutil_base64_encoder_create_for_stream(m_env, stream);
+    ASSERT_NE(encoder, nullptr);
+    /* uneven pieces, some shorter than a group of 3 */
+    for (j = 1; done < len; j = j * 3 % 1999)
+    {
+        int n = j < len - done ? j : len - done;
+        EXPECT_EQ(axutil_base64_encoder_update(encoder, m_env, plain + done, n), AXIS2_SUCCESS);
+        done += n;
+    }
+    EXPECT_EQ(axutil_base64_encoder_finish(encoder, m_env), AXIS2_SUCCESS);
+    axutil_base64_encoder_free(encoder, m_env);
+
+    ASSERT_EQ(axutil_stream_get_len(stream, m_env), (int) strlen(expected));
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(stream, m_env), expected, strlen(expected)), 0);
+
+    axutil_stream_free(stream, m_env);
+    free(plain);
+    free(expected);
+}
+
+TEST_F(TestUtil, test_stream_buffered_socket)
+{
+    const char *data = "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n"
+        "X-Long: 0123456789abcdef\r\n\r\nbody";
+    axutil_stream_t *stream;
+    const axis2_char_t *buffered = NULL;
+    char line[64];
+    char small[8];
+    int fds[2];
+
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(send(fds[1], data, strlen(data), 0), (ssize_t)strlen(data));
+    close(fds[1]);
+
+    /* a buffer much smaller than the lines, so that lines span refills */
+    stream = axutil_stream_create_buffered_socket(m_env, fds[0], 8);
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ(axutil_stream_peek(stream, m_env, small, 4), 4);
+    EXPECT_EQ(memcmp(small, "HTTP", 4), 0);
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, line, sizeof(line)), 17);
+    EXPECT_STREQ(line, "HTTP/1.1 200 OK\r\n");
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, line, sizeof(line)), 19);
+    EXPECT_STREQ(line, "Content-Length: 4\r\n");
+
+    /* a line longer than the caller's buffer comes back in parts */
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, small, sizeof(small)), 7);
+    EXPECT_STREQ(small, "X-Long:");
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, line, sizeof(line)), 19);
+    EXPECT_STREQ(line, " 0123456789abcdef\r\n");
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, line, sizeof(line)), 2);
+    EXPECT_STREQ(line, "\r\n");
+
+    /* the body is handed over from the buffer */
+    ASSERT_EQ(axutil_stream_peek(stream, m_env, small, 1), 1);
+    ASSERT_EQ(axutil_stream_get_buffered(stream, m_env, &buffered), 4);
+    EXPECT_EQ(memcmp(buffered, "body", 4), 0);
+    EXPECT_EQ(axutil_stream_skip(stream, m_env, 2), 2);
+    EXPECT_EQ(axutil_stream_read(stream, m_env, line, sizeof(line)), 2);
+    EXPECT_EQ(memcmp(line, "dy", 2), 0);
+    EXPECT_EQ(axutil_stream_get_buffered(stream, m_env, &buffered), 0);
+    EXPECT_EQ(axutil_stream_read_line(stream, m_env, line, sizeof(line)), 0);
+
+    axutil_stream_free(stream, m_env);
+    close(fds[0]);
+}
+
+static int
+recv_all(
+    int fd,
+    char *buffer,
+    int size)
+{
+    int total = 0;
+    int len;
+
+    while (total < size && (len = (int)recv(fd, buffer + total, size - total, 0)) > 0)
+        total += len;
+    return total;
+}
+
+TEST_F(TestUtil, test_stream_writev_cork)
+{
+    axutil_stream_t *stream;
+    axutil_stream_t *basic;
+    axutil_stream_iovec_t iov[3];
+    char *big = (char *)malloc(3 * AXIS2_STREAM_SOCKET_BUF_SIZE);
+    char *received = (char *)malloc(4 * AXIS2_STREAM_SOCKET_BUF_SIZE);
+    char peek;
+    int fds[2];
+    int i;
+
+    for (i = 0; i < 3 * AXIS2_STREAM_SOCKET_BUF_SIZE; i++)
+        big[i] = 'a' + i % 26;
+    iov[0].base = "HTTP/1.1 200 OK\r\n";
+    iov[0].len = 17;
+    iov[1].base = "";
+    iov[1].len = 0;
+    iov[2].base = "\r\n";
+    iov[2].len = 2;
+
+    /* streams other than sockets write the segments one by one */
+    basic = axutil_stream_create_basic(m_env);
+    ASSERT_EQ(axutil_stream_writev(basic, m_env, iov, 3), 19);
+    ASSERT_EQ(axutil_stream_get_len(basic, m_env), 19);
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(basic, m_env), "HTTP/1.1 200 OK\r\n\r\n", 19), 0);
+    axutil_stream_free(basic, m_env);
+
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    stream = axutil_stream_create_buffered_socket(m_env, fds[0], 0);
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ(axutil_stream_writev(stream, m_env, iov, 3), 19);
+    ASSERT_EQ(recv_all(fds[1], received, 19), 19);
+    EXPECT_EQ(memcmp(received, "HTTP/1.1 200 OK\r\n\r\n", 19), 0);
+
+    /* nothing leaves a corked stream until it is uncorked */
+    ASSERT_EQ(axutil_stream_cork(stream, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, "abc", 3), 3);
+    ASSERT_EQ(axutil_stream_writev(stream, m_env, iov, 3), 19);
+    EXPECT_EQ(recv(fds[1], &peek, 1, MSG_DONTWAIT), -1);
+    ASSERT_EQ(axutil_stream_uncork(stream, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(recv_all(fds[1], received, 22), 22);
+    EXPECT_EQ(memcmp(received, "abcHTTP/1.1 200 OK\r\n\r\n", 22), 0);
+
+    /* a write too big for the cork buffer is sent along with what was collected */
+    ASSERT_EQ(axutil_stream_cork(stream, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, "head", 4), 4);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, big, AXIS2_STREAM_SOCKET_BUF_SIZE),
+        AXIS2_STREAM_SOCKET_BUF_SIZE);
+    ASSERT_EQ(recv_all(fds[1], received, AXIS2_STREAM_SOCKET_BUF_SIZE + 4),
+        AXIS2_STREAM_SOCKET_BUF_SIZE + 4);
+    EXPECT_EQ(memcmp(received, "head", 4), 0);
+    EXPECT_EQ(memcmp(received + 4, big, AXIS2_STREAM_SOCKET_BUF_SIZE), 0);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, "tail", 4), 4);
+    ASSERT_EQ(axutil_stream_uncork(stream, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(recv_all(fds[1], received, 4), 4);
+    EXPECT_EQ(memcmp(received, "tail", 4), 0);
+
+    axutil_stream_free(stream, m_env);
+    close(fds[0]);
+    close(fds[1]);
+    free(big);
+    free(received);
+}
+
+TEST_F(TestUtil, test_stream_sendfile)
+{
+    axutil_stream_t *stream;
+    axutil_stream_t *basic;
+    axutil_http_chunked_stream_t *chunked;
+    int size = 3 * AXIS2_STREAM_SOCKET_BUF_SIZE;
+    char *big = (char *)malloc(size);
+    char *received = (char *)malloc(size + 4);
+    FILE *file = tmpfile();
+    int fds[2];
+    int i;
+
+    ASSERT_NE(file, nullptr);
+    for (i = 0; i < size; i++)
+        big[i] = 'a' + i % 26;
+    ASSERT_EQ((int)fwrite(big, 1, size, file), size);
+    fflush(file);
+
+    /* what a corked stream collected goes out first, and the file is left
+     * positioned after the bytes that were sent */
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    stream = axutil_stream_create_buffered_socket(m_env, fds[0], 0);
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ(axutil_stream_cork(stream, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, "head", 4), 4);
+    fseek(file, 5, SEEK_SET);
+    ASSERT_EQ(axutil_stream_sendfile(stream, m_env, file, size - 8), AXIS2_SUCCESS);
+    ASSERT_EQ(recv_all(fds[1], received, size - 4), size - 4);
+    EXPECT_EQ(memcmp(received, "head", 4), 0);
+    EXPECT_EQ(memcmp(received + 4, big + 5, size - 8), 0);
+    ASSERT_EQ(fread(received, 1, 4, file), 3u);
+    EXPECT_EQ(memcmp(received, big + size - 3, 3), 0);
+    ASSERT_EQ(axutil_stream_uncork(stream, m_env), AXIS2_SUCCESS);
+
+    /* asking for more than the file has fails */
+    rewind(file);
+    EXPECT_EQ(axutil_stream_sendfile(stream, m_env, file, size + 1), AXIS2_FAILURE);
+    ASSERT_EQ(recv_all(fds[1], received, size), size);
+    axutil_stream_free(stream, m_env);
+    close(fds[0]);
+    close(fds[1]);
+
+    /* other streams get the file through a buffer */
+    basic = axutil_stream_create_basic(m_env);
+    rewind(file);
+    ASSERT_EQ(axutil_stream_sendfile(basic, m_env, file, size), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_get_len(basic, m_env), size);
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(basic, m_env), big, size), 0);
+    axutil_stream_free(basic, m_env);
+
+    basic = axutil_stream_create_basic(m_env);
+    chunked = axutil_http_chunked_stream_create(m_env, basic);
+    rewind(file);
+    ASSERT_EQ(axutil_http_chunked_stream_write_file(chunked, m_env, file, 26), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_get_len(basic, m_env), 32);
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(basic, m_env),
+        "1a\r\nabcdefghijklmnopqrstuvwxyz\r\n", 32), 0);
+    axutil_http_chunked_stream_free(chunked, m_env);
+    axutil_stream_free(basic, m_env);
+
+    fclose(file);
+    free(big);
+    free(received);
+}
+
+TEST_F(TestUtil, test_buffer_chain)
+{
+    const int size = 2 * AXUTIL_BUFFER_CHAIN_CHUNK_SIZE + 100;
+    axutil_buffer_chain_t *chain;
+    axutil_stream_t *stream;
+    axutil_stream_t *basic;
+    axutil_stream_iovec_t iov[4];
+    char *data = (char *)malloc(size);
+    char *received = (char *)malloc(size + 4);
+    char *flat;
+    int fds[2];
+    int i;
+
+    for (i = 0; i < size; i++)
+        data[i] = 'a' + i % 26;
+
+    /* appends spill over into new chunks, which are handed out in order */
+    chain = axutil_buffer_chain_create(m_env);
+    ASSERT_NE(chain, nullptr);
+    ASSERT_EQ(axutil_buffer_chain_append(chain, m_env, data, 10), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_buffer_chain_append(chain, m_env, data + 10, size - 10), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_buffer_chain_get_len(chain, m_env), (size_t)size);
+    ASSERT_EQ(axutil_buffer_chain_get_segments(chain, m_env, iov, 4), 3);
+    EXPECT_EQ(iov[0].len, (size_t)AXUTIL_BUFFER_CHAIN_CHUNK_SIZE);
+    EXPECT_EQ(iov[2].len, (size_t)100);
+    EXPECT_EQ(memcmp(iov[1].base, data + AXUTIL_BUFFER_CHAIN_CHUNK_SIZE,
+        AXUTIL_BUFFER_CHAIN_CHUNK_SIZE), 0);
+    EXPECT_EQ(axutil_buffer_chain_get_segments(chain, m_env, iov, 2), 2);
+
+    flat = axutil_buffer_chain_flatten(chain, m_env);
+    ASSERT_NE(flat, nullptr);
+    EXPECT_EQ(memcmp(flat, data, size), 0);
+    EXPECT_EQ(flat[size], '\0');
+    AXIS2_FREE(m_env->allocator, flat);
+
+    /* consumed chunks are dropped from the front */
+    axutil_buffer_chain_consume(chain, m_env, AXUTIL_BUFFER_CHAIN_CHUNK_SIZE + 5);
+    EXPECT_EQ(axutil_buffer_chain_get_len(chain, m_env),
+        (size_t)(size - AXUTIL_BUFFER_CHAIN_CHUNK_SIZE - 5));
+    ASSERT_EQ(axutil_buffer_chain_get_segments(chain, m_env, iov, 4), 2);
+    EXPECT_EQ(memcmp(iov[0].base, data + AXUTIL_BUFFER_CHAIN_CHUNK_SIZE + 5, 10), 0);
+    EXPECT_EQ(axutil_buffer_chain_read(chain, m_env, received, size),
+        (size_t)(size - AXUTIL_BUFFER_CHAIN_CHUNK_SIZE - 5));
+    EXPECT_EQ(memcmp(received, data + AXUTIL_BUFFER_CHAIN_CHUNK_SIZE + 5,
+        size - AXUTIL_BUFFER_CHAIN_CHUNK_SIZE - 5), 0);
+    EXPECT_EQ(axutil_buffer_chain_get_len(chain, m_env), (size_t)0);
+    EXPECT_EQ(axutil_buffer_chain_get_segments(chain, m_env, iov, 4), 0);
+    axutil_buffer_chain_free(chain, m_env);
+
+    /* contiguous appends are not split, and may be larger than a chunk */
+    chain = axutil_buffer_chain_create(m_env);
+    ASSERT_EQ(axutil_buffer_chain_append(chain, m_env, data, AXUTIL_BUFFER_CHAIN_CHUNK_SIZE - 5),
+        AXIS2_SUCCESS);
+    flat = axutil_buffer_chain_append_contiguous(chain, m_env, data, 10);
+    ASSERT_NE(flat, nullptr);
+    EXPECT_EQ(memcmp(flat, data, 10), 0);
+    flat = axutil_buffer_chain_append_contiguous(chain, m_env, data, size);
+    ASSERT_NE(flat, nullptr);
+    EXPECT_EQ(memcmp(flat, data, size), 0);
+    ASSERT_EQ(axutil_buffer_chain_get_segments(chain, m_env, iov, 4), 3);
+    EXPECT_EQ(iov[0].len, (size_t)(AXUTIL_BUFFER_CHAIN_CHUNK_SIZE - 5));
+    EXPECT_EQ(iov[1].len, (size_t)10);
+    EXPECT_EQ(iov[2].len, (size_t)size);
+    EXPECT_EQ(axutil_buffer_chain_get_len(chain, m_env),
+        (size_t)(AXUTIL_BUFFER_CHAIN_CHUNK_SIZE + 5 + size));
+    axutil_buffer_chain_free(chain, m_env);
+
+    /* a chain stream counts what is appended to its chain directly */
+    stream = axutil_stream_create_chain(m_env);
+    ASSERT_NE(stream, nullptr);
+    chain = axutil_stream_get_chain(stream, m_env);
+    ASSERT_NE(chain, nullptr);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, data, 10), 10);
+    ASSERT_EQ(axutil_buffer_chain_append(chain, m_env, data + 10, size - 10), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_stream_get_len(stream, m_env), size);
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(stream, m_env), data, size), 0);
+    EXPECT_EQ(axutil_stream_skip(stream, m_env, 3), 3);
+    EXPECT_EQ(axutil_stream_read(stream, m_env, received, 4), 4);
+    EXPECT_EQ(memcmp(received, data + 3, 4), 0);
+    EXPECT_EQ(axutil_stream_get_len(stream, m_env), size - 7);
+
+    /* and writes it out without flattening it */
+    basic = axutil_stream_create_basic(m_env);
+    ASSERT_EQ(axutil_buffer_chain_write_to_stream(chain, m_env, basic), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_stream_get_len(basic, m_env), size - 7);
+    EXPECT_EQ(memcmp(axutil_stream_get_buffer(basic, m_env), data + 7, size - 7), 0);
+    EXPECT_EQ(axutil_stream_get_len(stream, m_env), 0);
+    axutil_stream_free(basic, m_env);
+
+    /* to a corked socket, what was collected goes out with the chunks */
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    basic = axutil_stream_create_socket(m_env, fds[0]);
+    ASSERT_NE(basic, nullptr);
+    ASSERT_EQ(axutil_stream_write(stream, m_env, data, size), size);
+    ASSERT_EQ(axutil_stream_cork(basic, m_env), AXIS2_SUCCESS);
+    ASSERT_EQ(axutil_stream_write(basic, m_env, "head", 4), 4);
+    ASSERT_EQ(axutil_buffer_chain_write_to_stream(chain, m_env, basic), AXIS2_SUCCESS);
+    ASSERT_EQ(recv_all(fds[1], received, size + 4), size + 4);
+    EXPECT_EQ(memcmp(received, "head", 4), 0);
+    EXPECT_EQ(memcmp(received + 4, data, size), 0);
+    ASSERT_EQ(axutil_stream_uncork(basic, m_env), AXIS2_SUCCESS);
+
+    axutil_stream_free(basic, m_env);
+    axutil_stream_free(stream, m_env);
+    close(fds[0]);
+    close(fds[1]);
+    free(data);
+    free(received);
+}
+
+TEST_F(TestUtil, test_dns_cache)
+{
+    axutil_dns_addr_t addrs[AXUTIL_DNS_CACHE_MAX_ADDRS];
+    unsigned long hits = 0, misses = 0, hits2 = 0, misses2 = 0;
+    struct sockaddr_in *in = NULL;
+    int count = 0;
+
+    axutil_dns_cache_set_ttl(m_env, AXUTIL_DNS_CACHE_DEFAULT_TTL,
+        AXUTIL_DNS_CACHE_DEFAULT_NEGATIVE_TTL);
+    axutil_dns_cache_invalidate(m_env, NULL);
+
+    /* numeric addresses are not looked up */
+    axutil_dns_cache_get_stats(&hits, &misses);
+    ASSERT_EQ(axutil_dns_cache_resolve(m_env, "127.0.0.1", 8080, addrs, 1), 1);
+    in = (struct sockaddr_in *)&addrs[0].addr;
+    EXPECT_EQ(addrs[0].family, AF_INET);
+    EXPECT_EQ(ntohs(in->sin_port), 8080);
+    EXPECT_EQ(ntohl(in->sin_addr.s_addr), 0x7f000001UL);
+    ASSERT_EQ(axutil_dns_cache_resolve(m_env, "::1", 8080, addrs, 1), 1);
+    EXPECT_EQ(addrs[0].family, AF_INET6);
+    EXPECT_EQ(ntohs(((struct sockaddr_in6 *)&addrs[0].addr)->sin6_port), 8080);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(hits2, hits);
+    EXPECT_EQ(misses2, misses);
+
+    /* names are looked up once, then served from the cache */
+    count = axutil_dns_cache_resolve(m_env, "localhost", 80, addrs, AXUTIL_DNS_CACHE_MAX_ADDRS);
+    ASSERT_GT(count, 0);
+    ASSERT_EQ(axutil_dns_cache_resolve(m_env, "localhost", 443, addrs,
+        AXUTIL_DNS_CACHE_MAX_ADDRS), count);
+    EXPECT_EQ(ntohs(((struct sockaddr_in *)&addrs[0].addr)->sin_port), 443);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(misses2, misses + 1);
+    EXPECT_EQ(hits2, hits + 1);
+
+    /* so are names that do not resolve */
+    EXPECT_EQ(axutil_dns_cache_resolve(m_env, "nonexistent.invalid", 80, addrs, 1), 0);
+    EXPECT_EQ(axutil_dns_cache_resolve(m_env, "nonexistent.invalid", 80, addrs, 1), 0);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(misses2, misses + 2);
+    EXPECT_EQ(hits2, hits + 2);
+
+    /* dropped names are looked up again */
+    axutil_dns_cache_invalidate(m_env, "localhost");
+    EXPECT_EQ(axutil_dns_cache_prewarm(m_env, "http://localhost:9090/axis2/services"),
+        AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_dns_cache_resolve(m_env, "localhost", 80, addrs, 1), 1);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(misses2, misses + 3);
+    EXPECT_EQ(hits2, hits + 3);
+
+    /* nothing is cached with a ttl of 0 */
+    axutil_dns_cache_set_ttl(m_env, 0, 0);
+    EXPECT_GT(axutil_dns_cache_resolve(m_env, "localhost", 80, addrs, 1), 0);
+    EXPECT_GT(axutil_dns_cache_resolve(m_env, "localhost", 80, addrs, 1), 0);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(misses2, misses + 5);
+    EXPECT_EQ(hits2, hits + 3);
+    axutil_dns_cache_set_ttl(m_env, AXUTIL_DNS_CACHE_DEFAULT_TTL,
+        AXUTIL_DNS_CACHE_DEFAULT_NEGATIVE_TTL);
+}
+
+static int listen_loopback(int backlog, int *port)
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || listen(fd, backlog) < 0
+        || getsockname(fd, (struct sockaddr *)&addr, &len) < 0)
+        return -1;
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static long elapsed_ms(long since)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000L + tv.tv_usec / 1000 - since;
+}
+
+TEST_F(TestUtil, test_network_connect)
+{
+    axutil_socket_options_t options;
+    int listener, port, sock, value, i;
+    int backlog[8];
+    struct sockaddr_in addr;
+    socklen_t len;
+    long start;
+    unsigned long hits = 0, misses = 0, hits2 = 0, misses2 = 0;
+
+    listener = listen_loopback(8, &port);
+    ASSERT_GE(listener, 0);
+
+    /* options are applied and the socket is left blocking */
+    axutil_socket_options_init(&options);
+    options.connect_timeout = 1000;
+    options.keepalive = AXIS2_TRUE;
+    options.recv_buffer_size = 65536;
+    sock = axutil_network_handler_open_socket_with_options(m_env, (char *)"localhost", port,
+        &options);
+    ASSERT_GE(sock, 0);
+    value = 0;
+    len = sizeof(value);
+    getsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &value, &len);
+    EXPECT_EQ(value, 1);
+    value = 0;
+    getsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &value, &len);
+    EXPECT_EQ(value, 1);
+    value = 0;
+    getsockopt(sock, SOL_SOCKET, SO_RCVBUF, &value, &len);
+    EXPECT_GE(value, 65536);
+    EXPECT_EQ(fcntl(sock, F_GETFL, 0) & O_NONBLOCK, 0);
+    close(sock);
+    close(listener);
+
+    /* refused connections fail without waiting for the timeout */
+    start = elapsed_ms(0);
+    EXPECT_EQ(axutil_network_handler_open_socket_with_options(m_env, (char *)"127.0.0.1", port,
+        &options), AXIS2_INVALID_SOCKET);
+    EXPECT_EQ(axutil_network_handler_open_socket(m_env, (char *)"127.0.0.1", port),
+        AXIS2_INVALID_SOCKET);
+    EXPECT_LT(elapsed_ms(start), 500);
+
+    /* a host whose addresses could not be connected to is looked up again */
+    EXPECT_EQ(axutil_network_handler_open_socket(m_env, (char *)"localhost", port),
+        AXIS2_INVALID_SOCKET);
+    axutil_dns_cache_get_stats(&hits, &misses);
+    EXPECT_EQ(axutil_network_handler_open_socket(m_env, (char *)"localhost", port),
+        AXIS2_INVALID_SOCKET);
+    EXPECT_EQ(axutil_network_handler_open_socket(m_env, (char *)"localhost", port),
+        AXIS2_INVALID_SOCKET);
+    axutil_dns_cache_get_stats(&hits2, &misses2);
+    EXPECT_EQ(misses2, misses + 2);
+    EXPECT_EQ(hits2, hits);
+
+    /* a server that does not answer is given up on after the timeout; its
+     * accept queue is filled so that further connects go unanswered */
+    listener = listen_loopback(0, &port);
+    ASSERT_GE(listener, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    for (i = 0; i < 8; i++)
+    {
+        backlog[i] = socket(AF_INET, SOCK_STREAM, 0);
+        fcntl(backlog[i], F_SETFL, O_NONBLOCK);
+        connect(backlog[i], (struct sockaddr *)&addr, sizeof(addr));
+    }
+    options.connect_timeout = 200;
+    start = elapsed_ms(0);
+    EXPECT_EQ(axutil_network_handler_open_socket_with_options(m_env, (char *)"127.0.0.1", port,
+        &options), AXIS2_INVALID_SOCKET);
+    EXPECT_GE(elapsed_ms(start), 150);
+    EXPECT_LT(elapsed_ms(start), 2000);
+    for (i = 0; i < 8; i++)
+        close(backlog[i]);
+    close(listener);
+}
+
 TEST_F(TestUtil, test_uuid_gen)
 {
     char *uuid = NULL;
@@ -261,6 +1006,97 @@ TEST_F(TestUtil, test_uuid_gen)
     printf("finished uuid_gen test...\n");
 }
 
+#define UUID_THREADS 4
+#define UUID_PER_THREAD 2000
+
+static void *AXIS2_THREAD_FUNC
+uuid_gen_worker(
+    axutil_thread_t *thd,
+    void *data)
+{
+    char (*uuids)[AXUTIL_UUID_STRING_SIZE] = (char (*)[AXUTIL_UUID_STRING_SIZE])data;
+    int i;
+
+    (void)thd;
+    for (i = 0; i < UUID_PER_THREAD; i++)
+    {
+        axutil_uuid_gen_into(uuids[i]);
+    }
+    return NULL;
+}
+
+static int
+uuid_compare(
+    const void *a,
+    const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+static void
+check_uuids(
+    axutil_env_t *env,
+    axutil_uuid_version_t version)
+{
+    char (*uuids)[AXUTIL_UUID_STRING_SIZE] = (char (*)[AXUTIL_UUID_STRING_SIZE])malloc(
+        UUID_THREADS * UUID_PER_THREAD * AXUTIL_UUID_STRING_SIZE);
+    axutil_thread_t *threads[UUID_THREADS];
+    int i, j;
+
+    ASSERT_EQ(axutil_uuid_gen_set_version(env, version), AXIS2_SUCCESS);
+    EXPECT_EQ(axutil_uuid_gen_get_version(), version);
+    for (i = 0; i < UUID_THREADS; i++)
+    {
+        threads[i] = axutil_thread_create(env->allocator, NULL, uuid_gen_worker,
+            uuids + i * UUID_PER_THREAD);
+        ASSERT_NE(threads[i], nullptr);
+    }
+    for (i = 0; i < UUID_THREADS; i++)
+    {
+        axutil_thread_join(threads[i]);
+        axutil_thread_free(threads[i], env->allocator);
+    }
+
+    for (i = 0; i < UUID_THREADS * UUID_PER_THREAD; i++)
+    {
+        const char *uuid = uuids[i];
+        ASSERT_EQ(strlen(uuid), 36U);
+        for (j = 0; j < 36; j++)
+        {
+            if (j == 8 || j == 13 || j == 18 || j == 23)
+            {
+                ASSERT_EQ(uuid[j], '-');
+            }
+            else
+            {
+                ASSERT_TRUE(strchr("0123456789abcdef", uuid[j]) != NULL) << uuid;
+            }
+        }
+        ASSERT_EQ(uuid[14], '0' + (int)version) << uuid;
+        ASSERT_TRUE(strchr("89ab", uuid[19]) != NULL) << uuid;
+        /* time ordered uuids of one thread sort in the order they were made */
+        if (version == AXUTIL_UUID_VERSION_7 && i % UUID_PER_THREAD)
+        {
+            ASSERT_LT(strcmp(uuids[i - 1], uuid), 0) << uuids[i - 1] << " " << uuid;
+        }
+    }
+
+    qsort(uuids, UUID_THREADS * UUID_PER_THREAD, AXUTIL_UUID_STRING_SIZE, uuid_compare);
+    for (i = 1; i < UUID_THREADS * UUID_PER_THREAD; i++)
+    {
+        ASSERT_STRNE(uuids[i - 1], uuids[i]);
+    }
+    free(uuids);
+}
+
+TEST_F(TestUtil, test_uuid_gen_threads)
+{
+    check_uuids(m_env, AXUTIL_UUID_VERSION_7);
+    check_uuids(m_env, AXUTIL_UUID_VERSION_4);
+    EXPECT_EQ(axutil_uuid_gen_set_version(m_env, (axutil_uuid_version_t)1), AXIS2_FAILURE);
+    EXPECT_EQ(axutil_uuid_gen_get_version(), AXUTIL_UUID_VERSION_4);
+}
+
 
 TEST_F(TestUtil, test_log_write)
 {
@@ -286,3 +1122,86 @@ TEST_F(TestUtil, test_log_write)
 
 }
 
+static void *AXIS2_THREAD_FUNC
+log_async_worker(
+    axutil_thread_t *thd,
+    void *data)
+{
+    axutil_env_t *env = (axutil_env_t *)data;
+    int i;
+
+    (void)thd;
+    for (i = 0; i < 500; i++)
+    {
+        AXIS2_LOG_DEBUG(env->log, AXIS2_LOG_SI, "async line %d", i);
+    }
+    return NULL;
+}
+
+static int
+count_log_lines(
+    const char *file_name,
+    const char *text)
+{
+    char line[256];
+    int count = 0;
+    FILE *file = fopen(file_name, "r");
+
+    if (!file)
+        return -1;
+    while (fgets(line, sizeof(line), file))
+    {
+        if (strstr(line, text))
+            count++;
+    }
+    fclose(file);
+    return count;
+}
+
+TEST_F(TestUtil, test_log_async)
+{
+    const char *file_name = "./test_log_async.log";
+    axutil_allocator_t *allocator = axutil_allocator_init(NULL);
+    axutil_error_t *error = axutil_error_create(allocator);
+    axutil_log_t *log = NULL;
+    axutil_env_t *env = NULL;
+    axutil_thread_t *threads[4];
+    int i;
+
+    remove(file_name);
+    log = axutil_log_create(allocator, NULL, file_name);
+    ASSERT_NE(log, nullptr);
+    log->level = AXIS2_LOG_LEVEL_DEBUG;
+    env = axutil_env_create_with_error_log(allocator, error, log);
+    ASSERT_NE(env, nullptr);
+
+    /* small buffers, so that writers have to wait for the flusher */
+    ASSERT_EQ(axutil_log_set_async(log, allocator, 1, AXUTIL_LOG_OVERFLOW_BLOCK),
+        AXIS2_SUCCESS);
+    for (i = 0; i < 4; i++)
+    {
+        threads[i] = axutil_thread_create(allocator, NULL, log_async_worker, env);
+        ASSERT_NE(threads[i], nullptr);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        axutil_thread_join(threads[i]);
+        axutil_thread_free(threads[i], allocator);
+    }
+    axutil_log_flush(log);
+    EXPECT_EQ(count_log_lines(file_name, "async line"), 2000);
+    EXPECT_EQ(axutil_log_get_dropped(log), 0UL);
+
+    /* critical lines are written through at once */
+    AXIS2_LOG_INFO(log, "before critical");
+    AXIS2_LOG_CRITICAL(log, AXIS2_LOG_SI, "critical line");
+    EXPECT_EQ(count_log_lines(file_name, "before critical"), 1);
+    EXPECT_EQ(count_log_lines(file_name, "critical line"), 1);
+
+    /* buffered lines are written out when the log is freed */
+    AXIS2_LOG_INFO(log, "last line");
+    axutil_env_free(env);
+    EXPECT_EQ(count_log_lines(file_name, "last line"), 1);
+    remove(file_name);
+}
+